@@ -0,0 +1,194 @@
+// Part of the Pg test suite, measures the cycle counts of the library's hot paths.
+//
+// Each benchmark runs its body a fixed number of times on the same
+// pseudo-random input, so results are comparable between builds and
+// boards. Results are printed as "name: cycles/iteration" lines. Define
+// __PG_CYCLE_COUNTER before including the library to count cycles exactly
+// on AVR boards (see <system/cycles.h>), otherwise AVR and SAMD21 counts
+// have a resolution of one microsecond.
+//
+// The sketch also builds and runs on a Linux host, against the stub
+// Arduino API in hardware/host: run `make' in that folder.
+
+#define __PG_CYCLE_COUNTER
+#include <pg.h>
+#include <algorithm>
+#include <cstring>
+#include <valarray>
+#include <lib/crc.h>
+#include <lib/fmath.h>	// Before <complex>, which defines pg::sqr() if fmath.h isn't included.
+#include <lib/fft.h>
+#include <lib/imath.h>
+#include <system/cycles.h>
+#include <utilities/Interpreter.h>
+
+using namespace pg;
+
+const std::size_t Size = 64;			// Number of input values.
+const uint16_t Iterations = 16;			// Number of times each benchmark body runs.
+
+uint8_t bytes[Size];
+int ints[Size];
+int16_t shorts[Size];
+float floats[Size];
+char text[Size + 1];
+char other[Size + 1];
+const char Accept[] = "abcdefghijklmnop";	// Every character of text.
+volatile uint32_t sink;					// Keeps benchmark results from being optimized away.
+
+// Deterministic pseudo-random numbers, so every run sees the same input.
+uint32_t xorshift()
+{
+  static uint32_t x = 2463534242UL;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+
+  return x;
+}
+
+template<class F>
+void bench(const char* name, F body)
+{
+  cycle_counter::value_type t = cycle_counter::now();
+
+  for (uint16_t i = 0; i < Iterations; ++i)
+    body();
+  t = cycle_counter::now() - t;
+  Serial.print(name); Serial.print(": "); Serial.println(t / Iterations);
+}
+
+// The byte-at-a-time string loops, to compare with the library versions.
+std::size_t strlen_bytes(const char* s)
+{
+  std::size_t len = 0;
+
+  while (*s++)
+    ++len;
+
+  return len;
+}
+
+int strcmp_bytes(const char* lhs, const char* rhs)
+{
+  while (*lhs && *lhs == *rhs)
+    ++lhs, ++rhs;
+
+  return (unsigned char)*lhs - (unsigned char)*rhs;
+}
+
+int memcmp_bytes(const void* lhs, const void* rhs, std::size_t count)
+{
+  const unsigned char* p = (const unsigned char*)lhs;
+  const unsigned char* q = (const unsigned char*)rhs;
+
+  for (; count; --count, ++p, ++q)
+    if (*p != *q)
+      return *p - *q;
+
+  return 0;
+}
+
+std::size_t strspn_bytes(const char* str, const char* accept)
+{
+  std::size_t count = 0;
+
+  for (; *str; ++str, ++count)
+  {
+    const char* a = accept;
+
+    while (*a && *a != *str)
+      ++a;
+    if (!*a)
+      break;
+  }
+
+  return count;
+}
+
+void add(int a, int b) { sink = a + b; }
+
+Interpreter interp;
+Interpreter::Command<void, void, int, int> add_cmd("add", &add);
+Interpreter::CommandBase* commands[] = { &add_cmd };
+
+void setup()
+{
+  Serial.begin(115200);
+  cycle_counter::start();
+  for (std::size_t i = 0; i < Size; ++i)
+  {
+    bytes[i] = xorshift();
+    shorts[i] = xorshift();
+    floats[i] = (xorshift() % 1000) / 100.0f;
+    text[i] = other[i] = Accept[xorshift() % (sizeof(Accept) - 1)];
+  }
+  other[Size - 1] = '.';	// Strings differ in the last character.
+# if defined __PG_HAS_CYCLE_COUNTER
+  Serial.println("cycles (exact)");
+# else
+  Serial.println("cycles (micros() scaled)");
+# endif
+
+  static uint16_t lut16[256];
+  crc_lut(lut16, lut16 + 256, crc_16().poly);
+  bench("crc_16", [] { sink = crc(bytes, bytes + Size, crc_16()); });
+  bench("crc_16 lut", [] { sink = crc(bytes, bytes + Size, lut16, crc_16()); });
+  bench("crc_32", [] { sink = crc(bytes, bytes + Size, crc_32()); });
+
+  bench("sin", [] { float s = 0; for (auto f : floats) s += pg::sin(f); sink = s; });
+  bench("exp", [] { float s = 0; for (auto f : floats) s += pg::exp(-f); sink = s; });
+  bench("hypot", [] { float s = 0; for (auto f : floats) s += pg::hypot(f, 1.0f); sink = s; });
+  bench("mean", [] { sink = pg::mean(floats, floats + Size); });
+
+  bench("ilog2", [] { uint32_t s = 0; for (auto b : bytes) s += ilog2<uint32_t>(b + 1UL); sink = s; });
+  bench("igcd", [] { uint32_t s = 0; for (std::size_t i = 1; i < Size; ++i) s += igcd<uint32_t>(bytes[i] + 1UL, bytes[i - 1] + 1UL); sink = s; });
+
+  bench("sort random", [] { for (auto& i : ints) i = xorshift(); std::sort(ints, ints + Size); });
+  bench("sort sorted", [] { std::sort(ints, ints + Size); });
+  bench("sort reversed", [] { std::reverse(ints, ints + Size); std::sort(ints, ints + Size); });
+
+  bench("valarray", [] {
+    std::valarray<float, Size> a(floats, Size), b(floats, Size);
+    a = a * b + a;
+    sink = a.sum();
+    });
+  bench("valarray int16", [] {
+    std::valarray<int16_t, Size> a(shorts, Size), b(shorts, Size);
+    a = a * b + a;
+    sink = a.sum() + a.max();
+    });
+  bench("inner_product int16", [] { sink = std::inner_product(shorts, shorts + Size, shorts, 0L); });
+  bench("fft float", [] {
+    std::array<std::complex<float>, Size> x;
+    for (std::size_t i = 0; i < Size; ++i) x[i] = floats[i];
+    pg::fft(x);
+    sink = pg::fft_peak<Size>(x.data());
+    });
+  bench("fft q15", [] {
+    std::array<std::complex<int16_t>, Size> x;
+    for (std::size_t i = 0; i < Size; ++i) x[i] = shorts[i] >> 1;
+    pg::fft(x);
+    sink = pg::fft_peak<Size>(x.data());
+    });
+
+  bench("strlen", [] { sink = std::strlen(text); });
+  bench("strlen bytes", [] { sink = strlen_bytes(text); });
+  bench("strcmp", [] { sink = std::strcmp(text, other); });
+  bench("strcmp bytes", [] { sink = strcmp_bytes(text, other); });
+  bench("memcmp", [] { sink = std::memcmp(text, other, Size); });
+  bench("memcmp bytes", [] { sink = memcmp_bytes(text, other, Size); });
+  bench("strspn", [] { sink = std::strspn(text, Accept); });
+  bench("strspn bytes", [] { sink = strspn_bytes(text, Accept); });
+
+  bench("interpreter", [] {
+    char line[] = "add 1,2";
+    interp.execute(std::begin(commands), std::end(commands), line);
+    });
+}
+
+void loop()
+{
+
+}
@@ -0,0 +1,51 @@
+// Part of the Pg test suite for <bit>.
+#include <pg.h>
+#include <bit>
+
+bool _bit_count()
+{
+  return std::countl_zero(uint8_t(0)) == 8 && std::countl_zero(uint8_t(1)) == 7 && 
+    std::countl_zero(uint16_t(0x0100)) == 7 && std::countl_zero(uint32_t(0x80000000)) == 0 && 
+    std::countl_zero(uint64_t(1)) == 63 && std::countl_one(uint8_t(0xf0)) == 4 && 
+    std::countr_zero(uint8_t(0)) == 8 && std::countr_zero(uint16_t(0x8000)) == 15 && 
+    std::countr_zero(uint64_t(0x100000000)) == 32 && std::countr_one(uint32_t(0x7)) == 3;
+}
+
+bool _bit_popcount()
+{
+  return std::popcount(uint8_t(0)) == 0 && std::popcount(uint8_t(0xff)) == 8 && 
+    std::popcount(uint16_t(0xa5a5)) == 8 && std::popcount(uint32_t(0xffffffff)) == 32 && 
+    std::popcount(uint64_t(0x8000000000000001)) == 2;
+}
+
+bool _bit_pow2()
+{
+  return std::has_single_bit(uint8_t(64)) && !std::has_single_bit(uint8_t(0)) && 
+    !std::has_single_bit(uint16_t(3)) && std::bit_width(uint8_t(0)) == 0 && 
+    std::bit_width(uint16_t(5)) == 3 && std::bit_width(uint32_t(0xffffffff)) == 32 && 
+    std::bit_ceil(uint8_t(0)) == 1 && std::bit_ceil(uint16_t(5)) == 8 && 
+    std::bit_ceil(uint32_t(64)) == 64 && std::bit_floor(uint8_t(0)) == 0 && 
+    std::bit_floor(uint16_t(5)) == 4 && std::bit_floor(uint64_t(0x8000000000000001)) == 0x8000000000000000;
+}
+
+bool _bit_rotate()
+{
+  return std::rotl(uint8_t(0x81), 1) == 0x03 && std::rotl(uint8_t(0x81), -1) == 0xc0 && 
+    std::rotr(uint16_t(0x0001), 1) == 0x8000 && std::rotl(uint32_t(0x12345678), 8) == 0x34567812 && 
+    std::rotl(uint32_t(0x12345678), 32) == 0x12345678;
+}
+
+void setup() 
+{
+  Serial.begin(9600);
+  bool b1 = _bit_count(), b2 = _bit_popcount(), b3 = _bit_pow2(), b4 = _bit_rotate();
+  Serial.print("count() = "); Serial.println(b1 ? "OK" : "FAIL");
+  Serial.print("popcount() = "); Serial.println(b2 ? "OK" : "FAIL");
+  Serial.print("pow2() = "); Serial.println(b3 ? "OK" : "FAIL");
+  Serial.print("rotate() = "); Serial.println(b4 ? "OK" : "FAIL");
+}
+
+void loop() 
+{
+
+}
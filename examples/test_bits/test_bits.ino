@@ -91,7 +91,8 @@ bool _bits_bitrev()
   uint32_t u32 = 42;
   uint64_t u64 = 42;
   result = result && pg::bitrev(u8) == 84 && pg::bitrev(u16) == 21504 &&
-    pg::bitrev(u32) == 1409286144 && pg::bitrev(u64) == 6052837899185946624;
+    pg::bitrev(u32) == 1409286144 && pg::bitrev(u64) == 6052837899185946624 && 
+    pg::bitrev(uint16_t(0x8003)) == 0xc001 && pg::bitrev(uint32_t(0x12345678)) == 0x1e6a2c48;
 
   return result;
 }
@@ -0,0 +1,62 @@
+// Part of the Pg test suite for <lib/fft.h>.
+#include <pg.h>
+#include <lib/fft.h>
+
+const std::size_t N = 64;
+
+// Returns a sine wave of `bin' cycles per N samples, plus a DC offset.
+float _fft_signal(std::size_t i, std::size_t bin)
+{
+  return 0.5f * std::sin(std::numbers::two_pi * bin * i / N) + 0.25f;
+}
+
+bool _fft_float()
+{
+  std::array<std::complex<float>, N> x;
+
+  for (std::size_t i = 0; i < N; ++i)
+    x[i] = std::complex<float>(_fft_signal(i, 5), 0);
+  pg::fft(x);
+
+  bool result = pg::fft_peak<N>(x.data()) == 5 && std::abs(x[0].real() - 0.25f * N) < 0.01f && 
+    std::abs(pg::bin_magnitude(x[5]) - 0.25f * N) < 0.01f && std::abs(pg::bin_magnitude(x[6])) < 0.01f;
+
+  pg::ifft(x);
+  for (std::size_t i = 0; i < N; ++i)
+    result = result && std::abs(x[i].real() - _fft_signal(i, 5)) < 0.001f && std::abs(x[i].imag()) < 0.001f;
+
+  return result;
+}
+
+bool _fft_q15()
+{
+  std::valarray<std::complex<int16_t>, N> x(N);
+
+  for (std::size_t i = 0; i < N; ++i)
+    x[i] = std::complex<int16_t>(_fft_signal(i, 7) * 32767, 0);
+  pg::fft(x);
+
+  const uint16_t m = pg::bin_magnitude(x[7]);	// 0.5 / 2 in Q15 = 8192.
+
+  return pg::fft_peak<N>(std::begin(x)) == 7 && m > 8150 && m < 8230 && 
+    pg::band_energy(std::begin(x), 6, 9) > pg::band_energy(std::begin(x), 1, 6);
+}
+
+bool _fft_frequency()
+{
+  return pg::bin_frequency<N>(8, 1000.0f) == 125.0f;
+}
+
+void setup() 
+{
+  Serial.begin(9600);
+  bool b1 = _fft_float(), b2 = _fft_q15(), b3 = _fft_frequency();
+  Serial.print("fft() float = "); Serial.println(b1 ? "OK" : "FAIL");
+  Serial.print("fft() q15 = "); Serial.println(b2 ? "OK" : "FAIL");
+  Serial.print("bin_frequency() = "); Serial.println(b3 ? "OK" : "FAIL");
+}
+
+void loop() 
+{
+
+}
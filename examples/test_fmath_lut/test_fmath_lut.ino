@@ -0,0 +1,77 @@
+#include <pg.h>
+#include <lib/fmath.h>
+
+// Compares the speed and accuracy of the fmath series and lookup table approximations.
+
+const unsigned Count = 1000;	// Number of calls timed per function.
+volatile float sink;			// Keeps the compiler from eliding the calls.
+
+template<class Fn>
+void bench(const char* name, Fn fn, float first, float last)
+{
+  const float step = (last - first) / Count;
+  float x = first;
+  unsigned long start = micros();
+
+  for (unsigned i = 0; i < Count; ++i, x += step)
+    sink = fn(x);
+
+  unsigned long elapsed = micros() - start;
+
+  Serial.print(name); Serial.print(": "); 
+  Serial.print(static_cast<float>(elapsed) / Count, 2); Serial.println(" us/call");
+}
+
+template<class Fn, class Ref>
+void accuracy(const char* name, Fn fn, Ref ref, float first, float last)
+{
+  const float step = (last - first) / Count;
+  float x = first, error = 0;
+
+  for (unsigned i = 0; i < Count; ++i, x += step)
+  {
+    float e = fabs(fn(x) - ref(x));
+    if (e > error)
+      error = e;
+  }
+  Serial.print(name); Serial.print(" max error: "); Serial.println(error, 7);
+}
+
+float series_sin(float x) { return pg::sin(x); }
+float lut_sin_low(float x) { return pg::lut_sin<pg::lut_accuracy::Low>(x); }
+float lut_sin_med(float x) { return pg::lut_sin<pg::lut_accuracy::Medium>(x); }
+float lut_sin_high(float x) { return pg::lut_sin<pg::lut_accuracy::High>(x); }
+float series_atan(float x) { return pg::atan(x); }
+float lut_atan_med(float x) { return pg::lut_atan(x); }
+float series_exp(float x) { return pg::exp(x); }
+float lut_exp_med(float x) { return pg::lut_exp(x); }
+float libm_sin(float x) { return ::sin(x); }
+float libm_atan(float x) { return ::atan(x); }
+float libm_exp(float x) { return ::exp(x); }
+
+void setup()
+{
+  Serial.begin(9600);
+  bench("libm sin", &libm_sin, -3.14f, 3.14f);
+  bench("series sin", &series_sin, -3.14f, 3.14f);
+  bench("lut sin low", &lut_sin_low, -3.14f, 3.14f);
+  bench("lut sin medium", &lut_sin_med, -3.14f, 3.14f);
+  bench("lut sin high", &lut_sin_high, -3.14f, 3.14f);
+  bench("libm atan", &libm_atan, -1.0f, 1.0f);
+  bench("series atan", &series_atan, -1.0f, 1.0f);
+  bench("lut atan medium", &lut_atan_med, -1.0f, 1.0f);
+  bench("libm exp", &libm_exp, -5.0f, 5.0f);
+  bench("series exp", &series_exp, -5.0f, 5.0f);
+  bench("lut exp medium", &lut_exp_med, -5.0f, 5.0f);
+  accuracy("series sin", &series_sin, &libm_sin, -3.14f, 3.14f);
+  accuracy("lut sin low", &lut_sin_low, &libm_sin, -3.14f, 3.14f);
+  accuracy("lut sin medium", &lut_sin_med, &libm_sin, -3.14f, 3.14f);
+  accuracy("lut sin high", &lut_sin_high, &libm_sin, -3.14f, 3.14f);
+  accuracy("series atan", &series_atan, &libm_atan, -1.0f, 1.0f);
+  accuracy("lut atan medium", &lut_atan_med, &libm_atan, -1.0f, 1.0f);
+}
+
+void loop()
+{
+
+}
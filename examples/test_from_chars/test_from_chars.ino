@@ -0,0 +1,58 @@
+// Part of the Pg test suite for the floating point std::from_chars() in <cstdlib>.
+#include <pg.h>
+#include <cfloat>
+#include <cstdlib>
+#include <cstring>
+
+// Returns true if str parses to within a few ulps of expected.
+template<class T>
+bool _from_chars_near(const char* str, T expected)
+{
+  T value = 0;
+  std::from_chars_result r = std::from_chars(str, str + std::strlen(str), value);
+  T error = value > expected ? value - expected : expected - value;
+
+  return r.ec == std::errc() && r.ptr == str + std::strlen(str) && 
+    error <= expected * 4 * std::numeric_limits<T>::epsilon();
+}
+
+// Returns true if str is out of range for T and value is left unchanged.
+template<class T>
+bool _from_chars_range(const char* str)
+{
+  T value = 1;
+
+  return std::from_chars(str, str + std::strlen(str), value).ec == std::errc::result_out_of_range && value == 1;
+}
+
+bool _from_chars_float()
+{
+  return _from_chars_near("0.1", 0.1f) && _from_chars_near("2.5e3", 2500.0f) && 
+    _from_chars_near("3.40282347e38", FLT_MAX) && _from_chars_near("1.17549435e-38", FLT_MIN) &&
+    _from_chars_near("0.0000000000000000000000000000000000000117549435", FLT_MIN) &&
+    _from_chars_range<float>("3.5e38") && _from_chars_range<float>("1e-50");
+}
+
+bool _from_chars_double()
+{
+  // Boards with a 32-bit double only run the float limits.
+  if (std::numeric_limits<double>::digits <= std::numeric_limits<float>::digits)
+    return _from_chars_near("3.40282347e38", (double)FLT_MAX) && _from_chars_range<double>("3.5e38");
+
+  return _from_chars_near("0.1", 0.1) && 
+    _from_chars_near("1.7976931348623157e308", DBL_MAX) && _from_chars_near("2.2250738585072014e-308", DBL_MIN) &&
+    _from_chars_range<double>("1.8e308") && _from_chars_range<double>("1e-330");
+}
+
+void setup() 
+{
+  Serial.begin(9600);
+  bool b1 = _from_chars_float(), b2 = _from_chars_double();
+  Serial.print("from_chars() float = "); Serial.println(b1 ? "OK" : "FAIL");
+  Serial.print("from_chars() double = "); Serial.println(b2 ? "OK" : "FAIL");
+}
+
+void loop() 
+{
+
+}
@@ -0,0 +1,75 @@
+#include <pg.h>
+#include <components/ServoGroup.h>
+#include <utilities/TaskScheduler.h>
+
+/* 
+ *  This sketch demonstrates synchronized motion of two servo motors using 
+ *	the ServoGroup and TaskScheduler classes. Each move is planned once by 
+ *	ServoGroup::move(), which stretches the move until the slowest servo can 
+ *	keep up and precomputes the pulse widths of every step, so both servos 
+ *	start and finish together. The group is clocked by one scheduled task, 
+ *	the servos themselves are not clocked. Define __PG_HW_TIMER before 
+ *	including the library, on boards where the Servo library doesn't use 
+ *	Timer1, to write the steps from the hardware timer interrupt instead.
+ */
+
+using namespace pg;
+using namespace pg::servos;
+using namespace std::chrono;
+
+// Servo type is Hiwonder LD20MG (change if using different motor). 
+using RotaryActuator = SweepServo<hiwonder_ld20mg>; 
+using Group = ServoGroup<hiwonder_ld20mg, 2>;
+using group_state = Group::State;
+using Scheduler = TaskScheduler<>;
+using ScheduledTask = Scheduler::Task;
+using task_state = ScheduledTask::State;
+
+// Group callback function.
+void groupCallback(group_state);
+
+const pin_t ShoulderOut = 3;	// The servo pwm output pins, change if yours differ.
+const pin_t ElbowOut = 5;
+const milliseconds clk_rate = milliseconds(20);	// Group clock rate, the servo refresh period.
+const seconds demo_time = seconds(10);			// Time alloted to run the demo.
+
+RotaryActuator shoulder, elbow;			// The servos being controlled.
+Group arm({ &shoulder, &elbow }, groupCallback);	// The servo group.
+ClockCommand clk_cmd(&arm);				// Command that executes the group's clock() method.
+ScheduledTask task{ clk_rate, &clk_cmd, task_state::Active };	// Task that schedules group clocking.
+Scheduler sched({ &task });				// The task scheduler.
+Timer<milliseconds> tmr(demo_time);		// Demo timer.
+bool out = false;						// Direction of the next move.
+
+void setup() 
+{
+	shoulder.attach(ShoulderOut);
+	elbow.attach(ElbowOut);
+	shoulder.initialize();
+	elbow.initialize();
+# if defined __PG_HAS_HW_TIMER
+	arm.trigger(Group::Trigger::Interrupt);
+# endif
+	delay(500);
+	sched.start();
+	tmr.start();
+	groupCallback(group_state::Idle);
+}
+
+void loop() 
+{
+	sched.tick();
+}
+
+void groupCallback(group_state state)
+{
+	if (tmr.expired())
+		task.state(task_state::Idle);	// Quit the demo if alloted time has expired.
+	// When each move completes, move both servos back the other way, the elbow twice as far as the shoulder.
+	else if (state == group_state::Idle)
+	{
+		out = !out;
+		arm.move(out ? Group::position_type{ 90.0f, 180.0f } : Group::position_type{ 0.0f, 0.0f },
+			milliseconds(1000), Group::Profile::SCurve);
+	}
+}
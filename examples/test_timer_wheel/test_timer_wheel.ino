@@ -0,0 +1,45 @@
+#include <pg.h>
+#include <utilities/TimerWheel.h>
+using namespace pg;
+using namespace std::chrono;
+
+// Small wheel, 4 slots x 4 levels, so a 100ms timer crosses several cascade boundaries.
+using Wheel = TimerWheel<milliseconds, std::chrono::system_clock, 2, 4>;
+
+Wheel wheel;
+Wheel::tick_type start_tick;
+Wheel::tick_type fired[8];	// Wheel ticks at which the repeating timer fired.
+uint8_t fired_count = 0;
+
+void record() { if (fired_count < 8) fired[fired_count++] = wheel.now(); }
+Command<void> command(&record);
+Wheel::Handle repeater(wheel, milliseconds(100), &command, true);	// Repeating 100ms timer.
+
+void setup()
+{
+  Serial.begin(9600);
+  start_tick = wheel.now();
+  repeater.start();
+}
+
+void loop()
+{
+  wheel.tick();
+  if (fired_count == 8)
+  {
+    bool pass = true;
+
+    // Each expiry must land exactly on a multiple of the interval, with no drift.
+    for (uint8_t i = 0; i < fired_count; ++i)
+    {
+      Wheel::tick_type offset = fired[i] - start_tick;
+
+      Serial.print("fired at +"); Serial.println(static_cast<unsigned long>(offset));
+      if (offset != 100UL * (i + 1))
+        pass = false;
+    }
+    Serial.println(pass ? "PASS" : "FAIL");
+    repeater.stop();
+    fired_count = 0xff;
+  }
+}
@@ -0,0 +1,124 @@
+/*
+ *	This file implements a minimal Arduino API for building sketches on a host.
+ *
+ *	***************************************************************************
+ *
+ *	File: Arduino.cpp
+ *	Date: October 14, 2026
+ *	Version: 1.0
+ *	Author: Michael Brodsky
+ *	Email: mbrodskiis@gmail.com
+ *	Copyright (c) 2012-2022 Michael Brodsky
+ *
+ *	***************************************************************************
+ *
+ *  This file is part of "Pretty Good" (Pg). "Pg" is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  This file is distributed in the hope that it will be useful, but
+ *	WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *	along with this file. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *	***************************************************************************
+ *
+ *	Description:
+ *
+ *		Implements the functions declared in <Arduino.h> and a main() that
+ *		calls the sketch's setup(), then loop() __PG_HOST_LOOPS times (default 1).
+ *
+ *	**************************************************************************/
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <time.h>
+
+#if !defined __PG_HOST_LOOPS
+# define __PG_HOST_LOOPS 1
+#endif
+
+HardwareSerial Serial;
+
+static unsigned long long now_us()
+{
+	timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+
+	return t.tv_sec * 1000000ULL + t.tv_nsec / 1000;
+}
+
+unsigned long millis() { return static_cast<unsigned long>(now_us() / 1000); }
+unsigned long micros() { return static_cast<unsigned long>(now_us()); }
+void delay(unsigned long ms) { unsigned long t = millis(); while (millis() - t < ms); }
+void delayMicroseconds(unsigned int us) { unsigned long t = micros(); while (micros() - t < us); }
+void pinMode(uint8_t, uint8_t) {}
+int digitalRead(uint8_t) { return LOW; }
+void digitalWrite(uint8_t, uint8_t) {}
+int analogRead(uint8_t) { return 0; }
+void analogWrite(uint8_t, int) {}
+
+extern "C"
+{
+	int isfinite(double x) { return __builtin_isfinite(x); }
+	int isinf(double x) { return __builtin_isinf(x); }
+	int isnan(double x) { return __builtin_isnan(x); }
+	int signbit(double x) { return __builtin_signbit(x); }
+}
+
+size_t Print::write(const char* s)
+{
+	size_t n = 0;
+
+	while (*s)
+		n += write(static_cast<uint8_t>(*s++));
+
+	return n;
+}
+
+template<class T>
+static size_t print_fmt(Print& p, const char* fmt, T value)
+{
+	char buf[32];
+
+	snprintf(buf, sizeof(buf), fmt, value);
+
+	return p.write(buf);
+}
+
+size_t Print::print(const char* s) { return write(s); }
+size_t Print::print(char c) { return write(static_cast<uint8_t>(c)); }
+size_t Print::print(int n, int) { return print_fmt(*this, "%d", n); }
+size_t Print::print(unsigned n, int) { return print_fmt(*this, "%u", n); }
+size_t Print::print(long n, int) { return print_fmt(*this, "%ld", n); }
+size_t Print::print(unsigned long n, int) { return print_fmt(*this, "%lu", n); }
+size_t Print::print(double n, int digits) { char buf[64]; snprintf(buf, sizeof(buf), "%.*f", digits, n); return write(buf); }
+size_t Print::println() { return write("\r\n"); }
+size_t Print::println(const char* s) { return print(s) + println(); }
+size_t Print::println(char c) { return print(c) + println(); }
+size_t Print::println(int n, int base) { return print(n, base) + println(); }
+size_t Print::println(unsigned n, int base) { return print(n, base) + println(); }
+size_t Print::println(long n, int base) { return print(n, base) + println(); }
+size_t Print::println(unsigned long n, int base) { return print(n, base) + println(); }
+size_t Print::println(double n, int digits) { return print(n, digits) + println(); }
+
+void HardwareSerial::flush() { fflush(stdout); }
+size_t HardwareSerial::write(uint8_t c) { putchar(c); return 1; }
+
+void setup();
+void loop();
+
+int main()
+{
+	setup();
+	for (unsigned long i = 0; i < __PG_HOST_LOOPS; ++i)
+		loop();
+	Serial.flush();
+
+	return 0;
+}
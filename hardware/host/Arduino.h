@@ -0,0 +1,148 @@
+/*
+ *	This file defines a minimal Arduino API for building sketches on a host.
+ *
+ *	***************************************************************************
+ *
+ *	File: Arduino.h
+ *	Date: October 14, 2026
+ *	Version: 1.0
+ *	Author: Michael Brodsky
+ *	Email: mbrodskiis@gmail.com
+ *	Copyright (c) 2012-2022 Michael Brodsky
+ *
+ *	***************************************************************************
+ *
+ *  This file is part of "Pretty Good" (Pg). "Pg" is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  This file is distributed in the hope that it will be useful, but
+ *	WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *	along with this file. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *	***************************************************************************
+ *
+ *	Description:
+ *
+ *		This file stands in for the <Arduino.h> file bundled with the Arduino
+ *		IDE, so that sketches which only use the time functions and Serial
+ *		output can be compiled and run natively on a Linux host (see the
+ *		Makefile in this folder). It describes a generic board with no
+ *		architecture macros, so the library selects its portable code paths.
+ *
+ *	Notes:
+ *
+ *		millis() and micros() read the host's monotonic clock. Serial prints
+ *		to stdout and never receives. The pin functions do nothing and read
+ *		LOW, and print() ignores its base argument. F_CPU is 1 GHz, so
+ *		<system/cycles.h> counts nanoseconds, with a resolution of one
+ *		microsecond.
+ *
+ *	**************************************************************************/
+
+#if !defined __PG_HOST_ARDUINO_H
+# define __PG_HOST_ARDUINO_H 20261014L
+
+# include <stdint.h>
+# include <stddef.h>
+# include <stdlib.h>
+# include <string.h>
+# include <math.h>
+
+# define ARDUINO 10813
+# define F_CPU 1000000000UL		// Host "cycles" are nanoseconds.
+
+# define NUM_DIGITAL_PINS 20
+# define NUM_ANALOG_INPUTS 6
+# define LED_BUILTIN 13
+# define FLASHEND 0x3ffff
+# define RAMSTART 0x0000
+# define RAMEND 0x7fff
+# define A0 14
+# define A1 15
+# define A2 16
+# define A3 17
+# define A4 18
+# define A5 19
+# define NOT_AN_INTERRUPT -1
+# define analogInputToDigitalPin(p) (((p) < NUM_ANALOG_INPUTS) ? (p) + A0 : -1)
+# define digitalPinToInterrupt(p) NOT_AN_INTERRUPT
+# define digitalPinHasPWM(p) false
+
+# define HIGH 1
+# define LOW 0
+# define INPUT 0
+# define OUTPUT 1
+# define INPUT_PULLUP 2
+# define CHANGE 1
+# define FALLING 2
+# define RISING 3
+# define PROGMEM
+# define noInterrupts()
+# define interrupts()
+
+// The library's <cmath> imports these from the global namespace as functions, as avr-libc declares them.
+# undef isfinite
+# undef isinf
+# undef isnan
+# undef signbit
+extern "C" { int isfinite(double); int isinf(double); int isnan(double); int signbit(double); }
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long);
+void delayMicroseconds(unsigned int);
+void pinMode(uint8_t, uint8_t);
+int digitalRead(uint8_t);
+void digitalWrite(uint8_t, uint8_t);
+int analogRead(uint8_t);
+void analogWrite(uint8_t, int);
+
+class Print
+{
+public:
+	virtual ~Print() {}
+	virtual size_t write(uint8_t) = 0;
+	size_t write(const char*);
+
+	size_t print(const char*);
+	size_t print(char);
+	size_t print(int, int = 10);
+	size_t print(unsigned, int = 10);
+	size_t print(long, int = 10);
+	size_t print(unsigned long, int = 10);
+	size_t print(double, int = 2);
+	size_t println();
+	size_t println(const char*);
+	size_t println(char);
+	size_t println(int, int = 10);
+	size_t println(unsigned, int = 10);
+	size_t println(long, int = 10);
+	size_t println(unsigned long, int = 10);
+	size_t println(double, int = 2);
+};
+
+class HardwareSerial : public Print
+{
+public:
+	void begin(unsigned long) {}
+	void end() {}
+	int available() { return 0; }
+	int read() { return -1; }
+	void flush();
+	size_t write(uint8_t) override;
+	using Print::write;
+	operator bool() { return true; }
+};
+
+extern HardwareSerial Serial;
+
+#endif // !defined __PG_HOST_ARDUINO_H
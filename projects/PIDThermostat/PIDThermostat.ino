@@ -154,6 +154,7 @@ Display display(&lcd, displayCallback, &run_screen);
 
 TemperatureSensor temp_sensor(SensorInput, sensorCallback);
 InputFilter temp_filter;
+temperature_table<temperature_t, SensorOutMax + 1> temp_table; // Sensor output to degrees K conversion table.
 Pid pid;
 Pwm pwm(PwmOutput);
 EEStream eeprom;
@@ -386,6 +387,7 @@ void sensorCallback()
 
 void initSensor()
 {
+    temp_table.generate(R, Vss, Vbe, Ka, Kb, Kc); // Precompute the sensor output conversions.
     delay(SensorInitDelay.count());     // Wait a sec for sensor/ADC to stabilize.
     temp_filter.seed(temp_sensor());    // Seed the input filter with the current sensor reading.
     Tsense = getTemperature(temp_filter.out(temp_sensor.value())); // Save the current temperature.
@@ -708,7 +710,7 @@ void formatPidScreen()
 
 temperature_t getTemperature(sensor_t value)
 {
-    temperature_t Tk = tsense(value, SensorOutMax, R, Vss, Vbe, Ka, Kb, Kc);
+    temperature_t Tk = temp_table(value);
 
 	return settings.temperatureUnits.value()(Tk); // Convert Kelvin to current temperature units.
 }
\ No newline at end of file
@@ -183,6 +183,7 @@ Display display(&lcd, displayCallback, &run_screen);
 #pragma region Thermometer Objects
 TemperatureSensor temp_sensor(SensorInput, sensorCallback);
 InputFilter temp_filter;
+temperature_table<Thermometer::value_type, SensorOutMax + 1> temp_table; // Sensor output to degrees K conversion table.
 Thermometer thermometer{
     ThermometerDisplay(DisplayRangeLow,DisplayRangeHigh,DegreesCelsius),
     ThermometerAlarm(AlarmOutput,AlarmDisabled,AlarmCmpGreater,AlarmSetPoint),
@@ -361,6 +362,7 @@ void sensorCallback()
 
 void initSensor()
 {
+    temp_table.generate(R, Vss, Vbe, Ka, Kb, Kc); // Precompute the sensor output conversions.
     delay(SensorInitDelay.count()); // Wait a sec for sensor/ADC to stabilize.
     temp_filter.seed(temp_sensor());
     Tsense = getTemperature(temp_filter.out(temp_sensor.value()));
@@ -607,7 +609,7 @@ void switchUnits(ThermometerAlarm& alarm, ThermometerDisplay& display, Thermomet
 
 Thermometer::value_type getTemperature(TemperatureSensor::value_type sense_out) 
 {
-    Thermometer::value_type Tk = tsense(sense_out, AnalogMax<board_type>(), R, Vss, Vbe, Ka, Kb, Kc);
+    Thermometer::value_type Tk = temp_table(sense_out);
 
 	return thermometer.display.unitConvert()(Tk); 
 }
@@ -55,6 +55,11 @@
  *	inputs asynchronously. 
  *
  *	The function call operator `operator()' returns the current input value.
+ *	If the ranges are ordered from low to high and do not overlap, the 
+ *	matching range is found with a binary search, otherwise the ranges are 
+ *	checked in collection order and the first match is returned. The order 
+ *	is checked once, when the ranges are set. 
+ *
  *	AnalogInput also specializes six non-member comparison functions which can 
  *	be used to compare two AnalogInput objects for equality. The functions 
  *	compare on the last value read from the attached input. If clients need to 
@@ -65,6 +70,10 @@
  *		bool b1 = in1 == in2;		// Compares the last known input values.
  *		bool b2 = in1() == in2();	// Reads and compares the current values.
  * 
+ *	If the client defines __PG_ADC_SCAN and the attached pin is added to the 
+ *	background ADC scan (see <system/adcscan.h>), inputs read the latest 
+ *	scanned sample instead of calling the blocking analogRead() function.
+ * 
  *	AnalogInput objects are not copyable or assignable as this would lead to 
  *	multiple instances attached to the same analog input, which is redundant.
  *
@@ -73,6 +82,7 @@
 #if !defined __PG_ANALOG_INPUT_H
 # define __PG_ANALOG_INPUT_H 20211005L
 
+# include <algorithm>					// std::upper_bound.
 # include <utility>						// std::pair type.
 # include <array>						// Fixed-size array types.
 # include <system/types.h>				// pin_t and analog_t types.
@@ -80,6 +90,7 @@
 # include <interfaces/iclockable.h>		// iclockable interface.
 # include <utilities/ValueWrappers.h>	// RangeValueWrapper type.
 # include <utilities/Unique.h>			// Unique base class.
+# include <system/adcscan.h>			// adc_scan service.
 
 # if defined __PG_HAS_NAMESPACES
 
@@ -156,7 +167,7 @@ namespace pg
 		bool matchAny() const;
 		// Sets the client callback.
 		void callback(callback_type);
-		// Reads and returns the current input value.
+		// Reads and returns the current input value, from the ADC scan if the pin is scanned.
 		value_type operator()();
 		// Returns the last read input value.
 		value_type value() const;
@@ -168,6 +179,8 @@ namespace pg
 	private:
 		// Sets the pin mode to an analog input.
 		void setPinMode(pin_t);
+		// Checks whether the ranges are ordered and disjoint, so they can be binary searched.
+		void index();
 		// Reads the current input value and returns the matched range, if any.
 		iterator read_input();
 		// Executes the current client callback, if any.
@@ -182,67 +195,74 @@ namespace pg
 		iterator		current_;	// The last range matched by the last input value, if any.
 		bool			match_any_;	// Flag indicating whether any matched range triggers a callback.
 		callback_type	callback_;	// The client callback.
+		bool			sorted_;	// Flag indicating whether the ranges are ordered and disjoint.
 	};
 
 #pragma region member_funcs
 
 	template<class T>
 	AnalogInput<T>::AnalogInput() :
-		pin_(InvalidPin), value_(), callback_(), ranges_(), current_(), match_any_(ranges_.size() == 0)
+		pin_(InvalidPin), value_(), callback_(), ranges_(), current_(), match_any_(ranges_.size() == 0), sorted_()
 	{
 
 	}
 
 	template<class T>
 	AnalogInput<T>::AnalogInput(pin_t pin) :
-		pin_(pin), value_(), callback_(), ranges_(), current_(), match_any_(ranges_.size() == 0)
+		pin_(pin), value_(), callback_(), ranges_(), current_(), match_any_(ranges_.size() == 0), sorted_()
 	{
 		setPinMode(pin);
+		index();
 	}
 
 	template<class T>
 	template<std::size_t N>
 	AnalogInput<T>::AnalogInput(pin_t pin, callback_type callback, Range* (&ranges)[N], bool match_any) :
 		pin_(pin), value_(), callback_(callback), ranges_(ranges), 
-		current_(std::end(ranges_)), match_any_(ranges_.size() == 0 || match_any)
+		current_(std::end(ranges_)), match_any_(ranges_.size() == 0 || match_any), sorted_()
 	{
 		setPinMode(pin);
+		index();
 	}
 
 	template<class T>
 	AnalogInput<T>::AnalogInput(pin_t pin, callback_type callback, Range* ranges[], std::size_t n, bool match_any) :
 		pin_(pin), value_(), callback_(callback), ranges_(ranges, n), 
-		current_(std::end(ranges_)), match_any_(ranges_.size() == 0 || match_any)
+		current_(std::end(ranges_)), match_any_(ranges_.size() == 0 || match_any), sorted_()
 	{
 		setPinMode(pin);
+		index();
 	}
 
 	template<class T>
 	AnalogInput<T>::AnalogInput(pin_t pin, callback_type callback, Range** first, Range** last, bool match_any) :
 		pin_(pin), value_(), callback_(callback), ranges_(first, last), 
-		current_(std::end(ranges_)), match_any_(ranges_.size() == 0 || match_any)
+		current_(std::end(ranges_)), match_any_(ranges_.size() == 0 || match_any), sorted_()
 	{
 		setPinMode(pin);
+		index();
 	}
 
 	template<class T>
 	AnalogInput<T>::AnalogInput(pin_t pin, callback_type callback, container_type& ranges, bool match_any) :
 		pin_(pin), value_(), callback_(callback), 
-		ranges_(ranges), current_(std::end(ranges_)), match_any_(ranges_.size() == 0 || match_any)
+		ranges_(ranges), current_(std::end(ranges_)), match_any_(ranges_.size() == 0 || match_any), sorted_()
 	{
 		setPinMode(pin);
+		index();
 	}
 
 	template<class T>
 	AnalogInput<T>::AnalogInput(pin_t pin, callback_type callback, std::initializer_list<Range*> il, bool match_any) :
 		pin_(pin), value_(), callback_(callback),
 		ranges_(const_cast<Range**>(il.begin()), il.size()), 
-		current_(std::end(ranges_)), match_any_(ranges_.size() == 0 || match_any)
+		current_(std::end(ranges_)), match_any_(ranges_.size() == 0 || match_any), sorted_()
 	{
 		std::size_t i = 0;
 
 		for (auto j : il)
 			*ranges_[i++] = *j;
+		index();
 	}
 
 	template<class T>
@@ -264,6 +284,7 @@ namespace pg
 		ranges_ = container_type(ranges);
 		current_ = std::end(ranges_);
 		matchAny(match_any_);
+		index();
 	}
 
 	template<class T>
@@ -272,6 +293,7 @@ namespace pg
 		ranges_ = container_type(ranges, n);
 		current_ = std::end(ranges_);
 		matchAny(match_any_);
+		index();
 	}
 
 	template<class T>
@@ -280,6 +302,7 @@ namespace pg
 		ranges_ = container_type(first, last);
 		current_ = std::end(ranges_);
 		matchAny(match_any_);
+		index();
 	}
 
 	template<class T>
@@ -292,6 +315,7 @@ namespace pg
 			*ranges_[i++] = *j;
 		current_ = std::end(ranges_);
 		matchAny(match_any_);
+		index();
 	}
 
 	template<class T>
@@ -300,6 +324,7 @@ namespace pg
 		ranges_ = ranges;
 		current_ = std::end(ranges_);
 		matchAny(match_any_);
+		index();
 	}
 
 	template<class T>
@@ -329,7 +354,11 @@ namespace pg
 	template<class T>
 	typename AnalogInput<T>::value_type AnalogInput<T>::operator()()
 	{
+# if defined __PG_HAS_ADC_SCAN
+		return (value_ = adc_scan::contains(pin_) ? adc_scan::read(pin_) : analogRead(pin_));
+# else
 		return (value_ = analogRead(pin_));
+# endif
 	}
 
 	template<class T>
@@ -341,14 +370,14 @@ namespace pg
 	template<class T>
 	typename AnalogInput<T>::Range* AnalogInput<T>::range() const
 	{
-		return *current_;
+		return current_ == std::end(ranges_) ? nullptr : *current_;
 	}
 
 	template<class T>
 	void AnalogInput<T>::poll()
 	{
 		iterator i = read_input();
-		Serial.print("poll");
+
 		if (match_any_ || i != current_) 
 		{
 			current_ = i;
@@ -363,18 +392,38 @@ namespace pg
 		pin_ = pin;
 	}
 
+	template<class T>
+	void AnalogInput<T>::index()
+	{
+		sorted_ = std::begin(ranges_) < std::end(ranges_);
+		for (std::size_t i = 1; sorted_ && i < ranges_.size(); ++i)
+			sorted_ = ranges_[i - 1]->high() < ranges_[i]->low();
+	}
+
 	template<class T>
 	typename AnalogInput<T>::iterator AnalogInput<T>::read_input()
 	{
 		iterator i = std::end(ranges_);
 
 		operator()();
-		for (auto j : ranges_)
+		if (sorted_)
+		{
+			// Find the last range that starts at or below the value, only it can contain the value.
+			iterator j = std::upper_bound(std::begin(ranges_), std::end(ranges_), value_, 
+				[](const value_type& value, const Range* range) { return value < range->low(); });
+
+			if (j != std::begin(ranges_) && (*--j)->in_range(value_))
+				i = j;
+		}
+		else
 		{
-			if (j->in_range(value_))
+			for (iterator j = std::begin(ranges_); j != std::end(ranges_); ++j)
 			{
-				i = &j;
-				break;
+				if ((*j)->in_range(value_))
+				{
+					i = j;
+					break;
+				}
 			}
 		}
 
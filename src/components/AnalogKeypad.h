@@ -63,6 +63,8 @@
  *      trigger_level_ appears in the collection before buttons with lower 
  *      levels it will prevent those buttons from ever being triggered. This is 
  *      why Button collections must be ordered from lowest to highest levels.
+ *      The order is checked once, when the Buttons are set, and ordered 
+ *      collections are binary searched, so a lookup takes O(log N) compares.
  * 
  *      Valid events are enumerated by the AnalogKeypad::Event type and can be 
  *      one of the    following:      Press,      Release     or     Longpress.
@@ -95,6 +97,7 @@
 #if !defined __PG_ANALOGKEYPAD_H 
 # define __PG_ANALOGKEYPAD_H 20211005L
 
+# include <algorithm>               // `std::upper_bound', `std::is_sorted'.
 # include <array>                   // `ArrayWrapper' type.
 # include <system/types.h>          // `pin_t', `analog_t' types.
 # include <interfaces/iclockable.h>	// `iclockable' interface.
@@ -254,6 +257,8 @@ namespace pg
         Button* value() const;
 
     private:
+        // Checks whether the buttons are ordered by trigger level, so they can be binary searched.
+        void index();
         // Reads the attached pin's input level and returns the currently pressed button, if any.
         iterator readInput();
         // Button press event handler.
@@ -274,12 +279,13 @@ namespace pg
         duration        lp_interval_;   // Longpress event interval.
         LongPress       lp_mode_;       // Longpress event triggering mode.
         bool            repeat_;	    // Flag indicating whether the Press event repeats.
+        bool            sorted_;        // Flag indicating whether the buttons are ordered by trigger level.
     };
 
     template<class T, class TimerType>
     AnalogKeypad<T, TimerType>::AnalogKeypad() :
         pin_(InvalidPin), callback_(), buttons_(), current_(), lp_timer_(),
-        lp_interval_(), lp_mode_(), repeat_()
+        lp_interval_(), lp_mode_(), repeat_(), sorted_()
     {
 
     }
@@ -287,7 +293,7 @@ namespace pg
     template<class T, class TimerType>
     AnalogKeypad<T, TimerType>::AnalogKeypad(pin_t pin, callback_type callback) : 
         pin_(pin), callback_(callback), buttons_(), current_(), lp_timer_(),
-        lp_interval_(), lp_mode_(), repeat_()
+        lp_interval_(), lp_mode_(), repeat_(), sorted_()
     {
 
     }
@@ -297,45 +303,45 @@ namespace pg
     AnalogKeypad<T, TimerType>::AnalogKeypad(pin_t pin, callback_type callback, Button* (&buttons)[Size],  
         LongPress lp_mode, duration lp_interval) :
         pin_(pin), callback_(callback), buttons_(buttons), current_(std::end(buttons_)),
-        lp_timer_(lp_interval), lp_interval_(lp_interval), lp_mode_(lp_mode), repeat_()
+        lp_timer_(lp_interval), lp_interval_(lp_interval), lp_mode_(lp_mode), repeat_(), sorted_()
     {
-
+        index();
     }
 
     template<class T, class TimerType>
     AnalogKeypad<T, TimerType>::AnalogKeypad(pin_t pin, callback_type callback, Button* buttons[], std::size_t size, 
         LongPress lp_mode, duration lp_interval) :
         pin_(pin), callback_(callback), buttons_(buttons, size), current_(std::end(buttons_)),
-        lp_timer_(lp_interval), lp_interval_(lp_interval), lp_mode_(lp_mode), repeat_()
+        lp_timer_(lp_interval), lp_interval_(lp_interval), lp_mode_(lp_mode), repeat_(), sorted_()
     {
-
+        index();
     }
 
     template<class T, class TimerType>
     AnalogKeypad<T, TimerType>::AnalogKeypad(pin_t pin, callback_type callback, Button** first, Button** last, 
         LongPress lp_mode, duration lp_interval) :
         pin_(pin), callback_(callback), buttons_(first, last), current_(std::end(buttons_)),
-        lp_timer_(lp_interval), lp_interval_(lp_interval), lp_mode_(lp_mode), repeat_()
+        lp_timer_(lp_interval), lp_interval_(lp_interval), lp_mode_(lp_mode), repeat_(), sorted_()
     {
-
+        index();
     }
 
     template<class T, class TimerType>
     AnalogKeypad<T, TimerType>::AnalogKeypad(pin_t pin, callback_type callback, std::initializer_list<Button*> il,  
         LongPress lp_mode, duration lp_interval) :
         pin_(pin), callback_(callback), buttons_(const_cast<Button**>(il.begin()), il.size()), current_(std::end(buttons_)),
-        lp_timer_(lp_interval), lp_interval_(lp_interval), lp_mode_(lp_mode), repeat_()
+        lp_timer_(lp_interval), lp_interval_(lp_interval), lp_mode_(lp_mode), repeat_(), sorted_()
     {
-
+        index();
     }
 
     template<class T, class TimerType>
     AnalogKeypad<T, TimerType>::AnalogKeypad(pin_t pin, callback_type callback, const container_type& buttons, 
         LongPress lp_mode, duration lp_interval) :
         pin_(pin), callback_(callback), buttons_(buttons), current_(std::end(buttons_)),
-        lp_timer_(lp_interval), lp_interval_(lp_interval), lp_mode_(lp_mode), repeat_()
+        lp_timer_(lp_interval), lp_interval_(lp_interval), lp_mode_(lp_mode), repeat_(), sorted_()
     {
-
+        index();
     }
 
     template<class T, class TimerType>
@@ -356,6 +362,7 @@ namespace pg
     {
         buttons_ = container_type(buttons);
         current_ = std::end(buttons_);
+        index();
     }
 
     template<class T, class TimerType>
@@ -363,6 +370,7 @@ namespace pg
     {
         buttons_ = container_type(buttons, n);
         current_ = std::end(buttons_);
+        index();
     }
 
     template<class T, class TimerType>
@@ -370,6 +378,7 @@ namespace pg
     {
         buttons_ = container_type(first, last);
         current_ = std::end(buttons_);
+        index();
     }
 
     template<class T, class TimerType>
@@ -377,6 +386,7 @@ namespace pg
     {
         buttons_ = container_type(const_cast<Button**>(il.begin()), il.size());
         current_ = std::end(buttons_);
+        index();
     }
 
     template<class T, class TimerType>
@@ -384,6 +394,7 @@ namespace pg
     {
         buttons_ = container;
         current_ = std::end(buttons_);
+        index();
     }
 
     template<class T, class TimerType>
@@ -445,16 +456,29 @@ namespace pg
         current_ = button;
     }
 
+    template<class T, class TimerType>
+    void AnalogKeypad<T, TimerType>::index()
+    {
+        sorted_ = std::begin(buttons_) < std::end(buttons_) && std::is_sorted(std::begin(buttons_), std::end(buttons_), 
+            [](const Button* lhs, const Button* rhs) { return lhs->trigger_level_ < rhs->trigger_level_; });
+    }
+
     template<class T, class TimerType>
     typename AnalogKeypad<T, TimerType>::iterator AnalogKeypad<T, TimerType>::readInput()
     {
         value_type input_level = analogRead(pin_);
         auto button = std::begin(buttons_);
 
-        for (; button < std::end(buttons_); button++)
+        if (sorted_)    // The first button whose trigger level is above the input.
+            button = std::upper_bound(std::begin(buttons_), std::end(buttons_), input_level, 
+                [](const value_type& level, const Button* b) { return level < b->trigger_level_; });
+        else
         {
-            if (input_level < (*button)->trigger_level_)
-                break;
+            for (; button < std::end(buttons_); button++)
+            {
+                if (input_level < (*button)->trigger_level_)
+                    break;
+            }
         }
 
         return button;
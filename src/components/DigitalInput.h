@@ -68,6 +68,29 @@
  *	level, also test if the level satisfies the trigger settings and, if so, 
  *	issues a client callback.
  * 
+ *	DigitalInput objects can also be attached to a `FastPin' (see 
+ *	<system/fastpin.h>), in which case inputs are read directly from the 
+ *	pin's port register instead of with digitalRead(): 
+ * 
+ *		DigitalInput button(FastPin<2>(), callback); 
+ * 
+ *	Inputs attached to pins with hardware interrupts can be switched to 
+ *	interrupt mode with the interrupt() method. In interrupt mode, an ISR 
+ *	timestamps every input change with micros() into a small lock-free 
+ *	queue, and the clock() and poll() methods debounce the queued edges and 
+ *	issue the callbacks. An edge is accepted once the input has been stable 
+ *	for the debounce interval passed to interrupt(), so pulses shorter than 
+ *	a loop iteration are not lost, and the input is not read at all while 
+ *	it is idle. Each edge toggles the queued level rather than reading the 
+ *	input, so pulses shorter than the ISR latency are still seen as two 
+ *	edges. timestamp() returns the time of the last accepted edge. Up 
+ *	to InterruptsMaxCount inputs can be in interrupt mode at once, and up to 
+ *	EdgesMaxCount edges are queued between calls to clock(), further edges 
+ *	are merged into the newest one, which is resynced with the input level: 
+ * 
+ *		DigitalInput button(2, callback); 
+ *		button.interrupt(true, 5000);	// 5 ms debounce. 
+ * 
  *	DigitalInput objects are not copyable or assignable as this would lead to 
  *	multiple instances attached to the same digital input, which is redundant. 
  *	
@@ -77,6 +100,7 @@
 # define __PG_DIGITAL_INPUT_H 20211003L
 
 #include <system/types.h>			// pin_t type.
+#include <system/fastpin.h>			// FastPin type.
 #include <interfaces/icomponent.h>	// icomponent interface.
 #include <interfaces/iclockable.h>	// iclockable interface.
 
@@ -104,6 +128,10 @@ namespace pg
 		};
 
 		using callback_type = typename callback<void>::type;
+		using read_type = bool(*)();	// FastPin input read method type.
+
+		static constexpr uint8_t InterruptsMaxCount = 4;	// Maximum number of inputs in interrupt mode.
+		static constexpr uint8_t EdgesMaxCount = 8;			// Size of each input's edge queue, a power of 2.
 
 	public:
 		// Constructs an uninitialized DigitalInput.
@@ -113,8 +141,14 @@ namespace pg
 		// Constructs a DigitalInput attached to the given pin and configured with the specified 
 		// mode, trigger, level and callback.
 		explicit DigitalInput(pin_t, callback_type, PinMode = PinMode::Input_Pullup, Trigger = Trigger::Edge, bool = false);
+		// Constructs a DigitalInput attached to the given fast pin and configured with the specified 
+		// mode, trigger, level and callback.
+		template<pin_t P>
+		explicit DigitalInput(FastPin<P>, callback_type, PinMode = PinMode::Input_Pullup, Trigger = Trigger::Edge, bool = false);
 		// Move constructor.
-		DigitalInput(DigitalInput&&) = default;
+		DigitalInput(DigitalInput&&);
+		// Destructor.
+		~DigitalInput();
 		// No copy constructor.
 		DigitalInput(const DigitalInput&) = delete;
 		// No copy assignment operator.
@@ -123,6 +157,9 @@ namespace pg
 	public:
 		// Attaches the a digital input pin and sets its pin mode.
 		void			attach(pin_t, PinMode = PinMode::Input_Pullup);
+		// Attaches the a fast digital input pin and sets its pin mode.
+		template<pin_t P>
+		void			attach(FastPin<P>, PinMode = PinMode::Input_Pullup);
 		// Returns the currently attached input pin or InvalidPin if not attached.
 		pin_t			attach() const;
 		// Sets the input trigger type.
@@ -139,6 +176,12 @@ namespace pg
 		bool			operator()();
 		// Returns the last known input level.
 		bool			value() const;
+		// Switches interrupt mode on or off with a debounce interval in microseconds, returns true if on.
+		bool			interrupt(bool, uint32_t = 0);
+		// Checks whether the input is in interrupt mode.
+		bool			interrupt() const;
+		// Returns the time in microseconds of the last accepted edge in interrupt mode.
+		uint32_t		timestamp() const;
 		// Polls the input and executes a callback if the input has been triggered.
 		void			poll();
 		// Checks whether the attached input has been triggered.
@@ -147,43 +190,118 @@ namespace pg
 	private:
 		// Polls the input and executes a callback if the input has been triggered.
 		void			clock() override;
+		// Reads the attached input level.
+		bool			read() const;
+		// Debounces the queued edges and executes any callbacks.
+		void			drain();
+		// Accepts the pending edge and executes a callback if it triggers the input.
+		void			accept();
+		// Detaches the input from its interrupt.
+		void			release();
+		// Queues an input edge from an interrupt slot.
+		static void		capture(uint8_t);
+		// Interrupt slot service routines.
+		template<uint8_t I>
+		static void		isr();
+
+	private:
+		static constexpr uint8_t NoSlot = 0xff;	// Interrupt slot of inputs in polled mode.
+		using isr_type = void(*)();				// Interrupt service routine type.
 
 	private:
 		pin_t			pin_;		// The attached digital input pin.
+		read_type		read_;		// The attached fast pin's read method, if any.
 		PinMode			mode_;		// The current input pin mode.
 		bool			value_;		// The last value read from the attached input.
 		Trigger			trigger_;	// The current trigger type.
 		bool			level_;		// The current trigger level.
 		callback_type	callback_;	// Client callback function, if any.
+		uint8_t			slot_;		// The interrupt slot, or NoSlot in polled mode.
+		uint32_t		debounce_;	// Interrupt mode debounce interval in microseconds.
+		uint32_t		time_;		// Time of the last accepted edge.
+		uint32_t		raw_time_;	// Time of the last queued edge.
+		bool			raw_level_;	// Input level after the last queued edge.
+		bool			pending_;	// Flag indicating whether the last queued edge is awaiting acceptance.
 	};
 
+	namespace details
+	{
+		// Edge queue of an input in interrupt mode, written by the isr and read by clock().
+		struct digital_input_slot
+		{
+			DigitalInput*		input_;								// The input, or nullptr if the slot is free.
+			volatile uint32_t	time_[DigitalInput::EdgesMaxCount];	// Queued edge times.
+			volatile bool		level_[DigitalInput::EdgesMaxCount];	// Queued edge levels.
+			volatile uint8_t	head_;								// Number of queued edges.
+			volatile uint8_t	tail_;								// Number of dequeued edges.
+			volatile bool		last_;								// Input level after the newest queued edge.
+		};
+
+		static digital_input_slot __digital_input_slots[DigitalInput::InterruptsMaxCount];
+	} // namespace details
+
 #pragma region member_funcs
 
 	DigitalInput::DigitalInput() : 
-		pin_(InvalidPin), mode_(), value_(), trigger_(), level_(), callback_() 
+		pin_(InvalidPin), read_(), mode_(), value_(), trigger_(), level_(), callback_(), slot_(NoSlot), 
+		debounce_(), time_(), raw_time_(), raw_level_(), pending_()
 	{
 
 	}
 
 	DigitalInput::DigitalInput(pin_t pin) :
-		pin_(pin), mode_(), value_(), trigger_(), level_(), callback_()
+		pin_(pin), read_(), mode_(), value_(), trigger_(), level_(), callback_(), slot_(NoSlot), 
+		debounce_(), time_(), raw_time_(), raw_level_(), pending_()
 	{
 
 	}
 
 	DigitalInput::DigitalInput(pin_t pin, callback_type callback, PinMode mode, Trigger trigger, bool level) :
-		pin_(), mode_(), value_(), trigger_(trigger), level_(level), callback_(callback)
+		pin_(), read_(), mode_(), value_(), trigger_(trigger), level_(level), callback_(callback), slot_(NoSlot), 
+		debounce_(), time_(), raw_time_(), raw_level_(), pending_()
 	{
 		attach(pin, mode);
 	}
 
+	template<pin_t P>
+	DigitalInput::DigitalInput(FastPin<P> pin, callback_type callback, PinMode mode, Trigger trigger, bool level) :
+		pin_(), read_(), mode_(), value_(), trigger_(trigger), level_(level), callback_(callback), slot_(NoSlot), 
+		debounce_(), time_(), raw_time_(), raw_level_(), pending_()
+	{
+		attach(pin, mode);
+	}
+
+	DigitalInput::DigitalInput(DigitalInput&& other) :
+		pin_(other.pin_), read_(other.read_), mode_(other.mode_), value_(other.value_), trigger_(other.trigger_), 
+		level_(other.level_), callback_(other.callback_), slot_(other.slot_), debounce_(other.debounce_), 
+		time_(other.time_), raw_time_(other.raw_time_), raw_level_(other.raw_level_), pending_(other.pending_)
+	{
+		if (slot_ != NoSlot)
+			details::__digital_input_slots[slot_].input_ = this;	// Redirect the isr to the new object.
+		other.slot_ = NoSlot;
+	}
+
+	DigitalInput::~DigitalInput()
+	{
+		release();
+	}
+
 	void DigitalInput::attach(pin_t pin, PinMode mode)
 	{
+		release();
 		mode_ = mode;
+		read_ = nullptr;
 		if ((pin_ = pin) != InvalidPin)
 			pinMode(pin, static_cast<uint8_t>(mode));
 	}
 
+	template<pin_t P>
+	void DigitalInput::attach(FastPin<P>, PinMode mode)
+	{
+		attach(P, mode);
+		read_ = &FastPin<P>::read;
+	}
+
 	pin_t DigitalInput::attach() const
 	{
 		return pin_;
@@ -216,7 +334,7 @@ namespace pg
 
 	bool DigitalInput::operator()()
 	{
-		return (value_ = digitalRead(pin_));
+		return slot_ == NoSlot ? (value_ = read()) : read();	// The isr owns value_ in interrupt mode.
 	}
 
 	bool DigitalInput::value() const
@@ -224,9 +342,50 @@ namespace pg
 		return value_;
 	}
 
+	bool DigitalInput::interrupt(bool enable, uint32_t debounce)
+	{
+		static const isr_type isrs[InterruptsMaxCount] = { &isr<0>, &isr<1>, &isr<2>, &isr<3> };
+
+		release();
+		debounce_ = debounce;
+		if (enable && pin_ != InvalidPin && digitalPinToInterrupt(pin_) != NOT_AN_INTERRUPT)
+		{
+			for (uint8_t i = 0; i < InterruptsMaxCount; ++i)
+			{
+				details::digital_input_slot& slot = details::__digital_input_slots[i];
+
+				if (!slot.input_)
+				{
+					slot.head_ = slot.tail_ = 0;
+					slot.input_ = this;
+					slot_ = i;
+					slot.last_ = raw_level_ = value_ = read();
+					raw_time_ = time_ = micros();
+					pending_ = false;
+					attachInterrupt(digitalPinToInterrupt(pin_), isrs[i], static_cast<PinStatus>(CHANGE));
+					break;
+				}
+			}
+		}
+
+		return slot_ != NoSlot;
+	}
+
+	bool DigitalInput::interrupt() const
+	{
+		return slot_ != NoSlot;
+	}
+
+	uint32_t DigitalInput::timestamp() const
+	{
+		return time_;
+	}
+
 	void DigitalInput::poll()
 	{
-		if (triggered() && callback_)
+		if (slot_ != NoSlot)
+			drain();
+		else if (triggered() && callback_)
 			(*callback_)();
 	}
 
@@ -256,6 +415,90 @@ namespace pg
 		poll();
 	}
 
+	bool DigitalInput::read() const
+	{
+		return read_ ? (*read_)() : digitalRead(pin_);
+	}
+
+	void DigitalInput::drain()
+	{
+		details::digital_input_slot& slot = details::__digital_input_slots[slot_];
+		uint8_t tail = slot.tail_;
+
+		while (tail != slot.head_)
+		{
+			const uint8_t i = tail & (EdgesMaxCount - 1);
+			const uint32_t time = slot.time_[i];
+			const bool level = slot.level_[i];
+
+			slot.tail_ = ++tail;	// Free the queue entry for the isr.
+			if (pending_ && time - raw_time_ >= debounce_)
+				accept();	// The previous edge was stable for the debounce interval.
+			raw_time_ = time;
+			raw_level_ = level;
+			pending_ = true;
+		}
+		if (pending_ && static_cast<uint32_t>(micros()) - raw_time_ >= debounce_)
+			accept();
+		if (trigger_ == Trigger::Level && value_ == level_ && callback_)
+			(*callback_)();
+	}
+
+	void DigitalInput::accept()
+	{
+		pending_ = false;
+		if (raw_level_ != value_)
+		{
+			value_ = raw_level_;
+			time_ = raw_time_;
+			if (trigger_ == Trigger::Edge && value_ == level_ && callback_)
+				(*callback_)();
+		}
+	}
+
+	void DigitalInput::release()
+	{
+		if (slot_ != NoSlot)
+		{
+			detachInterrupt(digitalPinToInterrupt(pin_));
+			details::__digital_input_slots[slot_].input_ = nullptr;
+			slot_ = NoSlot;
+		}
+	}
+
+	void DigitalInput::capture(uint8_t n)
+	{
+		details::digital_input_slot& slot = details::__digital_input_slots[n];
+		const uint8_t head = slot.head_;
+
+		if (slot.input_)
+		{
+			if (static_cast<uint8_t>(head - slot.tail_) < EdgesMaxCount)
+			{
+				const uint8_t i = head & (EdgesMaxCount - 1);
+				const bool level = !slot.last_;	// Every CHANGE edge toggles the level, even if the pulse has already ended.
+
+				slot.time_[i] = micros();
+				slot.level_[i] = slot.last_ = level;
+				slot.head_ = head + 1;	// Publish the edge after its entry is written.
+			}
+			else
+			{
+				const uint8_t i = (head - 1) & (EdgesMaxCount - 1);	// Queue full, merge into the newest edge.
+				const bool level = slot.input_->read();				// Resync with the input level.
+
+				slot.time_[i] = micros();
+				slot.level_[i] = slot.last_ = level;
+			}
+		}
+	}
+
+	template<uint8_t I>
+	void DigitalInput::isr()
+	{
+		capture(I);
+	}
+
 #pragma endregion
 #pragma region non-member_funcs
 
@@ -51,6 +51,38 @@
  *		EventSequencer can update clients via callbacks at the beginning and 
  *		end of an event.
  * 
+ *		By default, events are timed by polling the event timer from `tick()', 
+ *		so event timing jitter is the time between calls to `tick()'. If the 
+ *		client defines __PG_HW_TIMER and the board has a hardware timer (see 
+ *		<system/hwtimer.h>), `trigger()' can program each event's duration 
+ *		into the hardware timer instead. With Trigger::Interrupt, events 
+ *		advance from the timer interrupt, so event commands and callbacks run 
+ *		in interrupt context and must be short and interrupt-safe. With 
+ *		Trigger::Flag, the interrupt only sets a flag and the event advances 
+ *		on the next call to `tick()'. Only one sequencer at a time can use the 
+ *		hardware timer.
+ * 
+ *		Long sequences can be stored in program memory (flash) as constant 
+ *		arrays of Event objects, instead of arrays of pointers to Events in 
+ *		RAM. The sequencer then keeps only the current event's index and a 
+ *		copy of the current event in RAM, and reads each event from program 
+ *		memory as the sequence advances (see <lib/progmem.h>):
+ *
+ *			const char FillName[] __PG_PROGMEM = "Fill";
+ *			const char DrainName[] __PG_PROGMEM = "Drain";
+ *			const Sequencer::Event Events[] __PG_PROGMEM = {
+ *				{ FillName, seconds(30), &fill_cmd },
+ *				{ DrainName, seconds(10), &drain_cmd },
+ *				...
+ *			};
+ *			Sequencer seq(Events, &sequencer_cb);
+ *
+ *		Event names in program memory tables should be stored in program 
+ *		memory too, and printed as `const __FlashStringHelper*'. The `event()' 
+ *		method and callbacks return the RAM copy of the current event. 
+ *		Starting, stopping, resuming and stepping through the sequence 
+ *		behave the same for both kinds of events.
+ * 
  *	**************************************************************************/
 
 #if !defined __PG_EVENTSEQUENCER_H
@@ -60,6 +92,8 @@
 # include <interfaces/icomponent.h>	// `icomponent' interface.
 # include <interfaces/iclockable.h>	// `iclockable" and `icommand' interfaces.
 # include <utilities/Timer.h>		// `Timer' class.
+# include <lib/progmem.h>			// `pgm_read()'
+# include <system/hwtimer.h>		// `hw_timer' type.
 
 using namespace std::chrono;
 
@@ -96,6 +130,14 @@ namespace pg
 			Done		// Current sequence is completed.
 		};
 
+		// Enumerates the valid event timing sources.
+		enum class Trigger
+		{
+			Polled = 0,	// Events are timed by polling from tick().
+			Interrupt,	// Events advance from the hardware timer interrupt.
+			Flag		// The hardware timer interrupt flags the event to advance on the next tick().
+		};
+
 		using sequencer_type = EventSequencer<T>;
 		using event_type = typename sequencer_type::Event;
 		using state_type = typename sequencer_type::Event::State;
@@ -103,6 +145,7 @@ namespace pg
 		using container_type = std::ArrayWrapper<Event*>;
 		using iterator = typename container_type::iterator;
 		using const_iterator = typename container_type::const_iterator;
+		using size_type = std::size_t;
 
 	public:
 		//Constructs an uninitialized sequencer.
@@ -118,6 +161,11 @@ namespace pg
 		EventSequencer(std::initializer_list<Event*>, callback_type, bool = false);
 		// Constructs the sequencer from a container of events.
 		EventSequencer(const container_type&, callback_type, bool = false);
+		// Constructs the sequencer from an array of events in program memory.
+		template <std::size_t N>
+		explicit EventSequencer(const Event (&)[N], callback_type, bool = false);
+		// Constructs the sequencer from a pointer to and size of events in program memory.
+		EventSequencer(const Event*, std::size_t, callback_type, bool = false);
 
 	public:
 		// Sets the events collection from an array.
@@ -131,8 +179,15 @@ namespace pg
 		void			events(std::initializer_list<Event*>);
 		// Sets the events collection from a container.
 		void			events(container_type&); 
-		// Returns the current events collection.
+		// Sets the events collection from an array in program memory.
+		template <std::size_t N>
+		void			events(const Event (&)[N]);
+		// Sets the events collection from a pointer and size in program memory.
+		void			events(const Event*, std::size_t);
+		// Returns the current events collection, empty if the events are in program memory.
 		const container_type& events() const;
+		// Returns the number of events in the sequence.
+		size_type		size() const;
 		// Sets the client callback.
 		void			callback(callback_type);
 		// Starts the current sequence.
@@ -160,7 +215,13 @@ namespace pg
 		// Returns the current event's time elapsed in milliseconds.
 		duration		elapsed() const;
 		// Returns the index of the current event within the sequence.
-		uint8_t			index() const;
+		size_type		index() const;
+		// Returns the time remaining in the current event, or duration::max() if not active.
+		duration		remaining() const;
+		// Sets the event timing source.
+		void			trigger(Trigger);
+		// Returns the current event timing source.
+		Trigger			trigger() const;
 		// Steps through and executes the current sequence chronologically.
 		void			tick();
 
@@ -173,96 +234,148 @@ namespace pg
 		void			end();
 		// Rewinds the sequence to the first event.
 		void			rewind();
+		// Reads the current event from program memory, if the events are in program memory.
+		void			load();
 		// Calls the `tick()' method.
 		void			clock() override;
 		// Executes the current callback.
-		void			callback(const_iterator, state_type);
+		void			callback(const Event*, state_type);
+		// Ends the current event and begins the next one.
+		void			transition();
+		// Programs the hardware timer with the current event's remaining time.
+		void			arm();
+		// Hardware timer expiry callback.
+		static void		expire(void*);
 
 	private:
 		container_type	events_;		// The current events collection.
-		const_iterator	current_;		// Points to the current event in the collection.
+		const Event*	table_;			// The current events in program memory, if any.
+		size_type		table_size_;	// The number of events in program memory.
+		size_type		current_;		// The index of the current event in the collection.
+		Event			cache_;			// RAM copy of the current event in program memory.
 		callback_type	callback_;		// Client callback.
 		bool			wrap_;			// Flag indicating whether the sequence wraps-around continuously.
 		bool			done_;			// Flag indicating whether the current sequence is completed.
 		bool			exec_;			// Flag indicating whether to execute the current event on resume.
 		timer_type		event_timer_;	// Sequence event timer.
+		Trigger			trigger_;		// Event timing source.
+		volatile bool	pending_;		// Flag indicating the hardware timer expired.
 	};
 
 	template<class T>
 	template <std::size_t N>
 	EventSequencer<T>::EventSequencer(Event* (&events)[N], callback_type callback, bool wrap) :
-		events_(events), current_(events_.begin()), callback_(callback),
-		wrap_(wrap), done_(), exec_(), event_timer_()
+		events_(events), table_(), table_size_(), current_(), cache_(), callback_(callback),
+		wrap_(wrap), done_(), exec_(), event_timer_(), trigger_(), pending_()
 	{
 
 	}
 
 	template<class T>
 	EventSequencer<T>::EventSequencer(Event* events[], std::size_t size, callback_type callback, bool wrap) :
-		events_(events, size), current_(events_.begin()), callback_(callback),
-		wrap_(wrap), done_(), exec_(), event_timer_()
+		events_(events, size), table_(), table_size_(), current_(), cache_(), callback_(callback),
+		wrap_(wrap), done_(), exec_(), event_timer_(), trigger_(), pending_()
 	{
 
 	}
 
 	template<class T>
 	EventSequencer<T>::EventSequencer(Event** first, Event** last, callback_type callback, bool wrap) :
-		events_(first, last), current_(events_.begin()), callback_(callback),
-		wrap_(wrap), done_(), exec_(), event_timer_()
+		events_(first, last), table_(), table_size_(), current_(), cache_(), callback_(callback),
+		wrap_(wrap), done_(), exec_(), event_timer_(), trigger_(), pending_()
 	{
 
 	}
 
 	template<class T>
 	EventSequencer<T>::EventSequencer(std::initializer_list<Event*> il, callback_type callback, bool wrap) :
-		events_(const_cast<Event**>(il.begin()), il.size()), current_(events_.begin()), callback_(callback),
-		wrap_(wrap), done_(), exec_(), event_timer_()
+		events_(const_cast<Event**>(il.begin()), il.size()), table_(), table_size_(), current_(), cache_(), callback_(callback),
+		wrap_(wrap), done_(), exec_(), event_timer_(), trigger_(), pending_()
 	{
 
 	}
 
 	template<class T>
 	EventSequencer<T>::EventSequencer(const container_type& events, callback_type callback, bool wrap) :
-		events_(events), current_(events_.begin()), callback_(callback),
-		wrap_(wrap), done_(), exec_(), event_timer_()
+		events_(events), table_(), table_size_(), current_(), cache_(), callback_(callback),
+		wrap_(wrap), done_(), exec_(), event_timer_(), trigger_(), pending_()
 	{
 
 	}
 
+	template<class T>
+	template <std::size_t N>
+	EventSequencer<T>::EventSequencer(const Event (&events)[N], callback_type callback, bool wrap) :
+		events_(), table_(events), table_size_(N), current_(), cache_(), callback_(callback),
+		wrap_(wrap), done_(), exec_(), event_timer_(), trigger_(), pending_()
+	{
+		load();
+	}
+
+	template<class T>
+	EventSequencer<T>::EventSequencer(const Event* events, std::size_t size, callback_type callback, bool wrap) :
+		events_(), table_(events), table_size_(size), current_(), cache_(), callback_(callback),
+		wrap_(wrap), done_(), exec_(), event_timer_(), trigger_(), pending_()
+	{
+		load();
+	}
+
 	template<class T>
 	template <std::size_t N>
 	void EventSequencer<T>::events(Event* (&events)[N])
 	{
 		events_ = events;
-		current_ = std::begin(events_);
+		table_ = nullptr;
+		current_ = 0;
 	}
 
 	template<class T>
 	void EventSequencer<T>::events(Event* events[], std::size_t n)
 	{
 		events_ = container_type(events, n);
-		current_ = std::begin(events_);
+		table_ = nullptr;
+		current_ = 0;
 	}
 
 	template<class T>
 	void EventSequencer<T>::events(Event** first, Event** last)
 	{
 		events_ = container_type(first, last);
-		current_ = std::begin(events_);
+		table_ = nullptr;
+		current_ = 0;
 	}
 
 	template<class T>
 	void EventSequencer<T>::events(std::initializer_list<Event*> il)
 	{
 		events_ = (const_cast<Event**>(il.begin()), il.size());
-		current_ = std::begin(events_);
+		table_ = nullptr;
+		current_ = 0;
 	}
 
 	template<class T>
 	void EventSequencer<T>::events(container_type& events)
 	{
 		events_ = events;
-		current_ = std::begin(events_);
+		table_ = nullptr;
+		current_ = 0;
+	}
+
+	template<class T>
+	template <std::size_t N>
+	void EventSequencer<T>::events(const Event (&events)[N])
+	{
+		this->events(events, N);
+	}
+
+	template<class T>
+	void EventSequencer<T>::events(const Event* events, std::size_t n)
+	{
+		events_ = container_type();
+		table_ = events;
+		table_size_ = n;
+		current_ = 0;
+		load();
 	}
 
 	template<class T>
@@ -271,6 +384,12 @@ namespace pg
 		return events_;
 	}
 
+	template<class T>
+	typename EventSequencer<T>::size_type EventSequencer<T>::size() const
+	{
+		return table_ ? table_size_ : events_.size();
+	}
+
 	template<class T>
 	void EventSequencer<T>::callback(callback_type cb)
 	{
@@ -285,6 +404,7 @@ namespace pg
 			rewind();
 			begin();
 			event_timer_.start();
+			arm();
 		}
 	}
 
@@ -292,6 +412,11 @@ namespace pg
 	void EventSequencer<T>::stop()
 	{
 		event_timer_.stop();
+# if defined __PG_HAS_HW_TIMER
+		if (trigger_ != Trigger::Polled)
+			hw_timer::cancel();
+		pending_ = false;
+# endif
 	}
 
 	template<class T>
@@ -302,6 +427,7 @@ namespace pg
 		{
 			event_timer_.reset();
 			begin();
+			arm();
 		}
 		else
 			event_timer_.interval(duration(0)); // "Flag" to indicate sequencer is reset.
@@ -323,6 +449,7 @@ namespace pg
 					exec_ = false;
 				}
 				event_timer_.resume();
+				arm();
 			}
 		}
 	}
@@ -330,22 +457,28 @@ namespace pg
 	template<class T>
 	void EventSequencer<T>::next()
 	{
-		if (++current_ == std::end(events_))
-			current_ = std::begin(events_);
+		if (++current_ == size())
+			current_ = 0;
+		load();
 		exec_ = true;
-		event_timer_.interval((*current_)->duration_);
+		event_timer_.interval(event()->duration_);
 		event_timer_.reset();
+		if (status() == Status::Active)
+			arm();
 	}
 
 	template<class T>
 	void EventSequencer<T>::prev()
 	{
-		if (current_ == std::begin(events_))
-			current_ = std::end(events_);
+		if (current_ == 0)
+			current_ = size();
 		--current_;
+		load();
 		exec_ = true;
-		event_timer_.interval((*current_)->duration_);
+		event_timer_.interval(event()->duration_);
 		event_timer_.reset();
+		if (status() == Status::Active)
+			arm();
 	}
 
 	template<class T>
@@ -373,13 +506,17 @@ namespace pg
 	template<class T>
 	const typename EventSequencer<T>::Event* EventSequencer<T>::event() const
 	{
-		return *current_;
+		return table_ ? &cache_ : events_[current_];
 	}
 
 	template<class T>
 	void EventSequencer<T>::event(Event* event)
 	{
-		current_ = std::find(events_.begin(), events_.end(), event);
+		if (table_)
+			current_ = event >= table_ && event < table_ + table_size_ ? event - table_ : table_size_;
+		else
+			current_ = std::distance(events_.begin(), std::find(events_.begin(), events_.end(), event));
+		load();
 	}
 
 	template<class T>
@@ -389,41 +526,84 @@ namespace pg
 	}
 
 	template<class T>
-	uint8_t	EventSequencer<T>::index() const
+	typename EventSequencer<T>::size_type EventSequencer<T>::index() const
 	{
-		return static_cast<uint8_t>(std::distance(std::begin(events_), current_) + 1);
+		return current_ + 1;
 	}
 
 	template<class T>
-	void EventSequencer<T>::tick()
+	typename EventSequencer<T>::duration EventSequencer<T>::remaining() const
+	{
+		duration remaining = duration::max();
+
+		if (status() == Status::Active)
+		{
+			duration elapsed = event_timer_.elapsed();
+
+			remaining = elapsed < event_timer_.interval() ? event_timer_.interval() - elapsed : duration();
+		}
+
+		return remaining;
+	}
+
+	template<class T>
+	void EventSequencer<T>::trigger(Trigger source)
 	{
-		if (event_timer_.expired())
+# if defined __PG_HAS_HW_TIMER
+		if (trigger_ != Trigger::Polled)
+			hw_timer::begin(nullptr, nullptr);
+		trigger_ = source;
+		pending_ = false;
+		if (trigger_ != Trigger::Polled)
 		{
-			end();
-			advance();
+			hw_timer::begin(&EventSequencer<T>::expire, this);
 			if (status() == Status::Active)
-				begin();
+				arm();
+		}
+# else
+		(void)source;	// Only polling is available.
+# endif
+	}
+
+	template<class T>
+	typename EventSequencer<T>::Trigger EventSequencer<T>::trigger() const
+	{
+		return trigger_;
+	}
+
+	template<class T>
+	void EventSequencer<T>::tick()
+	{
+		if (trigger_ == Trigger::Polled)
+		{
+			if (event_timer_.expired())
+				transition();
+		}
+		else if (pending_)
+		{
+			pending_ = false;
+			transition();
 		}
 	}
 
 	template<class T>
 	void EventSequencer<T>::begin()
 	{
-		Event* it = *current_;
+		const Event* it = event();
 
 		event_timer_.interval(it->duration_);
 		if (it->command_)
 			it->command_->execute();
-		callback(current_, EventSequencer<T>::Event::State::Begin);
+		callback(it, EventSequencer<T>::Event::State::Begin);
 	}
 
 	template<class T>
 	void EventSequencer<T>::advance()
 	{
-		if (++current_ == std::end(events_))
+		if (++current_ == size())
 		{
 			if (wrap_)
-				current_ = std::begin(events_);
+				current_ = 0;
 			else
 			{
 				stop();
@@ -431,21 +611,30 @@ namespace pg
 				done_ = true;
 			}
 		}
+		load();
 	}
 
 	template<class T>
 	void EventSequencer<T>::end()
 	{
-		callback(current_, Event::State::End);
+		callback(event(), Event::State::End);
 	}
 
 	template<class T>
 	void EventSequencer<T>::rewind()
 	{
-		current_ = std::begin(events_);
+		current_ = 0;
+		load();
 		done_ = false;
 	}
 
+	template<class T>
+	void EventSequencer<T>::load()
+	{
+		if (table_ && current_ < table_size_)
+			cache_ = pgm_read(table_ + current_);
+	}
+
 	template<class T>
 	void EventSequencer<T>::clock()
 	{
@@ -453,10 +642,49 @@ namespace pg
 	}
 
 	template<class T>
-	void EventSequencer<T>::callback(const_iterator event, state_type state)
+	void EventSequencer<T>::callback(const Event* event, state_type state)
 	{
 		if (callback_)
-			(*callback_)(*event, state);
+			(*callback_)(event, state);
+	}
+
+	template<class T>
+	void EventSequencer<T>::transition()
+	{
+		end();
+		advance();
+		if (status() == Status::Active)
+		{
+			begin();
+			event_timer_.reset();
+			arm();
+		}
+	}
+
+	template<class T>
+	void EventSequencer<T>::arm()
+	{
+# if defined __PG_HAS_HW_TIMER
+		if (trigger_ != Trigger::Polled)
+		{
+			duration left = event_timer_.interval() - event_timer_.elapsed();
+
+			if (left < duration())
+				left = duration();
+			hw_timer::arm(static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(left).count()));
+		}
+# endif
+	}
+
+	template<class T>
+	void EventSequencer<T>::expire(void* arg)
+	{
+		EventSequencer<T>* sequencer = static_cast<EventSequencer<T>*>(arg);
+
+		if (sequencer->trigger_ == Trigger::Interrupt)
+			sequencer->transition();
+		else
+			sequencer->pending_ = true;
 	}
 
 } // namespace pg
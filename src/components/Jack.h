@@ -42,6 +42,9 @@
  *	call one of the member methods declared by its public interface (see 
  *	below). Command objects are defined by a unique key string, parameter list 
  *	and delegate, which can be ether a free-standing function or object method.
+ *	Keys of up to four characters are packed into integers, and longer keys 
+ *	are hashed, so that built-in commands are resolved with a single switch 
+ *	and no string compares.
  *	Jack listens to a network connection and forwards any messages received 
  *	to the `Interpreter' which decodes and executes any valid messages. Any 
  *	parameters encoded in the message are passed as arguments to the delegate.
@@ -64,12 +67,126 @@
  *	error detection/correction schemes, including retransmitting messages where 
  *	a reply was expected but not received.
  *
+ *	Connections can optionally be switched to a compact binary protocol, 
+ *	which is faster to decode and encode than text. Binary messages are 
+ *	frames of the form:
+ *
+ *		| 0x7e | opcode | size | args[size] | crc |
+ *
+ *	where opcode identifies one of the built-in commands (see `Opcode' below), 
+ *	args are the command's arguments packed little-endian in the same order 
+ *	and widths as the text arguments, strings and lists are packed as null-
+ *	terminated text, and crc is the CRC-8 of the opcode, size and args bytes. 
+ *	Replies use the same framing, with the opcode of the text reply key. 
+ *	Frames with invalid check values are dropped. Clients switch between 
+ *	protocols with the `prt' command (prt=0 text, prt=1 binary), which is 
+ *	available in both protocols. The binary protocol can be compiled out by 
+ *	defining __PG_NO_BINARY_PROTOCOL.
+ *
+ *	Text message check values (see docs/Jack/Messages.txt) can be compiled 
+ *	out by defining __PG_NO_CHECKSUM. They used to be compiled in only if 
+ *	<lib/crc.h> was included, but <utilities/Connection.h> now always 
+ *	includes it for the frame CRC, so __PG_NO_CHECKSUM is the only switch.
+ *
  *	Messages can be sent consecutively at network speeds, however Jack 
  *	currently does not implement any message queueing. Messages are decoded, 
  *	executed and replies sent as they are received. Therefore, message sizes 
  *	and queues are limited by the device hardware buffer sizes. For serial 
  *	connections this is the hardware receive and transmit buffer sizes, and 
- *	for UDP connections, the UDP packet size.
+ *	for UDP connections, the UDP packet size. Defining __PG_ASYNC_CONNECTION 
+ *	wraps every connection in an `AsyncConnection' (see <Connection.h>), which 
+ *	queues replies in a ring buffer and drains it from clock(), so that 
+ *	large replies don't block the application loop. Defining 
+ *	__PG_COALESCE_REPLIES packs all replies sent by UDP connections during 
+ *	one clock() pass into as few datagrams as possible, text replies are 
+ *	separated by newlines.
+ *
+ *	A text message can hold several commands separated by `;', such as 
+ *	`spm=2,1;spm=3,1;atc=0,2,1,0,0,0', which are executed in order, so a 
+ *	device can be configured in one round trip. Their replies are sent 
+ *	back as one message, with one `;' separated segment per command, in 
+ *	the same order: the command's replies, separated by spaces, nothing 
+ *	if it didn't reply, or `?' if it wasn't executed. A trailing `;' is 
+ *	ignored. A message check value covers the whole batch, and the 
+ *	combined reply gets one too. 
+ *	Combined replies longer than a message are split into as many messages 
+ *	as needed. Batches can be compiled out by defining __PG_NO_BATCH.
+ *
+ *	Ethernet and WiFi connections serve several clients at once, such as an 
+ *	HMI and a historian polling the same device. Each client has its own 
+ *	session (see <Connection.h>), which holds its address and port and its 
+ *	acknowledge (`sck') and checksum reply flags, and replies always go to 
+ *	the client that sent the message. Subscriptions are pushed to the 
+ *	client that made them.
+ *
+ *	Network connections come up in the background: clock() advances their 
+ *	link and DHCP negotiation until they open, then checks their link and 
+ *	lease once a second, reconnecting if either is lost, so the device 
+ *	keeps running locally while the network is down. The board LED is lit 
+ *	while the connection is open.
+ *
+ *	The `rdb' command replies with the input states of all digital pins as 
+ *	a packed bitmap, one bit per pin. On AVR boards, each GPIO port input 
+ *	register is read once with interrupts disabled, so the snapshot is 
+ *	consistent across pins and takes a few microseconds, instead of one 
+ *	digitalRead() call per pin. The `rda' command uses the same snapshot 
+ *	for its digital pins.
+ *
+ *	Timers attached in the Capture mode (2) measure the period of the signal 
+ *	on their pin with the timer capture unit (see <system/capture.h>), which 
+ *	latches each edge in hardware. Their value is the last period in 
+ *	nanoseconds, resolved to a fraction of a microsecond, and edges cost 
+ *	no trampoline ISR. Only one timer can capture at a time and only on a 
+ *	capture pin, and the mode requires defining __PG_HW_CAPTURE.
+ *
+ *	Timer values read by the `tms', `tma' and `tml' commands and by timer
+ *	subscriptions are consistent with the timer interrupts without 
+ *	disabling them: the interrupt handler makes a sequence counter odd 
+ *	while it updates a timer, and readers retry if the counter changed 
+ *	during the read. The `tma' command reads every timer in one pass, so 
+ *	its replies are a consistent snapshot of the whole timer set.
+ *
+ *	Defining __PG_TASK_STATS adds the `tst' command, which replies with the 
+ *	execution statistics of TaskScheduler tasks registered with monitor(), 
+ *	so control-loop budgets can be checked in the field.
+ *
+ *	Defining __PG_PROFILE adds the `prf' command, which replies with the 
+ *	cycle counts of scopes instrumented with PG_PROFILE_SCOPE (see 
+ *	<utilities/Profiler.h>), including Jack::clock() itself.
+ *
+ *	Defining __PG_SAMPLE_LOGGER adds a SampleLogger (see 
+ *	<components/SampleLogger.h>) of __PG_SAMPLE_LOG_SIZE samples, 256 by 
+ *	default, which samples a pin list at a fixed rate on the device, so 
+ *	transients are captured at rates the link can't keep up with: `log' 
+ *	arms it with the pins, period in microseconds, trigger condition, level 
+ *	and pretrigger frames, `lgt' triggers it, `lgs' replies with its status 
+ *	and `lgd' downloads the captured frames in bulk, packing as many whole 
+ *	frames as fit into each message or binary frame. Frames are taken from 
+ *	the hardware timer interrupt if __PG_HW_TIMER is defined and the board 
+ *	has one, which then can't be used by anything else, or polled from 
+ *	clock().
+ *
+ *	Defining __PG_EEPROM_JOURNAL keeps the EEPROM memory map in a RAM 
+ *	journal (see EEJournal in <utilities/EEStream.h>). Storing the 
+ *	configuration or connection then only changes the journal, and clock() 
+ *	writes the changes in the background, rotating them through the whole 
+ *	EEPROM. The journal takes about as much RAM as the memory map below.
+ *
+ *	The current program can be stored in the EEPROM after the memory map, 
+ *	or before the journal, in __PG_PROGRAM_EEPROM_SIZE bytes, 512 by 
+ *	default, with `pgm=9'. `pgm=11' also marks it to run at power-up, and 
+ *	`pgm=10' reloads it. Stored programs are checked with a CRC, loaded 
+ *	by initialize() unless the power-on defaults pin is LOW, and run if 
+ *	marked, so the device resumes its program without the host re-sending 
+ *	it. The program is stored outside of the journal, which then has that 
+ *	much less EEPROM to rotate through, and storing it blocks until it has 
+ *	been written. A size of 0 disables storing.
+ *
+ *	Each clock() executes up to a budget of program instructions, 
+ *	__PG_PROGRAM_STEPS, 1 by default, until __PG_PROGRAM_SLICE 
+ *	microseconds have passed, if not 0, or the program sleeps, then yields 
+ *	to the connection. `spb=n,us' sets the budget and `pgb' replies with 
+ *	it.
  *
  *  Jack also defines a function that allows users to force the device to 
  *	use the default connection at power-up. It checks a digital input pin 
@@ -91,23 +208,39 @@
 
 # include <cassert>
 # include <cstdio>
+# include <cstdlib>
 # include <cstring>
 # include <valarray>
 # include <system/boards.h>
+# include <system/capture.h>
 # include <system/utils.h>
 # include <interfaces/iclockable.h>
 # include <interfaces/icomponent.h>
+# include <lib/format.h>
 # include <lib/hardware.h>
 # include <utilities/EEStream.h>
 # include <utilities/Connection.h>
 # if !defined __PG_NO_PROGRAM
 #  include <utilities/Program.h>	
+#  if !defined __PG_PROGRAM_EEPROM_SIZE
+#   define __PG_PROGRAM_EEPROM_SIZE 512
+#  endif
 # else
 #  include <utilities/Interpreter.h>
 # endif
 # if !defined __PG_NO_CHECKSUM 
 #  include <lib/crc.h>
 # endif
+# if defined __PG_TASK_STATS
+#  include <utilities/TaskStats.h>
+# endif
+# if defined __PG_SAMPLE_LOGGER
+#  include <components/SampleLogger.h>
+#  if !defined __PG_SAMPLE_LOG_SIZE
+#   define __PG_SAMPLE_LOG_SIZE 256
+#  endif
+# endif
+# include <utilities/Profiler.h>
 
 # if defined __PG_HAS_NAMESPACES
 
@@ -136,18 +269,40 @@ namespace pg
 		using command_type = Interpreter::CommandBase;					// Remote command interface type.
 		using cmdlist_type = std::initializer_list<command_type*>;		// Remote command interface list type.
 		using key_type = typename command_type::key_type;				// Command key storage type.
+		using hash_type = Interpreter::hash_type;						// Packed command key storage type.
 		using size_type = uint8_t;										// Type that can hold the size of any Jack object.
 		using value_type = uint16_t;									// Type that can hold any pin state.
 		using timer_t = uint8_t;										// Timer index type alias.
 
+# if defined __PG_TASK_STATS
+		static constexpr size_type OptTaskStatsCount = 1;				// Number of task statistics commands.
+# else
+		static constexpr size_type OptTaskStatsCount = 0;				// Number of task statistics commands.
+# endif
+# if defined __PG_PROFILE
+		static constexpr size_type OptProfileCount = 1;					// Number of profiler commands.
+# else
+		static constexpr size_type OptProfileCount = 0;					// Number of profiler commands.
+# endif
+# if defined __PG_SAMPLE_LOGGER
+		static constexpr size_type OptSampleLogCount = 4;				// Number of sample logger commands.
+# else
+		static constexpr size_type OptSampleLogCount = 0;				// Number of sample logger commands.
+# endif
+		static constexpr size_type OptCommandsCount =					// Number of optional built-in commands.
+			OptTaskStatsCount + OptProfileCount + OptSampleLogCount;
 # if defined __PG_PROGRAM_H
 		static constexpr size_type CommandsMaxCount = 64;				// Maximum number of storable remote commands.
 # elif defined __PG_NO_USR_COMMANDS 
-		static constexpr size_type CommandsMaxCount = 31;				// Maximum number of storable remote commands.
+		static constexpr size_type CommandsMaxCount = 36 + OptCommandsCount;	// Maximum number of storable remote commands.
 # else
-		static constexpr size_type CommandsMaxCount = 40;				// Maximum number of storable remote commands.
+		static constexpr size_type CommandsMaxCount = 44 + OptCommandsCount;	// Maximum number of storable remote commands.
 # endif
 		static constexpr size_type TimersMaxCount = 16;					// Maximum number of event counters/timers.
+		static constexpr size_type PinBitmapSize = (GpioCount + 7) / 8;	// Size in bytes of the digital pins bitmap.
+# if defined __AVR__
+		static constexpr size_type PortsMaxCount = 16;					// Maximum number of GPIO ports.
+# endif
 		static constexpr size_type InterruptsCount =					// Number of pins with hardware interrupts.
 			countInterrupts<GpioCount>();
 		static constexpr size_type TimersCount = 						// Number of instantiated event counters/timers, 
@@ -160,24 +315,58 @@ namespace pg
 		static constexpr const char* DefaultConnectionParams = "9600,8N1";
 		static constexpr const char* ListDelimiterChars = ".";			// Delimiter char for lists encoded as a single Command arg.
 		static constexpr const char* CheckSumDelimiterChars = ":";		// Delimiter char for check values appended to messages.
+		static constexpr const char* BatchDelimiterChars = ";";		// Delimiter char for commands batched in one message.
+		static constexpr const char* BatchErrorChars = "?";				// Batch reply segment of commands that weren't executed.
+		static constexpr const char* BatchReplyDelimiterChars = " ";	// Delimiter char for replies of one batched command.
 		static constexpr size_type ListSize = GpioCount > TimersCount
 			? GpioCount
 			: TimersCount;
+		static constexpr size_type SubscriptionsMaxCount = 8;			// Maximum number of subscribed pins or timers, each.
+# if defined __PG_TASK_STATS
+		static constexpr size_type TaskStatsMaxCount = 16;				// Maximum number of monitored scheduler tasks.
+# endif
+# if defined __PG_SAMPLE_LOGGER
+		static constexpr size_type SampleLogChannelsMax = 8;			// Maximum number of logged pins.
+		static constexpr size_type SampleLogHexMax = Connection::size() - 16;	// Hex chars of samples per text message.
+# endif
 
 		using Commands = typename std::valarray<command_type*, CommandsMaxCount>;	// Remote commands collection type.
 		using Timers = typename std::array<TimerCounter, TimersCount>;	// Event counters/timers collection type.
 		using Pins = std::array<GpioPin, GpioCount>;					// GpioPins collection type.
 		using Isrs = std::array<isr_type, TimersCount>;					// ISRs collection type.
 		using List = std::valarray<uint8_t, ListSize>;					// Type that holds Command argument lists.
+# if defined __PG_TASK_STATS
+		using TaskStatsList = std::valarray<const TaskStats*, TaskStatsMaxCount>;	// Monitored task statistics collection type.
+# endif
+# if defined __PG_SAMPLE_LOGGER
+		using SampleLog = SampleLogger<__PG_SAMPLE_LOG_SIZE, SampleLogChannelsMax>;	// Sample logger type.
+# endif
+
+		// Pins or timers whose values are pushed to the client on change or when the period elapses.
+		struct Subscription
+		{
+			using timer_type = Timer<std::chrono::milliseconds>;
+
+			std::array<uint8_t, SubscriptionsMaxCount> items_;		// Subscribed pin or timer indexes.
+			std::array<uint32_t, SubscriptionsMaxCount> values_;	// Last published values.
+			std::array<bool, SubscriptionsMaxCount> active_;		// Last published timer states.
+			size_type	size_;										// Number of subscribed items.
+			value_type	deadband_;									// Minimum change that is published.
+			timer_type	period_;									// Republish period, 0 = changes only.
+			Connection::size_type session_;							// Session of the subscribing client.
+		};
 
 		// EEPROM Memory Map
 		// 
-		//  |          |             |               |                   |
-		//	| DeviceId | Pins Config | Timers Config | Connection Params |
-		//  |          |             |               |                   |
-		//	0		   A                             B
+		//  |          |             |               |                   |         |
+		//	| DeviceId | Pins Config | Timers Config | Connection Params | Program |
+		//  |          |             |               |                   |         |
+		//	0		   A                             B                   C
+		//
+		// With __PG_EEPROM_JOURNAL the program is stored at 0 and the journal after it.
 
 		static constexpr address_type ConfigurationEepromAddress = sizeof(devid_type);	// A
+		static constexpr size_type TimerConfigSize = 5;									// Stored bytes per timer.
 		static constexpr address_type ConnectionEepromAddress =							// B
 			ConfigurationEepromAddress +
 			(GpioCount * sizeof(decltype(GpioPin::mode_))) +							// Pins Config saves mode_
@@ -186,6 +375,19 @@ namespace pg
 				sizeof(decltype(TimerCounter::trigger_)) +								// trigger_ and 
 				sizeof(decltype(TimerCounter::timing_)) +								// operation
 				sizeof(decltype(TimerCounter::instant_)));								// instant
+# if defined __PG_EEPROM_JOURNAL
+		static constexpr address_type EepromSize =									// Size of the memory map in bytes.
+			ConnectionEepromAddress + sizeof(uint8_t) + Connection::size();			// Connection type and params.
+# endif
+# if defined __PG_PROGRAM_H
+#  if defined __PG_EEPROM_JOURNAL
+		static constexpr address_type ProgramEepromAddress = 0;					// Journal follows the program.
+#  else
+		static constexpr address_type ProgramEepromAddress =						// C
+			ConnectionEepromAddress + sizeof(uint8_t) + Connection::size();
+#  endif
+		static constexpr address_type ProgramEepromSize = __PG_PROGRAM_EEPROM_SIZE;	// Bytes reserved for the stored program.
+# endif
 
 #pragma region strings
 
@@ -208,6 +410,7 @@ namespace pg
 		static constexpr key_type KeyReadPin = "rdp";			// Read pin:						rdp=p
 		static constexpr key_type KeyReadPinAll = "rda";		// Read all pins:					rda
 		static constexpr key_type KeyReadPinList = "rdl";		// Read pin list:					rdl=p0[.p1. ... .pN]
+		static constexpr key_type KeyReadPinBitmap = "rdb";		// Read digital pins bitmap:		rdb
 		static constexpr key_type KeyWritePin = "wrp";			// Write pin:						wrp=p,v
 		static constexpr key_type KeyGetTimerStatus = "tms";	// Get timer state:					tms=t
 		static constexpr key_type KeyGetTimerStatusAll = "tma";	// Get all timers state:			tma
@@ -224,6 +427,16 @@ namespace pg
 		static constexpr key_type KeyStoreConfig = "sto";		// Store device config to eeprom:	sto
 		static constexpr key_type KeySetTimerStatusAll = "sta";	// Set all timers state:			sta=s
 		static constexpr key_type KeyTimerDetachAll = "dta";	// Detach all timers:				dta
+		static constexpr key_type KeySetProtocol = "prt";		// Set connection protocol:			prt=0|1
+		static constexpr key_type KeySubscribePins = "sbp";		// Subscribe to pin list values:	sbp=p0[.p1. ... .pN],period,deadband
+		static constexpr key_type KeySubscribeTimers = "sbt";	// Subscribe to timer list status:	sbt=t0[.t1. ... .tN],period,deadband
+		static constexpr key_type KeyUnsubscribe = "uns";		// Cancel all subscriptions:		uns
+		static constexpr key_type KeyGetTaskStats = "tst";		// Get task statistics:				tst=n
+		static constexpr key_type KeyGetProfile = "prf";		// Get profiled scope statistics:	prf=n
+		static constexpr key_type KeySampleLog = "log";			// Arm sample logger:				log=p0[.p1. ... .pN],period,condition,level,pretrigger
+		static constexpr key_type KeySampleLogFire = "lgt";		// Trigger sample logger:			lgt
+		static constexpr key_type KeySampleLogStatus = "lgs";	// Get sample logger status:		lgs
+		static constexpr key_type KeySampleLogData = "lgd";		// Get sample logger frames:		lgd=first,count
 
 		static constexpr fmt_type FmtAcknowledge = "%s=%u";				// ack=0|1
 		static constexpr fmt_type FmtConnectionGet = "%s=%u,%s";		// net=type,arg0,arg1,arg2
@@ -232,17 +445,82 @@ namespace pg
 		static constexpr fmt_type FmtElapsedTime = "%s=%u,%lu";			// tim=unit,time
 		static constexpr fmt_type FmtPinInfo = "%s=%u,%u,%u,%u";		// pin=p#,type,int,mode
 		static constexpr fmt_type FmtPinMode = "%s=%u,%u";				// pmd=p#,mode
+		static constexpr fmt_type FmtReadPinBitmap = "%s=%s";			// rdb=b0b1 ... bN, hex bytes, pin p is bit (p % 8) of byte p / 8
+		static constexpr fmt_type FmtPinBitmapByte = "%02x";			// One hex bitmap byte.
+		static constexpr fmt_type FmtProtocol = "%s=%u";				// prt=0|1
 		static constexpr fmt_type FmtReadPin = "%u=%u";					// p#=value
 		static constexpr fmt_type FmtTimerAttach = "%s=%u,%u,%u,%u,%u,%u";	// atc=t#,p#,mode,trigger,timing
 		static constexpr fmt_type FmtTimerStatus = "%s=%u,%u,%lu";		// tms=t#,active,value
+		static constexpr fmt_type FmtTaskStats = "%s=%u,%lu,%lu,%lu,%lu,%lu,%lu";	// tst=n,runs,min,max,mean,late,overruns
+		static constexpr fmt_type FmtProfile = "%s=%u,%s,%lu,%lu,%lu,%lu";	// prf=n,name,calls,min,max,mean
+		static constexpr fmt_type FmtSampleLogStatus = "%s=%u,%u,%u,%u,%lu,%lu";	// lgs=state,channels,frames,trigger,period,overruns
+		static constexpr fmt_type FmtSampleLogData = "%s=%u,%s";		// lgd=frame,s0s1 ... sN, 4 hex chars per sample
+		static constexpr fmt_type FmtSampleHex = "%04x";				// One hex sample.
 		static constexpr fmt_type FmtChecksum = ":%u";					// Message check value. 
 # if defined __PG_PROGRAM_H
 		static constexpr key_type KeyProgram = "pgm";					// Get/set program state:	pgm=a
 		static constexpr fmt_type FmtProgramStatus = "%s=%u,%u";		// pgm=action,status
+		static constexpr fmt_type FmtProgramLine = "%s";				// One program listing line.
+		static constexpr key_type KeyGetProgramBudget = "pgb";			// Get program budget:		pgb
+		static constexpr key_type KeySetProgramBudget = "spb";			// Set program budget:		spb=n,us
+		static constexpr fmt_type FmtProgramBudget = "%s=%u,%u";		// pgb=steps,slice
 																		// #pin value, %timer elapsed, +counter count, 
 																		// *tc active, $time elapsed.
 # endif
 
+		/*
+		 *  Binary protocol command opcodes.
+		 */
+
+		enum Opcode : uint8_t
+		{
+			OpDevReset = 0x01,				// rst
+			OpDevInfo = 0x02,				// inf
+			OpGetAck = 0x03,				// ack
+			OpSetAck = 0x04,				// sck
+			OpGetPinInfo = 0x05,			// pin
+			OpGetPinInfoAll = 0x06,			// pna
+			OpGetPinMode = 0x07,			// pmd
+			OpGetPinModeAll = 0x08,			// pma
+			OpGetPinModeList = 0x09,		// pml
+			OpSetPinMode = 0x0a,			// spm
+			OpSetPinModeAll = 0x0b,			// spa
+			OpGetElapsedTime = 0x0c,		// tim
+			OpReadPin = 0x0d,				// rdp
+			OpReadPinAll = 0x0e,			// rda
+			OpReadPinList = 0x0f,			// rdl
+			OpWritePin = 0x10,				// wrp
+			OpGetTimerStatus = 0x11,		// tms
+			OpGetTimerStatusAll = 0x12,		// tma
+			OpGetTimerStatusList = 0x13,	// tml
+			OpSetTimerStatus = 0x14,		// stm
+			OpTimerDetach = 0x15,			// dtc
+			OpTimerGetAttach = 0x16,		// tcm
+			OpTimerGetAttachAll = 0x17,		// tca
+			OpTimerGetAttachList = 0x18,	// tcl
+			OpTimerAttach = 0x19,			// atc
+			OpGetConnection = 0x1a,			// net
+			OpSetConnection = 0x1b,			// snt
+			OpLoadConfig = 0x1c,			// lda
+			OpStoreConfig = 0x1d,			// sto
+			OpSetTimerStatusAll = 0x1e,		// sta
+			OpTimerDetachAll = 0x1f,		// dta
+			OpSetProtocol = 0x20,			// prt
+			OpProgram = 0x21,				// pgm
+			OpSubscribePins = 0x22,			// sbp
+			OpSubscribeTimers = 0x23,		// sbt
+			OpUnsubscribe = 0x24,			// uns
+			OpGetTaskStats = 0x25,			// tst
+			OpReadPinBitmap = 0x26,			// rdb
+			OpGetProfile = 0x27,			// prf
+			OpSampleLog = 0x28,				// log
+			OpSampleLogFire = 0x29,			// lgt
+			OpSampleLogStatus = 0x2a,		// lgs
+			OpSampleLogData = 0x2b,			// lgd
+			OpGetProgramBudget = 0x2c,		// pgb
+			OpSetProgramBudget = 0x2d		// spb
+		};
+
 #pragma endregion
 #pragma region interrupt service routines
 
@@ -290,10 +568,26 @@ namespace pg
 		void cmdPinModeGetList(char*);
 		void cmdPinModeSet(pin_t, uint8_t);
 		void cmdPinModeSetAll(uint8_t);
+		void cmdProtocolSet(uint8_t);
 		void cmdReadPin(pin_t);
 		void cmdReadPinAll();
+		void cmdReadPinBitmap();
 		void cmdReadPinList(char*);
 		void cmdStoreConfig();
+		void cmdSubscribePins(char*, uint32_t, value_type);
+		void cmdSubscribeTimers(char*, uint32_t, value_type);
+# if defined __PG_TASK_STATS
+		void cmdTaskStatsGet(uint8_t);
+# endif
+# if defined __PG_PROFILE
+		void cmdProfileGet(uint8_t);
+# endif
+# if defined __PG_SAMPLE_LOGGER
+		void cmdSampleLog(char*, uint32_t, uint8_t, value_type, uint16_t);
+		void cmdSampleLogData(uint16_t, uint16_t);
+		void cmdSampleLogFire();
+		void cmdSampleLogStatus();
+# endif
 		void cmdTimerAttachGet(timer_t);
 		void cmdTimerAttachGetAll();
 		void cmdTimerAttachGetList(char*);
@@ -305,21 +599,34 @@ namespace pg
 		void cmdTimerStatusGetList(char*);
 		void cmdTimerStatusSet(timer_t, uint8_t);
 		void cmdTimerStatusSetAll(uint8_t);
+		void cmdUnsubscribe();
 		void cmdWritePin(pin_t, value_type);
 		Commands commands() const;
 		Connection* connection() const;
 		void initialize(pin_t = PowerOnDefaultsPin);
 		void isrHandler(timer_t);
+# if defined __PG_TASK_STATS
+		template<class Scheduler>
+		void monitor(const Scheduler&);
+# endif
 
 	private:
 		template<class ForwardIt>
 		void addCommands(Commands&, ForwardIt, ForwardIt);
 		void attachTimer(timer_t, pin_t, uint8_t, uint8_t, uint8_t, bool);
+		bool ack() const;
+		bool binary() const;
+		void batch(char*);
+		void batchFlush();
+		void batchReply(const char*);
 		bool check(char*);
 		void closeConnection(Connection*&);
+		command_type* command(Opcode);
+		command_type* lookup(hash_type);
 		void detachTimer(timer_t, bool = true);
 		std::time_t elapsedTime(uint8_t);
 		void endTimer(timer_t);
+		bool execute(const char*);
 		bool eepromValid(EEStream&, devid_type);
 		template<class... Ts>
 		size_type fmtMessage(char*, const char*, Ts...);
@@ -331,32 +638,51 @@ namespace pg
 		void initialize(Timers&);
 		void intializeEeprom(EEStream&, devid_type, connection_type, const char*, const Pins&, const Timers&);
 		void invalidateEeprom(EEStream&);
+		static bool isCapturePin(pin_t);
 		void loadConfig(EEStream&, Jack::Pins&, Jack::Timers&);
 		Connection* loadConnection(EEStream&, char*);
 		void maintainConnection();
 		void makeList(char*, uint8_t);
 		Connection* openConnection(connection_type, const char*);
 		bool powerOnDefaults(pin_t);
+		void publish();
 		value_type readPin(pin_t);
+		void readPins(uint8_t*);
+		bool readsDigital(pin_t) const;
+		void receiveFrames();
+		void receiveMessages();
+		template<class... Ts>
+		void sendFrame(Opcode, Ts...);
 		template<class... Ts>
 		void sendMessage(const char*, Ts...);
 		void sendPinInfo(pin_t);
 		void sendPinMode(pin_t);
 		void sendPinValue(pin_t, value_type);
+		void sendReply(char*);
 		void sendTimerInfo(timer_t);
 		void sendTimerStatus(timer_t);
+		void sendTimerStatus(timer_t, bool, uint32_t);
 		void setConnection(Connection*);
 		void setPinMode(pin_t, uint8_t);
 		void setTimerStatus(timer_t, TimerCounter::Action);
 		void storeConfig(EEStream&, const Pins&, const Timers&);
 		void storeConnection(EEStream&, connection_type, const char*);
+		void subscribe(Subscription&, uint8_t, uint32_t, value_type);
+		uint32_t timerStatus(timer_t, bool&);
+		uint32_t readTimerStatus(timer_t, bool&);
+		uint8_t timersReadBegin() const;
+		bool timersReadRetry(uint8_t) const;
 		void writePin(pin_t, value_type);
 # if defined __PG_PROGRAM_H
 		void list();
-		void process(const char*);
+		bool loadProgram(EEStream&, bool&);
+		bool process(const char*);
 		void program(uint8_t);
+		void programBudgetGet();
+		void programBudgetSet(Program::size_type, uint16_t);
 		void sendProgramStatus(Program::Action, value_type);
-		iprogram::value_type sys_get(const char*) override;
+		bool storeProgram(EEStream&, bool);
+		iprogram::value_type sys_get(char, iprogram::value_type) override;
 		bool verify();
 # endif
 	private: 
@@ -379,6 +705,7 @@ namespace pg
 		Command<pin_t> cmd_readpin_{ KeyReadPin, *this, &Jack::cmdReadPin };	// rdp=p
 		Command<void> cmd_readpinall_{ KeyReadPinAll, *this, &Jack::cmdReadPinAll };	// rda
 		Command<char*> cmd_readpinlist_{ KeyReadPinList, *this, &Jack::cmdReadPinList };	// rdl="p0.p1.p2. ... .pN"
+		Command<void> cmd_readpinbitmap_{ KeyReadPinBitmap, *this, &Jack::cmdReadPinBitmap };	// rdb
 		Command<timer_t> cmd_timerattachget_{ KeyTimerGetAttach, *this, &Jack::cmdTimerAttachGet };	// tcm=t
 		Command<void> cmd_timerattachgetall_{ KeyTimerGetAttachAll, *this, &Jack::cmdTimerAttachGetAll };	// tca
 		Command<char*> cmd_timerattachgetlist_{ KeyTimerGetAttachList, *this, &Jack::cmdTimerAttachGetList };	// tcl
@@ -391,23 +718,59 @@ namespace pg
 		Command<void> cmd_stoconfig_{ KeyStoreConfig, *this, &Jack::cmdStoreConfig };	// sto
 		Command<void> cmd_timerdetachall_{ KeyTimerDetachAll, *this, &Jack::cmdTimerDetachAll };	// dta
 		Command<uint8_t> cmd_timerstatussetall_{ KeySetTimerStatusAll, *this, &Jack::cmdTimerStatusSetAll }; // sta=t,a
+		Command<uint8_t> cmd_protocolset_{ KeySetProtocol, *this, &Jack::cmdProtocolSet }; // prt=0|1
+		Command<char*, uint32_t, value_type> cmd_subscribepins_{ KeySubscribePins, *this, &Jack::cmdSubscribePins }; // sbp=l,p,d
+		Command<char*, uint32_t, value_type> cmd_subscribetimers_{ KeySubscribeTimers, *this, &Jack::cmdSubscribeTimers }; // sbt=l,p,d
+		Command<void> cmd_unsubscribe_{ KeyUnsubscribe, *this, &Jack::cmdUnsubscribe }; // uns
+# if defined __PG_TASK_STATS
+		Command<uint8_t> cmd_taskstatsget_{ KeyGetTaskStats, *this, &Jack::cmdTaskStatsGet }; // tst=n
+# endif
+# if defined __PG_PROFILE
+		Command<uint8_t> cmd_profileget_{ KeyGetProfile, *this, &Jack::cmdProfileGet }; // prf=n
+# endif
+# if defined __PG_SAMPLE_LOGGER
+		Command<char*, uint32_t, uint8_t, value_type, uint16_t> cmd_samplelog_{ KeySampleLog, *this, &Jack::cmdSampleLog }; // log=l,p,c,v,n
+		Command<void> cmd_samplelogfire_{ KeySampleLogFire, *this, &Jack::cmdSampleLogFire }; // lgt
+		Command<void> cmd_samplelogstatus_{ KeySampleLogStatus, *this, &Jack::cmdSampleLogStatus }; // lgs
+		Command<uint16_t, uint16_t> cmd_samplelogdata_{ KeySampleLogData, *this, &Jack::cmdSampleLogData }; // lgd=f,n
+# endif
 
 		Connection*		connection_;	// Current network connection.
 		Interpreter		interp_;		// Command interpreter.
+# if defined __PG_EEPROM_JOURNAL
+		uint8_t			eeprom_image_[EepromSize];		// EEPROM memory map image.
+#  if defined __PG_PROGRAM_H
+		EEJournal		journal_{ eeprom_image_, ProgramEepromSize };	// EEPROM memory map journal.
+#  else
+		EEJournal		journal_{ eeprom_image_ };	// EEPROM memory map journal.
+#  endif
+# endif
 		EEStream		eeprom_;		// EEPROM streaming object.
 		Pins			pins_;			// Gpio pins collection.
 		Timers			timers_;		// Event counters/timers collection.
+		volatile uint8_t timers_seq_{};	// Timers sequence counter, odd while isrHandler() updates a timer.
 		Commands		commands_;		// Remote commands collection.
 		Isrs			isrs_;			// Interrupt service routines collection.
-		bool			ack_;			// Command acknowledge flag.
 		List			list_;			// Command argument list buffer.
+		Subscription	pin_subs_;		// Subscribed pins.
+		Subscription	timer_subs_;	// Subscribed timers.
+# if !defined __PG_NO_BATCH
+		char*			batch_{ nullptr };	// Combined replies of the executing batch, if any.
+		Connection::size_type batch_size_{};	// Size of the combined replies.
+		bool			batch_replied_{};	// Flag indicating whether the executing batch command has replied.
+# endif
+# if defined __PG_TASK_STATS
+		TaskStatsList	task_stats_;	// Monitored scheduler task statistics.
+# endif
+# if defined __PG_SAMPLE_LOGGER
+		SampleLog		logger_;		// Sample logger.
+# endif
 # if defined __PG_PROGRAM_H
 		Command<uint8_t> cmd_program_{ KeyProgram, *this, &Jack::program };	// Program command object.
+		Command<void> cmd_programbudgetget_{ KeyGetProgramBudget, *this, &Jack::programBudgetGet };	// pgb
+		Command<Program::size_type, uint16_t> cmd_programbudgetset_{ KeySetProgramBudget, *this, &Jack::programBudgetSet };	// spb=n,us
 		Program			program_;		// Program manager/executor.
 # endif
-# if defined __PG_CRC_H 
-		bool checksum_;					// Flag indicating whether a received message included a checksum.
-#endif
 	};
 } // namespace pg
 
@@ -417,74 +780,125 @@ namespace pg
 
 # if defined __PG_PROGRAM_H
 	Jack::Jack(cmdlist_type commands) :
-		connection_(), interp_(), eeprom_(), pins_(), timers_(), isrs_(), ack_(), program_(*this), list_(),
+		connection_(), interp_(), eeprom_(), pins_(), timers_(), isrs_(), list_(), pin_subs_(), timer_subs_(), 
+		program_(*this),
 		commands_({ & cmd_devinfo_ , & cmd_devreset_, & cmd_ackget_, & cmd_ackset_, & cmd_pininfoget_, & cmd_pininfogetall_,
 			& cmd_pinmodeget_, & cmd_pinmodegetall_, & cmd_pinmodeset_, & cmd_pinmodesetall_, & cmd_timerstatusget_,
 			& cmd_timerstatusgetall_, & cmd_timerstatusset_, & cmd_timerstatussetall_, & cmd_readpin_, & cmd_readpinall_, 
 			& cmd_readpinlist_, & cmd_timerattachget_, & cmd_timerattachgetall_, & cmd_timerattachset_, & cmd_timerdetach_,
 			& cmd_timerdetachall_, & cmd_connectionget_, & cmd_connectionset_, & cmd_ldaconfig_, & cmd_stoconfig_, 
 			& cmd_elapsed_,& cmd_writepin_, & cmd_program_, & cmd_pinmodegetlist_, & cmd_timerstatusgetlist_, 
-			& cmd_timerattachgetlist_ })
+			& cmd_timerattachgetlist_, & cmd_protocolset_, & cmd_subscribepins_, & cmd_subscribetimers_, & cmd_unsubscribe_, 
+			& cmd_readpinbitmap_, & cmd_programbudgetget_, & cmd_programbudgetset_ })
 # else
 	Jack::Jack(cmdlist_type commands) :
-		connection_(), interp_(), eeprom_(), pins_(), timers_(), isrs_(), ack_(), list_(), 
+		connection_(), interp_(), eeprom_(), pins_(), timers_(), isrs_(), list_(), pin_subs_(), timer_subs_(),
 		commands_({ &cmd_devinfo_ , &cmd_devreset_, &cmd_ackget_, &cmd_ackset_, &cmd_pininfoget_, &cmd_pininfogetall_,
 			&cmd_pinmodeget_, &cmd_pinmodegetall_, &cmd_pinmodeset_, &cmd_pinmodesetall_, &cmd_timerstatusget_,
 			&cmd_timerstatusgetall_, &cmd_timerstatusset_, &cmd_timerstatussetall_, &cmd_readpin_, &cmd_readpinall_,
 			&cmd_readpinlist_, &cmd_timerattachget_, &cmd_timerattachgetall_, &cmd_timerattachset_, &cmd_timerdetach_,
 			&cmd_timerdetachall_, &cmd_connectionget_, &cmd_connectionset_, &cmd_ldaconfig_, &cmd_stoconfig_,
-			&cmd_elapsed_, & cmd_writepin_,& cmd_pinmodegetlist_,& cmd_timerstatusgetlist_,	& cmd_timerattachgetlist_ })
+			&cmd_elapsed_, & cmd_writepin_,& cmd_pinmodegetlist_,& cmd_timerstatusgetlist_,	& cmd_timerattachgetlist_,
+			&cmd_protocolset_, &cmd_subscribepins_, &cmd_subscribetimers_, &cmd_unsubscribe_, &cmd_readpinbitmap_ })
 # endif
 	{
 		initialize(pins_);
 		initialize(timers_);
 		initialize<TimersCount>(isrs_);
+# if defined __PG_TASK_STATS || defined __PG_PROFILE || defined __PG_SAMPLE_LOGGER
+		command_type* optional[] = { 
+#  if defined __PG_TASK_STATS
+			&cmd_taskstatsget_,
+#  endif
+#  if defined __PG_PROFILE
+			&cmd_profileget_,
+#  endif
+#  if defined __PG_SAMPLE_LOGGER
+			&cmd_samplelog_, &cmd_samplelogfire_, &cmd_samplelogstatus_, &cmd_samplelogdata_,
+#  endif
+		};
+
+		addCommands(commands_, std::begin(optional), std::end(optional));
+# endif
 		initialize(commands);
 	}
 
 	void Jack::clock()
 	{
-		if (connection_ && connection_->open())
-		{
-			const char* msg;
+		PG_PROFILE_SCOPE("Jack::clock");
 
+# if defined __PG_EEPROM_JOURNAL
+		journal_.clock();	// Write any stored changes to the EEPROM.
+# endif
+# if defined __PG_SAMPLE_LOGGER
+		static_cast<iclockable&>(logger_).clock();	// Take any polled samples due, even without a connection.
+# endif
+		if (connection_ && connection_->status() == Connection::Status::Connecting)
+		{
+			connection_->clock();	// Advance the network bring-up, without blocking.
+			if (connection_->open())
+				digitalWrite(pg::LedPinNumber, true);
+		}
+		else if (connection_ && connection_->open())
+		{
 			connection_->clock();
-			while(*(msg = connection_->receive()))
-# if defined __PG_CRC_H
-				if(check(const_cast<char*>(msg))) // Look for trailing check value and compare to checksum.
+# if defined __PG_COALESCE_REPLIES
+			connection_->coalesce(true);	// Pack all replies from this pass into as few datagrams as possible.
 # endif
+			if (binary())
+				receiveFrames();
+			else
+				receiveMessages();
 # if defined __PG_PROGRAM_H
-					process(msg);		// Check for program control messages before executing command.
-				if (program_.active())	// If current program is active, execute next instruction.
+			if (program_.active())	// If current program is active, execute instructions up to its budget.
+			{
+				const uint32_t start = micros();
+
+				for (Program::size_type n = program_.steps(); n-- && connection_ && program_.active() && !program_.sleeping();)
 				{
-					const char* instruction = program_.instruction();
 					// Programs can execute both remote commands and program instructions.
-					if (!interp_.execute(std::begin(program_.instructions()), std::end(program_.instructions()), instruction))
-						interp_.execute(std::begin(commands_), std::end(commands_), program_.tryGet(const_cast<char*>(instruction)));
+					const char* command = program_.step();
+
+					if (command)
+						interp_.execute([this](hash_type key) { return lookup(key); }, program_.tryGet(const_cast<char*>(command)));
+					if (program_.slice() && micros() - start >= program_.slice())
+						break;
 				}
-# else 
-					interp_.execute(std::begin(commands_), std::end(commands_), msg);
+			}
+# endif
+			if (connection_)	// Commands may have replaced the connection.
+				publish();
+# if defined __PG_COALESCE_REPLIES
+			if (connection_)
+				connection_->coalesce(false);
 # endif
-			maintainConnection();		// Maintain dhcp lease.
+			if (connection_)
+				maintainConnection();	// Check the link and maintain any dhcp lease.
 		}
 	}
 
 	void Jack::cmdAckGet()
 	{
-		sendMessage(FmtAcknowledge, KeyGetAck, ack_);
+		if (binary())
+			sendFrame(OpGetAck, ack());
+		else
+			sendMessage(FmtAcknowledge, KeyGetAck, ack());
 	}
 
 	void Jack::cmdAckSet(bool value)
 	{
-		if ((ack_ = value))
-			sendMessage(FmtAcknowledge, KeyGetAck, ack_);
+		if ((connection_->session().ack = value))
+			cmdAckGet();
 	}
 
 	void Jack::cmdConnectionGet()
 	{
 		char params[Connection::size()] = { '\0' };
 
-		sendMessage(FmtConnectionGet, KeyGetConnection, connection_->type(), connection_->params(params));
+		if (binary())
+			sendFrame(OpGetConnection, static_cast<uint8_t>(connection_->type()), connection_->params(params));
+		else
+			sendMessage(FmtConnectionGet, KeyGetConnection, connection_->type(), connection_->params(params));
 	}
 
 	void Jack::cmdConnectionSet(uint8_t type, const char* arg0, const char* arg1, const char* arg2)
@@ -495,7 +909,10 @@ namespace pg
 
 		// Convert arg0, arg1 and arg2 into a comma-delimited string: "arg0,arg1,arg2".
 		(void)fmtMessage(params, FmtConnectionSet, arg0, arg1, arg2);
-		sendMessage(FmtConnectionGet, KeySetConnection, type, params);
+		if (binary())
+			sendFrame(OpSetConnection, type, static_cast<const char*>(params));
+		else
+			sendMessage(FmtConnectionGet, KeySetConnection, type, params);
 		closeConnection(connection_);
 		setConnection(nullptr);
 		storeConnection(eeprom_, net_type, params);
@@ -505,22 +922,36 @@ namespace pg
 
 	void Jack::cmdDevInfo()
 	{
-		sendMessage(FmtDevInfo, cmd_devinfo_.key(), DeviceId,
-			board_traits<board_type>::board, board_traits<board_type>::mcu,
-			static_cast<unsigned>(board_traits<board_type>::clock_frequency / 1000000),
-			static_cast<size_type>(pins_.size()), static_cast<size_type>(timers_.size()));
+		if (binary())
+			sendFrame(OpDevInfo, static_cast<uint32_t>(DeviceId),
+				board_traits<board_type>::board, board_traits<board_type>::mcu,
+				static_cast<uint16_t>(board_traits<board_type>::clock_frequency / 1000000),
+				static_cast<size_type>(pins_.size()), static_cast<size_type>(timers_.size()));
+		else
+			sendMessage(FmtDevInfo, cmd_devinfo_.key(), DeviceId,
+				board_traits<board_type>::board, board_traits<board_type>::mcu,
+				static_cast<unsigned>(board_traits<board_type>::clock_frequency / 1000000),
+				static_cast<size_type>(pins_.size()), static_cast<size_type>(timers_.size()));
 	}
 
 	void Jack::cmdDevReset()
 	{
-		sendMessage(KeyDevReset);	// Send reset ack to host.
+		if (binary())
+			sendFrame(OpDevReset);	// Send reset ack to host.
+		else
+			sendMessage(KeyDevReset);
+		connection_->coalesce(false);
+		eeprom_.flush();			// Finish writing any stored changes.
 		delay(50);					// Wait for Tx buf to empty.
 		resetFunc();				// Reset the device.
 	}
 
 	void Jack::cmdElapsedTime(uint8_t s)
 	{
-		sendMessage(FmtElapsedTime, KeyGetElapsedTime, s, elapsedTime(s));
+		if (binary())
+			sendFrame(OpGetElapsedTime, s, static_cast<uint32_t>(elapsedTime(s)));
+		else
+			sendMessage(FmtElapsedTime, KeyGetElapsedTime, s, elapsedTime(s));
 	}
 
 	void Jack::cmdLoadConfig()
@@ -578,6 +1009,23 @@ namespace pg
 				setPinMode(p, mode);
 	}
 
+	void Jack::cmdProtocolSet(uint8_t p)
+	{
+# if !defined __PG_NO_BINARY_PROTOCOL
+		if (p <= static_cast<uint8_t>(Connection::Protocol::Binary))
+		{
+			if (ack())	// Acknowledge in the current protocol, before switching.
+			{
+				if (binary())
+					sendFrame(OpSetProtocol, p);
+				else
+					sendMessage(FmtProtocol, KeySetProtocol, p);
+			}
+			connection_->protocol(static_cast<Connection::Protocol>(p));
+		}
+# endif
+	}
+
 	void Jack::cmdReadPin(pin_t p)
 	{
 		if (p < GpioCount)
@@ -586,8 +1034,28 @@ namespace pg
 
 	void Jack::cmdReadPinAll()
 	{
+		uint8_t bits[PinBitmapSize];
+
+		readPins(bits);
 		for (size_type p = 0; p < GpioCount; ++p)
-			sendPinValue(p, readPin(p));
+			sendPinValue(p, readsDigital(p) ? (bits[p >> 3] >> (p & 0x07)) & 0x01 : readPin(p));
+	}
+
+	void Jack::cmdReadPinBitmap()
+	{
+		uint8_t bits[PinBitmapSize];
+
+		readPins(bits);
+		if (binary())
+			(void)connection_->send(OpReadPinBitmap, bits, sizeof(bits));
+		else
+		{
+			char hex[PinBitmapSize * 2 + 1] = { '\0' };
+
+			for (size_type i = 0; i < PinBitmapSize; ++i)
+				(void)pg::format(hex + i * 2, FmtPinBitmapByte, bits[i]);
+			sendMessage(FmtReadPinBitmap, KeyReadPinBitmap, static_cast<const char*>(hex));
+		}
 	}
 
 	void Jack::cmdReadPinList(char* list)
@@ -598,6 +1066,148 @@ namespace pg
 				sendPinValue(p, readPin(p));
 	}
 
+	void Jack::cmdSubscribePins(char* list, uint32_t period, value_type deadband)
+	{
+		makeList(list, GpioCount);
+		subscribe(pin_subs_, GpioCount, period, deadband);
+		for (size_type i = 0; i < pin_subs_.size_; ++i)	// Publish initial values.
+			sendPinValue(pin_subs_.items_[i], pin_subs_.values_[i] = readPin(pin_subs_.items_[i]));
+	}
+
+	void Jack::cmdSubscribeTimers(char* list, uint32_t period, value_type deadband)
+	{
+		makeList(list, TimersCount);
+		subscribe(timer_subs_, TimersCount, period, deadband);
+		for (size_type i = 0; i < timer_subs_.size_; ++i)	// Publish initial status.
+		{
+			timer_t t = timer_subs_.items_[i];
+
+			timer_subs_.values_[i] = timerStatus(t, timer_subs_.active_[i]);
+			sendTimerStatus(t, timer_subs_.active_[i], timer_subs_.values_[i]);
+		}
+	}
+
+# if defined __PG_TASK_STATS
+	void Jack::cmdTaskStatsGet(uint8_t n)
+	{
+		if (n < task_stats_.size())
+		{
+			const TaskStats& stats = *task_stats_[n];
+
+			if (binary())
+				sendFrame(OpGetTaskStats, n, stats.runs_, stats.min_, stats.max_, stats.mean(), stats.late_, stats.overruns_);
+			else
+				sendMessage(FmtTaskStats, KeyGetTaskStats, n, 
+					static_cast<unsigned long>(stats.runs_), static_cast<unsigned long>(stats.min_), 
+					static_cast<unsigned long>(stats.max_), static_cast<unsigned long>(stats.mean()), 
+					static_cast<unsigned long>(stats.late_), static_cast<unsigned long>(stats.overruns_));
+		}
+	}
+
+# endif
+# if defined __PG_PROFILE
+	void Jack::cmdProfileGet(uint8_t n)
+	{
+		const ProfileEntry* entry = Profiler::entry(n);
+
+		if (entry)
+		{
+			if (binary())
+				sendFrame(OpGetProfile, n, entry->name_, entry->calls_, entry->min_, entry->max_, entry->mean());
+			else
+				sendMessage(FmtProfile, KeyGetProfile, n, entry->name_,
+					static_cast<unsigned long>(entry->calls_), static_cast<unsigned long>(entry->min_),
+					static_cast<unsigned long>(entry->max_), static_cast<unsigned long>(entry->mean()));
+		}
+	}
+
+# endif
+# if defined __PG_SAMPLE_LOGGER
+	void Jack::cmdSampleLog(char* list, uint32_t period, uint8_t condition, value_type level, uint16_t pretrigger)
+	{
+		pin_t pins[SampleLogChannelsMax];
+		size_type n = 0;
+
+		makeList(list, GpioCount);
+		for (auto p : list_)
+			if (p < GpioCount && n < SampleLogChannelsMax)
+				pins[n++] = p;
+		if (logger_.configure(pins, pins + n, period))
+		{
+#  if defined __PG_HAS_HW_TIMER
+			logger_.trigger(SampleLog::Trigger::Interrupt);
+#  endif
+			logger_.arm(static_cast<SampleLog::Condition>(condition), level, pretrigger);
+		}
+		if (ack())
+			cmdSampleLogStatus();
+	}
+
+	void Jack::cmdSampleLogData(uint16_t first, uint16_t count)
+	{
+		// Sends frames [first, first + count), or all frames from first if count is 0, 
+		// packing as many whole frames as fit into each message or binary frame.
+		const SampleLog::size_type channels = logger_.channels(), frames = logger_.frames();
+		const std::size_t values = binary() 
+			? (Connection::frameArgsMax() - sizeof(uint16_t)) / sizeof(value_type) 
+			: SampleLogHexMax / 4;
+		const uint16_t per = channels && values > channels ? static_cast<uint16_t>(values / channels) : 1;
+		const uint16_t last = count && count < frames - first ? first + count : frames;
+
+		for (uint16_t f = first; f < last; f += per)
+		{
+			const uint16_t end = last - f < per ? last : f + per;
+
+			if (binary())
+			{
+				uint8_t buf[Connection::frameArgsMax()];
+				uint8_t* ptr = buf;
+
+				*ptr++ = static_cast<uint8_t>(f);
+				*ptr++ = static_cast<uint8_t>(f >> 8);
+				for (uint16_t i = f; i < end; ++i)
+					for (SampleLog::size_type c = 0; c < channels; ++c)
+					{
+						const value_type v = logger_.sample(i, c);
+
+						*ptr++ = static_cast<uint8_t>(v);
+						*ptr++ = static_cast<uint8_t>(v >> 8);
+					}
+				(void)connection_->send(OpSampleLogData, buf, ptr - buf);
+			}
+			else
+			{
+				char hex[SampleLogHexMax + 1] = { '\0' };
+				char* ptr = hex;
+
+				for (uint16_t i = f; i < end; ++i)
+					for (SampleLog::size_type c = 0; c < channels; ++c)
+						ptr += pg::format(ptr, FmtSampleHex, logger_.sample(i, c));
+				sendMessage(FmtSampleLogData, KeySampleLogData, f, static_cast<const char*>(hex));
+			}
+		}
+	}
+
+	void Jack::cmdSampleLogFire()
+	{
+		logger_.fire();
+		if (ack())
+			cmdSampleLogStatus();
+	}
+
+	void Jack::cmdSampleLogStatus()
+	{
+		const uint8_t state = static_cast<uint8_t>(logger_.state());
+
+		if (binary())
+			sendFrame(OpSampleLogStatus, state, static_cast<uint8_t>(logger_.channels()), logger_.frames(), 
+				logger_.triggerFrame(), logger_.period(), logger_.overruns());
+		else
+			sendMessage(FmtSampleLogStatus, KeySampleLogStatus, state, logger_.channels(), logger_.frames(), 
+				logger_.triggerFrame(), static_cast<unsigned long>(logger_.period()), static_cast<unsigned long>(logger_.overruns()));
+	}
+
+# endif
 	void Jack::cmdTimerAttachGet(timer_t t)
 	{
 		if (t < TimersCount)
@@ -623,22 +1233,33 @@ namespace pg
 		// Hardware interrupts have frequency limits. Triggering interrupts faster than they can be 
 		// handled will cause them to become unresponsive.
 		
+		// Capture mode timers use the capture unit instead of interrupts and can't be operated manually.
+		const bool capture = mode == timer_mode::Capture;
+
 		// If t & p are valid, ...
-		if (t < TimersCount && ((p < GpioCount && pins_[p].isAvailable() && pins_[p].hasInterrupt()) || p == InvalidPin))
+		if (t < TimersCount && ((p < GpioCount && pins_[p].isAvailable() && (capture ? isCapturePin(p) : pins_[p].hasInterrupt())) || 
+			(p == InvalidPin && !capture)))
 		{
 			// If timer attached to another pin, detach it first.
 			if (timers_[t].isAttached())
 				detachTimer(t, false);
-			// If not manual operation, detach any other timer attached to same pin and attach to pin to interrupt.
+			// If not manual operation, detach any other timer attached to same pin or capture unit and attach to pin to interrupt.
 			if (p != InvalidPin)
 			{
 				for(size_type i = 0; i < TimersCount; ++i)
-					if (timers_[i].pin_ == p)
+					if (timers_[i].pin_ == p || (capture && timers_[i].isAttached() && timers_[i].mode_ == timer_mode::Capture))
 						detachTimer(i, false);
-				// Using trigger LOW and floating input may cause attachInterrupt() to not return, so set as pullup.
-				if (trigger == LOW && pins_[p].mode_ != gpio_mode::Pullup)
-					setPinMode(p, gpio_mode::Pullup);
-				attachInterrupt(digitalPinToInterrupt(p), getIsr(t), static_cast<PinStatus>(trigger));
+# if defined __PG_HAS_HW_CAPTURE
+				if (capture)
+					(void)hw_capture::begin(p, trigger == FALLING);
+				else
+# endif
+				{
+					// Using trigger LOW and floating input may cause attachInterrupt() to not return, so set as pullup.
+					if (trigger == LOW && pins_[p].mode_ != gpio_mode::Pullup)
+						setPinMode(p, gpio_mode::Pullup);
+					attachInterrupt(digitalPinToInterrupt(p), getIsr(t), static_cast<PinStatus>(trigger));
+				}
 			}
 			// Attach timer to pin, p == InvalidPin allows user to operate timer manually with commands.
 			attachTimer(t, p, mode, trigger, timing, instant);
@@ -673,8 +1294,19 @@ namespace pg
 
 	void Jack::cmdTimerStatusGetAll()
 	{
+		// Snapshots every timer in one pass, before any replies slow the read down.
+		bool active[TimersCount];
+		uint32_t values[TimersCount];
+		uint8_t seq;
+
+		do
+		{
+			seq = timersReadBegin();
+			for (size_type t = 0; t < TimersCount; ++t)
+				values[t] = readTimerStatus(t, active[t]);
+		} while (timersReadRetry(seq));
 		for (size_type t = 0; t < TimersCount; ++t)
-			sendTimerStatus(t);
+			sendTimerStatus(t, active[t], values[t]);
 	}
 
 	void Jack::cmdTimerStatusSet(timer_t t, uint8_t action)
@@ -689,6 +1321,18 @@ namespace pg
 			setTimerStatus(t, static_cast<timer_action>(action));
 	}
 
+	void Jack::cmdUnsubscribe()
+	{
+		pin_subs_.size_ = timer_subs_.size_ = 0;
+		if (ack())
+		{
+			if (binary())
+				sendFrame(OpUnsubscribe);
+			else
+				sendMessage(KeyUnsubscribe);
+		}
+	}
+
 	void Jack::cmdWritePin(pin_t p, value_type value)
 	{
 		if (p < GpioCount)
@@ -710,6 +1354,10 @@ namespace pg
 		char params_buf[Connection::size()] = { '\0' };
 		bool use_dflt = powerOnDefaults(p);
 
+# if defined __PG_EEPROM_JOURNAL
+		eeprom_.journal(&journal_);
+		(void)journal_.begin();	// Invalid journals fail the DeviceId check below.
+# endif
 		eeprom_ << EEStream::update(); // Stay Home, Save Lives, Protect the EEPROM.
 # if defined __PG_FORMAT_EEPROM
 		invalidateEeprom(eeprom_); // Reinitialize eeprom. 
@@ -723,6 +1371,12 @@ namespace pg
 		else
 			connection_ = loadConnection(eeprom_, params_buf);
 		setConnection(connection_);
+# if defined __PG_PROGRAM_H
+		bool autorun = false;
+
+		if (!use_dflt && loadProgram(eeprom_, autorun) && autorun)
+			program_.run();	// Resume the stored program.
+# endif
 	}
 
 	void Jack::isrHandler(timer_t t)
@@ -731,6 +1385,8 @@ namespace pg
 		// in response to hardware interrupts.
 		TimerCounter& timer = timers_[t];
 
+		timers_seq_ = timers_seq_ + 1;		// Odd while the timer is updated.
+		__asm__ __volatile__("" ::: "memory");
 		if (timer.enabled_)
 		{
 			switch (timer.mode_)
@@ -753,8 +1409,26 @@ namespace pg
 				break;
 			}
 		}
+		__asm__ __volatile__("" ::: "memory");
+		timers_seq_ = timers_seq_ + 1;
 	}
 
+# if defined __PG_TASK_STATS
+	template<class Scheduler>
+	void Jack::monitor(const Scheduler& scheduler)
+	{
+		// Task statistics are read by index, in the scheduler's current task order.
+		task_stats_.resize(0);
+		for (auto task : scheduler.tasks())
+		{
+			if (task_stats_.size() == TaskStatsMaxCount)
+				break;
+			task_stats_.resize(task_stats_.size() + 1);
+			task_stats_[task_stats_.size() - 1] = &task->stats();
+		}
+	}
+
+# endif
 #pragma endregion
 #pragma region private methods
 
@@ -767,6 +1441,81 @@ namespace pg
 		std::copy(first, last, end);
 	}
 
+	bool Jack::ack() const
+	{
+		return connection_ && connection_->session().ack;	// Each client sets its own acknowledge flag.
+	}
+
+	bool Jack::binary() const
+	{
+# if !defined __PG_NO_BINARY_PROTOCOL
+		return connection_->protocol() == Connection::Protocol::Binary;
+# else
+		return false;
+# endif
+	}
+
+# if !defined __PG_NO_BATCH
+	void Jack::batch(char* msg)
+	{
+		// Batched commands are executed in order, with their replies combined by sendMessage().
+
+		char* next = std::strpbrk(msg, BatchDelimiterChars);
+
+		if (next)
+		{
+			char replies[Connection::size()] = { '\0' };
+
+			batch_ = replies;
+			batch_size_ = 0;
+			for (; msg; msg = next)
+			{
+				if ((next = std::strpbrk(msg, BatchDelimiterChars)))
+				{
+					*next++ = '\0';
+					if (!*next)
+						next = nullptr;	// Ignore an empty last command, a trailing delimiter.
+				}
+				batch_replied_ = false;
+				if (!execute(msg))
+					batchReply(BatchErrorChars);
+				if (next)
+				{
+					batch_replied_ = false;
+					batchReply(BatchDelimiterChars);
+				}
+			}
+			batchFlush();
+			batch_ = nullptr;
+		}
+		else
+			(void)execute(msg);
+	}
+
+	void Jack::batchFlush()
+	{
+		if (batch_size_ && connection_)
+			sendReply(batch_);
+		batch_size_ = 0;
+		*batch_ = '\0';
+	}
+
+	void Jack::batchReply(const char* reply)
+	{
+		// Replies that don't fit, with room for a check value, are sent in the next message.
+
+		const Connection::size_type size = std::strlen(reply);
+
+		if (batch_size_ + size + sizeof(":255") > Connection::size())
+			batchFlush();
+		if (batch_replied_ && batch_size_)
+			batch_[batch_size_++] = *BatchReplyDelimiterChars;
+		std::strcpy(batch_ + batch_size_, reply);
+		batch_size_ += size;
+		batch_replied_ = true;
+	}
+
+# endif
 	void Jack::attachTimer(timer_t t, pin_t p, uint8_t mode, uint8_t trigger, uint8_t timing, bool instant)
 	{
 		TimerCounter& timer = timers_[t];
@@ -774,10 +1523,10 @@ namespace pg
 		timer.pin_ = p;
 		timer.mode_ = static_cast<timer_mode>(mode);
 		timer.trigger_ = static_cast<PinStatus>(trigger);
-		timer.timing_ = timer.pin_ == InvalidPin || timer.mode_ == timer_mode::Counter ? timing_mode::Continuous : static_cast<timing_mode>(timing);
-		timer.instant_ = timer.pin_ == InvalidPin || timer.mode_ == timer_mode::Counter ? true : instant;
+		timer.timing_ = timer.pin_ == InvalidPin || timer.mode_ != timer_mode::Timer ? timing_mode::Continuous : static_cast<timing_mode>(timing);
+		timer.instant_ = timer.pin_ == InvalidPin || timer.mode_ != timer_mode::Timer ? true : instant;
 		timer.enabled_ = true;
-		if (ack_)
+		if (ack())
 			sendTimerInfo(t);
 	}
 
@@ -785,6 +1534,7 @@ namespace pg
 	{
 		if (connection)
 		{
+			connection->coalesce(false);	// Send any pending replies.
 			connection->close();
 			delete connection;
 			connection = nullptr;
@@ -792,14 +1542,159 @@ namespace pg
 		}
 	}
 
+	typename Jack::command_type* Jack::command(Opcode op)
+	{
+		// Maps binary protocol opcodes to their command objects.
+		command_type* cmd = nullptr;
+
+		switch (op)
+		{
+		case OpDevReset: cmd = &cmd_devreset_; break;
+		case OpDevInfo: cmd = &cmd_devinfo_; break;
+		case OpGetAck: cmd = &cmd_ackget_; break;
+		case OpSetAck: cmd = &cmd_ackset_; break;
+		case OpGetPinInfo: cmd = &cmd_pininfoget_; break;
+		case OpGetPinInfoAll: cmd = &cmd_pininfogetall_; break;
+		case OpGetPinMode: cmd = &cmd_pinmodeget_; break;
+		case OpGetPinModeAll: cmd = &cmd_pinmodegetall_; break;
+		case OpGetPinModeList: cmd = &cmd_pinmodegetlist_; break;
+		case OpSetPinMode: cmd = &cmd_pinmodeset_; break;
+		case OpSetPinModeAll: cmd = &cmd_pinmodesetall_; break;
+		case OpGetElapsedTime: cmd = &cmd_elapsed_; break;
+		case OpReadPin: cmd = &cmd_readpin_; break;
+		case OpReadPinAll: cmd = &cmd_readpinall_; break;
+		case OpReadPinList: cmd = &cmd_readpinlist_; break;
+		case OpReadPinBitmap: cmd = &cmd_readpinbitmap_; break;
+		case OpWritePin: cmd = &cmd_writepin_; break;
+		case OpGetTimerStatus: cmd = &cmd_timerstatusget_; break;
+		case OpGetTimerStatusAll: cmd = &cmd_timerstatusgetall_; break;
+		case OpGetTimerStatusList: cmd = &cmd_timerstatusgetlist_; break;
+		case OpSetTimerStatus: cmd = &cmd_timerstatusset_; break;
+		case OpTimerDetach: cmd = &cmd_timerdetach_; break;
+		case OpTimerGetAttach: cmd = &cmd_timerattachget_; break;
+		case OpTimerGetAttachAll: cmd = &cmd_timerattachgetall_; break;
+		case OpTimerGetAttachList: cmd = &cmd_timerattachgetlist_; break;
+		case OpTimerAttach: cmd = &cmd_timerattachset_; break;
+		case OpGetConnection: cmd = &cmd_connectionget_; break;
+		case OpSetConnection: cmd = &cmd_connectionset_; break;
+		case OpLoadConfig: cmd = &cmd_ldaconfig_; break;
+		case OpStoreConfig: cmd = &cmd_stoconfig_; break;
+		case OpSetTimerStatusAll: cmd = &cmd_timerstatussetall_; break;
+		case OpTimerDetachAll: cmd = &cmd_timerdetachall_; break;
+		case OpSetProtocol: cmd = &cmd_protocolset_; break;
+		case OpSubscribePins: cmd = &cmd_subscribepins_; break;
+		case OpSubscribeTimers: cmd = &cmd_subscribetimers_; break;
+		case OpUnsubscribe: cmd = &cmd_unsubscribe_; break;
+# if defined __PG_TASK_STATS
+		case OpGetTaskStats: cmd = &cmd_taskstatsget_; break;
+# endif
+# if defined __PG_PROFILE
+		case OpGetProfile: cmd = &cmd_profileget_; break;
+# endif
+# if defined __PG_SAMPLE_LOGGER
+		case OpSampleLog: cmd = &cmd_samplelog_; break;
+		case OpSampleLogFire: cmd = &cmd_samplelogfire_; break;
+		case OpSampleLogStatus: cmd = &cmd_samplelogstatus_; break;
+		case OpSampleLogData: cmd = &cmd_samplelogdata_; break;
+# endif
+# if defined __PG_PROGRAM_H
+		case OpProgram: cmd = &cmd_program_; break;
+		case OpGetProgramBudget: cmd = &cmd_programbudgetget_; break;
+		case OpSetProgramBudget: cmd = &cmd_programbudgetset_; break;
+# endif
+		default: break;
+		}
+
+		return cmd;
+	}
+
+	typename Jack::command_type* Jack::lookup(hash_type key)
+	{
+		// Resolves built-in command keys with a single switch on the packed key, 
+		// duplicate keys fail to compile. User commands are searched linearly.
+		command_type* cmd = nullptr;
+
+		switch (key)
+		{
+		case Interpreter::hash(KeyDevReset): cmd = &cmd_devreset_; break;
+		case Interpreter::hash(KeyDevInfo): cmd = &cmd_devinfo_; break;
+		case Interpreter::hash(KeyGetAck): cmd = &cmd_ackget_; break;
+		case Interpreter::hash(KeySetAck): cmd = &cmd_ackset_; break;
+		case Interpreter::hash(KeyGetPinInfo): cmd = &cmd_pininfoget_; break;
+		case Interpreter::hash(KeyGetPinInfoAll): cmd = &cmd_pininfogetall_; break;
+		case Interpreter::hash(KeyGetPinMode): cmd = &cmd_pinmodeget_; break;
+		case Interpreter::hash(KeyGetPinModeAll): cmd = &cmd_pinmodegetall_; break;
+		case Interpreter::hash(KeyGetPinModeList): cmd = &cmd_pinmodegetlist_; break;
+		case Interpreter::hash(KeySetPinMode): cmd = &cmd_pinmodeset_; break;
+		case Interpreter::hash(KeySetPinModeAll): cmd = &cmd_pinmodesetall_; break;
+		case Interpreter::hash(KeyGetElapsedTime): cmd = &cmd_elapsed_; break;
+		case Interpreter::hash(KeyReadPin): cmd = &cmd_readpin_; break;
+		case Interpreter::hash(KeyReadPinAll): cmd = &cmd_readpinall_; break;
+		case Interpreter::hash(KeyReadPinList): cmd = &cmd_readpinlist_; break;
+		case Interpreter::hash(KeyReadPinBitmap): cmd = &cmd_readpinbitmap_; break;
+		case Interpreter::hash(KeyWritePin): cmd = &cmd_writepin_; break;
+		case Interpreter::hash(KeyGetTimerStatus): cmd = &cmd_timerstatusget_; break;
+		case Interpreter::hash(KeyGetTimerStatusAll): cmd = &cmd_timerstatusgetall_; break;
+		case Interpreter::hash(KeyGetTimerStatusList): cmd = &cmd_timerstatusgetlist_; break;
+		case Interpreter::hash(KeySetTimerStatus): cmd = &cmd_timerstatusset_; break;
+		case Interpreter::hash(KeyTimerDetach): cmd = &cmd_timerdetach_; break;
+		case Interpreter::hash(KeyTimerGetAttach): cmd = &cmd_timerattachget_; break;
+		case Interpreter::hash(KeyTimerGetAttachAll): cmd = &cmd_timerattachgetall_; break;
+		case Interpreter::hash(KeyTimerGetAttachList): cmd = &cmd_timerattachgetlist_; break;
+		case Interpreter::hash(KeyTimerAttach): cmd = &cmd_timerattachset_; break;
+		case Interpreter::hash(KeyGetConnection): cmd = &cmd_connectionget_; break;
+		case Interpreter::hash(KeySetConnection): cmd = &cmd_connectionset_; break;
+		case Interpreter::hash(KeyLoadConfig): cmd = &cmd_ldaconfig_; break;
+		case Interpreter::hash(KeyStoreConfig): cmd = &cmd_stoconfig_; break;
+		case Interpreter::hash(KeySetTimerStatusAll): cmd = &cmd_timerstatussetall_; break;
+		case Interpreter::hash(KeyTimerDetachAll): cmd = &cmd_timerdetachall_; break;
+		case Interpreter::hash(KeySetProtocol): cmd = &cmd_protocolset_; break;
+		case Interpreter::hash(KeySubscribePins): cmd = &cmd_subscribepins_; break;
+		case Interpreter::hash(KeySubscribeTimers): cmd = &cmd_subscribetimers_; break;
+		case Interpreter::hash(KeyUnsubscribe): cmd = &cmd_unsubscribe_; break;
+# if defined __PG_TASK_STATS
+		case Interpreter::hash(KeyGetTaskStats): cmd = &cmd_taskstatsget_; break;
+# endif
+# if defined __PG_PROFILE
+		case Interpreter::hash(KeyGetProfile): cmd = &cmd_profileget_; break;
+# endif
+# if defined __PG_SAMPLE_LOGGER
+		case Interpreter::hash(KeySampleLog): cmd = &cmd_samplelog_; break;
+		case Interpreter::hash(KeySampleLogFire): cmd = &cmd_samplelogfire_; break;
+		case Interpreter::hash(KeySampleLogStatus): cmd = &cmd_samplelogstatus_; break;
+		case Interpreter::hash(KeySampleLogData): cmd = &cmd_samplelogdata_; break;
+# endif
+# if defined __PG_PROGRAM_H
+		case Interpreter::hash(KeyProgram): cmd = &cmd_program_; break;
+		case Interpreter::hash(KeyGetProgramBudget): cmd = &cmd_programbudgetget_; break;
+		case Interpreter::hash(KeySetProgramBudget): cmd = &cmd_programbudgetset_; break;
+# endif
+		default: 
+# if !defined __PG_NO_USR_COMMANDS
+			cmd = Interpreter::find(std::begin(commands_), std::end(commands_), key);
+# endif
+			break;
+		}
+
+		return cmd;
+	}
+
 	void Jack::detachTimer(timer_t t, bool ack)
 	{
 		TimerCounter& timer = timers_[t];
 
 		timer.object_.stop();
+# if defined __PG_HAS_HW_CAPTURE
+		if (timer.mode_ == timer_mode::Capture)
+		{
+			if (timer.isAttached())
+				hw_capture::end();
+		}
+		else
+# endif
 		detachInterrupt(digitalPinToInterrupt(timer.pin_));
 		timer.pin_ = InvalidPin;
-		if (ack_ && ack)
+		if (ack && this->ack())
 			sendTimerInfo(t);
 	}
 
@@ -820,7 +1715,12 @@ namespace pg
 		switch (s)
 		{
 		case 0:
+# if defined __PG_HW_CLOCK
+			elapsed = std::chrono::duration_cast<std::chrono::microseconds>(	// Hardware clock, compensated for sleep.
+				std::chrono::steady_clock::now().time_since_epoch()).count();
+# else
 			elapsed = micros();
+# endif
 			break;
 		case 1:
 			elapsed = millis();
@@ -838,10 +1738,19 @@ namespace pg
 		detachTimer(t);
 	}
 
+	bool Jack::execute(const char* msg)
+	{
+# if defined __PG_PROGRAM_H
+		return process(msg);		// Check for program control messages before executing command.
+# else 
+		return interp_.execute([this](hash_type key) { return lookup(key); }, msg);
+# endif
+	}
+
 	template<class... Ts>
 	Jack::size_type Jack::fmtMessage(char* buf, const char* fmt, Ts... args)
 	{
-		return std::sprintf(buf, fmt, args...);
+		return pg::format(buf, fmt, args...);
 	}
 
 	Jack::isr_type Jack::getIsr(timer_t n)
@@ -849,17 +1758,22 @@ namespace pg
 		return isrs_[n];
 	}
 
+	bool Jack::isCapturePin(pin_t p)
+	{
+# if defined __PG_HAS_HW_CAPTURE
+		return hw_capture::isPin(p);
+# else
+		return false;
+# endif
+	}
+
 	void Jack::initialize(cmdlist_type& user_cmds)
 	{
 		// This method appends any client-defined commands to the built-in collection.
 # if !defined __PG_NO_USR_COMMANDS
 		addCommands(commands_, user_cmds.begin(), user_cmds.end());
 # endif
-		// Command keys must be unique, uncomment this if you need to check:
-		//assert(std::unique(std::begin(commands_), std::end(commands_)) == std::end(commands_));
-		
-		// Interpreter uses binary search algo, collections must be sorted.
-		std::sort(std::begin(commands_), std::end(commands_), cbcomp);
+		// Built-in commands are resolved by lookup(), user command keys must not collide with them.
 	}
 
 	template<typename Jack::size_type I>
@@ -999,29 +1913,18 @@ namespace pg
 
 	void Jack::loadConfig(EEStream& eeprom, Pins& pins, Timers& timers)
 	{
+		// Pin and timer configurations are each read as one block.
+
+		uint8_t modes[GpioCount] = { 0 };
+		uint8_t attach[TimersCount][TimerConfigSize] = { { 0 } };	// pin, mode, trigger, timing, instant
+
 		eeprom.address() = ConfigurationEepromAddress;
+		eeprom >> modes;
+		eeprom >> attach;
 		for (size_type i = 0; i < GpioCount; ++i)
-		{
-			uint8_t mode = 0;
-
-			eeprom >> mode;
-			cmdPinModeSet(i, mode);
-		}
+			cmdPinModeSet(i, modes[i]);
 		for (size_type i = 0; i < TimersCount; ++i)
-		{
-			uint8_t pin = InvalidPin;
-			uint8_t mode = 0;
-			uint8_t trigger = 0;
-			uint8_t timing = 0;
-			bool instant = false;
-
-			eeprom >> pin;
-			eeprom >> mode;
-			eeprom >> trigger;
-			eeprom >> timing; 
-			eeprom >> instant;
-			cmdTimerAttachSet(i, pin, mode, trigger, timing, instant);
-		}
+			cmdTimerAttachSet(i, attach[i][0], attach[i][1], attach[i][2], attach[i][3], attach[i][4] != 0);
 	}
 
 	Connection* Jack::loadConnection(EEStream& eeprom, char* params)
@@ -1055,6 +1958,8 @@ namespace pg
 		default:
 			break;
 		}
+		if (!connection_->open())
+			digitalWrite(pg::LedPinNumber, false);	// Link lost, reconnecting from clock().
 	}
 
 	void Jack::makeList(char* list, uint8_t last)
@@ -1069,18 +1974,21 @@ namespace pg
 		list_.resize(0);
 		while (tok && list_.size() < ListSize)
 		{
-			pin_t from = std::atoi(tok), to = from;
+			pin_t from = 0, to;
 			char* range = std::strchr(tok, '-');
 
 			if (range)
-			{
 				*range = '\0';
-				to = *++range ? std::atoi(range) : ListSize;
-			}
+			(void)std::from_chars(tok, tok + std::strlen(tok), from);
+			to = from;
+			if (range && !*++range)
+				to = ListSize;
+			else if (range)
+				(void)std::from_chars(range, range + std::strlen(range), to);
 			for (; from <= to && list_.size() < ListSize; ++from)
 			{
-				list_[list_.size()] = from;
 				list_.resize(list_.size() + 1);
+				list_[list_.size() - 1] = from;
 			}
 			tok = std::strtok(nullptr, ListDelimiterChars);
 		}
@@ -1108,6 +2016,10 @@ namespace pg
 		default:
 			break;
 		}
+# if defined __PG_ASYNC_CONNECTION
+		if (connection)
+			connection = new pg::AsyncConnection<>(connection);	// Replies no longer block the loop.
+# endif
 
 		return connection;
 	}
@@ -1125,6 +2037,54 @@ namespace pg
 		return result;
 	}
 
+	void Jack::publish()
+	{
+		// Pushes subscribed values that changed by more than the deadband, and all 
+		// of them whenever the subscription period elapses. Running timers change 
+		// every pass, so their values are only pushed on a non-zero deadband, 
+		// while starts and stops are always pushed.
+		if (pin_subs_.size_)
+		{
+			bool all = pin_subs_.period_.active() && pin_subs_.period_.expired();
+
+			connection_->session(pin_subs_.session_);	// Pushes to the subscribing client.
+
+			for (size_type i = 0; i < pin_subs_.size_; ++i)
+			{
+				pin_t p = pin_subs_.items_[i];
+				value_type value = readPin(p), last = pin_subs_.values_[i];
+
+				if (all || (value > last ? value - last : last - value) > pin_subs_.deadband_)
+					sendPinValue(p, pin_subs_.values_[i] = value);
+			}
+			if (all)
+				pin_subs_.period_.start();
+		}
+		if (timer_subs_.size_)
+		{
+			bool all = timer_subs_.period_.active() && timer_subs_.period_.expired();
+
+			connection_->session(timer_subs_.session_);
+
+			for (size_type i = 0; i < timer_subs_.size_; ++i)
+			{
+				timer_t t = timer_subs_.items_[i];
+				bool active;
+				uint32_t value = timerStatus(t, active), last = timer_subs_.values_[i];
+				uint32_t delta = value > last ? value - last : last - value;
+
+				if (all || active != timer_subs_.active_[i] || 
+					(active ? timer_subs_.deadband_ && delta > timer_subs_.deadband_ : delta))
+				{
+					timer_subs_.active_[i] = active;
+					sendTimerStatus(t, active, timer_subs_.values_[i] = value);
+				}
+			}
+			if (all)
+				timer_subs_.period_.start();
+		}
+	}
+
 	typename Jack::value_type Jack::readPin(pin_t p)
 	{
 		GpioPin& pin = pins_[p];
@@ -1152,51 +2112,217 @@ namespace pg
 		return value;
 	}
 
+	void Jack::readPins(uint8_t* bits)
+	{
+		std::memset(bits, 0, PinBitmapSize);
+# if defined __AVR__
+		uint8_t ports[PortsMaxCount];	// Port input register snapshots.
+		uint16_t read = 0;				// Bitmask of snapshot ports.
+		const uint8_t sreg = SREG;
+
+		cli();	// Read every port once, so that all pins are sampled at the same time.
+		for (size_type p = 0; p < GpioCount; ++p)
+		{
+			const uint8_t port = digitalPinToPort(p);
+
+			if (port != NOT_A_PIN && port < PortsMaxCount && !(read & (1U << port)))
+			{
+				ports[port] = *portInputRegister(port);
+				read |= (1U << port);
+			}
+		}
+		SREG = sreg;
+		for (size_type p = 0; p < GpioCount; ++p)
+		{
+			const uint8_t port = digitalPinToPort(p);
+
+			if (readsDigital(p) && port != NOT_A_PIN && port < PortsMaxCount && (ports[port] & digitalPinToBitMask(p)))
+				bits[p >> 3] |= (1 << (p & 0x07));
+		}
+# else
+		for (size_type p = 0; p < GpioCount; ++p)
+			if (readsDigital(p) && digitalRead(p))
+				bits[p >> 3] |= (1 << (p & 0x07));
+# endif
+	}
+
+	bool Jack::readsDigital(pin_t p) const
+	{
+		const GpioPin& pin = pins_[p];
+
+		return pin.isAvailable() && (pin.type_ == gpio_type::Digital || 
+			(pin.type_ == gpio_type::Pwm && pin.mode_ != gpio_mode::PwmOut));
+	}
+
+	void Jack::receiveFrames()
+	{
+		// Binary frames are dispatched straight to their command objects, 
+		// program loading and text checksums only apply to text messages.
+		Connection::Frame frame;
+
+		while (connection_->receive(frame))
+		{
+			command_type* cmd = command(static_cast<Opcode>(frame.opcode));
+			
+			if (cmd && cmd->assemble(frame.args, frame.size))
+				cmd->execute();
+		}
+	}
+
+	void Jack::receiveMessages()
+	{
+		const char* msg;
+
+		while (*(msg = connection_->receive()))
+# if !defined __PG_NO_CHECKSUM
+			if (check(const_cast<char*>(msg))) // Look for trailing check value and compare to checksum.
+# endif
+# if !defined __PG_NO_BATCH
+				batch(const_cast<char*>(msg));
+# else
+				(void)execute(msg);
+# endif
+	}
+
+	template<class... Ts>
+	void Jack::sendFrame(Opcode op, Ts... args)
+	{
+		uint8_t buf[Connection::frameArgsMax()];
+
+		connection_->send(op, buf, Interpreter::pack(buf, sizeof(buf), args...));
+	}
+
 	template<class... Ts>
 	void Jack::sendMessage(const char* fmt, Ts... args)
 	{
 		char msg[Connection::size()] = { '\0' };
 
 		(void)fmtMessage(msg, fmt, args...);
-# if defined __PG_CRC_H
-		if (checksum_)	// If we received a msg with a checksum then set our reply flag.
-			(void)fmtMessage(msg + std::strlen(msg), FmtChecksum, checksum(static_cast<char*>(msg)));
+# if !defined __PG_NO_BATCH
+		if (batch_)
+			batchReply(msg);	// Combine the replies of batched commands.
+		else
 # endif
-		connection_->send(msg);
+			sendReply(msg);
 	}
 
 	void Jack::sendPinInfo(pin_t n)
 	{
 		const GpioPin& pin = pins_[n];
 
-		sendMessage(FmtPinInfo, KeyGetPinInfo, n, pin.type_, pin.int_, pin.mode_);
+		if (binary())
+			sendFrame(OpGetPinInfo, n, static_cast<uint8_t>(pin.type_), pin.int_, static_cast<uint8_t>(pin.mode_));
+		else
+			sendMessage(FmtPinInfo, KeyGetPinInfo, n, pin.type_, pin.int_, pin.mode_);
 	}
 
 	void Jack::sendPinMode(pin_t n)
 	{
 		const GpioPin& pin = pins_[n];
 
-		sendMessage(FmtPinMode, KeyGetPinMode, n, pin.mode_);
+		if (binary())
+			sendFrame(OpGetPinMode, n, static_cast<uint8_t>(pin.mode_));
+		else
+			sendMessage(FmtPinMode, KeyGetPinMode, n, pin.mode_);
 	}
 
 	void Jack::sendPinValue(pin_t n, value_type value)
 	{
-		sendMessage(FmtReadPin, n, value);
+		if (binary())
+			sendFrame(OpReadPin, n, value);
+		else
+			sendMessage(FmtReadPin, n, value);
+	}
+
+	void Jack::sendReply(char* msg)
+	{
+# if !defined __PG_NO_CHECKSUM
+		if (connection_->session().checksum)	// If we received a msg with a checksum then set our reply flag.
+			(void)fmtMessage(msg + std::strlen(msg), FmtChecksum, checksum(static_cast<char*>(msg)));
+# endif
+		connection_->send(msg);
 	}
 
 	void Jack::sendTimerInfo(timer_t n)
 	{
 		const TimerCounter& timer = timers_[n];
 
-		sendMessage(FmtTimerAttach, KeyTimerAttach, n, timer.pin_, timer.mode_, timer.trigger_, timer.timing_, timer.instant_);
+		if (binary())
+			sendFrame(OpTimerAttach, n, timer.pin_, static_cast<uint8_t>(timer.mode_), static_cast<uint8_t>(timer.trigger_), 
+				static_cast<uint8_t>(timer.timing_), timer.instant_);
+		else
+			sendMessage(FmtTimerAttach, KeyTimerAttach, n, timer.pin_, timer.mode_, timer.trigger_, timer.timing_, timer.instant_);
 	}
 
 	void Jack::sendTimerStatus(timer_t n)
 	{
-		TimerCounter& timer = timers_[n];
 		bool active = false;
-		unsigned long value = 0;
+		uint32_t value = timerStatus(n, active);
+
+		sendTimerStatus(n, active, value);
+	}
 
+	void Jack::sendTimerStatus(timer_t n, bool active, uint32_t value)
+	{
+		if (binary())
+			sendFrame(OpGetTimerStatus, n, active, static_cast<uint32_t>(value));
+		else
+			sendMessage(FmtTimerStatus, KeyGetTimerStatus, n, active, static_cast<unsigned long>(value));
+	}
+
+	void Jack::subscribe(Subscription& subs, uint8_t last, uint32_t period, value_type deadband)
+	{
+		// Replaces a subscription with the valid indexes in list_.
+		subs.session_ = connection_->sessionIndex();
+		subs.size_ = 0;
+		for (auto i : list_)
+			if (i < last && subs.size_ < SubscriptionsMaxCount)
+				subs.items_[subs.size_++] = i;
+		subs.deadband_ = deadband;
+		if (period)
+			subs.period_.start(std::chrono::milliseconds(period));
+		else
+			subs.period_.stop();
+	}
+
+	uint32_t Jack::timerStatus(timer_t n, bool& active)
+	{
+		uint32_t value;
+		uint8_t seq;
+
+		do
+		{
+			seq = timersReadBegin();
+			value = readTimerStatus(n, active);
+		} while (timersReadRetry(seq));
+
+		return value;
+	}
+
+	uint8_t Jack::timersReadBegin() const
+	{
+		uint8_t seq;
+
+		while ((seq = timers_seq_) & 1)
+			;	// isrHandler() is updating a timer concurrently.
+		__asm__ __volatile__("" ::: "memory");
+
+		return seq;
+	}
+
+	bool Jack::timersReadRetry(uint8_t seq) const
+	{
+		__asm__ __volatile__("" ::: "memory");
+
+		return timers_seq_ != seq;	// isrHandler() ran during the read.
+	}
+
+	uint32_t Jack::readTimerStatus(timer_t n, bool& active)
+	{
+		TimerCounter& timer = timers_[n];
+		uint32_t value = 0;
+
+		active = false;
 		switch (timer.mode_)
 		{
 		case timer_mode::Counter:
@@ -1207,10 +2333,20 @@ namespace pg
 			active = timer.object_.active(timer_tag{});
 			value = timer.instant_ ? timer.object_.elapsed().count() : timer.value_;
 			break;
+# if defined __PG_HAS_HW_CAPTURE
+		case timer_mode::Capture:
+			if (timer.isAttached())
+			{
+				active = hw_capture::active();
+				value = hw_capture::nanoseconds(hw_capture::period());
+			}
+			break;
+# endif
 		default:
 			break;
 		}
-		sendMessage(FmtTimerStatus, KeyGetTimerStatus, n, active, value);
+
+		return value;
 	}
 
 	void Jack::setConnection(Connection* connection)
@@ -1228,7 +2364,7 @@ namespace pg
 			// If pin attached to interrupt w/ active LOW trigger it should only be used in pullup mode.  
 			pinMode(p, mode);
 			pin.mode_ = static_cast<gpio_mode>(mode);
-			if (ack_)
+			if (ack())
 				sendPinMode(p);
 		}
 	}
@@ -1279,26 +2415,56 @@ namespace pg
 				break;
 			}
 			break;
+# if defined __PG_HAS_HW_CAPTURE
+		case timer_mode::Capture:
+			if (timer.isAttached())
+			{
+				switch (action)
+				{
+				case timer_action::Start:
+				case timer_action::Resume:
+					(void)hw_capture::begin(timer.pin_, timer.trigger_ == FALLING);
+					break;
+				case timer_action::Stop:
+					hw_capture::end();
+					break;
+				case timer_action::Reset:
+					hw_capture::reset();
+					break;
+				default:
+					break;
+				}
+			}
+			break;
+# endif
 		default:
 			break;
 		}
-		if (ack_)
+		if (ack())
 			sendTimerStatus(t);
 	}
 
 	void Jack::storeConfig(EEStream& eeprom, const Jack::Pins& pins, const Jack::Timers& timers)
 	{
-		eeprom.address() = ConfigurationEepromAddress;
-		for (auto& pin : pins)
-			eeprom << static_cast<uint8_t>(pin.mode_);
-		for (auto& timer : timers)
+		// Pin and timer configurations are each written as one block.
+
+		uint8_t modes[GpioCount];
+		uint8_t attach[TimersCount][TimerConfigSize];	// pin, mode, trigger, timing, instant
+
+		for (size_type i = 0; i < GpioCount; ++i)
+			modes[i] = static_cast<uint8_t>(pins[i].mode_);
+		for (size_type i = 0; i < TimersCount; ++i)
 		{
-			eeprom << timer.pin_;
-			eeprom << static_cast<uint8_t>(timer.mode_);
-			eeprom << static_cast<uint8_t>(timer.trigger_);
-			eeprom << static_cast<uint8_t>(timer.timing_);
-			eeprom << static_cast<bool>(timer.instant_);
+			attach[i][0] = timers[i].pin_;
+			attach[i][1] = static_cast<uint8_t>(timers[i].mode_);
+			attach[i][2] = static_cast<uint8_t>(timers[i].trigger_);
+			attach[i][3] = static_cast<uint8_t>(timers[i].timing_);
+			attach[i][4] = static_cast<uint8_t>(timers[i].instant_);
 		}
+		eeprom.address() = ConfigurationEepromAddress;
+		eeprom << modes;
+		eeprom << attach;
+		eeprom.commit();
 	}
 
 	void Jack::storeConnection(EEStream& eeprom, connection_type type, const char* params)
@@ -1306,6 +2472,7 @@ namespace pg
 		eeprom.address() = ConnectionEepromAddress;
 		eeprom << static_cast<uint8_t>(type);
 		eeprom << params;
+		eeprom.commit();
 	}
 
 	void Jack::writePin(pin_t n, value_type value)
@@ -1335,18 +2502,21 @@ namespace pg
 			default:
 				break;
 			}
-			if (ack_)
+			if (ack())
 				sendPinValue(n, write_value);
 		}
 	}
-# if defined __PG_CRC_H
+# if !defined __PG_NO_CHECKSUM
 	bool Jack::check(char* msg)
 	{
 		(void)std::strtok(msg, CheckSumDelimiterChars); // look for msg w/ trailing ":", 
 		char* chk_val = std::strtok(nullptr, CheckSumDelimiterChars); // followed by a check value. 
-		checksum_ = chk_val;	// set our checksum reply flag.
+		connection_->session().checksum = chk_val;	// set our checksum reply flag.
 		// result is either no check value found or check value == checksum().
-		return !chk_val || checksum(msg) == static_cast<unsigned char>(std::atoi(chk_val));
+		unsigned char chk = 0;
+
+		return !chk_val || (std::from_chars(chk_val, chk_val + std::strlen(chk_val), chk).ec == std::errc() && 
+			checksum(msg) == chk);
 	}
 # endif
 # if defined __PG_PROGRAM_H
@@ -1357,26 +2527,53 @@ namespace pg
 
 		while (*text)
 		{
-			connection_->send(text);
+			if (binary())
+				sendFrame(OpProgram, static_cast<uint8_t>(Program::Action::List), text);
+			else
+				sendMessage(FmtProgramLine, text);	// Combined with any batched replies.
 			text += program_.next(text);
 		}
 	}
 
-	void Jack::process(const char* msg)
+	bool Jack::loadProgram(EEStream& eeprom, bool& autorun)
+	{
+		// The stored program is outside of the journal, if any.
+
+		EEJournal* journal = eeprom.journal();
+
+		eeprom.journal(nullptr);
+		eeprom.address() = ProgramEepromAddress;
+
+		bool result = ProgramEepromSize && program_.load(eeprom, autorun);
+
+		eeprom.journal(journal);
+
+		return result;
+	}
+
+	bool Jack::process(const char* msg)
 	{
 		// Message processor only executes remote commands, not program instructions.
-		command_type* cmd = static_cast<command_type*>(interp_.interpret(std::begin(commands_), std::end(commands_), msg));
+		command_type* cmd = static_cast<command_type*>(interp_.interpret([this](hash_type key) { return lookup(key); }, msg));
+		bool result = cmd != nullptr;
 
 		// When loading a program, execute any program control commands else forward message to program for storage.
 		if (program_.loading())
 		{
-			if (cmd && *cmd == KeyProgram)
+			if (cmd == &cmd_program_)
 				cmd->execute();
 			else
+			{
+				interp_.restore();	// Store the original message text.
 				program_.instruction(msg);
+				result = true;
+			}
 		}
 		else if (cmd)
 			cmd->execute();
+		interp_.restore();
+
+		return result;
 	}
 
 	void Jack::program(uint8_t a)
@@ -1386,6 +2583,7 @@ namespace pg
 		Program::Action action = static_cast<Program::Action>(a);
 		bool send = false;
 		bool invalid = false;
+		bool overflow = false;
 		value_type status = 0;
 
 		switch (action)
@@ -1403,6 +2601,7 @@ namespace pg
 			program_.end();
 			action = Program::Action::Size;
 			status = program_.size();
+			overflow = program_.overflow();
 			break;
 		case Program::Action::Halt:
 			program_.halt();
@@ -1428,25 +2627,80 @@ namespace pg
 			status = verify();
 			send = true;
 			break;
+		case Program::Action::Store:
+		case Program::Action::Autorun:
+			status = storeProgram(eeprom_, action == Program::Action::Autorun);
+			send = true;
+			break;
+		case Program::Action::Load:
+		{
+			bool autorun = false;
+
+			status = loadProgram(eeprom_, autorun);
+			overflow = status && program_.overflow();
+			send = true;
+			break;
+		}
 		default:
 			invalid = true;
 			break;
 		}
-		if (!invalid && (ack_ || send))
+		if (overflow)
+		{
+			action = Program::Action::TooLong;	// Always reported, the program can't run.
+			status = Program::CodeMax;
+			send = true;
+		}
+		if (!invalid && (ack() || send))
 			sendProgramStatus(action, status);
 	}
 
+	void Jack::programBudgetGet()
+	{
+		if (binary())
+			sendFrame(OpGetProgramBudget, program_.steps(), program_.slice());
+		else
+			sendMessage(FmtProgramBudget, KeyGetProgramBudget, program_.steps(), program_.slice());
+	}
+
+	void Jack::programBudgetSet(Program::size_type steps, uint16_t slice)
+	{
+		program_.budget(steps, slice);
+		if (ack())
+			programBudgetGet();
+	}
+
 	void Jack::sendProgramStatus(Program::Action action, value_type status)
 	{
-		sendMessage(FmtProgramStatus, KeyProgram, action, status);
+		if (binary())
+			sendFrame(OpProgram, static_cast<uint8_t>(action), status);
+		else
+			sendMessage(FmtProgramStatus, KeyProgram, action, status);
 	}
 
-	iprogram::value_type Jack::sys_get(const char* str)
+	bool Jack::storeProgram(EEStream& eeprom, bool autorun)
+	{
+		// The stored program is outside of the journal, if any, and written immediately.
+
+		EEJournal* journal = eeprom.journal();
+
+		eeprom.journal(nullptr);
+		eeprom.address() = ProgramEepromAddress;
+
+		bool result = program_.store(eeprom, ProgramEepromSize, autorun);
+
+		if (result)
+			eeprom.commit();
+		eeprom.journal(journal);
+
+		return result;
+	}
+
+	iprogram::value_type Jack::sys_get(char call, iprogram::value_type n)
 	{
 		iprogram::value_type value = 0;
-		size_type n = std::atoi(str + 1);
 
-		switch (*str)
+		switch (call)
 		{
 		case '#':
 			value = readPin(n);
@@ -1464,7 +2718,6 @@ namespace pg
 			value = elapsedTime(n);
 			break;
 		default:
-			value = std::atol(str);
 			break;
 		}
 
@@ -1485,12 +2738,15 @@ namespace pg
 			{
 				while (*text)
 				{
-					if (!(interp_.interpret(std::begin(commands_), std::end(commands_), text) || 
-						interp_.interpret(std::begin(program_.instructions()), std::end(program_.instructions()), text)))
+					bool valid = interp_.interpret([this](hash_type key) { return lookup(key); }, text) ||
+						interp_.interpret([this](hash_type key) { return program_.lookup(key); }, text);
+
+					interp_.restore();
+					if (!valid)
 						break;
 					text += program_.next(text);
 				}
-				result = !(*text);	// Program is valid if end of text reached.
+				result = !(*text) && program_.resolved();	// Program is valid if end of text reached and all branches land in it.
 			}
 		}
 
@@ -34,8 +34,17 @@
  *		an lcd display device. It supports formatted printing and synchronous 
  *		or asynchronous operation. The display hardware is controlled via the 
  *		Arduino `LiquidCrystal' api.
- * 
- *		
+ *
+ *		The display keeps a shadow copy of the device contents (see 
+ *		<utilities/LCDFrame.h>) and each refresh only writes the characters 
+ *		that changed since the last one.
+ *
+ *		The `budget()' method bounds the number of bytes written to the 
+ *		device per refresh, so a redraw can never block the caller for long. 
+ *		Any remaining output is queued and written by later calls to 
+ *		`flush()' or `clock()', which only drains the queue while output is 
+ *		pending. Each byte takes about 40 us over the parallel interface and 
+ *		0.5 ms over a PCF8574 I2C backpack at 100 kHz.
  *
  *	**************************************************************************/
 
@@ -47,9 +56,12 @@
 # include <cstdlib>
 # include <array>
 # include <system/boards.h>
+# include <lib/format.h>
 # include <interfaces/icomponent.h>	
 # include <interfaces/iclockable.h>
 # include <utilities/Timer.h>
+# include <utilities/LCDFrame.h>
+# include <utilities/Profiler.h>
 # include <LiquidCrystal.h>
 
 # if defined __PG_HAS_NAMESPACES
@@ -241,9 +253,15 @@ namespace pg
 		void			next();
 		// Advances to the previous field in the collection.
 		void			prev();
+		// Sets the maximum number of bytes written to the device per call, or 0 for no limit.
+		void			budget(uint8_t);
+		// Returns the maximum number of bytes written to the device per call.
+		uint8_t			budget() const;
+		// Writes queued output to the device and returns true if none is left.
+		bool			flush();
 
 	private:
-		// Calls the client callback function.
+		// Writes any queued output, else calls the client callback function.
 		void clock() override;
 		// Writes one formatted field and value to the display device.
 		template<class T>
@@ -251,15 +269,9 @@ namespace pg
 		// Writes two or more formatted fields and values to the display device.
 		template<class T, class ...Ts>
 		void write_all(char* buf, iterator it, T&& arg, Ts&& ...args);
-		// Primary template for writing a formatted value.
+		// Writes a formatted value.
 		template<class T>
 		void write_value(char* buf, const Field* it, const T& arg);
-		// Template specialization for writing a formatted float value.
-		void write_value(char* buf, const Field* it, const float& arg);
-		// Template specialization for writing a formatted double value.
-		void write_value(char* buf, const Field* it, const double& arg);
-		// Template specialization for writing a formatted long double value.
-		void write_value(char* buf, const Field* it, const long double& arg);
 		// Writes a field label to the display device.
 		inline void write_label(const Field* it);
 		// Sets the update cursor event.
@@ -282,6 +294,8 @@ namespace pg
 		Event			event_;		// Currently pending update events.
 		timer_type		timer_;		// Display blink timer.
 		callback_type	callback_;	// Client callback.
+		LCDFrame<Cols, Rows> frame_;	// Shadow of the device contents and output queue.
+		uint8_t			budget_;	// Maximum number of bytes written per call.
 	};
 
 #pragma region screen
@@ -404,13 +418,14 @@ namespace pg
 
 	template<uint8_t Cols, uint8_t Rows>
 	LCDDisplay<Cols, Rows>::LCDDisplay(LiquidCrystal* lcd, callback_type cb, Screen* screen) :
-		lcd_(lcd), callback_(cb), screen_(screen), cursor_(), display_(true), mode_(), event_(), timer_() 
+		lcd_(lcd), callback_(cb), screen_(screen), cursor_(), display_(true), mode_(), event_(), timer_(), frame_(), budget_() 
 	{}
 
 	template<uint8_t Cols, uint8_t Rows>
 	template<class ...Ts>
 	void LCDDisplay<Cols, Rows>::refresh(Ts&& ...args)
 	{
+		PG_PROFILE_SCOPE("LCDDisplay::refresh");
 		// Device is refreshed all at once with any pending updates.
 
 		if (mode_ == Mode::Normal)
@@ -426,7 +441,10 @@ namespace pg
 		if (event_ == Update::Display)	// Set display/noDisplay.
 			display_ ? lcd_->display() : lcd_->noDisplay();
 		if (event_ == Update::Clear)	// Clear display.
+		{
 			lcd_->clear();
+			frame_.clear();
+		}
 		if (event_ == Update::Cursor)	// Set display cursor.
 		{
 			switch (cursor_)
@@ -451,14 +469,13 @@ namespace pg
 		{
 			char buf[Cols * Rows + 1] = { '\0' };
 			
-			lcd_->home();
-			lcd_->print(screen_->label());
+			frame_.begin();				// Render the screen into the frame buffer.
+			frame_.print(screen_->label());
 			iterator it = std::begin(screen_->fields());
 			write_all(buf, it, std::forward<Ts>(args)...);
 		}
-		if (event_ == Update::Field)	// Position cursor at current field.
-			lcd_->setCursor(screen_->active_field()->col_, screen_->active_field()->row_);
-		event_ = Update::None;			// Reset the Update Event flags.
+		event_ = event_ == Update::Field ? Event(Update::Field) : Event();	// Reset the Update Event flags, ...
+		(void)flush();					// ... except the cursor, which is positioned once the output is written.
 	}
 
 	template<uint8_t Cols, uint8_t Rows>
@@ -558,10 +575,39 @@ namespace pg
 		set_field_event();
 	}
 
+	template<uint8_t Cols, uint8_t Rows>
+	void LCDDisplay<Cols, Rows>::budget(uint8_t bytes)
+	{
+		budget_ = bytes;
+	}
+
+	template<uint8_t Cols, uint8_t Rows>
+	uint8_t LCDDisplay<Cols, Rows>::budget() const
+	{
+		return budget_;
+	}
+
+	template<uint8_t Cols, uint8_t Rows>
+	bool LCDDisplay<Cols, Rows>::flush()
+	{
+		PG_PROFILE_SCOPE("LCDDisplay::flush");
+		const bool done = frame_.flush(lcd_, budget_);
+
+		if (done && event_ == Update::Field)	// Position cursor at current field.
+		{
+			lcd_->setCursor(screen_->active_field()->col_, screen_->active_field()->row_);
+			event_.clr(Update::Field);
+		}
+
+		return done;
+	}
+
 	template<uint8_t Cols, uint8_t Rows>
 	void LCDDisplay<Cols, Rows>::clock() 
 	{
-		if (callback_)
+		if (frame_.pending())
+			(void)flush();	// Drain queued output before rendering again.
+		else if (callback_)
 			(*callback_)(); // Client provides display values for each field in callback func.
 	}
 
@@ -592,44 +638,15 @@ namespace pg
 	template<class T>
 	void LCDDisplay<Cols, Rows>::write_value(char* buf, const Field* it, const T& arg)
 	{
-		(void)sprintf(buf, it->fmt_, arg); // Print formatted value to buf.
-		lcd_->print(buf);
-	}
-
-	template<uint8_t Cols, uint8_t Rows>
-	void LCDDisplay<Cols, Rows>::write_value(char* buf, const Field* it, const float& arg)
-	{
-		write_value(buf, it, static_cast<double>(arg));
-	}
-
-	template<uint8_t Cols, uint8_t Rows>
-	void LCDDisplay<Cols, Rows>::write_value(char* buf, const Field* it, const double& arg)
-	{
-		// Arduino cstdlib sprintf() doesn't support printing of floating point types, 
-		// so we have to use dtostrf(). Format strings limited to "%w.pf", where 
-		// w = width, p = precision, and f is the literal floating-point type specifier, 
-		// e.g. "%3.1f" = floating point format 3 digits wide with 1 digit after decimal.
-
-		char str[11]; // Formatted print buf for float types.
-		uint8_t w = std::atoi(std::strchr(it->fmt_, '%') + 1);	// Parse width from fmt spec.
-		uint8_t p = std::atoi(std::strchr(it->fmt_, '.') + 1);	// Parse precision from fmt spec.
-
-		(void)sprintf(buf, "%s", dtostrf(arg, w, p, str));		// Print formatted value as string.
-		lcd_->print(buf);
-	}
-
-	template<uint8_t Cols, uint8_t Rows>
-	void LCDDisplay<Cols, Rows>::write_value(char* buf, const Field* it, const long double& arg)
-	{
-		write_value(buf, it, static_cast<double>(arg));
+		(void)format(buf, it->fmt_, arg); // Print formatted value to buf, including floating point types.
+		frame_.print(buf);
 	}
 
 	template<uint8_t Cols, uint8_t Rows>
 	void LCDDisplay<Cols, Rows>::write_label(const Field* it)
 	{
-		lcd_->setCursor(it->col_, it->row_);	// Set cursor at field coords.
-		lcd_->print(it->label_);				// Print field label.
-		lcd_->setCursor(it->col_ + strlen(it->label_), it->row_);	// Set cursor after label for value.
+		frame_.setCursor(it->col_, it->row_);	// Set cursor at field coords.
+		frame_.print(it->label_);				// Print field label, leaving the cursor after it for value.
 	}
 
 	template<uint8_t Cols, uint8_t Rows>
@@ -33,7 +33,18 @@
  *		The `LCDDisplay' allows rapid configuration and simple management of 
  *		an lcd display device. It supports formatted printing and synchronous 
  *		or asynchronous operation. The display hardware is controlled via the 
- *		Arduino `LiquidCrystal' api.	
+ *		Arduino `LiquidCrystal' api.
+ *
+ *		The display keeps a shadow copy of the device contents (see 
+ *		<utilities/LCDFrame.h>) and each refresh only writes the characters 
+ *		that changed since the last one.
+ *
+ *		The `budget()' method bounds the number of bytes written to the 
+ *		device per refresh, so a redraw can never block the caller for long. 
+ *		Any remaining output is queued and written by later calls to 
+ *		`flush()' or `clock()', which only drains the queue while output is 
+ *		pending. Each byte takes about 40 us over the parallel interface and 
+ *		0.5 ms over a PCF8574 I2C backpack at 100 kHz.
  *
  *	**************************************************************************/
 
@@ -45,9 +56,11 @@
 # include <cstdlib>
 # include <array>
 # include <system/boards.h>
+# include <lib/format.h>
 # include <interfaces/icomponent.h>	
 # include <interfaces/iclockable.h>
 # include <utilities/Timer.h>
+# include <utilities/LCDFrame.h>
 # include <LiquidCrystal.h>
 
 # if defined __PG_HAS_NAMESPACES
@@ -79,7 +92,7 @@ namespace pg
 		public:
 			Value(object_type* object, method_type method) : BaseValue(), object_(object), method_(method) {}
 		public:
-			int format(char* buf, const char* fmt) override { return std::sprintf(buf, fmt, value()); }
+			int format(char* buf, const char* fmt) override { return static_cast<int>(pg::format(buf, fmt, value())); }
 			value_type value() const { return (object_->*method_)(); }
 		private:
 			object_type*	object_;	// Request receiver.
@@ -96,7 +109,7 @@ namespace pg
 		public:
 			Value(method_type method) : BaseValue(), method_(method) {}
 		public:
-			int format(char* buf, const char* fmt) override { return std::sprintf(buf, fmt, value()); }
+			int format(char* buf, const char* fmt) override { return static_cast<int>(pg::format(buf, fmt, value())); }
 			value_type value() const { return (*method_)(); }
 		private:
 			method_type		method_;	// Function call.
@@ -281,9 +294,15 @@ namespace pg
 		void			next();
 		// Advances to the previous field in the collection.
 		void			prev();
+		// Sets the maximum number of bytes written to the device per call, or 0 for no limit.
+		void			budget(uint8_t);
+		// Returns the maximum number of bytes written to the device per call.
+		uint8_t			budget() const;
+		// Writes queued output to the device and returns true if none is left.
+		bool			flush();
 
 	private:
-		// Calls the refresh() method.
+		// Writes any queued output, else calls the refresh() method.
 		void clock() override;
 		// Sets the update cursor event.
 		void set_cursor_event();
@@ -304,6 +323,8 @@ namespace pg
 		Mode			mode_;		// Current operating mode setting.
 		Event			event_;		// Currently pending update events.
 		timer_type		timer_;		// Display blink timer.
+		LCDFrame<Cols, Rows> frame_;	// Shadow of the device contents and output queue.
+		uint8_t			budget_;	// Maximum number of bytes written per call.
 	};
 
 #pragma region Screen
@@ -426,7 +447,7 @@ namespace pg
 
 	template<uint8_t Cols, uint8_t Rows>
 	LCDDisplay<Cols, Rows>::LCDDisplay(LiquidCrystal* lcd, Screen* screen) :
-		lcd_(lcd), screen_(screen), cursor_(), display_(true), mode_(), event_(), timer_() 
+		lcd_(lcd), screen_(screen), cursor_(), display_(true), mode_(), event_(), timer_(), frame_(), budget_() 
 	{}
 
 	template<uint8_t Cols, uint8_t Rows>
@@ -447,7 +468,10 @@ namespace pg
 		if (event_ == Update::Display)	// Set display/noDisplay.
 			display_ ? lcd_->display() : lcd_->noDisplay();
 		if (event_ == Update::Clear)	// Clear display.
+		{
 			lcd_->clear();
+			frame_.clear();
+		}
 		if (event_ == Update::Cursor)	// Set display cursor.
 		{
 			switch (cursor_)
@@ -472,8 +496,8 @@ namespace pg
 		{
 			char buf[Cols + 1]; // Formatted print buffer.
 
-			lcd_->home();
-			lcd_->print(screen_->label()); // Print screen label at home position.
+			frame_.begin(); // Render the screen into the frame buffer, ...
+			frame_.print(screen_->label()); // ... with the screen label at home position.
 			// Go through the current screen's fields ...
 			for (uint8_t i = 0; i < screen_->fields().size(); ++i)
 			{
@@ -481,15 +505,14 @@ namespace pg
 				// ... and print any visible ones.
 				if (field->visible_)
 				{
-					lcd_->setCursor(field->col_, field->row_);
+					frame_.setCursor(field->col_, field->row_);
 					field->value_.format(buf, field->fmt_);
-					lcd_->print(buf);
+					frame_.print(buf);
 				}
 			}
 		}
-		if (event_ == Update::Field)	// Position cursor at current field.
-			lcd_->setCursor(screen_->active_field()->col_, screen_->active_field()->row_);
-		event_ = Update::None;			// Reset the Update Event flags.
+		event_ = event_ == Update::Field ? Event(Update::Field) : Event();	// Reset the Update Event flags, ...
+		(void)flush();					// ... except the cursor, which is positioned once the output is written.
 	}
 
 	template<uint8_t Cols, uint8_t Rows>
@@ -589,10 +612,39 @@ namespace pg
 		set_field_event();
 	}
 
+	template<uint8_t Cols, uint8_t Rows>
+	void LCDDisplay<Cols, Rows>::budget(uint8_t bytes)
+	{
+		budget_ = bytes;
+	}
+
+	template<uint8_t Cols, uint8_t Rows>
+	uint8_t LCDDisplay<Cols, Rows>::budget() const
+	{
+		return budget_;
+	}
+
+	template<uint8_t Cols, uint8_t Rows>
+	bool LCDDisplay<Cols, Rows>::flush()
+	{
+		const bool done = frame_.flush(lcd_, budget_);
+
+		if (done && event_ == Update::Field)	// Position cursor at current field.
+		{
+			lcd_->setCursor(screen_->active_field()->col_, screen_->active_field()->row_);
+			event_.clr(Update::Field);
+		}
+
+		return done;
+	}
+
 	template<uint8_t Cols, uint8_t Rows>
 	void LCDDisplay<Cols, Rows>::clock() 
 	{
-		refresh();
+		if (frame_.pending())
+			(void)flush();	// Drain queued output before rendering again.
+		else
+			refresh();
 	}
 
 	template<uint8_t Cols, uint8_t Rows>
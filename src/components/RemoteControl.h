@@ -38,129 +38,12 @@
 # include "interfaces/icomponent.h"	// icomponent interface.
 # include "interfaces/iclockable.h"	// iclockable interface.
 # include "utilities/Connection.h"	// Remote communications types.
+# include "utilities/Interpreter.h"	// Message argument parsing.
 
 # if defined __PG_HAS_NAMESPACES
 
 namespace pg
 {
-	namespace detail
-	{
-		void getArg(const char* str, char*& arg)
-		{
-			arg = const_cast<char*>(str);
-		}
-
-		void getArg(const char* str, const char*& arg)
-		{
-			arg = str;
-		}
-
-		void getArg(const char* str, bool& arg)
-		{
-			arg = static_cast<bool>(std::atoi(str));
-		}
-
-		void getArg(const char* str, char& arg)
-		{
-			arg = static_cast<char>(std::atoi(str));
-		}
-
-		void getArg(const char* str, unsigned char& arg)
-		{
-			arg = static_cast<unsigned char>(std::atoi(str));
-		}
-
-		void getArg(const char* str, signed char& arg)
-		{
-			arg = static_cast<signed char>(std::atoi(str));
-		}
-
-		void getArg(const char* str, short& arg)
-		{
-			arg = static_cast<short>(std::atoi(str));
-		}
-
-		void getArg(const char* str, unsigned short& arg)
-		{
-			arg = static_cast<unsigned short>(std::atoi(str));
-		}
-
-		void getArg(const char* str, int& arg)
-		{
-			arg = std::atoi(str);
-		}
-
-		void getArg(const char* str, unsigned int& arg)
-		{
-			arg = static_cast<unsigned int>(std::atoi(str));
-		}
-
-		void getArg(const char* str, long& arg)
-		{
-			arg = std::atol(str);
-		}
-
-		void getArg(const char* str, unsigned long& arg)
-		{
-			arg = static_cast<unsigned long>(std::atol(str));
-		}
-
-		void getArg(const char* str, long long& arg)
-		{
-			arg = static_cast<long long>(std::atol(str));
-		}
-
-		void getArg(const char* str, unsigned long long& arg)
-		{
-			arg = static_cast<unsigned long long>(std::atol(str));
-		}
-
-		void getArg(const char* str, float& arg)
-		{
-			arg = static_cast<float>(std::atof(str));
-		}
-
-		void getArg(const char* str, double& arg)
-		{
-			arg = std::atof(str);
-		}
-
-		void getArg(const char* str, long double& arg)
-		{
-			arg = static_cast<long double>(std::atof(str));
-		}
-
-		// Terminating template for parsing message strings into command 
-		// arguments. Called after last tuple element.
-		template<std::size_t I = 0, class...Ts>
-		inline typename std::enable_if<I == sizeof...(Ts), std::size_t>::type
-			getCmdArgs(const char* delim, std::tuple<Ts...>& t)
-		{
-			return I;
-		}
-
-		// Primary template for parsing message strings into command 
-		// arguments. Called recursively for each tuple element.
-		template<std::size_t I = 0, class...Ts>
-		inline typename std::enable_if<I < sizeof...(Ts), std::size_t>::type
-			getCmdArgs(const char* delim, std::tuple<Ts...>& t)
-		{
-			char* tok = nullptr;
-			std::size_t i = 0;
-
-			/* Needs support for block quotes that may enclose delimiters. 
-			 * strtok won't work for this. 
-			 */
-			if ((tok = std::strtok(nullptr, delim)))
-			{
-				detail::getArg(tok, std::get<I>(t));
-				i = getCmdArgs<I + 1, Ts...>(delim, t);
-			}
-
-			return i; // Returns sizeof...(Ts) if no. of parsed tokens matches tuple size, else returns 0.
-		}
-	} // namespace detail
-
 	class RemoteControl : public iclockable, public icomponent
 	{
 	public:
@@ -207,9 +90,11 @@ namespace pg
 				// the same number of arguments as the tuple size: args_.size().
 
 				bool result = false;
+				tokenizer tok(str);
 
-				if((result = RemoteControl::parseCommand(str, args_) == args_.size()))
+				if((result = RemoteControl::parseCommand(tok, args_) == args_.size()))
 					std::experimental::apply(&object_, delegate_, args_);
+				tok.restore();
 
 				return result;
 			}
@@ -240,9 +125,11 @@ namespace pg
 			bool execute(char* str) override
 			{
 				bool result = false;
+				tokenizer tok(str);
 
-				if((result = RemoteControl::parseCommand(str, args_) == args_.size()))
+				if((result = RemoteControl::parseCommand(tok, args_) == args_.size()))
 					std::experimental::apply(delegate_, args_);
+				tok.restore();
 
 				return result;
 			}
@@ -322,7 +209,7 @@ namespace pg
 		bool exec(char*);
 		void poll();
 		template<class...Ts>
-		static std::size_t parseCommand(char*, std::tuple<Ts...>&, const char* = DfltCmdDelimStr, const char* = DfltArgDelimStr);
+		static std::size_t parseCommand(tokenizer&, std::tuple<Ts...>&, const char* = DfltCmdDelimStr, const char* = DfltArgDelimStr);
 
 	private:
 		void clock() override;
@@ -430,19 +317,14 @@ namespace pg
 	}
 
 	template<class...Ts>
-	std::size_t RemoteControl::parseCommand(char* cmd, std::tuple<Ts...>& args, const char* cmd_delim, const char* args_delim)
+	std::size_t RemoteControl::parseCommand(tokenizer& tok, std::tuple<Ts...>& args, const char* cmd_delim, const char* args_delim)
 	{
-		char tmp[Connection::size()];
-		char* tok = nullptr;
+		// The command string is tokenized in place, callers must restore() 
+		// it once the args are no longer needed.
 		std::size_t n = 0;
-		// Only need a copy of cmd string if echo_ is on otherwise strtok() will mangle it. 
-		// So maybe change this to a non-static member or get rid of echo.
-		(void)std::strncpy(tmp, cmd, sizeof(tmp)); 
-		/* Needs support for block quotes that may enclose delimiters.
-		 * strtok won't work for this.
-		 */
-		if ((tok = std::strtok(tmp, cmd_delim)))
-			n = detail::getCmdArgs(args_delim, args);
+
+		if (tok.next(cmd_delim))
+			n = details::getArgs(tok, args_delim, args);
 
 		return n;
 	}
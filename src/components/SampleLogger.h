@@ -0,0 +1,437 @@
+/*
+ *	This file defines a fixed-rate, triggered GPIO sample logger.
+ *
+ *	***************************************************************************
+ *
+ *	File: SampleLogger.h
+ *	Date: October 14, 2026
+ *	Version: 1.0
+ *	Author: Michael Brodsky
+ *	Email: mbrodskiis@gmail.com
+ *	Copyright (c) 2012-2022 Michael Brodsky
+ *
+ *	***************************************************************************
+ *
+ *  This file is part of "Pretty Good" (Pg). "Pg" is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  This file is distributed in the hope that it will be useful, but
+ *	WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *	along with this file. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *	**************************************************************************
+ *
+ *	Description:
+ *
+ *		A `SampleLogger' samples a list of up to ChannelsMax pins at a fixed
+ *		period into a static ring buffer of Size values, one frame of one
+ *		value per pin per period. Analog pins are read with analogRead()
+ *		and digital pins with digitalRead(). configure() sets the pins and
+ *		period, and arm() starts sampling and waits for the trigger
+ *		condition on the first pin:
+ *
+ *			Immediate: triggers on the first frame, or when fire() is called,
+ *			Above: triggers on the first frame whose value is above a level,
+ *			Below: triggers on the first frame whose value is below a level.
+ *
+ *		Up to `pretrigger' frames taken before the trigger are kept, and
+ *		sampling continues until the buffer holds capacity() frames, then
+ *		stops in the Done state, so the captured block can be read back at
+ *		any rate with sample():
+ *
+ *			SampleLogger<512> logger;
+ *			const pin_t pins[] = { A0, A1 };
+ *
+ *			logger.configure(std::begin(pins), std::end(pins), 500);	// 2 kHz.
+ *			logger.arm(Condition::Above, 600, 32);
+ *
+ *		By default frames are polled from `clock()', which counts any
+ *		periods it missed as overruns. If the client defines __PG_HW_TIMER
+ *		and the board has a hardware timer (see <system/hwtimer.h>),
+ *		`trigger(Trigger::Interrupt)' takes the frames from the timer
+ *		interrupt instead, so the sampling rate is independent of loop()
+ *		timing. The timer is re-armed from its interrupt, which adds its
+ *		latency, a few microseconds, to each period. The client callback is
+ *		called from clock() on each state change.
+ *
+ *	**************************************************************************/
+
+#if !defined __PG_SAMPLELOGGER_H
+# define __PG_SAMPLELOGGER_H 20261014L
+
+# include <algorithm>					// std::copy
+# include <cstdint>						// Fixed-width integer types.
+# include <system/boards.h>				// isAnalogPin()
+# include <system/hwtimer.h>			// `hw_timer' type.
+# include <lib/callback.h>				// Callback signature templates.
+# include <interfaces/iclockable.h>		// `iclockable' interface.
+# include <interfaces/icomponent.h>		// `icomponent' interface.
+# include <chrono>						// std::chrono::steady_clock
+
+# if defined __PG_HAS_NAMESPACES
+
+namespace pg
+{
+	// Samples up to ChannelsMax pins at a fixed rate into a ring buffer of Size values.
+	template<std::size_t Size = 256, std::size_t ChannelsMax = 8>
+	class SampleLogger : public iclockable, public icomponent
+	{
+		static_assert(ChannelsMax > 0 && Size >= ChannelsMax, "SampleLogger must hold at least one frame.");
+		static_assert(Size < 65536, "SampleLogger size must be less than 65536.");
+
+	public:
+		enum class State : uint8_t
+		{
+			Idle = 0,	// Not sampling.
+			Armed,		// Sampling, waiting for the trigger.
+			Triggered,	// Sampling after the trigger.
+			Done		// Block captured.
+		};
+
+		// Enumerates the trigger conditions.
+		enum class Condition : uint8_t
+		{
+			Immediate = 0,	// The first frame, or fire().
+			Above,			// The first pin's value above the level.
+			Below			// The first pin's value below the level.
+		};
+
+		// Enumerates the sample timing sources.
+		enum class Trigger : uint8_t
+		{
+			Polled = 0,	// Frames are timed by polling from clock().
+			Interrupt	// Frames are taken from the hardware timer interrupt.
+		};
+
+		using value_type = uint16_t;	// Type that holds a sample.
+		using size_type = uint16_t;		// Type that holds a sample or frame count.
+		using callback_type = typename callback<void, void, State>::type;
+
+	public:
+		explicit SampleLogger(callback_type = nullptr);
+		SampleLogger(const SampleLogger&) = delete;
+		SampleLogger& operator=(const SampleLogger&) = delete;
+
+	public:
+		// Sets the sampled pins and the sample period in microseconds, returns false if invalid.
+		bool configure(const pin_t*, const pin_t*, uint32_t);
+		// Starts sampling, keeping up to the given number of frames before the trigger.
+		void arm(Condition = Condition::Immediate, value_type = 0, size_type = 0);
+		// Triggers an armed logger on its next frame.
+		void fire();
+		// Stops sampling, keeping any frames taken.
+		void stop();
+		// Returns the logger's current state.
+		State state() const;
+		// Returns the number of sampled pins.
+		size_type channels() const;
+		// Returns a sampled pin.
+		pin_t pin(size_type) const;
+		// Returns the sample period in microseconds.
+		uint32_t period() const;
+		// Returns the number of frames the buffer holds.
+		size_type capacity() const;
+		// Returns the number of frames taken.
+		size_type frames() const;
+		// Returns the index of the trigger frame.
+		size_type triggerFrame() const;
+		// Returns the number of periods missed while polling.
+		uint32_t overruns() const;
+		// Returns a pin's sample in a frame, frame 0 is the oldest.
+		value_type sample(size_type, size_type) const;
+		// Sets the client callback.
+		void callback(callback_type);
+		// Sets the sample timing source.
+		void trigger(Trigger);
+		// Returns the current sample timing source.
+		Trigger trigger() const;
+
+	private:
+		static value_type read(pin_t);
+		static uint32_t now();
+		void take();
+		void clock() override;
+		static void expire(void*);
+
+	private:
+		value_type			buf_[Size];				// Ring buffer of frames.
+		pin_t				pins_[ChannelsMax];		// Sampled pins.
+		size_type			channels_;				// Number of sampled pins.
+		uint32_t			period_;				// Sample period in microseconds.
+		volatile size_type	head_;					// Index of the next frame.
+		volatile size_type	frames_;				// Number of frames held.
+		volatile size_type	remaining_;				// Frames left to take after the trigger.
+		size_type			pretrigger_;			// Maximum frames kept before the trigger.
+		volatile size_type	trigger_frame_;			// Index of the trigger frame.
+		volatile Condition	condition_;				// Trigger condition.
+		value_type			level_;					// Trigger level.
+		uint32_t			start_;					// Time polling started in microseconds.
+		uint32_t			taken_;					// Number of frames due so far when polling.
+		uint32_t			overruns_;				// Number of missed periods.
+		volatile State		state_;					// The current state.
+		State				reported_;				// The state last reported to the client.
+		Trigger				trigger_;				// The current sample timing source.
+		callback_type		callback_;				// Client callback.
+	};
+
+	template<std::size_t Size, std::size_t ChannelsMax>
+	SampleLogger<Size, ChannelsMax>::SampleLogger(callback_type cb) :
+		buf_(), pins_(), channels_(), period_(), head_(), frames_(), remaining_(), pretrigger_(),
+		trigger_frame_(), condition_(), level_(), start_(), taken_(), overruns_(), state_(), reported_(),
+		trigger_(), callback_(cb)
+	{
+
+	}
+
+	template<std::size_t Size, std::size_t ChannelsMax>
+	bool SampleLogger<Size, ChannelsMax>::configure(const pin_t* first, const pin_t* last, uint32_t us)
+	{
+		const std::size_t n = last - first;
+		const bool result = n > 0 && n <= ChannelsMax && us > 0;
+
+		if (result)
+		{
+			stop();
+			std::copy(first, last, pins_);
+			channels_ = static_cast<size_type>(n);
+			period_ = us;
+			frames_ = head_ = trigger_frame_ = 0;
+		}
+
+		return result;
+	}
+
+	template<std::size_t Size, std::size_t ChannelsMax>
+	void SampleLogger<Size, ChannelsMax>::arm(Condition condition, value_type level, size_type pretrigger)
+	{
+		stop();
+		if (channels_)
+		{
+			condition_ = condition;
+			level_ = level;
+			pretrigger_ = pretrigger < capacity() ? pretrigger : capacity() - 1;
+			frames_ = head_ = trigger_frame_ = 0;
+			taken_ = overruns_ = 0;
+			state_ = State::Armed;
+# if defined __PG_HAS_HW_TIMER
+			if (trigger_ == Trigger::Interrupt)
+			{
+				hw_timer::begin(&SampleLogger<Size, ChannelsMax>::expire, this);
+				take();
+				hw_timer::arm(period_);
+			}
+			else
+# endif
+			start_ = now();
+		}
+	}
+
+	template<std::size_t Size, std::size_t ChannelsMax>
+	void SampleLogger<Size, ChannelsMax>::fire()
+	{
+		condition_ = Condition::Immediate;
+	}
+
+	template<std::size_t Size, std::size_t ChannelsMax>
+	void SampleLogger<Size, ChannelsMax>::stop()
+	{
+		if (state_ == State::Armed || state_ == State::Triggered)
+		{
+# if defined __PG_HAS_HW_TIMER
+			if (trigger_ == Trigger::Interrupt)
+				hw_timer::cancel();
+# endif
+			state_ = State::Idle;
+		}
+	}
+
+	template<std::size_t Size, std::size_t ChannelsMax>
+	typename SampleLogger<Size, ChannelsMax>::State SampleLogger<Size, ChannelsMax>::state() const
+	{
+		return state_;
+	}
+
+	template<std::size_t Size, std::size_t ChannelsMax>
+	typename SampleLogger<Size, ChannelsMax>::size_type SampleLogger<Size, ChannelsMax>::channels() const
+	{
+		return channels_;
+	}
+
+	template<std::size_t Size, std::size_t ChannelsMax>
+	pin_t SampleLogger<Size, ChannelsMax>::pin(size_type i) const
+	{
+		return i < channels_ ? pins_[i] : InvalidPin;
+	}
+
+	template<std::size_t Size, std::size_t ChannelsMax>
+	uint32_t SampleLogger<Size, ChannelsMax>::period() const
+	{
+		return period_;
+	}
+
+	template<std::size_t Size, std::size_t ChannelsMax>
+	typename SampleLogger<Size, ChannelsMax>::size_type SampleLogger<Size, ChannelsMax>::capacity() const
+	{
+		return channels_ ? static_cast<size_type>(Size / channels_) : 0;
+	}
+
+	template<std::size_t Size, std::size_t ChannelsMax>
+	typename SampleLogger<Size, ChannelsMax>::size_type SampleLogger<Size, ChannelsMax>::frames() const
+	{
+		return frames_;
+	}
+
+	template<std::size_t Size, std::size_t ChannelsMax>
+	typename SampleLogger<Size, ChannelsMax>::size_type SampleLogger<Size, ChannelsMax>::triggerFrame() const
+	{
+		return trigger_frame_;
+	}
+
+	template<std::size_t Size, std::size_t ChannelsMax>
+	uint32_t SampleLogger<Size, ChannelsMax>::overruns() const
+	{
+		return overruns_;
+	}
+
+	template<std::size_t Size, std::size_t ChannelsMax>
+	typename SampleLogger<Size, ChannelsMax>::value_type SampleLogger<Size, ChannelsMax>::sample(size_type frame, size_type channel) const
+	{
+		value_type result = 0;
+
+		if (frame < frames_ && channel < channels_)
+		{
+			const size_type n = capacity();
+			const size_type i = static_cast<size_type>((head_ + n - frames_ + frame) % n);
+
+			result = buf_[i * channels_ + channel];
+		}
+
+		return result;
+	}
+
+	template<std::size_t Size, std::size_t ChannelsMax>
+	void SampleLogger<Size, ChannelsMax>::callback(callback_type cb)
+	{
+		callback_ = cb;
+	}
+
+	template<std::size_t Size, std::size_t ChannelsMax>
+	void SampleLogger<Size, ChannelsMax>::trigger(Trigger source)
+	{
+# if defined __PG_HAS_HW_TIMER
+		stop();
+		trigger_ = source;
+# else
+		(void)source;	// Only polling is available.
+# endif
+	}
+
+	template<std::size_t Size, std::size_t ChannelsMax>
+	typename SampleLogger<Size, ChannelsMax>::Trigger SampleLogger<Size, ChannelsMax>::trigger() const
+	{
+		return trigger_;
+	}
+
+	template<std::size_t Size, std::size_t ChannelsMax>
+	typename SampleLogger<Size, ChannelsMax>::value_type SampleLogger<Size, ChannelsMax>::read(pin_t p)
+	{
+		return static_cast<value_type>(isAnalogPin(p) ? analogRead(p) : digitalRead(p));
+	}
+
+	// Returns the polled sample time in microseconds. Timer<> runs on millis() 
+	// unless __PG_HW_CLOCK is defined, which would limit polling to 1 kHz.
+	template<std::size_t Size, std::size_t ChannelsMax>
+	uint32_t SampleLogger<Size, ChannelsMax>::now()
+	{
+# if defined __PG_HW_CLOCK
+		return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+# else
+		return static_cast<uint32_t>(micros());
+# endif
+	}
+
+	template<std::size_t Size, std::size_t ChannelsMax>
+	void SampleLogger<Size, ChannelsMax>::take()
+	{
+		const size_type n = capacity();
+		value_type* frame = buf_ + head_ * channels_;
+
+		for (size_type i = 0; i < channels_; ++i)
+			frame[i] = read(pins_[i]);
+		head_ = head_ + 1 < n ? head_ + 1 : 0;
+		if (frames_ < n)
+			frames_ = frames_ + 1;
+		if (state_ == State::Armed)
+		{
+			const bool hit = condition_ == Condition::Above ? frame[0] > level_
+				: condition_ == Condition::Below ? frame[0] < level_
+				: true;
+
+			if (hit)
+			{
+				// Only the last pretrigger_ frames before this one are kept.
+				if (frames_ > pretrigger_ + 1)
+					frames_ = pretrigger_ + 1;
+				trigger_frame_ = frames_ - 1;
+				remaining_ = n - frames_;
+				state_ = State::Triggered;
+			}
+		}
+		else if (remaining_)
+			remaining_ = remaining_ - 1;
+		if (state_ == State::Triggered && !remaining_)
+			state_ = State::Done;
+	}
+
+	template<std::size_t Size, std::size_t ChannelsMax>
+	void SampleLogger<Size, ChannelsMax>::clock()
+	{
+		if ((state_ == State::Armed || state_ == State::Triggered) && trigger_ == Trigger::Polled)
+		{
+			const uint32_t due = (now() - start_) / period_ + 1;
+
+			if (due > taken_)
+			{
+				overruns_ += due - taken_ - 1;	// Missed periods can't be sampled late.
+				taken_ = due;
+				take();
+			}
+		}
+		if (reported_ != state_)
+		{
+			reported_ = state_;
+			if (callback_)
+				(*callback_)(reported_);
+		}
+	}
+
+	template<std::size_t Size, std::size_t ChannelsMax>
+	void SampleLogger<Size, ChannelsMax>::expire(void* arg)
+	{
+# if defined __PG_HAS_HW_TIMER
+		SampleLogger<Size, ChannelsMax>* logger = static_cast<SampleLogger<Size, ChannelsMax>*>(arg);
+
+		if (logger->state_ == State::Armed || logger->state_ == State::Triggered)
+		{
+			logger->take();
+			if (logger->state_ != State::Done)
+				hw_timer::arm(logger->period_);
+		}
+# else
+		(void)arg;
+# endif
+	}
+} // namespace pg
+
+# else // !defined __PG_HAS_NAMESPACES
+#  error Requires C++11 and namespace support.
+# endif // defined __PG_HAS_NAMESPACES
+
+#endif // !defined __PG_SAMPLELOGGER_H
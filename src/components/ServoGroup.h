@@ -0,0 +1,385 @@
+/*
+ *	This file defines a synchronized motion planner for groups of servos.
+ *
+ *	***************************************************************************
+ *
+ *	File: ServoGroup.h
+ *	Date: October 14, 2026
+ *	Version: 1.0
+ *	Author: Michael Brodsky
+ *	Email: mbrodskiis@gmail.com
+ *	Copyright (c) 2012-2022 Michael Brodsky
+ *
+ *	***************************************************************************
+ *
+ *  This file is part of "Pretty Good" (Pg). "Pg" is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  This file is distributed in the hope that it will be useful, but
+ *	WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *	along with this file. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *	**************************************************************************
+ *
+ *	Description:
+ *
+ *		A `ServoGroup' moves N SweepServo objects of the same type to new
+ *		angles so that they all start and finish together. move() plans the
+ *		motion once: it stretches the requested duration until the slowest
+ *		servo can follow it at its current speed() (see <lib/servos.h>),
+ *		then precomputes a table of `Steps' pulse widths per servo along a
+ *		velocity profile:
+ *
+ *			Linear: constant speed, like SweepServo::sweep(),
+ *			Trapezoid: accelerates for the first quarter of the move,
+ *				cruises, and decelerates for the last quarter,
+ *			SCurve: smooth quintic 10u^3 - 15u^4 + 6u^5 profile, with zero
+ *				speed and acceleration at both ends.
+ *
+ *		The group then writes one table row per step interval to all of its
+ *		servos, so executing a move costs no arithmetic. By default steps
+ *		are polled from `clock()', which catches up if it runs late, and
+ *		servos must not be clocked while the group is driving them (their
+ *		clock() does nothing until the move completes). If the client
+ *		defines __PG_HW_TIMER and the board has a hardware timer (see
+ *		<system/hwtimer.h>), `trigger(Trigger::Interrupt)' writes the steps
+ *		from the timer interrupt instead, so a move is independent of loop()
+ *		timing, and clock() only reports completion. The hardware timer uses
+ *		AVR Timer1, which is only free on boards where the Servo library uses
+ *		another timer, such as Timer5 on the Mega, and only one group or
+ *		EventSequencer at a time can use it.
+ *
+ *			ServoGroup<towerpro_sg90, 2> arm({ &shoulder, &elbow });
+ *			arm.move({ 90.0, 45.0 }, milliseconds(1500), Profile::SCurve);
+ *
+ *		The group callback is called with State::Active when a move starts
+ *		and with State::Idle when it finishes, servo callbacks as usual.
+ *
+ *	**************************************************************************/
+
+#if !defined __PG_SERVOGROUP_H
+# define __PG_SERVOGROUP_H 20261014L
+
+# include <array>						// std::array
+# include <cstdint>						// Fixed-width integer types.
+# include <components/SweepServo.h>		// `SweepServo' type.
+# include <system/hwtimer.h>			// `hw_timer' type.
+
+# if defined __PG_HAS_NAMESPACES
+
+namespace pg
+{
+	namespace servos
+	{
+		// Synchronized motion planner for N servos of type T, with Steps steps per move.
+		template<class T, std::size_t N, std::size_t Steps = 32>
+		class ServoGroup : public iclockable, public icomponent
+		{
+			static_assert(N > 0, "ServoGroup size must be non-zero.");
+			static_assert(Steps > 0 && Steps < 256, "ServoGroup steps must be in [1, 255].");
+
+		public:
+			enum class State
+			{
+				Idle = 0,
+				Active
+			};
+
+			// Enumerates the velocity profiles.
+			enum class Profile
+			{
+				Linear = 0,	// Constant speed.
+				Trapezoid,	// Constant acceleration and deceleration.
+				SCurve		// Smooth acceleration and deceleration.
+			};
+
+			// Enumerates the step timing sources.
+			enum class Trigger
+			{
+				Polled = 0,	// Steps are timed by polling from clock().
+				Interrupt	// Steps are written from the hardware timer interrupt.
+			};
+
+			using sweep_type = SweepServo<T>;
+			using servo_type = typename sweep_type::servo_type;
+			using angle_type = typename sweep_type::angle_type;
+			using step_type = typename sweep_type::step_type;
+			using duration_type = typename sweep_type::duration_type;
+			using pulse_type = uint16_t;
+			using size_type = uint8_t;
+			using callback_type = typename callback<void, void, State>::type;
+			using container_type = std::array<sweep_type*, N>;
+			using position_type = std::array<angle_type, N>;
+
+		public:
+			// Constructs a group from its servos and an optional callback.
+			explicit ServoGroup(const container_type&, callback_type = nullptr);
+			ServoGroup(const ServoGroup&) = delete;
+			ServoGroup& operator=(const ServoGroup&) = delete;
+
+		public:
+			// Moves the servos to the given angles together, in at least the given duration.
+			void move(const position_type&, const duration_type& = duration_type(), Profile = Profile::Trapezoid);
+			// Stops the current move, leaving the servos where they are.
+			void stop();
+			// Returns the group's current state.
+			State state() const;
+			// Returns the planned duration of the current or last move.
+			duration_type duration() const;
+			// Returns the group's servos.
+			const container_type& servos() const;
+			// Sets the client callback.
+			void callback(callback_type);
+			// Sets the step timing source.
+			void trigger(Trigger);
+			// Returns the current step timing source.
+			Trigger trigger() const;
+
+		private:
+			// Returns the fraction of a move completed at time u, u in [0, 1].
+			static float shape(Profile, float);
+			// Returns the peak speed of a profile, relative to the Linear profile.
+			static float peak(Profile);
+			// Writes table row k - 1 to the servos.
+			void write(size_type);
+			// Releases the servos at the end of a move.
+			void finish(bool);
+			void changeState(State);
+			void clock() override;
+			static void expire(void*);
+
+		private:
+			container_type			servos_;			// The group's servos.
+			position_type			targets_;			// Commanded angles of the current move.
+			pulse_type				pulses_[Steps][N];	// Precomputed pulse widths of each step.
+			uint32_t				interval_;			// Step interval in microseconds.
+			Timer<microseconds>		timer_;				// Move timer.
+			volatile size_type		index_;				// Number of steps written.
+			State					state_;				// The current group state.
+			Trigger					trigger_;			// The current step timing source.
+			callback_type			callback_;			// Client callback.
+		};
+
+		template<class T, std::size_t N, std::size_t Steps>
+		ServoGroup<T, N, Steps>::ServoGroup(const container_type& servos, callback_type cb) :
+			servos_(servos), targets_(), pulses_(), interval_(), timer_(), index_(),
+			state_(), trigger_(), callback_(cb)
+		{
+
+		}
+
+		template<class T, std::size_t N, std::size_t Steps>
+		void ServoGroup<T, N, Steps>::move(const position_type& targets, const duration_type& dur, Profile profile)
+		{
+			uint32_t us = static_cast<uint32_t>(duration_cast<microseconds>(dur).count());
+			angle_type from[N];
+
+			stop();
+			for (std::size_t i = 0; i < N; ++i)
+			{
+				const typename sweep_type::speed_type& spd = servos_[i]->speed();
+				const angle_type delta = targets[i] > servos_[i]->sweep()
+					? targets[i] - servos_[i]->sweep() : servos_[i]->sweep() - targets[i];
+
+				from[i] = servos_[i]->sweep();
+				if (spd.angle > angle_type(0))
+				{
+					const uint32_t min_us = static_cast<uint32_t>(peak(profile) * delta / spd.angle *
+						duration_cast<microseconds>(spd.interval).count());
+
+					if (min_us > us)
+						us = min_us;	// The slowest servo sets the pace.
+				}
+			}
+			for (std::size_t k = 1; k < Steps; ++k)
+			{
+				const float s = shape(profile, static_cast<float>(k) / Steps);
+
+				for (std::size_t i = 0; i < N; ++i)
+					pulses_[k - 1][i] = static_cast<pulse_type>(steps<servo_type>(from[i] + (targets[i] - from[i]) * s).count());
+			}
+			for (std::size_t i = 0; i < N; ++i)
+			{
+				pulses_[Steps - 1][i] = static_cast<pulse_type>(steps<servo_type>(targets[i]).count());
+				servos_[i]->driven_ = true;
+				servos_[i]->cmd_angle_ = targets[i];
+				servos_[i]->changeState(sweep_type::State::Active);
+			}
+			targets_ = targets;
+			interval_ = us / Steps ? us / Steps : 1;
+			index_ = 0;
+			changeState(State::Active);
+			timer_.start();
+# if defined __PG_HAS_HW_TIMER
+			if (trigger_ == Trigger::Interrupt)
+			{
+				hw_timer::begin(&ServoGroup<T, N, Steps>::expire, this);
+				hw_timer::arm(interval_);
+			}
+# endif
+		}
+
+		template<class T, std::size_t N, std::size_t Steps>
+		void ServoGroup<T, N, Steps>::stop()
+		{
+			if (state_ == State::Active)
+			{
+# if defined __PG_HAS_HW_TIMER
+				if (trigger_ == Trigger::Interrupt)
+					hw_timer::cancel();
+# endif
+				finish(false);
+			}
+		}
+
+		template<class T, std::size_t N, std::size_t Steps>
+		typename ServoGroup<T, N, Steps>::State ServoGroup<T, N, Steps>::state() const
+		{
+			return state_;
+		}
+
+		template<class T, std::size_t N, std::size_t Steps>
+		typename ServoGroup<T, N, Steps>::duration_type ServoGroup<T, N, Steps>::duration() const
+		{
+			return duration_cast<duration_type>(microseconds(static_cast<uint32_t>(interval_) * Steps));
+		}
+
+		template<class T, std::size_t N, std::size_t Steps>
+		const typename ServoGroup<T, N, Steps>::container_type& ServoGroup<T, N, Steps>::servos() const
+		{
+			return servos_;
+		}
+
+		template<class T, std::size_t N, std::size_t Steps>
+		void ServoGroup<T, N, Steps>::callback(callback_type cb)
+		{
+			callback_ = cb;
+		}
+
+		template<class T, std::size_t N, std::size_t Steps>
+		void ServoGroup<T, N, Steps>::trigger(Trigger source)
+		{
+# if defined __PG_HAS_HW_TIMER
+			stop();
+			trigger_ = source;
+# else
+			(void)source;	// Only polling is available.
+# endif
+		}
+
+		template<class T, std::size_t N, std::size_t Steps>
+		typename ServoGroup<T, N, Steps>::Trigger ServoGroup<T, N, Steps>::trigger() const
+		{
+			return trigger_;
+		}
+
+		template<class T, std::size_t N, std::size_t Steps>
+		float ServoGroup<T, N, Steps>::shape(Profile profile, float u)
+		{
+			float s = u;
+
+			switch (profile)
+			{
+			case Profile::Trapezoid:	// Accelerates over [0, 1/4], decelerates over [3/4, 1].
+				s = u < 0.25f ? 8.0f / 3.0f * u * u
+					: u <= 0.75f ? 4.0f / 3.0f * (u - 0.125f)
+					: 1.0f - 8.0f / 3.0f * (1.0f - u) * (1.0f - u);
+				break;
+			case Profile::SCurve:
+				s = u * u * u * (10.0f + u * (6.0f * u - 15.0f));
+				break;
+			default:
+				break;
+			}
+
+			return s;
+		}
+
+		template<class T, std::size_t N, std::size_t Steps>
+		float ServoGroup<T, N, Steps>::peak(Profile profile)
+		{
+			return profile == Profile::Trapezoid ? 4.0f / 3.0f
+				: profile == Profile::SCurve ? 15.0f / 8.0f
+				: 1.0f;
+		}
+
+		template<class T, std::size_t N, std::size_t Steps>
+		void ServoGroup<T, N, Steps>::write(size_type k)
+		{
+			for (std::size_t i = 0; i < N; ++i)
+				servos_[i]->servo_.writeMicroseconds(pulses_[k - 1][i]);
+			index_ = k;
+		}
+
+		template<class T, std::size_t N, std::size_t Steps>
+		void ServoGroup<T, N, Steps>::finish(bool done)
+		{
+			for (std::size_t i = 0; i < N; ++i)
+			{
+				sweep_type* servo = servos_[i];
+
+				servo->angle_ = done ? targets_[i] : angle<servo_type>(step_type(servo->servo_.readMicroseconds()));
+				servo->cmd_angle_ = servo->angle_;
+				servo->driven_ = false;
+				servo->changeState(sweep_type::State::Idle);
+			}
+			changeState(State::Idle);
+		}
+
+		template<class T, std::size_t N, std::size_t Steps>
+		void ServoGroup<T, N, Steps>::changeState(State state)
+		{
+			if (state_ != state)
+			{
+				state_ = state;
+				if (callback_)
+					(*callback_)(state);
+			}
+		}
+
+		template<class T, std::size_t N, std::size_t Steps>
+		void ServoGroup<T, N, Steps>::clock()
+		{
+			if (state_ == State::Active)
+			{
+				if (trigger_ == Trigger::Polled)
+				{
+					const uint32_t elapsed = static_cast<uint32_t>(timer_.elapsed().count()) / interval_;
+					const size_type k = static_cast<size_type>(elapsed < Steps ? elapsed : Steps);
+
+					if (k > index_)
+						write(k);	// Skips to the current step if clocked late.
+				}
+				if (index_ == Steps)
+					finish(true);
+			}
+		}
+
+		template<class T, std::size_t N, std::size_t Steps>
+		void ServoGroup<T, N, Steps>::expire(void* arg)
+		{
+# if defined __PG_HAS_HW_TIMER
+			ServoGroup<T, N, Steps>* group = static_cast<ServoGroup<T, N, Steps>*>(arg);
+
+			group->write(group->index_ + 1);
+			if (group->index_ < Steps)
+				hw_timer::arm(group->interval_);
+# else
+			(void)arg;
+# endif
+		}
+
+	} // namespace servos
+} // namespace pg
+
+# else // !defined __PG_HAS_NAMESPACES
+#  error Requires C++11 and namespace support.
+# endif // defined __PG_HAS_NAMESPACES
+
+#endif // !defined __PG_SERVOGROUP_H
@@ -47,10 +47,16 @@ namespace pg
 {
 	namespace servos
 	{
+		template<class T, std::size_t N, std::size_t Steps>
+		class ServoGroup;
+
 		// Asynchronous servo controller.
 		template<class T>
 		class SweepServo : public iclockable, public icomponent
 		{
+			template<class, std::size_t, std::size_t>
+			friend class ServoGroup;
+
 		public:
 			enum class State
 			{
@@ -110,6 +116,7 @@ namespace pg
 			pin_t			pin_;		// The currently attached pwm output pin.
 			State			state_;		// The current servo state.
 			bool			init_;		// Flag indicating initialization state.
+			bool			driven_;	// Flag indicating the servo is driven by a ServoGroup.
 			timer_type		timer_;		// Step interval timer.
 			speed_type		speed_;		// The current rotation speed.
 			speed_type		cmd_speed_;	// The commanded rotation speed.
@@ -120,7 +127,7 @@ namespace pg
 
 		template<class T>
 		SweepServo<T>::SweepServo() :
-			servo_(), pin_(InvalidPin), state_(), init_(), timer_(),
+			servo_(), pin_(InvalidPin), state_(), init_(), driven_(), timer_(),
 			speed_(LowRotationSpeed()), cmd_speed_(speed_),
 			angle_(MinControlAngle()), cmd_angle_(angle_), callback_()
 		{
@@ -245,7 +252,8 @@ namespace pg
 		template<class T>
 		void SweepServo<T>::clock()
 		{
-			auto_rotate();
+			if (!driven_)
+				auto_rotate();
 			timer_.reset();
 		}
 
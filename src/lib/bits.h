@@ -58,12 +58,19 @@
  *		widthof(t): Returns the width of t in bits.
  *		bitintlv(x, y): Interleves the bits in x with those in y.
  * 
+ *		bitrev() uses the RBIT instruction on ARM Thumb-2 architectures 
+ *		(Cortex-M3 and up), and bitnset(), bitnlsbclr() and bitparity() use 
+ *		the compiler's population count and count trailing zeros builtins 
+ *		where <lib/imath.h> selects them. AVR boards use the portable 
+ *		algorithms.
+ * 
  *  **************************************************************************/
 
 #if !defined __PG_BITS_H
 # define __PG_BITS_H  2051215L
 
 # include <cstddef> // CHAR_BIT
+# include <cstdint>	// Fixed-width integer types.
 # include <lib/imath.h>	// Template substitution helpers.
  
 # if defined __PG_HAS_NAMESPACES
@@ -95,6 +102,42 @@ namespace pg
 {
 	namespace details
 	{
+# if defined __PG_HAS_ARM_RBIT
+		// Returns the bits of x in reverse order.
+		inline uint32_t rbit(uint32_t x)
+		{
+			uint32_t result;
+
+			__asm__("rbit %0, %1" : "=r" (result) : "r" (x));
+
+			return result;
+		}
+
+		template<class T> inline
+			T bitrev_8(T b)
+		{
+			return static_cast<T>(rbit(static_cast<uint8_t>(b)) >> 24);
+		}
+
+		template<class T> inline
+			T bitrev_16(T b)
+		{
+			return static_cast<T>(rbit(static_cast<uint16_t>(b)) >> 16);
+		}
+
+		template<class T> inline
+			T bitrev_32(T b)
+		{
+			return static_cast<T>(rbit(static_cast<uint32_t>(b)));
+		}
+
+		template<class T> inline
+			T bitrev_64(T b)
+		{
+			return static_cast<T>((static_cast<uint64_t>(rbit(static_cast<uint32_t>(b))) << 32) | 
+				rbit(static_cast<uint32_t>(static_cast<uint64_t>(b) >> 32)));
+		}
+# else
 		template<class T> inline
 			T bitrev_8(T b)
 		{
@@ -106,15 +149,20 @@ namespace pg
 		template<class T> inline
 			T bitrev_16(T b)
 		{
-			return  (b = bitrev_8(b), 
-				(b = (((b & 0xff00) >> 8) | ((b & 0x00ff) << 8))));
+			return  (b = (((b & 0xaaaa) >> 1) | ((b & 0x5555) << 1)), 
+				b = (((b & 0xcccc) >> 2) | ((b & 0x3333) << 2)), 
+				b = (((b & 0xf0f0) >> 4) | ((b & 0x0f0f) << 4)), 
+				b = (((b & 0xff00) >> 8) | ((b & 0x00ff) << 8)));
 		}
 
 		template<class T> inline
 			T bitrev_32(T b)
 		{
-			return (b = bitrev_16(b), 
-				(b = (((b & 0x0000ffff) << 16) | ((b & 0xffff0000) >> 16))));
+			return (b = (((b & 0xaaaaaaaa) >> 1) | ((b & 0x55555555) << 1)), 
+				b = (((b & 0xcccccccc) >> 2) | ((b & 0x33333333) << 2)), 
+				b = (((b & 0xf0f0f0f0) >> 4) | ((b & 0x0f0f0f0f) << 4)), 
+				b = (((b & 0xff00ff00) >> 8) | ((b & 0x00ff00ff) << 8)), 
+				b = (((b & 0x0000ffff) << 16) | ((b & 0xffff0000) >> 16)));
 		}
 
 		template<class T> inline
@@ -127,6 +175,7 @@ namespace pg
 				b = (((b & 0x0000ffff0000ffff) << 16) | ((b & 0xffff0000ffff0000) >> 16)), 
 				b = (((b & 0x00000000ffffffff) << 32) | ((b & 0xffffffffffffffff) >> 32)));
 		}
+# endif // defined __PG_HAS_ARM_RBIT
 
 		template <class T, size_t N>
 		struct bitrev_impl;
@@ -253,12 +302,7 @@ namespace pg
 	inline typename details::is_unsigned<T, size_t>::type
 		bitnset(T b)
 	{
-		size_t n = 0;
-
-		for (; b; n++) 
-			b &= b - 1;
-
-		return n;
+		return static_cast<size_t>(details::popcount(b));
 	}
 
 #if defined CHAR_BIT
@@ -267,14 +311,7 @@ namespace pg
 	inline typename details::is_unsigned<T, size_t>::type
 		bitnlsbclr(T b)
 	{
-		T n = pg::widthof(b);
-
-		if (b) {
-			b = (b ^ (b - 1)) >> 1;
-			for (n = 0; b; n++) b &= b - 1;
-		}
-
-		return static_cast<size_t>(n);
+		return b ? static_cast<size_t>(details::ctz(b)) : pg::widthof(b);
 	}
 #endif // defined CHAR_BIT
 
@@ -283,11 +320,7 @@ namespace pg
 	inline typename details::is_unsigned<T, bool>::type
 		bitparity(T b)
 	{
-		bool f = 0;
-
-		while (b) { f = !f; b = b & (b - 1); }
-
-		return f;
+		return (details::popcount(b) & 1) != 0;
 	}
 
 	/* Swaps the two values a and b. */
@@ -38,6 +38,8 @@
  *	checksum(): generates an inverted checksum from an input stream.
  *	     crc(): generates a crc remainder from an input byte stream.
  *	 crc_lut(): generates a crc lookup table for improved performance.
+ *	crc_table: compile-time crc lookup table stored in program memory.
+ *	crc_engine: computes a crc remainder incrementally, a byte at a time.
  * 
  *	Standard Parameterized Algorithms:
  * 
@@ -160,6 +162,29 @@
  *		crc(msg, msg + 9, crc_8);		// no lookup table.
  *		crc(msg, msg + 9, lut, crc_8);	// with lookup table.
  * 
+ *	The crc_table type holds the lookup table for one of the standard 
+ *	parameterized algorithm types. Tables are generated at compile time, 
+ *	stored in program memory (flash) and shared by all algorithms with the 
+ *	same polynomial, so they cost no RAM. Passing a crc_table to crc() 
+ *	selects the table-driven algorithm:
+ * 
+ *		crc(msg, msg + 9, crc_table<crc_32>()); 
+ * 
+ *	The crc_engine type computes the same remainders incrementally, for 
+ *	streams that arrive a byte or a block at a time. It needs no padding and 
+ *	can run bit-wise or with the algorithm's crc_table:
+ * 
+ *		crc_engine<crc_16_modbus, true> engine;	// true = use crc_table.
+ *		engine.update(msg, msg + 4).update(msg + 4, msg + 9);
+ *		uint16_t remainder = engine.value();
+ * 
+ *	On targets with a CRC peripheral (see system/boards.h), crc() calls 
+ *	taking a crc_traits or crc_table argument are computed by the hardware 
+ *	for algorithms it implements: 16-bit algorithms with poly 0x1021 and no 
+ *	reflection (crc_16_ccitt_false, crc_16_xmodem, crc_16_genibus, ...) and 
+ *	crc_32. All other algorithms, and crc_engine, run in software. Defining 
+ *	__PG_NO_DMAC_CRC disables the hardware backend.
+ * 
  *	Notes:
  *
  * 	The checksum() functions operate on streams of any unsigned type, crc() 
@@ -182,6 +207,8 @@
 #include <array>		// iterator_traits.
 #include <limits>		// numeric_limits.
 #include <lib/imath.h>	// is_unsigned template.
+#include <lib/progmem.h>	// __PG_PROGMEM, pgm_read().
+#include <system/boards.h>	// __PG_HAS_DMAC_CRC.
 
 # if defined __PG_HAS_NAMESPACES 
 
@@ -686,6 +713,30 @@ namespace pg
 			return result;
 		}
 
+		// Returns remainder rem updated with input byte in, computed bit-wise.
+		template<class Poly>
+		Poly crc_update(Poly rem, uint8_t in, Poly poly)
+		{
+			using shift_type = crc_shift<Poly>;
+
+			rem ^= (static_cast<Poly>(in) << (shift_type::width() - CHAR_BIT));
+			for (uint8_t j = 0; j < CHAR_BIT; ++j)
+				rem = rem & shift_type::top()
+				? (rem << 1) ^ poly
+				: (rem << 1);
+
+			return rem;
+		}
+
+		// Returns remainder rem updated with input byte in, using program memory table lut.
+		template<class Poly>
+		Poly crc_update_pgm(Poly rem, uint8_t in, const Poly* lut)
+		{
+			uint8_t i = in ^ static_cast<uint8_t>(rem >> (crc_shift<Poly>::width() - CHAR_BIT));
+
+			return pgm_read(lut + i) ^ static_cast<Poly>(rem << CHAR_BIT);
+		}
+
 		// Returns the CRC remainder for byte stream [first,last) using 
 		// CRC parameters poly, xorin, xorout, refin and refout.
 		template<class InputIt, class Poly>
@@ -694,33 +745,60 @@ namespace pg
 				Poly xorout, bool refin, bool refout)
 		{
 			// Message length must be >= size of generator polynomial, in bytes.
-			assert(std::distance(first, last) >= sizeof(Poly));
-			using msg_type = typename std::iterator_traits<InputIt>::value_type;
+			assert(std::distance(first, last) >= static_cast<typename std::iterator_traits<InputIt>::difference_type>(sizeof(Poly)));
 			using poly_type = Poly;
-			using shift_type = crc_shift<Poly>;
 
 			poly_type rem = xorin;	// crc remainder.
 
 			for (; first != last; ++first)
-			{
-				msg_type in = refin ? crc_reflect(*first) : *first;	// input byte.
-
-				rem ^= (static_cast<poly_type>(in) << (shift_type::width() - CHAR_BIT));
-				for (uint8_t j = 0; j < CHAR_BIT; ++j)
-					rem = rem & shift_type::top() 
-					? (rem << 1) ^ poly
-					: (rem << 1);
-			}
+				rem = crc_update(rem, refin ? crc_reflect(*first) : *first, poly);
 
 			return xorout ^ (refout ? crc_reflect(rem) : rem);
 		}
 
+		// Returns the lookup table entry for byte value rem << (w - 8) and polynomial poly.
+		template<class Poly>
+		constexpr Poly crc_lut_entry(Poly rem, Poly poly, uint8_t bits = CHAR_BIT)
+		{
+			return bits 
+				? crc_lut_entry<Poly>(rem & crc_shift<Poly>::top()
+					? static_cast<Poly>(static_cast<Poly>(rem << 1) ^ poly)
+					: static_cast<Poly>(rem << 1), poly, bits - 1)
+				: rem;
+		}
+
+		// Compile-time sequence of table indexes.
+		template<std::size_t...>
+		struct crc_indexes {};
+
+		template<std::size_t N, std::size_t... Is>
+		struct crc_make_indexes : crc_make_indexes<N - 1, N - 1, Is...> {};
+
+		template<std::size_t... Is>
+		struct crc_make_indexes<0, Is...> { using type = crc_indexes<Is...>; };
+
+		// Lookup table for polynomial P, one instance per distinct polynomial.
+		template<class Poly, Poly P, class Indexes = typename crc_make_indexes<256>::type>
+		struct crc_lut_data;
+
+		template<class Poly, Poly P, std::size_t... Is>
+		struct crc_lut_data<Poly, P, crc_indexes<Is...>>
+		{
+			static const Poly table[sizeof...(Is)];
+		};
+
+		template<class Poly, Poly P, std::size_t... Is>
+		const Poly crc_lut_data<Poly, P, crc_indexes<Is...>>::table[sizeof...(Is)] __PG_PROGMEM = 
+		{
+			crc_lut_entry<Poly>(static_cast<Poly>(static_cast<Poly>(Is) << (crc_shift<Poly>::width() - CHAR_BIT)), P)...
+		};
+
 		// Returns the CRC remainder for byte stream [first,last) using 
 		// table in [lutfirst,lutlast) and CRC parameters poly, xorin, xorout, refin and refout.
 		template<class InputIt, class InputIt2>
 		typename is_crc<InputIt, typename std::iterator_traits<InputIt2>::value_type>::type
 			crc_lut_impl(InputIt first, InputIt last, InputIt2 lutfirst, InputIt2 lutlast,
-				typename std::iterator_traits<InputIt2>::value_type poly,
+				typename std::iterator_traits<InputIt2>::value_type,	// poly, already applied to the table.
 				typename std::iterator_traits<InputIt2>::value_type xorin,
 				typename std::iterator_traits<InputIt2>::value_type xorout,
 				bool refin, bool refout)
@@ -729,7 +807,8 @@ namespace pg
 			using poly_type = typename std::iterator_traits<InputIt2>::value_type;
 			using shift_type = crc_shift<poly_type>;
 			// Message length must be >= size of generator polynomial in bytes, and table size must = 256.
-			assert(std::distance(first, last) >= sizeof(poly_type) && std::distance(lutfirst, lutlast) == 256);
+			assert(std::distance(first, last) >= static_cast<typename std::iterator_traits<InputIt>::difference_type>(sizeof(poly_type)) && 
+				std::distance(lutfirst, lutlast) == 256);
 
 			poly_type rem = xorin;	// crc remainder.
 			uint8_t i;				// lookup table index.
@@ -745,9 +824,150 @@ namespace pg
 			return xorout ^ (refout ? crc_reflect(rem) : rem);
 		}
 
+		// Returns the CRC remainder for byte stream [first,last) using the 256-entry 
+		// program memory table lut and CRC parameters xorin, xorout, refin and refout.
+		template<class InputIt, class Poly>
+		typename is_crc<InputIt, Poly>::type
+			crc_pgm_impl(InputIt first, InputIt last, const Poly* lut, 
+				Poly xorin, Poly xorout, bool refin, bool refout)
+		{
+			Poly rem = xorin;	// crc remainder.
+
+			for (; first != last; ++first)
+				rem = crc_update_pgm(rem, refin ? crc_reflect(*first) : *first, lut);
+
+			return xorout ^ (refout ? crc_reflect(rem) : rem);
+		}
+
+		// Checks whether the CRC peripheral implements algorithm Crc.
+		template<class Crc>
+		struct crc_hw_capable
+		{
+			static constexpr bool value = 
+				(sizeof(typename Crc::value_type) == sizeof(uint16_t) && 
+					Crc::poly == 0x1021 && !Crc::refin && !Crc::refout) ||
+				(sizeof(typename Crc::value_type) == sizeof(uint32_t) && 
+					Crc::poly == 0x04C11DB7 && Crc::refin && Crc::refout && 
+					Crc::xorin == 0xFFFFFFFF && Crc::xorout == 0xFFFFFFFF);
+		};
+
+# if defined __PG_HAS_DMAC_CRC
+		// Returns the CRC remainder for byte stream [first,last) computed by the DMAC 
+		// CRC unit, which must implement algorithm Crc. Sets done to false if the unit  
+		// is in use by a DMA channel.
+		template<class Crc, class InputIt>
+		typename Crc::value_type crc_hw(InputIt first, InputIt last, bool& done)
+		{
+			using value_type = typename Crc::value_type;
+
+			value_type rem = 0;
+
+			if ((done = !(DMAC->CTRL.reg & DMAC_CTRL_CRCENABLE)))
+			{
+				DMAC->CRCCTRL.reg = DMAC_CRCCTRL_CRCBEATSIZE_BYTE | DMAC_CRCCTRL_CRCSRC_IO | 
+					(sizeof(value_type) == sizeof(uint32_t) ? DMAC_CRCCTRL_CRCPOLY_CRC32 : DMAC_CRCCTRL_CRCPOLY_CRC16);
+				DMAC->CRCCHKSUM.reg = Crc::xorin;
+				DMAC->CTRL.reg |= DMAC_CTRL_CRCENABLE;
+				for (; first != last; ++first)
+				{
+					DMAC->CRCDATAIN.reg = *first;
+					__asm__ __volatile__("nop\n\tnop\n\tnop\n\tnop");	// Wait for the unit to absorb the byte.
+				}
+				// The CRC-32 checksum register is kept reflected, so only xorout remains.
+				rem = static_cast<value_type>(DMAC->CRCCHKSUM.reg) ^ Crc::xorout;
+				DMAC->CTRL.reg &= ~DMAC_CTRL_CRCENABLE;
+				DMAC->CRCCTRL.reg &= ~DMAC_CRCCTRL_CRCSRC_Msk;
+			}
 
+			return rem;
+		}
+# endif // defined __PG_HAS_DMAC_CRC
+
+		// Returns the CRC remainder for byte stream [first,last) using CRC algorithm Crc, 
+		// computed by the CRC peripheral if it can, else with lookup table lut, if any.
+		template<class Crc, class InputIt>
+		typename is_crc<InputIt, typename Crc::value_type>::type
+			crc_dispatch(InputIt first, InputIt last, const typename Crc::value_type* lut)
+		{
+# if defined __PG_HAS_DMAC_CRC
+			if (crc_hw_capable<Crc>::value)
+			{
+				bool done = false;
+				typename Crc::value_type rem = crc_hw<Crc>(first, last, done);
+
+				if (done)
+					return rem;
+			}
+# endif
+			return lut
+				? crc_pgm_impl(first, last, lut, Crc::xorin, Crc::xorout, Crc::refin, Crc::refout)
+				: crc_impl(first, last, Crc::poly, Crc::xorin, Crc::xorout, Crc::refin, Crc::refout);
+		}
 	} // namespace details
 
+	// Type that holds the compile-time lookup table of CRC algorithm Crc in program memory.
+	template<class Crc>
+	struct crc_table
+	{
+		using crc_type = Crc;
+		using value_type = typename crc_type::value_type;
+		using data_type = details::crc_lut_data<value_type, crc_type::poly>;
+
+		static constexpr std::size_t size() { return sizeof(data_type::table) / sizeof(value_type); }
+		static const value_type* data() { return data_type::table; }	// Program memory address.
+	};
+
+	// Type that computes the CRC remainder of a byte stream incrementally, using 
+	// CRC algorithm Crc, either bit-wise or with its program memory crc_table.
+	template<class Crc, bool Table = false>
+	class crc_engine
+	{
+	public:
+		using crc_type = Crc;
+		using value_type = typename crc_type::value_type;
+
+	public:
+		crc_engine() : rem_(crc_type::xorin) {}
+
+	public:
+		void reset() { rem_ = crc_type::xorin; }	// Starts a new stream.
+		crc_engine& update(uint8_t);				// Adds one byte to the stream.
+		template<class InputIt>
+		crc_engine& update(InputIt, InputIt);		// Adds a range of bytes to the stream.
+		value_type value() const;					// Returns the CRC remainder of the stream so far.
+
+	private:
+		value_type rem_;	// Running crc remainder, before output reflection and xorout.
+	};
+
+	template<class Crc, bool Table>
+	crc_engine<Crc, Table>& crc_engine<Crc, Table>::update(uint8_t in)
+	{
+		if (crc_type::refin)
+			in = details::crc_reflect(in);
+		rem_ = Table
+			? details::crc_update_pgm(rem_, in, crc_table<Crc>::data())
+			: details::crc_update(rem_, in, crc_type::poly);
+
+		return *this;
+	}
+
+	template<class Crc, bool Table>
+	template<class InputIt>
+	crc_engine<Crc, Table>& crc_engine<Crc, Table>::update(InputIt first, InputIt last)
+	{
+		for (; first != last; ++first)
+			update(static_cast<uint8_t>(*first));
+
+		return *this;
+	}
+
+	template<class Crc, bool Table>
+	typename crc_engine<Crc, Table>::value_type crc_engine<Crc, Table>::value() const
+	{
+		return crc_type::xorout ^ (crc_type::refout ? details::crc_reflect(rem_) : rem_);
+	}
+
 	// Appends r, byte at a time, beginning at first upto one before last, preserving endianness. 
 	template<class InputIt, class Poly>
 	typename details::is_crc<InputIt, Poly, InputIt>::type
@@ -762,7 +982,7 @@ namespace pg
 
 	// Generates a CRC lookup table in range [first,last) using polynomial poly.
 	template<class InputIt>
-	typename details::is_unsigned<typename std::iterator_traits<InputIt>::value_type>::type
+	typename details::is_unsigned<typename std::iterator_traits<InputIt>::value_type, void>::type
 		crc_lut(InputIt first, InputIt last, typename std::iterator_traits<InputIt>::value_type poly)
 	{
 		using poly_type = typename std::iterator_traits<InputIt>::value_type;
@@ -798,12 +1018,9 @@ namespace pg
 
 	// Returns the CRC remainder for byte stream [first,last) using CRC parameters crc.
 	template<class InputIt, class T> inline
-	typename crc_traits<T>::value_type crc(InputIt first, InputIt last, crc_traits<T> crc)
+	typename crc_traits<T>::value_type crc(InputIt first, InputIt last, crc_traits<T>)
 	{
-		using crc_type = crc_traits<T>;
-
-		return details::crc_impl(first, last, crc_type::poly, crc_type::xorin,
-			crc_type::xorout, crc_type::refin, crc_type::refout);
+		return details::crc_dispatch<crc_traits<T>>(first, last, nullptr);
 	}
 
 	// Returns the CRC remainder for byte stream [first,last) using table in [lutfirst,lutlast), 
@@ -843,7 +1060,7 @@ namespace pg
 	// Returns the CRC remainder for byte stream [first,last) using 
 	// table in array lut and CRC parameters crc.
 	template<class InputIt, class Poly, std::size_t N, class T> inline
-	Poly crc(InputIt first, InputIt last, Poly (&lut)[N], crc_traits<T> crc)
+	Poly crc(InputIt first, InputIt last, Poly (&lut)[N], crc_traits<T>)
 	{
 		using crc_type = crc_traits<T>;
 
@@ -851,6 +1068,14 @@ namespace pg
 			crc_type::poly, crc_type::xorin, crc_type::xorout, crc_type::refin, crc_type::refout);
 	}
 
+	// Returns the CRC remainder for byte stream [first,last) using 
+	// CRC parameters and program memory lookup table tbl.
+	template<class InputIt, class Crc> inline
+	typename crc_table<Crc>::value_type crc(InputIt first, InputIt last, crc_table<Crc> tbl)
+	{
+		return details::crc_dispatch<Crc>(first, last, tbl.data());
+	}
+
 	// Returns the checksum for stream range [first, last).
 	template<class InputIt> 
 	typename details::is_unsigned<typename std::iterator_traits<InputIt>::value_type>::type
@@ -0,0 +1,408 @@
+/*
+ *	This files defines fixed-size, in-place fast Fourier transforms and
+ *	spectrum helpers.
+ *
+ *	***************************************************************************
+ *
+ *	File: fft.h
+ *	Date: October 14, 2026
+ *	Version: 1.0
+ *	Author: Michael Brodsky
+ *	Email: mbrodskiis@gmail.com
+ *	Copyright (c) 2012-2022 Michael Brodsky
+ *
+ *	***************************************************************************
+ *
+ *  This file is part of "Pretty Good" (Pg). "Pg" is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  This file is distributed in the hope that it will be useful, but
+ *	WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this file. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *	**************************************************************************
+ *
+ *	Description:
+ *
+ *	The transforms in this file compute the discrete Fourier transform of N
+ *	complex values in place, with the iterative radix-2 algorithm, where N
+ *	is a compile-time power of two:
+ *
+ *		fft<N>(x), ifft<N>(x): transform the N values at x,
+ *		fft(a), ifft(a): transform the values of a std::array or
+ *			std::valarray of N values.
+ *
+ *	Values are either std::complex<float> (or double), or std::complex<int16_t>
+ *	holding Q15 fixed-point values in [-1, 1). Float ifft() scales its
+ *	result by 1/N, so ifft(fft(x)) == x. Q15 transforms halve their values
+ *	at each of the log2(N) stages so they can't overflow, so fft() returns
+ *	the spectrum scaled by 1/N, and input magnitudes must not exceed 1 (real
+ *	samples in [-1, 1) always qualify).
+ *
+ *	The twiddle factors of each N and value type are computed at compile
+ *	time and stored in program memory (see <lib/progmem.h>): N values of
+ *	type float or int16_t, so a 256-point float transform uses 1 KB of
+ *	flash and no RAM beyond its values.
+ *
+ *	The spectrum helpers summarize a transform, so clients can send a few
+ *	numbers instead of raw samples:
+ *
+ *		bin_power(z): returns the squared magnitude of a bin,
+ *		bin_magnitude(z): returns the magnitude of a bin,
+ *		bin_frequency<N>(bin, rate): returns the frequency of a bin in Hz,
+ *			for samples taken at rate Hz,
+ *		fft_peak<N>(x): returns the bin in [1, N/2) with the greatest
+ *			power, ignoring DC,
+ *		band_energy(x, first, last): returns the total power of bins
+ *			[first, last).
+ *
+ *	Q15 powers are returned as uint32_t Q30 values, energies as uint64_t.
+ *	For example, the dominant vibration frequency and its band energy of
+ *	64 accelerometer samples taken at 1 kHz:
+ *
+ *		std::array<std::complex<int16_t>, 64> x;
+ *		for (auto& z : x)
+ *			z = std::complex<int16_t>((analogRead(A0) - 512) << 6, 0);
+ *		pg::fft(x);
+ *		std::size_t peak = pg::fft_peak<64>(x.data());
+ *		float hz = pg::bin_frequency<64>(peak, 1000.0f);
+ *		uint64_t e = pg::band_energy(x.data(), peak - 1, peak + 2);
+ *
+ *	**************************************************************************/
+
+#if !defined __PG_FFT_H
+# define __PG_FFT_H 20261014L
+
+# include <array>			// std::array
+# include <cmath>			// std::sqrt
+# include <complex>			// std::complex
+# include <cstddef>			// std::size_t
+# include <cstdint>			// Fixed-width integer types.
+# include <numbers>			// std::numbers::two_pi
+# include <type_traits>		// Type traits.
+# include <utility>			// std::swap
+# include <valarray>		// std::valarray
+# include <lib/progmem.h>	// Twiddle tables in program memory.
+
+# if defined __PG_HAS_NAMESPACES
+
+namespace pg
+{
+	namespace details
+	{
+		template<std::size_t... I>
+		struct fft_indices {};
+
+		template<class, class>
+		struct fft_concat;
+
+		template<std::size_t... I, std::size_t... J>
+		struct fft_concat<fft_indices<I...>, fft_indices<J...>>
+		{
+			using type = fft_indices<I..., (sizeof...(I) + J)...>;
+		};
+
+		// Generates indices [0, N) with logarithmic template recursion depth.
+		template<std::size_t N>
+		struct fft_make_indices
+		{
+			using type = typename fft_concat<typename fft_make_indices<N / 2>::type,
+				typename fft_make_indices<N - N / 2>::type>::type;
+		};
+
+		template<>
+		struct fft_make_indices<0> { using type = fft_indices<>; };
+
+		template<>
+		struct fft_make_indices<1> { using type = fft_indices<0>; };
+
+		// Returns the sum of the Taylor series terms of sin or cos, starting with term n.
+		constexpr double fft_series(double x2, double term, unsigned n)
+		{
+			return n > 24 ? term : term + fft_series(x2, -term * x2 / ((n + 1) * (n + 2)), n + 2);
+		}
+
+		constexpr double fft_angle(std::size_t k, std::size_t n)
+		{
+			return std::numbers::two_pi * k / n;
+		}
+
+		// Returns cos or sin(2 * pi * k / n), k in [0, n/2), reduced to [0, pi/2] for accuracy.
+		constexpr double fft_sincos(std::size_t k, std::size_t n, bool sine)
+		{
+			return k > n / 4
+				? (sine ? 1.0 : -1.0) * fft_sincos(n / 2 - k, n, sine)
+				: sine
+					? fft_series(fft_angle(k, n) * fft_angle(k, n), fft_angle(k, n), 1)
+					: fft_series(fft_angle(k, n) * fft_angle(k, n), 1.0, 0);
+		}
+
+		template<class T>
+		constexpr typename std::enable_if<std::is_floating_point<T>::value, T>::type
+			fft_coeff(double v)
+		{
+			return static_cast<T>(v);
+		}
+
+		template<class T>
+		constexpr typename std::enable_if<std::is_same<T, int16_t>::value, T>::type
+			fft_coeff(double v)
+		{
+			return v * 32768.0 >= 32767.0 ? INT16_MAX : static_cast<T>(v * 32768.0 + (v < 0 ? -0.5 : 0.5));
+		}
+
+		// Twiddle factors of an N-point transform, cos and sin of 2 * pi * k / N, k in [0, N/2), interleaved.
+		template<class T, std::size_t N, class = typename fft_make_indices<N>::type>
+		struct fft_twiddles;
+
+		template<class T, std::size_t N, std::size_t... I>
+		struct fft_twiddles<T, N, fft_indices<I...>>
+		{
+			static const T table[N];
+		};
+
+		template<class T, std::size_t N, std::size_t... I>
+		const T fft_twiddles<T, N, fft_indices<I...>>::table[N] __PG_PROGMEM =
+		{
+			fft_coeff<T>(fft_sincos(I / 2, N, I & 1))...
+		};
+
+		template<std::size_t N, class T>
+		void fft_reorder(std::complex<T>* x)
+		{
+			static_assert(N >= 2 && (N & (N - 1)) == 0, "fft size must be a power of two.");
+
+			for (std::size_t i = 1, j = 0; i < N; ++i)
+			{
+				std::size_t bit = N >> 1;
+
+				for (; j & bit; bit >>= 1)
+					j ^= bit;
+				j ^= bit;
+				if (i < j)
+					std::swap(x[i], x[j]);
+			}
+		}
+
+		template<std::size_t N, class T>
+		typename std::enable_if<std::is_floating_point<T>::value>::type
+			fft_transform(std::complex<T>* x, bool inverse)
+		{
+			const T* twiddles = fft_twiddles<T, N>::table;
+
+			fft_reorder<N>(x);
+			for (std::size_t len = 2, step = N; len <= N; len <<= 1, step >>= 1)
+			{
+				const std::size_t half = len >> 1;
+
+				for (std::size_t k = 0; k < half; ++k)
+				{
+					const T wr = pgm_read(twiddles + k * step);
+					const T wi = inverse ? pgm_read(twiddles + k * step + 1) : -pgm_read(twiddles + k * step + 1);
+
+					for (std::size_t i = k; i < N; i += len)
+					{
+						const T ar = x[i + half].real(), ai = x[i + half].imag();
+						const T tr = ar * wr - ai * wi, ti = ar * wi + ai * wr;
+						const T ur = x[i].real(), ui = x[i].imag();
+
+						x[i] = std::complex<T>(ur + tr, ui + ti);
+						x[i + half] = std::complex<T>(ur - tr, ui - ti);
+					}
+				}
+			}
+			if (inverse)
+			{
+				const T scale = T(1) / N;
+
+				for (std::size_t i = 0; i < N; ++i)
+					x[i] = std::complex<T>(x[i].real() * scale, x[i].imag() * scale);
+			}
+		}
+
+		template<std::size_t N>
+		void fft_transform(std::complex<int16_t>* x, bool inverse)
+		{
+			const int16_t* twiddles = fft_twiddles<int16_t, N>::table;
+
+			fft_reorder<N>(x);
+			for (std::size_t len = 2, step = N; len <= N; len <<= 1, step >>= 1)
+			{
+				const std::size_t half = len >> 1;
+
+				for (std::size_t k = 0; k < half; ++k)
+				{
+					const int32_t wr = pgm_read(twiddles + k * step);
+					const int32_t ws = pgm_read(twiddles + k * step + 1);
+					const int32_t wi = inverse ? ws : -ws;
+
+					for (std::size_t i = k; i < N; i += len)
+					{
+						const int32_t ar = x[i + half].real(), ai = x[i + half].imag();
+						const int32_t tr = (ar * wr - ai * wi + 0x4000) >> 15;	// Q15 products, rounded.
+						const int32_t ti = (ar * wi + ai * wr + 0x4000) >> 15;
+						const int32_t ur = x[i].real(), ui = x[i].imag();
+
+						x[i] = std::complex<int16_t>((ur + tr) >> 1, (ui + ti) >> 1);	// Scaled by 1/2 per stage.
+						x[i + half] = std::complex<int16_t>((ur - tr) >> 1, (ui - ti) >> 1);
+					}
+				}
+			}
+		}
+
+		inline uint16_t fft_isqrt(uint32_t n)
+		{
+			uint32_t root = 0, bit = 1UL << 30;
+
+			while (bit > n)
+				bit >>= 2;
+			while (bit)
+			{
+				if (n >= root + bit)
+				{
+					n -= root + bit;
+					root = (root >> 1) + bit;
+				}
+				else
+					root >>= 1;
+				bit >>= 2;
+			}
+
+			return static_cast<uint16_t>(root);
+		}
+	} // namespace details
+
+	// Computes the N-point forward transform of the values at x in place.
+	template<std::size_t N, class T>
+	void fft(std::complex<T>* x)
+	{
+		details::fft_transform<N>(x, false);
+	}
+
+	// Computes the N-point inverse transform of the values at x in place.
+	template<std::size_t N, class T>
+	void ifft(std::complex<T>* x)
+	{
+		details::fft_transform<N>(x, true);
+	}
+
+	// Computes the forward transform of an array in place.
+	template<class T, std::size_t N>
+	void fft(std::array<std::complex<T>, N>& a)
+	{
+		fft<N>(a.data());
+	}
+
+	// Computes the inverse transform of an array in place.
+	template<class T, std::size_t N>
+	void ifft(std::array<std::complex<T>, N>& a)
+	{
+		ifft<N>(a.data());
+	}
+
+	// Computes the forward transform of a valarray of N values in place.
+	template<class T, std::size_t N, template<class, std::size_t> class Alloc>
+	void fft(std::valarray<std::complex<T>, N, Alloc>& a)
+	{
+		fft<N>(std::begin(a));
+	}
+
+	// Computes the inverse transform of a valarray of N values in place.
+	template<class T, std::size_t N, template<class, std::size_t> class Alloc>
+	void ifft(std::valarray<std::complex<T>, N, Alloc>& a)
+	{
+		ifft<N>(std::begin(a));
+	}
+
+	// Returns the squared magnitude of a bin.
+	template<class T>
+	typename std::enable_if<std::is_floating_point<T>::value, T>::type
+		bin_power(const std::complex<T>& z)
+	{
+		return z.real() * z.real() + z.imag() * z.imag();
+	}
+
+	// Returns the squared magnitude of a Q15 bin, in Q30.
+	inline uint32_t bin_power(const std::complex<int16_t>& z)
+	{
+		return static_cast<uint32_t>(int32_t(z.real()) * z.real()) + static_cast<uint32_t>(int32_t(z.imag()) * z.imag());
+	}
+
+	// Returns the magnitude of a bin.
+	template<class T>
+	typename std::enable_if<std::is_floating_point<T>::value, T>::type
+		bin_magnitude(const std::complex<T>& z)
+	{
+		return std::sqrt(bin_power(z));
+	}
+
+	// Returns the magnitude of a Q15 bin, in Q15.
+	inline uint16_t bin_magnitude(const std::complex<int16_t>& z)
+	{
+		return details::fft_isqrt(bin_power(z));
+	}
+
+	// Returns the frequency in Hz of a bin of an N-point transform of samples taken at `rate' Hz.
+	template<std::size_t N>
+	constexpr float bin_frequency(std::size_t bin, float rate)
+	{
+		return bin * rate / N;
+	}
+
+	// Returns the bin in [1, N/2) of an N-point transform with the greatest power.
+	template<std::size_t N, class T>
+	std::size_t fft_peak(const std::complex<T>* x)
+	{
+		std::size_t peak = 1;
+		auto peak_power = bin_power(x[1]);
+
+		for (std::size_t i = 2; i < N / 2; ++i)
+		{
+			const auto p = bin_power(x[i]);
+
+			if (p > peak_power)
+			{
+				peak = i;
+				peak_power = p;
+			}
+		}
+
+		return peak;
+	}
+
+	// Returns the total power of bins [first, last).
+	template<class T>
+	typename std::enable_if<std::is_floating_point<T>::value, T>::type
+		band_energy(const std::complex<T>* x, std::size_t first, std::size_t last)
+	{
+		T energy = 0;
+
+		for (; first < last; ++first)
+			energy += bin_power(x[first]);
+
+		return energy;
+	}
+
+	// Returns the total power of Q15 bins [first, last), in Q30.
+	inline uint64_t band_energy(const std::complex<int16_t>* x, std::size_t first, std::size_t last)
+	{
+		uint64_t energy = 0;
+
+		for (; first < last; ++first)
+			energy += bin_power(x[first]);
+
+		return energy;
+	}
+} // namespace pg
+
+# else // !defined __PG_HAS_NAMESPACES
+#  error Requires C++11 and namespace support.
+# endif // defined __PG_HAS_NAMESPACES
+
+#endif // !defined __PG_FFT_H
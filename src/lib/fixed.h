@@ -0,0 +1,393 @@
+/*
+ *	This file defines a saturating fixed-point numeric type.
+ *
+ *	***************************************************************************
+ *
+ *	File: fixed.h
+ *	Date: October 14, 2026
+ *	Version: 1.0
+ *	Author: Michael Brodsky
+ *	Email: mbrodskiis@gmail.com
+ *	Copyright (c) 2012-2022 Michael Brodsky
+ *
+ *	***************************************************************************
+ *
+ *  This file is part of "Pretty Good" (Pg). "Pg" is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  This file is distributed in the hope that it will be useful, but
+ *	WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *	along with this file. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *	**************************************************************************
+ *
+ *	Description:
+ *
+ *	The `fixed<I, F>' type is a signed Q-format fixed-point number with I
+ *	integer bits and F fraction bits, stored in the smallest signed integer
+ *	type of at least I + F + 1 bits, up to 32. It replaces floating point
+ *	types on boards without an FPU, where integer arithmetic is several times
+ *	faster:
+ *
+ *		using Q = pg::q15_16;
+ *		Q x = 1.5, y = 2;
+ *		Q z = x * y + 1;			// z == 4.
+ *		float f = float(z / 3);		// f ~= 1.33333.
+ *
+ *	Arithmetic saturates at the type's lowest() and max() values instead of
+ *	wrapping, and division by zero returns the saturated value with the sign
+ *	of the dividend. Conversions from arithmetic types are implicit and
+ *	saturating, conversions to arithmetic types are explicit, and integer
+ *	conversions truncate toward zero like floating point conversions.
+ *
+ *	The type specializes std::numeric_limits, and overloads std::abs(),
+ *	std::sqrt(), std::log() and std::log2(). from_chars() parses decimal
+ *	strings, such as "-1.25" or "2.5e-3", directly into a fixed-point value,
+ *	rounded to nearest, without floating point arithmetic (see <cstdlib>).
+ *	The fmath library functions
+ *	accept fixed-point arguments (see <lib/fmath.h>), so do the
+ *	PIDController and PWMOutput types.
+ *
+ *	Notes:
+ *
+ *		Multiplication and division use an integer type twice as wide as the
+ *		storage type. Values are converted from floating point literals at
+ *		compile time when used in constant expressions, so small constants
+ *		should be declared constexpr to keep floating point code out of
+ *		time-critical loops.
+ *
+ *	**************************************************************************/
+
+#if !defined __PG_FIXED_H
+# define __PG_FIXED_H 20261014L
+
+# include <cstdint>		// Fixed-width integer types.
+# include <cstdlib>		// std::from_chars_result
+# include <limits>		// std::numeric_limits.
+# include <type_traits>	// Type traits.
+
+# if defined __PG_HAS_NAMESPACES
+
+namespace pg
+{
+	namespace details
+	{
+		// Storage and intermediate types of fixed-point numbers of a given width.
+		template<int Bits, bool = (Bits <= 8), bool = (Bits <= 16)>
+		struct fixed_traits
+		{
+			using rep = int32_t;
+			using wide = int64_t;
+		};
+
+		template<int Bits, bool B>
+		struct fixed_traits<Bits, true, B>
+		{
+			using rep = int8_t;
+			using wide = int16_t;
+		};
+
+		template<int Bits>
+		struct fixed_traits<Bits, false, true>
+		{
+			using rep = int16_t;
+			using wide = int32_t;
+		};
+	} // namespace details
+
+	// Saturating Q-format fixed-point number with I integer and F fraction bits.
+	template<int I, int F>
+	class fixed
+	{
+		static_assert(I >= 0 && F >= 0 && F < 31 && I + F < 32, "fixed requires at most 31 integer and fraction bits.");
+
+	public:
+		using rep = typename details::fixed_traits<I + F + 1>::rep;		// Storage type.
+		using wide_type = typename details::fixed_traits<I + F + 1>::wide;	// Intermediate type.
+
+		static constexpr int integer_bits = I;
+		static constexpr int fraction_bits = F;
+		static constexpr wide_type One = static_cast<wide_type>(1) << F;	// Raw value of 1.
+		static constexpr rep RawMax = static_cast<rep>((static_cast<wide_type>(1) << (I + F)) - 1);
+		static constexpr rep RawMin = static_cast<rep>(-RawMax - 1);
+
+	public:
+		// Constructs a fixed-point zero.
+		constexpr fixed() : raw_() {}
+		// Constructs a fixed-point number from an integral value.
+		template<class T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
+		constexpr fixed(T value) : raw_(saturate(static_cast<wide_type>(value) > (RawMax >> F)
+			? RawMax
+			: static_cast<wide_type>(value) < (RawMin >> F) ? RawMin : static_cast<wide_type>(value) * One)) {}
+		// Constructs a fixed-point number from a floating point value, rounded to nearest.
+		template<class T, typename std::enable_if<std::is_floating_point<T>::value, int>::type = 0>
+		constexpr fixed(T value) : raw_(value * static_cast<T>(One) >= static_cast<T>(RawMax)
+			? RawMax
+			: value * static_cast<T>(One) <= static_cast<T>(RawMin)
+			? RawMin
+			: static_cast<rep>(value * static_cast<T>(One) + (value < 0 ? T(-0.5) : T(0.5)))) {}
+
+	public:
+		// Returns a fixed-point number with a given raw value.
+		static constexpr fixed from_raw(rep value) { return fixed(value, raw_tag()); }
+		// Returns the fixed-point ratio of two integers.
+		static constexpr fixed from_ratio(int64_t num, int64_t den)
+		{
+			return den == 0
+				? from_raw(num < 0 ? RawMin : RawMax)
+				: from_raw(saturate(static_cast<int64_t>(num * static_cast<int64_t>(One)) / den));
+		}
+		// Returns the raw value.
+		constexpr rep raw() const { return raw_; }
+		// Converts to an integral type, truncating toward zero.
+		template<class T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value, int>::type = 0>
+		explicit constexpr operator T() const
+		{
+			return static_cast<T>(raw_ < 0 ? -((-static_cast<wide_type>(raw_)) >> F) : raw_ >> F);
+		}
+		// Converts to a floating point type.
+		template<class T, typename std::enable_if<std::is_floating_point<T>::value, int>::type = 0>
+		explicit constexpr operator T() const { return static_cast<T>(raw_) / static_cast<T>(One); }
+		// Checks whether the value is non-zero.
+		explicit constexpr operator bool() const { return raw_ != 0; }
+
+		fixed& operator+=(const fixed& other) { return *this = *this + other; }
+		fixed& operator-=(const fixed& other) { return *this = *this - other; }
+		fixed& operator*=(const fixed& other) { return *this = *this * other; }
+		fixed& operator/=(const fixed& other) { return *this = *this / other; }
+
+		friend constexpr fixed operator+(const fixed& x) { return x; }
+		friend constexpr fixed operator-(const fixed& x) { return from_raw(saturate(-static_cast<wide_type>(x.raw_))); }
+		friend constexpr fixed operator+(const fixed& lhs, const fixed& rhs)
+		{
+			return from_raw(saturate(static_cast<wide_type>(lhs.raw_) + rhs.raw_));
+		}
+		friend constexpr fixed operator-(const fixed& lhs, const fixed& rhs)
+		{
+			return from_raw(saturate(static_cast<wide_type>(lhs.raw_) - rhs.raw_));
+		}
+		friend constexpr fixed operator*(const fixed& lhs, const fixed& rhs)
+		{
+			return from_raw(saturate((static_cast<wide_type>(lhs.raw_) * rhs.raw_ + (One >> 1)) >> F));
+		}
+		friend constexpr fixed operator/(const fixed& lhs, const fixed& rhs)
+		{
+			return rhs.raw_ == 0
+				? from_raw(lhs.raw_ < 0 ? RawMin : RawMax)
+				: from_raw(saturate(static_cast<wide_type>(lhs.raw_) * One / rhs.raw_));
+		}
+		friend constexpr bool operator==(const fixed& lhs, const fixed& rhs) { return lhs.raw_ == rhs.raw_; }
+		friend constexpr bool operator!=(const fixed& lhs, const fixed& rhs) { return lhs.raw_ != rhs.raw_; }
+		friend constexpr bool operator<(const fixed& lhs, const fixed& rhs) { return lhs.raw_ < rhs.raw_; }
+		friend constexpr bool operator>(const fixed& lhs, const fixed& rhs) { return lhs.raw_ > rhs.raw_; }
+		friend constexpr bool operator<=(const fixed& lhs, const fixed& rhs) { return lhs.raw_ <= rhs.raw_; }
+		friend constexpr bool operator>=(const fixed& lhs, const fixed& rhs) { return lhs.raw_ >= rhs.raw_; }
+
+	private:
+		struct raw_tag {};
+
+		constexpr fixed(rep value, raw_tag) : raw_(value) {}
+
+		// Clamps a wide value to the storage type range.
+		template<class T>
+		static constexpr rep saturate(T value)
+		{
+			return value > RawMax ? RawMax : value < RawMin ? RawMin : static_cast<rep>(value);
+		}
+
+	private:
+		rep raw_;	// Raw value, scaled by 2^F.
+	};
+
+	using q7_8 = fixed<7, 8>;		// 16-bit fixed-point type with 8 fraction bits.
+	using q15_16 = fixed<15, 16>;	// 32-bit fixed-point type with 16 fraction bits.
+
+	// Type trait that checks whether a type is a fixed-point type.
+	template<class T>
+	struct is_fixed : std::false_type {};
+
+	template<int I, int F>
+	struct is_fixed<fixed<I, F>> : std::true_type {};
+
+	// Returns the base 2 logarithm of a fixed-point number, or lowest() if not positive.
+	template<int I, int F>
+	fixed<I, F> log2(fixed<I, F> x)
+	{
+		using value_type = fixed<I, F>;
+		using wide_type = int64_t;
+		constexpr wide_type One = value_type::One;
+		wide_type z = x.raw(), y = 0, b = One >> 1;
+
+		if (z <= 0)
+			return value_type::from_raw(value_type::RawMin);
+		while (z < One)
+		{
+			z <<= 1;
+			y -= One;
+		}
+		while (z >= 2 * One)
+		{
+			z >>= 1;
+			y += One;
+		}
+		for (int i = 0; i < F; ++i)	// Square z and take one fraction bit each iteration.
+		{
+			z = (z * z) >> F;
+			if (z >= 2 * One)
+			{
+				z >>= 1;
+				y += b;
+			}
+			b >>= 1;
+		}
+
+		return value_type::from_raw(static_cast<typename value_type::rep>(y < value_type::RawMin 
+			? value_type::RawMin 
+			: y > value_type::RawMax ? value_type::RawMax : y));
+	}
+
+	// Parses a decimal number in [first, last) into a fixed-point number, rounded to nearest.
+	template<int I, int F>
+	std::from_chars_result from_chars(const char* first, const char* last, fixed<I, F>& value)
+	{
+		using value_type = fixed<I, F>;
+
+		std::details::from_chars_decimal<uint32_t> number;
+		const char* ptr = std::details::from_chars_parse(first, last, number);
+
+		if (ptr == first)
+			return { first, std::errc::invalid_argument };
+
+		const uint64_t limit = static_cast<uint64_t>(value_type::RawMax) + number.negative;	// Largest raw magnitude.
+		uint64_t raw = static_cast<uint64_t>(number.mantissa) << F;
+
+		if (raw && number.exponent > 0)
+		{
+			for (int i = 0; i < number.exponent && raw <= limit; ++i)
+				raw *= 10;
+		}
+		else if (number.exponent < 0)
+		{
+			if (number.exponent < -19)
+				raw = 0;	// raw < 10^19.
+			else
+			{
+				uint64_t divisor = 1;
+
+				for (int i = 0; i > number.exponent; --i)
+					divisor *= 10;
+				raw = (raw + (divisor >> 1)) / divisor;
+			}
+		}
+		if (raw > limit)
+			return { ptr, std::errc::result_out_of_range };
+		value = value_type::from_raw(static_cast<typename value_type::rep>(number.negative 
+			? -static_cast<int64_t>(raw) 
+			: static_cast<int64_t>(raw)));
+
+		return { ptr, std::errc() };
+	}
+} // namespace pg
+
+namespace std
+{
+	// Specialization of template std::numeric_limits for fixed-point types.
+	template<int I, int F> class numeric_limits<pg::fixed<I, F>>
+	{
+		using type = pg::fixed<I, F>;
+
+	public:
+		static constexpr bool is_specialized = true;
+		static constexpr bool is_signed = true;
+		static constexpr bool is_integer = false;
+		static constexpr bool is_exact = true;
+		static constexpr bool has_infinity = false;
+		static constexpr bool has_quiet_NaN = false;
+		static constexpr bool has_signaling_NaN = false;
+		static constexpr float_denorm_style has_denorm = denorm_absent;
+		static constexpr bool has_denorm_loss = false;
+		static constexpr float_round_style round_style = round_to_nearest;
+		static constexpr bool is_iec559 = false;
+		static constexpr bool is_bounded = true;
+		static constexpr bool is_modulo = false;
+		static constexpr int digits = I + F;
+		static constexpr int digits10 = (I + F) * 30103 / 100000;
+		static constexpr int max_digits10 = 0;
+		static constexpr int radix = 2;
+		static constexpr int min_exponent = 0;
+		static constexpr int min_exponent10 = 0;
+		static constexpr int max_exponent = 0;
+		static constexpr int max_exponent10 = 0;
+		static constexpr bool traps = false;
+		static constexpr bool tinyness_before = false;
+		static constexpr type min() noexcept { return type::from_raw(1); }
+		static constexpr type lowest() noexcept { return type::from_raw(type::RawMin); }
+		static constexpr type max() noexcept { return type::from_raw(type::RawMax); }
+		static constexpr type epsilon() noexcept { return type::from_raw(1); }
+		static constexpr type round_error() noexcept { return type::from_raw(static_cast<typename type::rep>(type::One >> 1)); }
+		static constexpr type infinity() noexcept { return type(); }
+		static constexpr type quiet_NaN() noexcept { return type(); }
+		static constexpr type signaling_NaN() noexcept { return type(); }
+		static constexpr type denorm_min() noexcept { return type::from_raw(1); }
+	};
+
+	// Returns the absolute value of a fixed-point number.
+	template<int I, int F>
+	constexpr pg::fixed<I, F> abs(pg::fixed<I, F> x)
+	{
+		return x.raw() < 0 ? -x : x;
+	}
+
+	// Returns the square root of a fixed-point number, or zero if negative.
+	template<int I, int F>
+	pg::fixed<I, F> sqrt(pg::fixed<I, F> x)
+	{
+		using value_type = pg::fixed<I, F>;
+		uint64_t n = x.raw() > 0 ? static_cast<uint64_t>(x.raw()) << F : 0, root = 0;
+		uint64_t bit = static_cast<uint64_t>(1) << 62;
+
+		while (bit > n)
+			bit >>= 2;
+		while (bit)
+		{
+			if (n >= root + bit)
+			{
+				n -= root + bit;
+				root = (root >> 1) + bit;
+			}
+			else
+				root >>= 1;
+			bit >>= 2;
+		}
+
+		return value_type::from_raw(static_cast<typename value_type::rep>(root));
+	}
+
+	// Returns the base 2 logarithm of a fixed-point number.
+	template<int I, int F>
+	pg::fixed<I, F> log2(pg::fixed<I, F> x)
+	{
+		return pg::log2(x);
+	}
+
+	// Returns the natural logarithm of a fixed-point number.
+	template<int I, int F>
+	pg::fixed<I, F> log(pg::fixed<I, F> x)
+	{
+		constexpr pg::fixed<I, F> ln2 = 0.69314718055994530942;
+
+		return x.raw() > 0 ? pg::log2(x) * ln2 : pg::log2(x);
+	}
+} // namespace std
+
+# else // !defined __PG_HAS_NAMESPACES
+#  error Requires C++11 and namespace support.
+# endif // defined __PG_HAS_NAMESPACES
+
+#endif // !defined __PG_FIXED_H
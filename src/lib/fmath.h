@@ -79,9 +79,39 @@
  *	thermistor(r,rinf,B) : evaluates the beta-parameter thermistor eqn.
  *	rsense(v,v0,r0): returns the unkown resistance in a two-node voltage divider network.
  *	vsense(aout,amax,aref,dc): returns the analog voltage represented by a digital ADC value.
+ *	lut_sin<A>(x): returns a table approximation of sin(x), where x in [-pi, pi] radians.
+ *	lut_cos<A>(x): returns a table approximation of cos(x), where x in [-pi, pi] radians.
+ *	lut_atan<A>(x): returns a table approximation of atan(x), where x in [-1, 1].
+ *	lut_exp<A>(x): returns a table approximation of e**x.
+ *	exp(v), sin(v), cos(v), atan(v), ilog2(v): element-wise closures over valarray expressions.
  * 
  *	Notes:
  *
+ *		The lut_ functions interpolate linearly between the entries of tables 
+ *		that are computed at compile time and stored in program memory. The 
+ *		template parameter A selects the table size and accuracy, at the cost 
+ *		of flash: lut_accuracy::Low (33 entries, 66 bytes, ~3e-4 absolute 
+ *		error), Medium (129 entries, ~3e-5) or High (513 entries, ~1.5e-5, 
+ *		limited by the 15-bit entries). Tables are only instantiated for the 
+ *		functions and accuracies used. They are faster than the series 
+ *		approximations on boards without an FPU.
+ *
+ *		The exp, sin, cos, atan and ilog2 overloads that take a std::valarray 
+ *		or a valarray expression return a lazily evaluated closure instead of 
+ *		a new valarray. Closures combine with each other, with valarrays and 
+ *		with scalars using the arithmetic operators, and the whole expression 
+ *		is evaluated in a single loop, without temporary arrays, when it is 
+ *		assigned to a valarray:
+ *
+ *			v = pg::exp(pg::sin(v) * gain) + offset;
+ *
+ *		Closures refer to their valarray operands, so they must be evaluated 
+ *		before the operands go out of scope.
+ *
+ *		Functions that take floating point arguments also take fixed-point 
+ *		arguments (see <lib/fixed.h>), and exp(x) has a fixed-point overload 
+ *		that uses range reduction.
+ *
  *		Functions are enabled using template substitution based on the type of
  *		calling parameters. Template substitution will fail if called with
  *		invalid argument types, resulting in an ill-formed program.
@@ -97,6 +127,9 @@
 # include <numeric>		// std::accumulate.
 # include <complex>		// Complex number support.
 # include <lib/imath.h>	// iseven, isodd
+# include <lib/fixed.h>	// Fixed-point type.
+# include <lib/progmem.h>	// Lookup tables in program memory.
+# include <valarray>		// Element-wise valarray closures.
 
 # if defined __PG_HAS_NAMESPACES 
 
@@ -152,8 +185,16 @@ namespace pg
 
 		template <class T, class U = T>
 		struct is_float
+			: std::enable_if<std::is_floating_point<T>::value, U>
 		{
-			typedef typename std::enable_if<std::is_floating_point<T>::value, U>::type type;
+
+		};
+
+		// Fixed-point types are accepted wherever floating point types are.
+		template <int I, int F, class U>
+		struct is_float<fixed<I, F>, U>
+		{
+			typedef U type;
 		};
 
 		/* Recursive implementation of exp(x). */
@@ -250,6 +291,26 @@ namespace pg
 		return details::exp_impl<T, N>::evaluate(x);
 	}
 
+	// Returns an approximation of e**x for fixed-point x.
+	template<int I, int F>
+	inline fixed<I, F> exp(fixed<I, F> x)
+	{
+		// e**x = 2**(x * log2(e)), split into a shift and a polynomial in [0, 1).
+		using value_type = fixed<I, F>;
+		using wide_type = typename value_type::wide_type;
+		constexpr value_type log2e = std::numbers::log2e;
+		constexpr value_type c1 = 0.6951786, c2 = 0.2261105, c3 = 0.0782062;
+		const wide_type t = (static_cast<wide_type>(x.raw()) * (log2e.raw()) + (value_type::One >> 1)) >> F;
+		const wide_type n = t >= 0 ? t >> F : -((-t + value_type::One - 1) >> F);
+		const value_type f = value_type::from_raw(static_cast<typename value_type::rep>(t - n * value_type::One));
+		const wide_type y = (value_type(1) + f * (c1 + f * (c2 + f * c3))).raw();
+		const wide_type r = n >= 0 
+			? (n >= I ? value_type::RawMax : y << n) 
+			: (n > -(F + 2) ? y >> -n : 0);
+
+		return value_type::from_raw(static_cast<typename value_type::rep>(r > value_type::RawMax ? value_type::RawMax : r));
+	}
+
 	/* Returns an approximation of sin(rads), where rads in [-pi, pi] radians. */
 	template<class T>
 	inline typename details::is_float<T>::type 
@@ -363,7 +424,7 @@ namespace pg
 		// Algo not so great for rads < 0, so we use |rads| and reflect that over -1 < rads < 0.
 		const T z = std::abs(rads);
 
-		return sign(rads) * (std::numbers::pi_inv_two - std::sqrt(1 - z) * 
+		return sign(rads) * (std::numbers::pi / 2 - std::sqrt(1 - z) * 
 			(1.5707288 - 0.2121144 * z + 0.074261 * sqr(z) - 0.0187293 * cube(z)));
 	}
 
@@ -396,7 +457,7 @@ namespace pg
 	{
 		constexpr const T a = 0.0776509570923569;
 		constexpr const T b = -0.287434475393028;
-		constexpr const T c = std::numbers::pi_inv_four - a - b;
+		constexpr const T c = std::numbers::pi / 4 - a - b;
 		const T z = sqr(rads);
 
 		return ((a * z + b) * z + c) * rads;
@@ -636,6 +697,317 @@ namespace pg
 		return ((vss * r0) / vnode) - r0;
 	}
 
+	/* Lookup table approximations. */
+
+	// Lookup table sizes, as the base 2 logarithm of the number of intervals.
+	enum class lut_accuracy : uint8_t
+	{
+		Low = 5,
+		Medium = 7,
+		High = 9
+	};
+
+	namespace details
+	{
+		constexpr uint8_t LutBits = 15;	// Fraction bits of table entries.
+		constexpr uint8_t LutFracBits = 12;	// Fraction bits of the interpolation factor.
+
+		/* Compile-time index sequences, generated with logarithmic recursion depth. */
+
+		template<std::size_t... Is> struct lut_indices {};
+
+		template<class A, class B> struct lut_concat;
+
+		template<std::size_t... A, std::size_t... B>
+		struct lut_concat<lut_indices<A...>, lut_indices<B...>>
+		{
+			using type = lut_indices<A..., (sizeof...(A) + B)...>;
+		};
+
+		template<std::size_t N>
+		struct lut_make
+		{
+			using type = typename lut_concat<typename lut_make<N / 2>::type, typename lut_make<N - N / 2>::type>::type;
+		};
+
+		template<> struct lut_make<0> { using type = lut_indices<>; };
+		template<> struct lut_make<1> { using type = lut_indices<0>; };
+
+		/* Compile-time series used to fill the tables. */
+
+		constexpr double lut_sin_series(double x2, double term, int k)
+		{
+			return k > 27 ? term : term + lut_sin_series(x2, -term * x2 / ((k + 1) * (k + 2)), k + 2);
+		}
+
+		constexpr double lut_atan_series(double x2, double term, int k)
+		{
+			return k > 61 ? term / k : term / k + lut_atan_series(x2, -term * x2, k + 2);
+		}
+
+		constexpr double lut_exp_series(double x, double term, int k)
+		{
+			return k > 20 ? term : term + lut_exp_series(x, term * x / k, k + 1);
+		}
+
+		constexpr uint16_t lut_round(double x)
+		{
+			return static_cast<uint16_t>(x * (1UL << LutBits) + 0.5);
+		}
+
+		// sin(x), x in [0, pi/2].
+		struct lut_sin_fn
+		{
+			static constexpr uint16_t value(std::size_t i, std::size_t n)
+			{
+				return lut_round(lut_sin_series((PG_PI_2 * i / n) * (PG_PI_2 * i / n), PG_PI_2 * i / n, 1));
+			}
+		};
+
+		// atan(x) / (pi/4), x in [0, 1], reduced by atan(x) = pi/4 + atan((x - 1)/(x + 1)) for x > 1/2.
+		struct lut_atan_fn
+		{
+			static constexpr double at(double x, double u)
+			{
+				return x > 0.5 ? 1 + lut_atan_series(u * u, u, 1) / PG_PI_4 : lut_atan_series(x * x, x, 1) / PG_PI_4;
+			}
+			static constexpr uint16_t value(std::size_t i, std::size_t n)
+			{
+				return lut_round(at(static_cast<double>(i) / n, (static_cast<double>(i) / n - 1) / (static_cast<double>(i) / n + 1)));
+			}
+		};
+
+		// 2**x - 1, x in [0, 1].
+		struct lut_exp2_fn
+		{
+			static constexpr uint16_t value(std::size_t i, std::size_t n)
+			{
+				return lut_round(lut_exp_series(PG_LN2 * i / n, 1.0, 1) - 1.0);
+			}
+		};
+
+		template<class Fn, std::size_t N, class = typename lut_make<N + 1>::type>
+		struct lut_table;
+
+		template<class Fn, std::size_t N, std::size_t... Is>
+		struct lut_table<Fn, N, lut_indices<Is...>>
+		{
+			static const uint16_t data[N + 1];
+		};
+
+		template<class Fn, std::size_t N, std::size_t... Is>
+		const uint16_t lut_table<Fn, N, lut_indices<Is...>>::data[N + 1] __PG_PROGMEM = { Fn::value(Is, N)... };
+
+		// Converts fixed-point integers with a given number of fraction bits to type T.
+		template<class T>
+		struct lut_convert
+		{
+			static T from_q(int32_t value, int bits) { return std::ldexp(static_cast<T>(value), -bits); }
+			static int32_t to_q(T value, int bits) { return static_cast<int32_t>(std::ldexp(value, bits)); }
+		};
+
+		template<int I, int F>
+		struct lut_convert<fixed<I, F>>
+		{
+			static fixed<I, F> from_q(int32_t value, int bits)
+			{
+				using value_type = fixed<I, F>;
+				const int shift = bits - F;
+				const int64_t raw = shift >= 0 
+					? (shift < 32 ? value >> shift : 0)
+					: (-shift < 32 ? static_cast<int64_t>(value) << -shift : value_type::RawMax);
+
+				return value_type::from_raw(static_cast<typename value_type::rep>(raw > value_type::RawMax ? value_type::RawMax : raw));
+			}
+			static int32_t to_q(fixed<I, F> value, int bits)
+			{
+				return bits >= F ? static_cast<int32_t>(value.raw()) << (bits - F) : value.raw() >> (F - bits);
+			}
+		};
+
+		// Interpolates table Fn with 2**Bits intervals at position pos in [0, 2**Bits], 
+		// and returns the result with LutBits + LutFracBits fraction bits.
+		template<class Fn, uint8_t Bits, class T>
+		int32_t lut_interp(T pos)
+		{
+			using table = lut_table<Fn, (1U << Bits)>;
+			std::size_t i = static_cast<std::size_t>(pos);
+
+			if (i >= (1U << Bits))
+				i = (1U << Bits) - 1;
+
+			const int32_t frac = lut_convert<T>::to_q(pos - T(i), LutFracBits);
+			const int32_t a = pgm_read(table::data + i), b = pgm_read(table::data + i + 1);
+
+			return (a << LutFracBits) + (b - a) * frac;
+		}
+	} // namespace details
+
+	/* Returns a table approximation of sin(rads), where rads in [-pi, pi] radians. */
+	template<lut_accuracy A = lut_accuracy::Medium, class T>
+	inline typename details::is_float<T>::type
+		lut_sin(T rads)
+	{
+		constexpr uint8_t Bits = static_cast<uint8_t>(A);
+		constexpr T scale = (1U << Bits) / PG_PI_2;
+		const T x = std::abs(rads);
+		const T z = x > T(PG_PI_2) ? T(PG_PI) - x : x;
+		const int32_t y = details::lut_interp<details::lut_sin_fn, Bits>(z * scale);
+
+		return details::lut_convert<T>::from_q(rads < T(0) ? -y : y, details::LutBits + details::LutFracBits);
+	}
+
+	/* Returns a table approximation of cos(rads), where rads in [-pi, pi] radians. */
+	template<lut_accuracy A = lut_accuracy::Medium, class T>
+	inline typename details::is_float<T>::type
+		lut_cos(T rads)
+	{
+		return lut_sin<A>(T(PG_PI_2) - std::abs(rads));
+	}
+
+	/* Returns a table approximation of atan(x), where x in [-1, 1]. */
+	template<lut_accuracy A = lut_accuracy::Medium, class T>
+	inline typename details::is_float<T>::type
+		lut_atan(T x)
+	{
+		constexpr uint8_t Bits = static_cast<uint8_t>(A);
+		const T z = std::abs(x);
+		const T y = details::lut_convert<T>::from_q(
+			details::lut_interp<details::lut_atan_fn, Bits>((z > T(1) ? T(1) : z) * T(1U << Bits)), 
+			details::LutBits + details::LutFracBits) * T(PG_PI_4);
+
+		return x < T(0) ? -y : y;
+	}
+
+	/* Returns a table approximation of e**x. */
+	template<lut_accuracy A = lut_accuracy::Medium, class T>
+	inline typename details::is_float<T>::type
+		lut_exp(T x)
+	{
+		// e**x = 2**n * 2**f, where n + f = x * log2(e) and f in [0, 1).
+		constexpr uint8_t Bits = static_cast<uint8_t>(A);
+		constexpr int32_t One = static_cast<int32_t>(1) << (details::LutBits + details::LutFracBits);
+		constexpr int Limit = 126;
+		const T t = x * T(PG_LOG2E);
+
+		if (t >= T(Limit))
+			return std::numeric_limits<T>::max();
+		else if (t <= T(-Limit))
+			return T(0);
+
+		int n = static_cast<int>(t);
+
+		if (T(n) > t)
+			--n;
+
+		const int32_t y = One + details::lut_interp<details::lut_exp2_fn, Bits>((t - T(n)) * T(1U << Bits));
+
+		return details::lut_convert<T>::from_q(y, details::LutBits + details::LutFracBits - n);
+	}
+
+#pragma region valarray_closures
+
+	namespace details
+	{
+		// Element-wise function objects used by valarray closures.
+		struct va_exp { template<class T> T operator()(T x) const { return pg::exp(x); } };
+		struct va_sin { template<class T> T operator()(T x) const { return pg::sin(x); } };
+		struct va_cos { template<class T> T operator()(T x) const { return pg::cos(x); } };
+		struct va_atan { template<class T> T operator()(T x) const { return pg::atan(x); } };
+		struct va_ilog2 { template<class T> T operator()(T x) const { return pg::ilog2(x); } };
+
+		// Returns a closure that applies Op to each element of a valarray.
+		template<class Op, class T, std::size_t N, template<class = T, std::size_t = N> typename Alloc>
+		inline std::_Expr<std::_UnClos<Op, std::_ValArray<T, std::valarray<T, N, Alloc>>>, T>
+			va_apply(const std::valarray<T, N, Alloc>& va)
+		{
+			using closure = std::_UnClos<Op, std::_ValArray<T, std::valarray<T, N, Alloc>>>;
+
+			return std::_Expr<closure, T>(closure(std::_ValArray<T, std::valarray<T, N, Alloc>>(va)));
+		}
+
+		// Returns a closure that applies Op to each element of a valarray expression.
+		template<class Op, class Clos, class T>
+		inline std::_Expr<std::_UnClos<Op, std::_Expr<Clos, T>>, T> 
+			va_apply(const std::_Expr<Clos, T>& expr)
+		{
+			using closure = std::_UnClos<Op, std::_Expr<Clos, T>>;
+
+			return std::_Expr<closure, T>(closure(expr));
+		}
+	} // namespace details
+
+	// Returns a closure that evaluates to exp(x) for each element x of a valarray.
+	template<class T, std::size_t N, template<class = T, std::size_t = N> typename Alloc>
+	inline auto exp(const std::valarray<T, N, Alloc>& va) -> decltype(details::va_apply<details::va_exp>(va))
+	{
+		return details::va_apply<details::va_exp>(va);
+	}
+
+	// Returns a closure that evaluates to exp(x) for each element x of a valarray expression.
+	template<class Clos, class T>
+	inline auto exp(const std::_Expr<Clos, T>& expr) -> decltype(details::va_apply<details::va_exp>(expr))
+	{
+		return details::va_apply<details::va_exp>(expr);
+	}
+
+	// Returns a closure that evaluates to sin(x) for each element x of a valarray.
+	template<class T, std::size_t N, template<class = T, std::size_t = N> typename Alloc>
+	inline auto sin(const std::valarray<T, N, Alloc>& va) -> decltype(details::va_apply<details::va_sin>(va))
+	{
+		return details::va_apply<details::va_sin>(va);
+	}
+
+	// Returns a closure that evaluates to sin(x) for each element x of a valarray expression.
+	template<class Clos, class T>
+	inline auto sin(const std::_Expr<Clos, T>& expr) -> decltype(details::va_apply<details::va_sin>(expr))
+	{
+		return details::va_apply<details::va_sin>(expr);
+	}
+
+	// Returns a closure that evaluates to cos(x) for each element x of a valarray.
+	template<class T, std::size_t N, template<class = T, std::size_t = N> typename Alloc>
+	inline auto cos(const std::valarray<T, N, Alloc>& va) -> decltype(details::va_apply<details::va_cos>(va))
+	{
+		return details::va_apply<details::va_cos>(va);
+	}
+
+	// Returns a closure that evaluates to cos(x) for each element x of a valarray expression.
+	template<class Clos, class T>
+	inline auto cos(const std::_Expr<Clos, T>& expr) -> decltype(details::va_apply<details::va_cos>(expr))
+	{
+		return details::va_apply<details::va_cos>(expr);
+	}
+
+	// Returns a closure that evaluates to atan(x) for each element x of a valarray.
+	template<class T, std::size_t N, template<class = T, std::size_t = N> typename Alloc>
+	inline auto atan(const std::valarray<T, N, Alloc>& va) -> decltype(details::va_apply<details::va_atan>(va))
+	{
+		return details::va_apply<details::va_atan>(va);
+	}
+
+	// Returns a closure that evaluates to atan(x) for each element x of a valarray expression.
+	template<class Clos, class T>
+	inline auto atan(const std::_Expr<Clos, T>& expr) -> decltype(details::va_apply<details::va_atan>(expr))
+	{
+		return details::va_apply<details::va_atan>(expr);
+	}
+
+	// Returns a closure that evaluates to ilog2(x) for each element x of an integral valarray.
+	template<class T, std::size_t N, template<class = T, std::size_t = N> typename Alloc>
+	inline auto ilog2(const std::valarray<T, N, Alloc>& va) -> decltype(details::va_apply<details::va_ilog2>(va))
+	{
+		return details::va_apply<details::va_ilog2>(va);
+	}
+
+	// Returns a closure that evaluates to ilog2(x) for each element x of an integral valarray expression.
+	template<class Clos, class T>
+	inline auto ilog2(const std::_Expr<Clos, T>& expr) -> decltype(details::va_apply<details::va_ilog2>(expr))
+	{
+		return details::va_apply<details::va_ilog2>(expr);
+	}
+
+#pragma endregion
 
 } // namespace pg
 
@@ -0,0 +1,442 @@
+/*
+ *	This file defines a type-safe, sprintf-compatible string formatter.
+ *
+ *	***************************************************************************
+ *
+ *	File: format.h
+ *	Date: October 14, 2026
+ *	Version: 1.0
+ *	Author: Michael Brodsky
+ *	Email: mbrodskiis@gmail.com
+ *	Copyright (c) 2012-2022 Michael Brodsky
+ *
+ *	***************************************************************************
+ *
+ *  This file is part of "Pretty Good" (Pg). "Pg" is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  This file is distributed in the hope that it will be useful, but
+ *	WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *	along with this file. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *	**************************************************************************
+ *
+ *	Description:
+ *
+ *	The format library writes formatted values into a caller buffer, like
+ *	std::sprintf(), without pulling vfprintf into the image. The argument
+ *	list is a variadic template, so each value is converted according to
+ *	its own type rather than the conversion character, and a mismatched
+ *	length modifier (e.g. "%u" for a uint32_t) can not corrupt the output.
+ *
+ *	Library Functions:
+ *
+ *	format(buf, fmt, args...): formats args into buf and returns the length written.
+ *	format_n(buf, n, fmt, args...): as format(), writing at most n characters, including the null.
+ *	format_count(fmt): returns the number of conversions in fmt, at compile time if fmt is constexpr.
+ *
+ *	Notes:
+ *
+ *		Format strings use the sprintf() syntax: %[flags][width][.precision]
+ *		[length]conversion, with the flags '-', '0', '+' and ' '. Length 
+ *		modifiers are accepted and ignored. Integral values are written in 
+ *		decimal, or in base 16 or 8 for the 'x', 'X' and 'o' conversions, or 
+ *		as a character for 'c'. Floating point and fixed-point values (see 
+ *		<lib/fixed.h>) are written in fixed notation with the given precision 
+ *		(up to 9 digits), and strings are written as is. "%%" writes a '%'.
+ *
+ *		Integers are converted with 16-bit arithmetic once their value fits 
+ *		in 16 bits, and floating point values with one multiplication for 
+ *		the fraction, which makes the conversions much faster than the 
+ *		vfprintf() ones on 8-bit boards. Floating point values whose integer 
+ *		part does not fit in 32 bits are written as "ovf", like Print does.
+ *
+ *		Conversions without a matching argument are skipped, and arguments 
+ *		without a matching conversion are ignored. Clients can check their 
+ *		argument counts at compile time with format_count():
+ *
+ *			static constexpr const char* Fmt = "%s=%u";
+ *			static_assert(pg::format_count(Fmt) == 2, "bad format");
+ *
+ *	**************************************************************************/
+
+#if !defined __PG_FORMAT_H
+# define __PG_FORMAT_H 20261014L
+
+# include <cstddef>			// std::size_t
+# include <cstdint>			// Fixed-width integer types.
+# include <cstring>			// std::strlen
+# include <type_traits>		// Type traits.
+# include <lib/fixed.h>		// Fixed-point type.
+
+namespace pg
+{
+	namespace details
+	{
+		// Parsed conversion specification.
+		struct format_spec
+		{
+			format_spec() : conv(), left(), zero(), plus(), space(), width(), precision(-1) {}
+
+			char	conv;		// Conversion character, or '\0' if none.
+			bool	left;		// Left-justify flag.
+			bool	zero;		// Zero padding flag.
+			bool	plus;		// Sign always flag.
+			bool	space;		// Space for a positive sign flag.
+			uint8_t	width;		// Minimum field width.
+			int8_t	precision;	// Precision, or -1 if none.
+		};
+
+		// Writes characters to a buffer, up to an optional end.
+		class format_writer
+		{
+		public:
+			format_writer(char* buf, char* end) : buf_(buf), pos_(buf), end_(end) {}
+
+		public:
+			void put(char c) { if (!end_ || pos_ < end_) *pos_++ = c; }
+			void put(const char* str, std::size_t n) { while (n--) put(*str++); }
+			void fill(char c, std::size_t n) { while (n--) put(c); }
+			std::size_t finish() { *pos_ = '\0'; return static_cast<std::size_t>(pos_ - buf_); }
+
+		private:
+			char* buf_;	// Start of the buffer.
+			char* pos_;	// Next character position.
+			char* end_;	// Position of the terminating null, or nullptr if unbounded.
+		};
+
+		constexpr uint8_t FormatPrecisionMax = 9;	// Maximum floating point precision.
+		constexpr uint8_t FormatDigitsMax = 24;		// Conversion buffer size.
+
+		// Powers of ten up to 10**FormatPrecisionMax.
+		constexpr uint32_t format_pow10(uint8_t n)
+		{
+			return n ? 10 * format_pow10(n - 1) : 1;
+		}
+
+		// Writes literal text up to the next conversion specification, parses it and returns the rest of fmt.
+		inline const char* format_next(format_writer& out, const char* fmt, format_spec& spec)
+		{
+			spec = format_spec();
+			while (*fmt)
+			{
+				if (*fmt != '%')
+				{
+					out.put(*fmt++);
+					continue;
+				}
+				if (*++fmt == '%')
+				{
+					out.put(*fmt++);
+					continue;
+				}
+				for (;; ++fmt)
+				{
+					if (*fmt == '-')
+						spec.left = true;
+					else if (*fmt == '0')
+						spec.zero = true;
+					else if (*fmt == '+')
+						spec.plus = true;
+					else if (*fmt == ' ')
+						spec.space = true;
+					else
+						break;
+				}
+				while (*fmt >= '0' && *fmt <= '9')
+					spec.width = spec.width * 10 + (*fmt++ - '0');
+				if (*fmt == '.')
+				{
+					spec.precision = 0;
+					while (*++fmt >= '0' && *fmt <= '9')
+						spec.precision = spec.precision * 10 + (*fmt - '0');
+				}
+				while (*fmt == 'h' || *fmt == 'l' || *fmt == 'L' || *fmt == 'z' || *fmt == 'j' || *fmt == 't')
+					++fmt;
+				if (*fmt)
+					spec.conv = *fmt++;
+				break;
+			}
+
+			return fmt;
+		}
+
+		// Writes a field made of a prefix and a body, padded to the spec width.
+		inline void format_field(format_writer& out, const format_spec& spec, 
+			const char* prefix, const char* body, std::size_t n, bool numeric)
+		{
+			const std::size_t np = std::strlen(prefix);
+			const std::size_t pad = spec.width > np + n ? spec.width - np - n : 0;
+			const bool zeros = numeric && spec.zero && !spec.left;
+
+			if (!spec.left && !zeros)
+				out.fill(' ', pad);
+			out.put(prefix, np);
+			if (zeros)
+				out.fill('0', pad);
+			out.put(body, n);
+			if (spec.left)
+				out.fill(' ', pad);
+		}
+
+		// Converts an unsigned value to digits ending before end, and returns the first digit.
+		template<class T>
+		char* format_digits(char* end, T value, uint8_t base, bool upper)
+		{
+			const char a = upper ? 'A' : 'a';
+
+			do
+			{
+				const T q = value / base;
+				const uint8_t d = static_cast<uint8_t>(value - q * base);
+
+				*--end = d < 10 ? static_cast<char>('0' + d) : static_cast<char>(a + d - 10);
+				value = q;
+			} while (value);
+
+			return end;
+		}
+
+		// Converts an unsigned value to digits, narrowing the arithmetic as the value shrinks.
+		inline char* format_utoa(char* end, unsigned long long value, uint8_t base, bool upper)
+		{
+			const char a = upper ? 'A' : 'a';
+
+			while (value > UINT32_MAX)
+			{
+				const unsigned long long q = value / base;
+				const uint8_t d = static_cast<uint8_t>(value - q * base);
+
+				*--end = d < 10 ? static_cast<char>('0' + d) : static_cast<char>(a + d - 10);
+				value = q;
+			}
+
+			uint32_t v = static_cast<uint32_t>(value);
+
+			while (v > UINT16_MAX)
+			{
+				const uint32_t q = v / base;
+				const uint8_t d = static_cast<uint8_t>(v - q * base);
+
+				*--end = d < 10 ? static_cast<char>('0' + d) : static_cast<char>(a + d - 10);
+				v = q;
+			}
+
+			return format_digits<uint16_t>(end, static_cast<uint16_t>(v), base, upper);
+		}
+
+		// Returns the sign prefix of a number.
+		inline const char* format_sign(const format_spec& spec, bool negative)
+		{
+			return negative ? "-" : spec.plus ? "+" : spec.space ? " " : "";
+		}
+
+		// Writes an integer magnitude with a sign.
+		inline void format_integer(format_writer& out, const format_spec& spec, unsigned long long value, bool negative)
+		{
+			char buf[FormatDigitsMax];
+			char* end = buf + sizeof(buf);
+			const uint8_t base = spec.conv == 'x' || spec.conv == 'X' ? 16 : spec.conv == 'o' ? 8 : 10;
+			char* first = format_utoa(end, value, base, spec.conv == 'X');
+
+			while (spec.precision > end - first && first > buf)
+				*--first = '0';
+			format_field(out, spec, format_sign(spec, negative), first, static_cast<std::size_t>(end - first), true);
+		}
+
+		// Writes a magnitude with an integer part and a fraction of precision digits.
+		template<class T>
+		void format_decimal(format_writer& out, const format_spec& spec, T ip, uint32_t fraction, uint8_t precision, bool negative)
+		{
+			char buf[FormatDigitsMax];
+			char* end = buf + sizeof(buf);
+			char* first = end;
+
+			if (precision)
+			{
+				char* point = format_utoa(end, fraction, 10, false);
+
+				while (end - point < precision)
+					*--point = '0';
+				*--point = '.';
+				first = point;
+			}
+			first = format_utoa(first, ip, 10, false);
+			format_field(out, spec, format_sign(spec, negative), first, static_cast<std::size_t>(end - first), true);
+		}
+
+		// Writes a signed integral value.
+		template<class T>
+		typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type
+			format_arg(format_writer& out, const format_spec& spec, T value)
+		{
+			if (spec.conv == 'c')
+			{
+				const char c = static_cast<char>(value);
+
+				format_field(out, spec, "", &c, 1, false);
+			}
+			else if (spec.conv == 'x' || spec.conv == 'X' || spec.conv == 'o')
+				format_integer(out, spec, static_cast<typename std::make_unsigned<T>::type>(value), false);
+			else
+				format_integer(out, spec, value < 0 
+					? 0ULL - static_cast<unsigned long long>(value) 
+					: static_cast<unsigned long long>(value), value < 0);
+		}
+
+		// Writes an unsigned integral value.
+		template<class T>
+		typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value>::type
+			format_arg(format_writer& out, const format_spec& spec, T value)
+		{
+			if (spec.conv == 'c')
+			{
+				const char c = static_cast<char>(value);
+
+				format_field(out, spec, "", &c, 1, false);
+			}
+			else
+				format_integer(out, spec, value, false);
+		}
+
+		// Writes an enumerated value as its underlying integral value.
+		template<class T>
+		typename std::enable_if<std::is_enum<T>::value>::type
+			format_arg(format_writer& out, const format_spec& spec, T value)
+		{
+			format_arg(out, spec, static_cast<typename std::underlying_type<T>::type>(value));
+		}
+
+		// Writes a floating point value.
+		template<class T>
+		typename std::enable_if<std::is_floating_point<T>::value>::type
+			format_arg(format_writer& out, const format_spec& spec, T value)
+		{
+			const uint8_t precision = spec.precision < 0 ? 6 
+				: spec.precision > FormatPrecisionMax ? FormatPrecisionMax : static_cast<uint8_t>(spec.precision);
+			const bool negative = value < 0;
+
+			if (value != value)
+				format_field(out, spec, "", "nan", 3, false);
+			else if (negative ? -value > T(UINT32_MAX) : value > T(UINT32_MAX))
+				format_field(out, spec, format_sign(spec, negative), value - value == 0 ? "ovf" : "inf", 3, false);
+			else
+			{
+				const T magnitude = negative ? -value : value;
+				const uint32_t scale = format_pow10(precision);
+				uint32_t ip = static_cast<uint32_t>(magnitude);
+				uint32_t fraction = static_cast<uint32_t>((magnitude - T(ip)) * T(scale) + T(0.5));
+
+				if (fraction >= scale)	// Rounding carried into the integer part.
+				{
+					fraction -= scale;
+					++ip;
+				}
+				format_decimal(out, spec, ip, fraction, precision, negative && (ip || fraction));
+			}
+		}
+
+		// Writes a fixed-point value.
+		template<int I, int F>
+		void format_arg(format_writer& out, const format_spec& spec, fixed<I, F> value)
+		{
+			using wide_type = typename fixed<I, F>::wide_type;
+			using unsigned_type = typename std::make_unsigned<wide_type>::type;
+			const uint8_t precision = spec.precision < 0 ? static_cast<uint8_t>((F * 3 + 9) / 10) 
+				: spec.precision > FormatPrecisionMax ? FormatPrecisionMax : static_cast<uint8_t>(spec.precision);
+			const wide_type raw = value.raw();
+			const unsigned_type magnitude = raw < 0 ? unsigned_type(0) - static_cast<unsigned_type>(raw) : static_cast<unsigned_type>(raw);
+			const uint32_t scale = format_pow10(precision);
+			unsigned long long ip = magnitude >> F;
+			uint32_t fraction = static_cast<uint32_t>(
+				((magnitude & ((unsigned_type(1) << F) - 1)) * static_cast<unsigned long long>(scale) 
+					+ (F ? 1ULL << (F - 1) : 0)) >> F);
+
+			if (fraction >= scale)
+			{
+				fraction -= scale;
+				++ip;
+			}
+			format_decimal(out, spec, ip, fraction, precision, raw < 0);
+		}
+
+		// Writes a string.
+		inline void format_arg(format_writer& out, const format_spec& spec, const char* str)
+		{
+			std::size_t n = str ? std::strlen(str) : 0;
+
+			if (spec.precision >= 0 && n > static_cast<std::size_t>(spec.precision))
+				n = static_cast<std::size_t>(spec.precision);
+			format_field(out, spec, "", str, n, false);
+		}
+
+		// Writes the rest of the format string, skipping conversions without arguments.
+		inline void format_impl(format_writer& out, const char* fmt)
+		{
+			format_spec spec;
+
+			do
+				fmt = format_next(out, fmt, spec);
+			while (spec.conv);
+		}
+
+		// Writes the format string with each conversion replaced by the next argument.
+		template<class T, class... Ts>
+		void format_impl(format_writer& out, const char* fmt, T arg, Ts... args)
+		{
+			format_spec spec;
+
+			fmt = format_next(out, fmt, spec);
+			if (spec.conv)
+			{
+				format_arg(out, spec, arg);
+				format_impl(out, fmt, args...);
+			}
+		}
+	} // namespace details
+
+	// Formats arguments into a buffer and returns the number of characters written, excluding the null.
+	template<class... Ts>
+	std::size_t format(char* buf, const char* fmt, Ts... args)
+	{
+		details::format_writer out(buf, nullptr);
+
+		details::format_impl(out, fmt, args...);
+
+		return out.finish();
+	}
+
+	// Formats arguments into a buffer of n characters and returns the number written, excluding the null.
+	template<class... Ts>
+	std::size_t format_n(char* buf, std::size_t n, const char* fmt, Ts... args)
+	{
+		std::size_t result = 0;
+
+		if (n)
+		{
+			details::format_writer out(buf, buf + n - 1);
+
+			details::format_impl(out, fmt, args...);
+			result = out.finish();
+		}
+
+		return result;
+	}
+
+	// Returns the number of conversion specifications in a format string.
+	constexpr std::size_t format_count(const char* fmt)
+	{
+		return *fmt == '\0' ? 0 
+			: *fmt != '%' ? format_count(fmt + 1) 
+			: fmt[1] == '%' ? format_count(fmt + 2) 
+			: 1 + format_count(fmt + 1);
+	}
+} // namespace pg
+
+#endif // !defined __PG_FORMAT_H
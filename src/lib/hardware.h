@@ -48,7 +48,8 @@ namespace pg
 		enum Mode : uint8_t
 		{
 			Counter = 0, 
-			Timer = 1 
+			Timer = 1, 
+			Capture = 2		// Hardware input capture, the value is the signal period in nanoseconds.
 		};
 
 		enum Action : uint8_t
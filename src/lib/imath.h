@@ -81,6 +81,13 @@
  *		redundant to take the sign of an unsigned type because its sign is 
  *		known beforehand.
  * 
+ *		ilog2(), ipow2ge() and ipow2le() use the compiler's count leading 
+ *		zeros builtins on architectures with a count leading zeros 
+ *		instruction (ARM Cortex-M3 and up, Xtensa), where __PG_HAS_BUILTIN_CLZ 
+ *		is defined, and the portable shift and mask sequences otherwise, 
+ *		including on AVR. Define __PG_NO_BUILTIN_BITOPS to use the portable 
+ *		versions on all architectures.
+ *
  *		Functions are enabled using template substitution based on the type of  
  *		calling parameters. Template substitution will fail if called with 
  *		invalid argument types, resulting in an ill-formed program.
@@ -94,6 +101,20 @@
 # include <limits>		// Required to deduce function argument types.
 # include <type_traits>	// Required for function template substitution.
 
+// Compiler intrinsic backends for the bit scanning functions.
+
+# if defined __GNUC__ && !defined __PG_NO_BUILTIN_BITOPS
+#  if defined __ARM_FEATURE_CLZ || defined __XTENSA__ || defined __x86_64__ || defined __i386__ || defined __aarch64__
+#   define __PG_HAS_BUILTIN_CLZ 1		// __builtin_clz() and __builtin_ctz() are single instructions.
+#  endif
+#  if !defined __AVR__
+#   define __PG_HAS_BUILTIN_POPCOUNT 1	// __builtin_popcount() is faster than the portable loop.
+#  endif
+#  if defined __arm__ && defined __ARM_ARCH_ISA_THUMB && __ARM_ARCH_ISA_THUMB >= 2
+#   define __PG_HAS_ARM_RBIT 1			// The architecture has the RBIT instruction.
+#  endif
+# endif
+
 # if defined __PG_HAS_NAMESPACES 
 
 namespace pg
@@ -104,22 +125,25 @@ namespace pg
 
 		template <class T, class U = T>
 		struct is_integer
+			: std::enable_if<std::is_integral<T>::value, U>
 		{
-			typedef typename std::enable_if<std::is_integral<T>::value, U>::type type;
+
 		};
 
 		template <class T, class U = T>
 		struct is_unsigned
+			: std::enable_if<std::is_integral<T>::value &&
+				std::is_unsigned<T>::value, U>
 		{
-			typedef typename std::enable_if<std::is_integral<T>::value &&
-				std::is_unsigned<T>::value, U>::type type;
+
 		};
 
 		template <class T, class U = T>
 		struct is_signed
+			: std::enable_if<std::is_integral<T>::value &&
+				std::is_signed<T>::value, U>
 		{
-			typedef typename std::enable_if<std::is_integral<T>::value &&
-				std::is_signed<T>::value, U>::type type;
+
 		};
 
 		// ilog2 specialization for 8-bit types.
@@ -359,6 +383,139 @@ namespace pg
 			T operator()(T x) const { return iPow2Le_128(x); }
 		};
 #endif // if defined __HAS_128_BIT_INTEGERS
+
+		/* Intrinsic backends, selected by type and architecture. */
+
+		template <class T>
+		struct has_builtin_clz : std::integral_constant<bool,
+# if defined __PG_HAS_BUILTIN_CLZ
+			sizeof(T) <= sizeof(unsigned long long)
+# else
+			false
+# endif
+		> {};
+
+		template <class T>
+		struct has_builtin_popcount : std::integral_constant<bool,
+# if defined __PG_HAS_BUILTIN_POPCOUNT
+			sizeof(T) <= sizeof(unsigned long long)
+# else
+			false
+# endif
+		> {};
+
+		// The narrowest type taken by the builtins that can hold T.
+		template <class T>
+		using builtin_type = typename std::conditional<sizeof(T) <= sizeof(unsigned int), unsigned int,
+			typename std::conditional<sizeof(T) <= sizeof(unsigned long), unsigned long, unsigned long long>::type>::type;
+
+# if defined __PG_HAS_BUILTIN_CLZ
+		inline int builtin_clz(unsigned int x) { return __builtin_clz(x); }
+		inline int builtin_clz(unsigned long x) { return __builtin_clzl(x); }
+		inline int builtin_clz(unsigned long long x) { return __builtin_clzll(x); }
+		inline int builtin_ctz(unsigned int x) { return __builtin_ctz(x); }
+		inline int builtin_ctz(unsigned long x) { return __builtin_ctzl(x); }
+		inline int builtin_ctz(unsigned long long x) { return __builtin_ctzll(x); }
+
+		template <class T>
+		inline int clz(T x, std::true_type)
+		{
+			return builtin_clz(static_cast<builtin_type<T>>(x)) - 
+				(std::numeric_limits<builtin_type<T>>::digits - std::numeric_limits<T>::digits);
+		}
+
+		template <class T>
+		inline int ctz(T x, std::true_type)
+		{
+			return builtin_ctz(static_cast<builtin_type<T>>(x));
+		}
+# endif // defined __PG_HAS_BUILTIN_CLZ
+
+# if defined __PG_HAS_BUILTIN_POPCOUNT
+		inline int builtin_popcount(unsigned int x) { return __builtin_popcount(x); }
+		inline int builtin_popcount(unsigned long x) { return __builtin_popcountl(x); }
+		inline int builtin_popcount(unsigned long long x) { return __builtin_popcountll(x); }
+
+		template <class T>
+		inline int popcount(T x, std::true_type)
+		{
+			return builtin_popcount(static_cast<builtin_type<T>>(x));
+		}
+# endif // defined __PG_HAS_BUILTIN_POPCOUNT
+
+		template <class T>
+		inline int clz(T x, std::false_type)
+		{
+			return std::numeric_limits<T>::digits - 1 - static_cast<int>(ilog2_<T, sizeof(T)>()(x));
+		}
+
+		template <class T>
+		inline int ctz(T x, std::false_type)
+		{
+			return static_cast<int>(ilog2_<T, sizeof(T)>()(static_cast<T>(x & static_cast<T>(~x + 1))));
+		}
+
+		template <class T>
+		inline int popcount(T x, std::false_type)
+		{
+			int n = 0;
+
+			for (; x; ++n)
+				x &= x - 1;
+
+			return n;
+		}
+
+		// Returns the number of leading zero bits in unsigned x, x must be non-zero.
+		template <class T>
+		inline int clz(T x) { return clz(x, has_builtin_clz<T>()); }
+
+		// Returns the number of trailing zero bits in unsigned x, x must be non-zero.
+		template <class T>
+		inline int ctz(T x) { return ctz(x, has_builtin_clz<T>()); }
+
+		// Returns the number of bits set in unsigned x.
+		template <class T>
+		inline int popcount(T x) { return popcount(x, has_builtin_popcount<T>()); }
+
+		template <class T>
+		inline T ilog2(T x, std::true_type)
+		{
+			return x ? static_cast<T>(std::numeric_limits<T>::digits - 1 - clz(x)) : 0;
+		}
+
+		template <class T>
+		inline T ilog2(T x, std::false_type)
+		{
+			return ilog2_<T, sizeof(T)>()(x);
+		}
+
+		template <class T>
+		inline T ipow2ge(T x, std::true_type)
+		{
+			// The result wraps to zero if x is greater than the greatest power of two, like the portable version.
+			const int shift = x > 1 ? std::numeric_limits<T>::digits - clz(static_cast<T>(x - 1)) : 0;
+
+			return x ? (shift < std::numeric_limits<T>::digits ? static_cast<T>(static_cast<T>(1) << shift) : 0) : 0;
+		}
+
+		template <class T>
+		inline T ipow2ge(T x, std::false_type)
+		{
+			return iPow2Ge_<T, sizeof(T)>()(x);
+		}
+
+		template <class T>
+		inline T ipow2le(T x, std::true_type)
+		{
+			return x ? static_cast<T>(static_cast<T>(1) << (std::numeric_limits<T>::digits - 1 - clz(x))) : 0;
+		}
+
+		template <class T>
+		inline T ipow2le(T x, std::false_type)
+		{
+			return iPow2Le_<T, sizeof(T)>()(x);
+		}
 	} // namespace details
 
 #pragma region library_functions
@@ -499,7 +656,7 @@ namespace pg
 	inline typename details::is_unsigned<T>::type
 		ilog2(T x)
 	{
-		return details::ilog2_<T, sizeof(T)>()(x);
+		return details::ilog2(x, details::has_builtin_clz<T>());
 	}
 
 	// returns the integral base 10 logarithm of x.
@@ -540,7 +697,7 @@ namespace pg
 	inline typename details::is_unsigned<T>::type
 		ipow2ge(T x)
 	{
-		return details::iPow2Ge_<T, sizeof(T)>()(x);
+		return details::ipow2ge(x, details::has_builtin_clz<T>());
 	}
 
 	// returns the greatest integer power of two less than or equal to x.
@@ -548,7 +705,7 @@ namespace pg
 	inline typename details::is_unsigned<T>::type
 		ipow2le(T x)
 	{
-		return details::iPow2Le_<T, sizeof(T)>()(x);
+		return details::ipow2le(x, details::has_builtin_clz<T>());
 	}
 
 	namespace details
@@ -0,0 +1,173 @@
+/*
+ *	This files defines a fixed-block memory pool with constant time
+ *	allocation.
+ *
+ *	***************************************************************************
+ *
+ *	File: pool.h
+ *	Date: October 14, 2026
+ *	Version: 1.0
+ *	Author: Michael Brodsky
+ *	Email: mbrodskiis@gmail.com
+ *	Copyright (c) 2012-2022 Michael Brodsky
+ *
+ *	***************************************************************************
+ *
+ *  This file is part of "Pretty Good" (Pg). "Pg" is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  This file is distributed in the hope that it will be useful, but
+ *	WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *	along with this file. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *	**************************************************************************
+ *
+ *	Description:
+ *
+ *	`fixed_block_pool<T, N>' statically allocates N blocks of type T and
+ *	hands them out one at a time. Free blocks are kept on an intrusive
+ *	singly-linked list threaded through their own `next_' members, so
+ *	allocate() and deallocate() take constant time and the pool needs no
+ *	storage beyond the blocks themselves and one pointer. Block types must
+ *	therefore be list nodes with a public member `T* next_', which belongs to
+ *	the pool while a block is free and to the client while it is allocated:
+ *
+ *		struct node { int data_; node* next_; };
+ *		pg::fixed_block_pool<node, 8> pool;
+ *		node* n = pool.allocate();	// nullptr if all blocks are allocated.
+ *		...
+ *		pool.deallocate(n);
+ *
+ *	Blocks are default constructed with the pool and never destroyed until
+ *	the pool is, so clients assign rather than construct block values. Pools
+ *	are not copyable in the usual sense: copying a pool creates a new pool
+ *	with all of its own blocks free, as blocks cannot be shared between
+ *	pools, and blocks live inside the pool object itself, so containers
+ *	that move or swap contents must move or swap block values rather than
+ *	blocks. The std::forward_list container uses fixed_block_pool as its
+ *	default allocator.
+ *
+ *	**************************************************************************/
+
+#if !defined __PG_POOL_H
+# define __PG_POOL_H 20261014L
+
+# include <cstddef>	// std::size_t
+
+namespace pg
+{
+	// Statically allocated pool of N list node blocks of type T.
+	template<class T, std::size_t N>
+	class fixed_block_pool
+	{
+		static_assert(N > 0, "fixed_block_pool size must be non-zero.");
+
+	public:
+		using value_type = T;
+		using pointer = T*;
+		using const_pointer = const T*;
+		using size_type = std::size_t;
+
+	public:
+		// Constructs a pool with all blocks free.
+		fixed_block_pool();
+		// Constructs a new pool with all blocks free.
+		fixed_block_pool(const fixed_block_pool&);
+
+	public:
+		// Does nothing, as blocks cannot be shared between pools.
+		fixed_block_pool& operator=(const fixed_block_pool&);
+
+	public:
+		// Allocates a block and returns a pointer to it, or nullptr if none are free.
+		pointer allocate();
+		// Returns an allocated block to the pool.
+		void deallocate(pointer);
+		// Checks whether all blocks are allocated.
+		bool full() const;
+		// Returns the number of allocated blocks.
+		size_type size() const;
+		// Returns the number of blocks in the pool.
+		constexpr size_type max_size() const { return N; }
+
+	private:
+		// Links all blocks into the free list.
+		void reset();
+
+	private:
+		value_type	blocks_[N];	// The pool blocks.
+		pointer		free_;		// The first free block, or nullptr if none.
+		size_type	size_;		// The number of allocated blocks.
+	};
+
+	template<class T, std::size_t N>
+	fixed_block_pool<T, N>::fixed_block_pool() : blocks_(), free_(), size_()
+	{
+		reset();
+	}
+
+	template<class T, std::size_t N>
+	fixed_block_pool<T, N>::fixed_block_pool(const fixed_block_pool&) : fixed_block_pool()
+	{
+
+	}
+
+	template<class T, std::size_t N>
+	fixed_block_pool<T, N>& fixed_block_pool<T, N>::operator=(const fixed_block_pool&)
+	{
+		return *this;
+	}
+
+	template<class T, std::size_t N>
+	typename fixed_block_pool<T, N>::pointer fixed_block_pool<T, N>::allocate()
+	{
+		pointer block = free_;
+
+		if (block)
+		{
+			free_ = block->next_;
+			block->next_ = nullptr;
+			++size_;
+		}
+
+		return block;
+	}
+
+	template<class T, std::size_t N>
+	void fixed_block_pool<T, N>::deallocate(pointer block)
+	{
+		block->next_ = free_;
+		free_ = block;
+		--size_;
+	}
+
+	template<class T, std::size_t N>
+	bool fixed_block_pool<T, N>::full() const
+	{
+		return !free_;
+	}
+
+	template<class T, std::size_t N>
+	typename fixed_block_pool<T, N>::size_type fixed_block_pool<T, N>::size() const
+	{
+		return size_;
+	}
+
+	template<class T, std::size_t N>
+	void fixed_block_pool<T, N>::reset()
+	{
+		for (size_type i = 0; i < N - 1; ++i)
+			blocks_[i].next_ = &blocks_[i + 1];
+		blocks_[N - 1].next_ = nullptr;
+		free_ = blocks_;
+		size_ = 0;
+	}
+} // namespace pg
+
+#endif // !defined __PG_POOL_H
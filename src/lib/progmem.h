@@ -0,0 +1,89 @@
+/*
+ *	This file defines functions for storing and reading constant data in 
+ *	program memory (flash).
+ *
+ *	***************************************************************************
+ *
+ *	File: progmem.h
+ *	Date: October 14, 2026
+ *	Version: 1.0
+ *	Author: Michael Brodsky
+ *	Email: mbrodskiis@gmail.com
+ *	Copyright (c) 2012-2022 Michael Brodsky
+ *
+ *	***************************************************************************
+ *
+ *  This file is part of "Pretty Good" (Pg). "Pg" is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  This file is distributed in the hope that it will be useful, but
+ *	WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *	along with this file. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *	**************************************************************************
+ *
+ *	Description:
+ *
+ *	Harvard architectures (AVR) copy all initialized data into RAM at startup 
+ *	unless it is placed in program memory, which must then be read with 
+ *	special instructions. Everywhere else constant data already stays in 
+ *	flash and can be read directly.
+ *
+ *	__PG_PROGMEM: placed in a const object definition, stores the object in 
+ *	program memory on architectures that need it, else expands to nothing.
+ *
+ *	pgm_read(p): returns the object of type T stored at program memory 
+ *	address p.
+ *
+ *		const uint16_t table[] __PG_PROGMEM = { 1, 2, 3 };
+ *		uint16_t x = pg::pgm_read(table + 2);	// x = 3
+ *
+ *	**************************************************************************/
+
+#if !defined __PG_PROGMEM_H
+# define __PG_PROGMEM_H 20261014L
+
+# include <cstdint>
+# if defined __AVR__
+#  include <avr/pgmspace.h>
+#  define __PG_PROGMEM PROGMEM
+# else
+#  define __PG_PROGMEM
+# endif
+
+namespace pg
+{
+	// Returns the object of type T stored at program memory address p.
+	template<class T>
+	T pgm_read(const T* p)
+	{
+# if defined __AVR__
+		T value;
+
+		memcpy_P(&value, p, sizeof(T));
+
+		return value;
+# else
+		return *p;
+# endif
+	}
+
+# if defined __AVR__
+	template<>
+	inline uint8_t pgm_read(const uint8_t* p) { return pgm_read_byte(p); }
+
+	template<>
+	inline uint16_t pgm_read(const uint16_t* p) { return pgm_read_word(p); }
+
+	template<>
+	inline uint32_t pgm_read(const uint32_t* p) { return pgm_read_dword(p); }
+# endif
+} // namespace pg
+
+#endif // !defined __PG_PROGMEM_H
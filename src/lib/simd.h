@@ -0,0 +1,377 @@
+/*
+ *	This files defines packed 8 and 16-bit integer array kernels for boards
+ *	with the ARM DSP extension.
+ *
+ *	***************************************************************************
+ *
+ *	File: simd.h
+ *	Date: October 14, 2026
+ *	Version: 1.0
+ *	Author: Michael Brodsky
+ *	Email: mbrodskiis@gmail.com
+ *	Copyright (c) 2012-2022 Michael Brodsky
+ *
+ *	***************************************************************************
+ *
+ *  This file is part of "Pretty Good" (Pg). "Pg" is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  This file is distributed in the hope that it will be useful, but
+ *	WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *	along with this file. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *	**************************************************************************
+ *
+ *	Description:
+ *
+ *	The kernels in this file compute element-wise arithmetic and reductions
+ *	over arrays of n values:
+ *
+ *		add(dst, lhs, rhs, n), sub(dst, lhs, rhs, n), mul(dst, lhs, rhs, n):
+ *			dst[i] = lhs[i] op rhs[i], dst may be lhs or rhs,
+ *		sum(first, n): returns the sum of the values,
+ *		min(first, n), max(first, n): return the least and greatest value, n
+ *			must be non-zero,
+ *		dot(first1, first2, n, init): returns init plus the sum of the
+ *			products of the values, like std::inner_product().
+ *
+ *	On boards with the ARM DSP extension (Cortex-M4 and M7, such as SAMD51,
+ *	nRF52 and Teensy 3/4 boards), __PG_HAS_DSP_SIMD is defined (see
+ *	<system/boards.h>) and the kernels process two 16-bit or four 8-bit
+ *	values per 32-bit word, with the SADD, SSUB, SEL and SMLAD SIMD
+ *	instructions. mul(), sum() and dot() are only packed for 16-bit values,
+ *	and dot() only for int16_t values and accumulators of 32 bits or less.
+ *	All other types, and all types on other boards, use the portable scalar
+ *	loops. Packed results are identical to the scalar ones: sums and
+ *	products wrap around rather than saturate.
+ *
+ *	std::valarray arithmetic, sum(), min() and max(), and std::inner_product()
+ *	over int16_t pointers use these kernels, so clients normally don't call
+ *	them directly. Define __PG_NO_DSP_SIMD to use the scalar loops on all
+ *	boards.
+ *
+ *	**************************************************************************/
+
+#if !defined __PG_SIMD_H
+# define __PG_SIMD_H 20261014L
+
+# include <cstddef>			// std::size_t
+# include <cstdint>			// Fixed-width integer types.
+# include <cstring>			// std::memcpy()
+# include <type_traits>		// Type traits.
+# include <system/boards.h>	// __PG_HAS_DSP_SIMD
+
+# if defined __PG_HAS_NAMESPACES
+
+namespace pg
+{
+	namespace simd
+	{
+		// Checks whether arrays of type T use the packed add(), sub(), min() and max() kernels.
+		template<class T>
+		struct is_packed : std::integral_constant<bool,
+# if defined __PG_HAS_DSP_SIMD
+			std::is_integral<T>::value && !std::is_same<T, bool>::value && (sizeof(T) == 1 || sizeof(T) == 2)
+# else
+			false
+# endif
+		> {};
+
+		// Checks whether arrays of type T use the packed mul() and sum() kernels.
+		template<class T>
+		struct is_packed16 : std::integral_constant<bool, is_packed<T>::value && sizeof(T) == 2> {};
+
+		// Checks whether ranges of type It1 and It2 and accumulators of type T use the packed dot() kernel.
+		template<class It1, class It2, class T>
+		struct is_packed_dot : std::integral_constant<bool,
+			std::is_pointer<It1>::value && std::is_pointer<It2>::value &&
+			is_packed<int16_t>::value &&
+			std::is_same<typename std::remove_cv<typename std::remove_pointer<It1>::type>::type, int16_t>::value &&
+			std::is_same<typename std::remove_cv<typename std::remove_pointer<It2>::type>::type, int16_t>::value &&
+			std::is_integral<T>::value && sizeof(T) <= sizeof(uint32_t)> {};
+
+#pragma region scalar
+
+		template<class T>
+		typename std::enable_if<!is_packed<T>::value>::type
+			add(T* dst, const T* lhs, const T* rhs, std::size_t n)
+		{
+			for (std::size_t i = 0; i < n; ++i)
+				dst[i] = lhs[i] + rhs[i];
+		}
+
+		template<class T>
+		typename std::enable_if<!is_packed<T>::value>::type
+			sub(T* dst, const T* lhs, const T* rhs, std::size_t n)
+		{
+			for (std::size_t i = 0; i < n; ++i)
+				dst[i] = lhs[i] - rhs[i];
+		}
+
+		template<class T>
+		typename std::enable_if<!is_packed16<T>::value>::type
+			mul(T* dst, const T* lhs, const T* rhs, std::size_t n)
+		{
+			for (std::size_t i = 0; i < n; ++i)
+				dst[i] = lhs[i] * rhs[i];
+		}
+
+		template<class T>
+		typename std::enable_if<!is_packed16<T>::value, T>::type
+			sum(const T* first, std::size_t n)
+		{
+			T result = T();
+
+			for (std::size_t i = 0; i < n; ++i)
+				result += first[i];
+
+			return result;
+		}
+
+		template<class T>
+		typename std::enable_if<!is_packed<T>::value, T>::type
+			min(const T* first, std::size_t n)
+		{
+			T result = first[0];
+
+			for (std::size_t i = 1; i < n; ++i)
+				if (first[i] < result)
+					result = first[i];
+
+			return result;
+		}
+
+		template<class T>
+		typename std::enable_if<!is_packed<T>::value, T>::type
+			max(const T* first, std::size_t n)
+		{
+			T result = first[0];
+
+			for (std::size_t i = 1; i < n; ++i)
+				if (result < first[i])
+					result = first[i];
+
+			return result;
+		}
+
+		template<class It1, class It2, class T>
+		typename std::enable_if<!is_packed_dot<It1, It2, T>::value, T>::type
+			dot(It1 first1, It2 first2, std::size_t n, T init)
+		{
+			for (std::size_t i = 0; i < n; ++i, ++first1, ++first2)
+				init = init + *first1 * *first2;
+
+			return init;
+		}
+
+#pragma endregion
+# if defined __PG_HAS_DSP_SIMD
+#pragma region packed
+
+		namespace details
+		{
+			// Reads a possibly unaligned word, Cortex-M4/M7 load it with a single LDR.
+			inline uint32_t load(const void* p)
+			{
+				uint32_t word;
+
+				std::memcpy(&word, p, sizeof(word));
+
+				return word;
+			}
+
+			inline void store(void* p, uint32_t word)
+			{
+				std::memcpy(p, &word, sizeof(word));
+			}
+
+			// Returns the packed lane-wise sum of two words.
+			template<class T>
+			uint32_t add(uint32_t x, uint32_t y)
+			{
+				return sizeof(T) == 1 ? __SADD8(x, y) : __SADD16(x, y);
+			}
+
+			// Returns the packed lane-wise difference of two words.
+			template<class T>
+			uint32_t sub(uint32_t x, uint32_t y)
+			{
+				return sizeof(T) == 1 ? __SSUB8(x, y) : __SSUB16(x, y);
+			}
+
+			// Sets the GE flags of the lanes where x >= y, for a following __SEL().
+			template<class T>
+			void compare(uint32_t x, uint32_t y)
+			{
+				(void)(std::is_signed<T>::value
+					? (sizeof(T) == 1 ? __SSUB8(x, y) : __SSUB16(x, y))
+					: (sizeof(T) == 1 ? __USUB8(x, y) : __USUB16(x, y)));
+			}
+
+			// Returns lane i of a packed word.
+			template<class T>
+			T lane(uint32_t word, std::size_t i)
+			{
+				T value;
+
+				std::memcpy(&value, reinterpret_cast<const uint8_t*>(&word) + i * sizeof(T), sizeof(T));
+
+				return value;
+			}
+		} // namespace details
+
+		template<class T>
+		typename std::enable_if<is_packed<T>::value>::type
+			add(T* dst, const T* lhs, const T* rhs, std::size_t n)
+		{
+			constexpr std::size_t Lanes = sizeof(uint32_t) / sizeof(T);
+			std::size_t i = 0;
+
+			for (; i + Lanes <= n; i += Lanes)
+				details::store(dst + i, details::add<T>(details::load(lhs + i), details::load(rhs + i)));
+			for (; i < n; ++i)
+				dst[i] = lhs[i] + rhs[i];
+		}
+
+		template<class T>
+		typename std::enable_if<is_packed<T>::value>::type
+			sub(T* dst, const T* lhs, const T* rhs, std::size_t n)
+		{
+			constexpr std::size_t Lanes = sizeof(uint32_t) / sizeof(T);
+			std::size_t i = 0;
+
+			for (; i + Lanes <= n; i += Lanes)
+				details::store(dst + i, details::sub<T>(details::load(lhs + i), details::load(rhs + i)));
+			for (; i < n; ++i)
+				dst[i] = lhs[i] - rhs[i];
+		}
+
+		template<class T>
+		typename std::enable_if<is_packed16<T>::value>::type
+			mul(T* dst, const T* lhs, const T* rhs, std::size_t n)
+		{
+			// There is no packed 16-bit multiply, but each pair of products needs only two loads and
+			// one store, and the compiler emits SMULBB/SMULTT for the lane products.
+			std::size_t i = 0;
+
+			for (; i + 2 <= n; i += 2)
+			{
+				const uint32_t x = details::load(lhs + i), y = details::load(rhs + i);
+				const uint32_t lo = static_cast<uint32_t>(static_cast<int16_t>(x) * static_cast<int16_t>(y));
+				const uint32_t hi = static_cast<uint32_t>(static_cast<int16_t>(x >> 16) * static_cast<int16_t>(y >> 16));
+
+				details::store(dst + i, (lo & 0xFFFF) | (hi << 16));
+			}
+			if (i < n)
+				dst[i] = lhs[i] * rhs[i];
+		}
+
+		template<class T>
+		typename std::enable_if<is_packed16<T>::value, T>::type
+			sum(const T* first, std::size_t n)
+		{
+			// Sums wrap to T, so signed lanes give the same result for unsigned values.
+			uint32_t result = 0;
+			std::size_t i = 0;
+
+			for (; i + 2 <= n; i += 2)
+				result = __SMLAD(details::load(first + i), 0x00010001UL, result);
+			if (i < n)
+				result += first[i];
+
+			return static_cast<T>(result);
+		}
+
+		template<class T>
+		typename std::enable_if<is_packed<T>::value, T>::type
+			min(const T* first, std::size_t n)
+		{
+			constexpr std::size_t Lanes = sizeof(uint32_t) / sizeof(T);
+			std::size_t i = 0;
+			T result = first[0];
+
+			if (n >= Lanes)
+			{
+				uint32_t word = details::load(first);
+
+				for (i = Lanes; i + Lanes <= n; i += Lanes)
+				{
+					const uint32_t next = details::load(first + i);
+
+					details::compare<T>(next, word);
+					word = __SEL(word, next);	// Selects word where next >= word.
+				}
+				result = details::lane<T>(word, 0);
+				for (std::size_t j = 1; j < Lanes; ++j)
+					if (details::lane<T>(word, j) < result)
+						result = details::lane<T>(word, j);
+			}
+			for (; i < n; ++i)
+				if (first[i] < result)
+					result = first[i];
+
+			return result;
+		}
+
+		template<class T>
+		typename std::enable_if<is_packed<T>::value, T>::type
+			max(const T* first, std::size_t n)
+		{
+			constexpr std::size_t Lanes = sizeof(uint32_t) / sizeof(T);
+			std::size_t i = 0;
+			T result = first[0];
+
+			if (n >= Lanes)
+			{
+				uint32_t word = details::load(first);
+
+				for (i = Lanes; i + Lanes <= n; i += Lanes)
+				{
+					const uint32_t next = details::load(first + i);
+
+					details::compare<T>(next, word);
+					word = __SEL(next, word);	// Selects next where next >= word.
+				}
+				result = details::lane<T>(word, 0);
+				for (std::size_t j = 1; j < Lanes; ++j)
+					if (result < details::lane<T>(word, j))
+						result = details::lane<T>(word, j);
+			}
+			for (; i < n; ++i)
+				if (result < first[i])
+					result = first[i];
+
+			return result;
+		}
+
+		template<class It1, class It2, class T>
+		typename std::enable_if<is_packed_dot<It1, It2, T>::value, T>::type
+			dot(It1 first1, It2 first2, std::size_t n, T init)
+		{
+			uint32_t result = static_cast<uint32_t>(init);
+			std::size_t i = 0;
+
+			for (; i + 2 <= n; i += 2)
+				result = __SMLAD(details::load(first1 + i), details::load(first2 + i), result);
+			if (i < n)
+				result += static_cast<uint32_t>(first1[i] * first2[i]);
+
+			return static_cast<T>(result);
+		}
+
+#pragma endregion
+# endif // defined __PG_HAS_DSP_SIMD
+	} // namespace simd
+} // namespace pg
+
+# else // !defined __PG_HAS_NAMESPACES
+#  error Requires C++11 and namespace support.
+# endif // defined __PG_HAS_NAMESPACES
+
+#endif // !defined __PG_SIMD_H
@@ -3,6 +3,16 @@
  *	<string.h> and can be used with implementations that lack one, such as the 
  *	`megaavr' architecture.
  *
+ *	On SAM and SAMD boards, whose newlib-nano C library is built for size
+ *	and compares strings a byte at a time, <cstring> defines
+ *	__PG_HAS_WORD_STRING and includes this file to replace strlen(),
+ *	strcmp(), strncmp() and memcmp() with versions that process aligned
+ *	32-bit words, detecting a zero byte in a word with the 
+ *	(w - 0x01010101) & ~w & 0x80808080 test, and strspn() with a version
+ *	that looks characters up in a 256-bit set. Only these functions are 
+ *	defined on those boards. Define __PG_NO_WORD_STRING to keep the 
+ *	C library versions.
+ *
  *  ***************************************************************************
  *
  *	File: string.h
@@ -32,12 +42,38 @@
 #if !defined __PG_LIBC_STRING_H
 # define __PG_LIBC_STRING_H 20220504L
 
-# include <lib/fmath.h> // pg::sign();
+# include <stddef.h>	// size_t
+# if defined __PG_HAS_WORD_STRING
+#  include <cstdint>	// Fixed-width integer types.
+# endif
+
+namespace pg
+{
+	namespace details
+	{
+		// Returns the sign of a character difference, without <lib/fmath.h>, which includes <cstring>.
+		inline int string_sign(int x) { return (0 < x) - (x < 0); }
+# if defined __PG_HAS_WORD_STRING
+
+		typedef uint32_t __attribute__((__may_alias__)) string_word;	// Word that can alias char data.
+
+		// Checks whether any byte of a word is zero.
+		inline bool string_word_has_zero(uint32_t w) { return ((w - 0x01010101UL) & ~w & 0x80808080UL) != 0; }
+
+		// Checks whether a pointer is aligned to a word boundary.
+		inline bool string_word_aligned(const void* p) { return ((uintptr_t)p & (sizeof(string_word) - 1)) == 0; }
+
+		// Checks whether two pointers are equally misaligned, so both can be read a word at a time.
+		inline bool string_word_alignable(const void* p, const void* q) { return (((uintptr_t)p ^ (uintptr_t)q) & (sizeof(string_word) - 1)) == 0; }
+# endif
+	} // namespace details
+} // namespace pg
 
 # if defined __cplusplus
 extern "C" {
 # endif
 
+# if !defined __PG_HAS_WORD_STRING
 void* memchr(const void* str, int ch, size_t n)
 {
 	unsigned char* p = (unsigned char*)str;
@@ -52,6 +88,7 @@ void* memchr(const void* str, int ch, size_t n)
 
 	return NULL;
 }
+# endif
 
 int memcmp(const void* lhs, const void* rhs, size_t count)
 {
@@ -61,6 +98,24 @@ int memcmp(const void* lhs, const void* rhs, size_t count)
 
 	if (lhs != rhs)
 	{
+#  if defined __PG_HAS_WORD_STRING
+		if (pg::details::string_word_alignable(p, q))
+		{
+			while (count > 0 && !pg::details::string_word_aligned(p) && *p == *q)
+			{
+				count--;
+				p++;
+				q++;
+			}
+			while (count >= sizeof(pg::details::string_word) && 
+				*(const pg::details::string_word*)p == *(const pg::details::string_word*)q)
+			{
+				count -= sizeof(pg::details::string_word);
+				p += sizeof(pg::details::string_word);
+				q += sizeof(pg::details::string_word);
+			}
+		}
+#  endif
 		while (count > 0)
 		{
 			if (*p != *q)
@@ -77,6 +132,7 @@ int memcmp(const void* lhs, const void* rhs, size_t count)
 	return result;
 }
 
+# if !defined __PG_HAS_WORD_STRING
 char* strcat(char* dest, const char* src)
 {
 	char* ptr = dest + strlen(dest);
@@ -95,29 +151,67 @@ char* strchr(const char* str, int ch)
 	return *str == (char)ch ? (char*)str : NULL;
 }
 
+# endif
+
 int strcmp(const char* lhs, const char* rhs)
 {
-	int result = 0;
+#  if defined __PG_HAS_WORD_STRING
+	if (pg::details::string_word_alignable(lhs, rhs))
+	{
+		while (!pg::details::string_word_aligned(lhs) && *lhs && *lhs == *rhs)
+		{
+			++lhs;
+			++rhs;
+		}
+		if (pg::details::string_word_aligned(lhs))
+		{
+			const pg::details::string_word* p = (const pg::details::string_word*)lhs;
+			const pg::details::string_word* q = (const pg::details::string_word*)rhs;
 
-	while (*lhs && *rhs)
+			while (*p == *q && !pg::details::string_word_has_zero(*p))
+			{
+				++p;
+				++q;
+			}
+			lhs = (const char*)p;
+			rhs = (const char*)q;
+		}
+	}
+#  endif
+	while (*lhs && *lhs == *rhs)
 	{
-		if ((result = *lhs++ - *rhs++))
-			break;
+		++lhs;
+		++rhs;
 	}
 
-	return pg::sign(result);
+	return pg::details::string_sign((unsigned char)*lhs - (unsigned char)*rhs);
 }
 
 size_t strlen(const char* s)
 {
-	size_t len = 0;
+	const char* p = s;
+
+#  if defined __PG_HAS_WORD_STRING
+	while (!pg::details::string_word_aligned(p))
+	{
+		if (!*p)
+			return p - s;
+		++p;
+	}
+
+	const pg::details::string_word* w = (const pg::details::string_word*)p;
 
-	while (*s++)
-		++len;
+	while (!pg::details::string_word_has_zero(*w))
+		++w;
+	p = (const char*)w;
+#  endif
+	while (*p)
+		++p;
 
-	return len;
+	return p - s;
 }
 
+# if !defined __PG_HAS_WORD_STRING
 char* strncat(char* dest, const char* src, size_t count)
 {
 	char* ptr = dest + strlen(dest);
@@ -129,19 +223,46 @@ char* strncat(char* dest, const char* src, size_t count)
 	return dest;
 }
 
+# endif
+
 int strncmp(const char* lhs, const char* rhs, size_t count)
 {
-	int result = 0;
+#  if defined __PG_HAS_WORD_STRING
+	if (pg::details::string_word_alignable(lhs, rhs))
+	{
+		while (count && !pg::details::string_word_aligned(lhs) && *lhs && *lhs == *rhs)
+		{
+			++lhs;
+			++rhs;
+			--count;
+		}
+		if (pg::details::string_word_aligned(lhs))
+		{
+			const pg::details::string_word* p = (const pg::details::string_word*)lhs;
+			const pg::details::string_word* q = (const pg::details::string_word*)rhs;
 
-	while (count-- && *lhs && *rhs)
+			while (count >= sizeof(pg::details::string_word) && *p == *q && !pg::details::string_word_has_zero(*p))
+			{
+				++p;
+				++q;
+				count -= sizeof(pg::details::string_word);
+			}
+			lhs = (const char*)p;
+			rhs = (const char*)q;
+		}
+	}
+#  endif
+	while (count && *lhs && *lhs == *rhs)
 	{
-		if ((result = *lhs++ - *rhs++))
-			break;
+		++lhs;
+		++rhs;
+		--count;
 	}
 
-	return pg::sign(result);
+	return count ? pg::details::string_sign((unsigned char)*lhs - (unsigned char)*rhs) : 0;
 }
 
+# if !defined __PG_HAS_WORD_STRING
 char* strncpy(char* dest, const char* src, size_t count)
 {
 	char* cpy = dest;
@@ -186,8 +307,22 @@ char* strrchr(const char* str, int ch)
 	return result;
 }
 
+# endif
+
 size_t strspn(const char* str, const char* accept)
 {
+#  if defined __PG_HAS_WORD_STRING
+	uint32_t set[8] = { 0 };	// One bit per character value, '\0' is never set.
+	const unsigned char* a = (const unsigned char*)accept;
+	const unsigned char* p = (const unsigned char*)str;
+
+	for (; *a != '\0'; ++a)
+		set[*a >> 5] |= 1UL << (*a & 31);
+	while (set[*p >> 5] & (1UL << (*p & 31)))
+		++p;
+
+	return p - (const unsigned char*)str;
+#  else
 	const char* p;
 	const char* a;
 	size_t count = 0;
@@ -204,8 +339,10 @@ size_t strspn(const char* str, const char* accept)
 	}
 
 	return count;
+#  endif
 }
 
+# if !defined __PG_HAS_WORD_STRING
 char* strstr(const char* string, const char* substring)
 {
 	const char* a;
@@ -259,6 +396,7 @@ char* strtok(char* str, const char* delim)
 
 	return token;
 }
+# endif
 
 # if defined __cplusplus
 }
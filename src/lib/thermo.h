@@ -30,6 +30,7 @@
 #if !defined __THERMOMETER_H 
 # define __THERMOMETER_H 20211014L
 
+# include <cstddef>
 # include <lib/fmath.h>
 # include <lib/units.h>
 
@@ -93,6 +94,69 @@ namespace pg
 	template<class T>
 	bool alarm_gt(T lhs, T rhs) { return lhs > rhs; }
 
+	// Piecewise-linear table of sensed temperatures, indexed by ADC output code.
+	//
+	// The table holds the temperature at every Codes / Segments ADC codes, computed once 
+	// by one of the generate() methods, and converts a code with one lookup and a linear 
+	// interpolation instead of evaluating the thermistor equation. Codes is the number of 
+	// ADC output codes (AnalogMax() + 1), and both Codes and Segments must be powers of two. 
+	// The interpolation error shrinks with the square of the number of segments, and is 
+	// under 0.1 K over typical thermistor ranges with the default 32 segments.
+	template<class T, std::size_t Codes = 1024, std::size_t Segments = 32>
+	class temperature_table
+	{
+		static_assert(Codes > 0 && (Codes & (Codes - 1)) == 0, "temperature_table codes must be a power of two.");
+		static_assert(Segments > 0 && Segments <= Codes && (Segments & (Segments - 1)) == 0, 
+			"temperature_table segments must be a power of two, not greater than codes.");
+
+	public:
+		using value_type = T;
+		using size_type = std::size_t;
+
+		static constexpr size_type Step = Codes / Segments;	// ADC codes per table segment.
+
+	public:
+		// Constructs an empty table.
+		temperature_table() : table_() {}
+
+	public:
+		// Fills the table with the values of a function of the ADC output code.
+		template<class Fn>
+		void generate(Fn fn)
+		{
+			for (size_type i = 0; i <= Segments; ++i)
+				table_[i] = fn(static_cast<value_type>(i * Step));
+		}
+
+		// Fills the table with temperatures, in degrees K, using the Steinhart-Hart eqn (see tsense()).
+		void generate(value_type r, value_type vss, value_type dc, value_type a, value_type b, value_type c)
+		{
+			for (size_type i = 0; i <= Segments; ++i)
+				table_[i] = tsense(static_cast<value_type>(i * Step), static_cast<value_type>(Codes - 1), r, vss, dc, a, b, c);
+		}
+
+		// Fills the table with temperatures, in degrees K, using the beta-parameter eqn (see tsense()).
+		void generate(value_type r, value_type vss, value_type dc, value_type rinf, value_type beta)
+		{
+			for (size_type i = 0; i <= Segments; ++i)
+				table_[i] = tsense(static_cast<value_type>(i * Step), static_cast<value_type>(Codes - 1), r, vss, dc, rinf, beta);
+		}
+
+		// Returns the table value for an ADC output code.
+		template<class ADCType>
+		value_type operator()(ADCType adc_out) const
+		{
+			const size_type code = static_cast<size_type>(adc_out) < Codes ? static_cast<size_type>(adc_out) : Codes - 1;
+			const size_type i = code / Step;
+			const value_type y0 = table_[i];
+
+			return y0 + (table_[i + 1] - y0) * static_cast<value_type>(code % Step) * (value_type(1) / Step);
+		}
+
+	private:
+		value_type	table_[Segments + 1];	// Temperatures at every Step ADC codes.
+	};
+
 } // namespace pg
 
 #endif // !defined __THERMOMETER_H 
\ No newline at end of file
@@ -0,0 +1,141 @@
+/*
+ *	This files defines a type that tokenizes character strings in place,
+ *	without copying them.
+ *
+ *	***************************************************************************
+ *
+ *	File: tokenizer.h
+ *	Date: October 14, 2026
+ *	Version: 1.0
+ *	Author: Michael Brodsky
+ *	Email: mbrodskiis@gmail.com
+ *	Copyright (c) 2012-2022 Michael Brodsky
+ *
+ *	***************************************************************************
+ *
+ *  This file is part of "Pretty Good" (Pg). "Pg" is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  This file is distributed in the hope that it will be useful, but
+ *	WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *	along with this file. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *	**************************************************************************/
+
+#if !defined __PG_TOKENIZER_H
+# define __PG_TOKENIZER_H 20261014L
+
+# include <cstdint>			// uint8_t
+# include <cstring>			// strspn(), strcspn()
+
+namespace pg
+{
+	// Scans a string for tokens exactly once, without copying it. Tokens are
+	// (pointer, size) views into the original string and are only null-
+	// terminated on demand, by overwriting the trailing delimiter. Any
+	// overwritten delimiters are put back by restore(), so the string can be
+	// scanned again.
+	class tokenizer
+	{
+	public:
+		using size_type = uint8_t;
+
+		static constexpr size_type TerminatedMax = 8;	// Maximum number of tokens that can be terminated in place.
+
+	public:
+		explicit tokenizer(char* = nullptr);
+
+	public:
+		char* next(const char*);	// Returns the next token or nullptr if none.
+		void reset(char*);			// Starts tokenizing a new string, without restoring the current one.
+		void restore();				// Restores any delimiters overwritten by terminate().
+		size_type size() const;		// Returns the size of the current token in characters.
+		char* terminate();			// Null-terminates the current token in place.
+		char* token() const;		// Returns the current token.
+
+	private:
+		char*		pos_;						// Current scan position.
+		char*		token_;						// Current token.
+		char*		end_;						// One past the end of the current token.
+		char*		saved_[TerminatedMax];		// Overwritten delimiter positions.
+		char		chars_[TerminatedMax];		// Overwritten delimiter chars.
+		size_type	count_;						// Number of overwritten delimiters.
+	};
+
+	tokenizer::tokenizer(char* str) :
+		pos_(str), token_(), end_(), saved_(), chars_(), count_()
+	{
+
+	}
+
+	char* tokenizer::next(const char* delim)
+	{
+		token_ = end_ = nullptr;
+		if (pos_)
+		{
+			pos_ += std::strspn(pos_, delim);	// Skip leading delimiters, same as strtok().
+			if (*pos_)
+			{
+				token_ = pos_;
+				end_ = pos_ += std::strcspn(pos_, delim);
+				if (*pos_)
+					++pos_;						// Consume the trailing delimiter.
+			}
+		}
+
+		return token_;
+	}
+
+	void tokenizer::reset(char* str)
+	{
+		pos_ = str;
+		token_ = end_ = nullptr;
+		count_ = 0;	// Discard any unrestored delimiters, the old string may be gone.
+	}
+
+	void tokenizer::restore()
+	{
+		while (count_)
+		{
+			--count_;
+			*saved_[count_] = chars_[count_];
+		}
+	}
+
+	typename tokenizer::size_type tokenizer::size() const
+	{
+		return static_cast<size_type>(end_ - token_);
+	}
+
+	char* tokenizer::terminate()
+	{
+		char* tok = token_;
+
+		if (tok && *end_)
+		{
+			if (count_ < TerminatedMax)
+			{
+				saved_[count_] = end_;
+				chars_[count_++] = *end_;
+				*end_ = '\0';
+			}
+			else
+				tok = nullptr;	// Cannot restore any more delimiters.
+		}
+
+		return tok;
+	}
+
+	char* tokenizer::token() const
+	{
+		return token_;
+	}
+} // namespace pg
+
+#endif // !defined __PG_TOKENIZER_H
@@ -26,6 +26,28 @@
  *  You should have received a copy of the GNU General Public License
  *	along with this file. If fnot, see <http://www.gnu.org/licenses/>.
  *
+ *	**************************************************************************
+ *
+ *	Description:
+ *
+ *	`AdcOversampler' gains ADC resolution by summing 4^n conversions and 
+ *	shifting the sum right by n bits, where n is the number of extra bits. 
+ *	The `read()' method converts a pin in a single call, which blocks for 
+ *	4^n conversions. 
+ *
+ *	Alternatively, pins can be attached to the oversampler, which then does 
+ *	one conversion per call to its `clock()' method, interleaving the 
+ *	attached pins. Once every pin has been converted 4^n times, the 
+ *	results are published, the client callback, if any, is executed once 
+ *	for each pin and accumulation starts over:
+ *
+ *		void cb(pin_t pin, analog_t value) { ... }
+ *		AdcOversampler ovs(14);
+ *		ovs.attach(A0);
+ *		ovs.attach(A1);
+ *		ovs.callback(&cb);
+ *		ClockCommand cmd(&ovs);	// Schedule cmd, or call static_cast<iclockable&>(ovs).clock().
+ *
  *	**************************************************************************/
 
 #if !defined __PG_ADC_H
@@ -33,30 +55,52 @@
 
 # include <system/boards.h>
 # include <lib/fmath.h>
+# include <lib/callback.h>
+# include <interfaces/iclockable.h>
 
 namespace pg
 {
 	// Type that increases ADC resolution by oversampling.
-	class AdcOversampler
+	class AdcOversampler : public iclockable
 	{
+	public:
+		using callback_type = typename callback<void, void, pin_t, analog_t>::type;
+
 	public:
 		static constexpr uint8_t AdcResolutionMin = 10;
 		static constexpr uint8_t AdcResolutionMax = 16;
 		static constexpr uint8_t AdcPrescalerDefault = 4;
+		static constexpr uint8_t PinsMax = 8;	// Maximum number of attached pins.
 
 	public:
 		AdcOversampler(uint8_t = AdcResolutionMin);
 
 	public:
+		// Adds a pin to the incrementally converted pins and returns true if successful.
+		bool attach(pin_t);
+		// Removes all incrementally converted pins.
+		void detach();
+		// Sets the client callback executed when a result is published.
+		void callback(callback_type);
 		analog_t max() const;
 		void prescaler(uint8_t);
 		uint8_t prescaler() const;
 		analog_t read(pin_t);
+		// Checks whether results have been published for the attached pins.
+		bool ready() const;
 		void resolution(uint8_t);
 		uint8_t resolution() const;
 		uint16_t samples() const;
+		// Returns the last published result of an attached pin.
+		analog_t value(pin_t) const;
 
 	private:
+		// Does one conversion of the next attached pin.
+		void clock() override;
+		// Publishes the results of all attached pins and restarts accumulation.
+		void publish();
+		// Clears the accumulated conversions.
+		void restart();
 		inline uint8_t setOvsBits(uint8_t);
 		inline uint16_t setOvsSamples(uint8_t);
 		uint8_t setPrescaler(uint8_t);
@@ -67,13 +111,49 @@ namespace pg
 		uint8_t prescaler_;
 		uint8_t ovsbits_;
 		uint16_t ovsamples_;
+		pin_t pins_[PinsMax];			// Incrementally converted pins.
+		unsigned long sums_[PinsMax];	// Accumulated conversions of each pin.
+		analog_t values_[PinsMax];		// Last published result of each pin.
+		uint8_t npins_;					// Number of attached pins.
+		uint8_t index_;					// Next pin to convert.
+		uint16_t count_;				// Number of conversions accumulated for each pin.
+		bool ready_;					// Flag indicating whether results have been published.
+		callback_type callback_;		// The client callback.
 	};
 
 	AdcOversampler::AdcOversampler(uint8_t res) : 
 		resolution_(setResolution(res)), prescaler_(setPrescaler(AdcPrescalerDefault)),
-		ovsbits_(setOvsBits(resolution_)), ovsamples_(setOvsSamples(ovsbits_))
+		ovsbits_(setOvsBits(resolution_)), ovsamples_(setOvsSamples(ovsbits_)),
+		pins_(), sums_(), values_(), npins_(), index_(), count_(), ready_(), callback_()
+	{
+
+	}
+
+	bool AdcOversampler::attach(pin_t pin)
 	{
+		bool result = npins_ < PinsMax;
+
+		if (result)
+		{
+			pinMode(pin, INPUT);
+			pins_[npins_] = pin;
+			values_[npins_++] = 0;
+			restart();
+		}
+
+		return result;
+	}
 
+	void AdcOversampler::detach()
+	{
+		npins_ = 0;
+		restart();
+		ready_ = false;
+	}
+
+	void AdcOversampler::callback(callback_type cb)
+	{
+		callback_ = cb;
 	}
 
 	analog_t AdcOversampler::max() const
@@ -101,11 +181,17 @@ namespace pg
 		return sum >> ovsbits_;
 	}
 
+	bool AdcOversampler::ready() const
+	{
+		return ready_;
+	}
+
 	void AdcOversampler::resolution(uint8_t res)
 	{
 		resolution_ = setResolution(res);
 		ovsbits_ = setOvsBits(resolution_);
 		ovsamples_ = ipow2(ovsbits_ * 2);
+		restart();
 	}
 
 	uint8_t AdcOversampler::resolution() const
@@ -118,6 +204,51 @@ namespace pg
 		return ovsamples_; 
 	}
 
+	analog_t AdcOversampler::value(pin_t pin) const
+	{
+		uint8_t i = 0;
+
+		while (i < npins_ && pins_[i] != pin)
+			++i;
+
+		return i < npins_ ? values_[i] : 0;
+	}
+
+	void AdcOversampler::clock()
+	{
+		if (npins_)
+		{
+			sums_[index_] += (analog_t)analogRead(pins_[index_]);
+			if (++index_ == npins_)
+			{
+				index_ = 0;
+				if (++count_ == ovsamples_)
+					publish();
+			}
+		}
+	}
+
+	void AdcOversampler::publish()
+	{
+		for (uint8_t i = 0; i < npins_; ++i)
+			values_[i] = sums_[i] >> ovsbits_;
+		restart();
+		ready_ = true;
+		if (callback_)
+		{
+			for (uint8_t i = 0; i < npins_; ++i)
+				(*callback_)(pins_[i], values_[i]);
+		}
+	}
+
+	void AdcOversampler::restart()
+	{
+		for (auto& i : sums_)
+			i = 0;
+		index_ = 0;
+		count_ = 0;
+	}
+
 	uint8_t AdcOversampler::setOvsBits(uint8_t res)
 	{
 		return res - AdcResolutionMin;
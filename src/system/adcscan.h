@@ -0,0 +1,290 @@
+/*
+ *	This files defines a background multi-channel ADC scan service.
+ *
+ *	***************************************************************************
+ *
+ *	File: adcscan.h
+ *	Date: October 14, 2026
+ *	Version: 1.0
+ *	Author: Michael Brodsky
+ *	Email: mbrodskiis@gmail.com
+ *	Copyright (c) 2012-2022 Michael Brodsky
+ *
+ *	***************************************************************************
+ *
+ *  This file is part of "Pretty Good" (Pg). "Pg" is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  This file is distributed in the hope that it will be useful, but
+ *	WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this file. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *	**************************************************************************
+ *
+ *	Description:
+ *
+ *	`adc_scan' converts a list of analog input pins continuously in the
+ *	background and keeps the latest sample of each one, so reading an input
+ *	costs a memory access instead of a blocking analogRead(). Each conversion
+ *	complete interrupt stores the result, selects the next pin and starts the
+ *	next conversion, so all pins are sampled round-robin at the ADC's full
+ *	conversion rate. AnalogInput objects attached to a scanned pin read from
+ *	the scan automatically (see <components/AnalogInput.h>):
+ *
+ *		pg::adc_scan::add(A0);
+ *		pg::adc_scan::add(A1);
+ *		pg::adc_scan::start();
+ *		...
+ *		analog_t value = pg::adc_scan::read(A0);
+ *
+ *	The scan is supported on AVR boards and on SAMD21 boards. The samples
+ *	have the resolution set with analogReadResolution() on SAMD21 boards, and
+ *	10 bits on AVR boards, using the default AVcc reference. While the scan
+ *	is running, analogRead() must not be called, as it reprograms the ADC.
+ *
+ *	The scan takes over the ADC interrupt, so it is only compiled if the
+ *	client defines __PG_ADC_SCAN, and __PG_HAS_ADC_SCAN is defined if it is
+ *	available.
+ *
+ *	**************************************************************************/
+
+#if !defined __PG_ADCSCAN_H
+# define __PG_ADCSCAN_H 20261014L
+
+# include <cstdint>			// Fixed-width integer types.
+# include <system/api.h>	// Arduino api.
+# include <system/types.h>	// pin_t and analog_t types.
+# if defined __PG_ADC_SCAN
+#  if defined __AVR__
+#   include <avr/interrupt.h>
+#   if defined ADCSRA && defined ADMUX
+#    define __PG_HAS_ADC_SCAN
+#   endif
+#  elif defined ARDUINO_ARCH_SAMD && defined ADC_STATUS_SYNCBUSY && defined ADC_INTENSET_RESRDY
+#   include <wiring_private.h>	// pinPeripheral().
+#   define __PG_HAS_ADC_SCAN
+#  endif
+# endif
+
+# if defined __PG_HAS_NAMESPACES && defined __PG_HAS_ADC_SCAN
+
+namespace pg
+{
+	// Background multi-channel ADC scan service.
+	struct adc_scan
+	{
+		static constexpr uint8_t ChannelsMax = 16;	// Maximum number of scanned pins.
+
+		// Adds a pin to the scan and returns true if successful.
+		static bool add(pin_t);
+		// Removes all pins from the scan and stops it.
+		static void clear();
+		// Checks whether a pin is scanned.
+		static bool contains(pin_t);
+		// Returns the latest sample of a scanned pin.
+		static analog_t read(pin_t);
+		// Returns the number of completed scans of all pins.
+		static uint32_t sweeps();
+		// Starts scanning.
+		static void start();
+		// Stops scanning after the current conversion.
+		static void stop();
+		// Services the conversion complete interrupt.
+		static void isr();
+	};
+
+	namespace details
+	{
+		static pin_t __adc_scan_pins[adc_scan::ChannelsMax];				// Scanned pins.
+		static volatile analog_t __adc_scan_samples[adc_scan::ChannelsMax];	// Latest sample of each pin.
+		static uint8_t __adc_scan_size = 0;									// Number of scanned pins.
+		static volatile uint8_t __adc_scan_current = 0;						// Pin being converted.
+		static volatile uint32_t __adc_scan_sweeps = 0;						// Number of completed scans.
+		static volatile bool __adc_scan_running = false;					// Flag indicating whether the scan is running.
+
+		// Returns the index of a scanned pin, or the number of scanned pins if not found.
+		inline uint8_t adc_scan_find(pin_t pin)
+		{
+			uint8_t i = 0;
+
+			while (i < __adc_scan_size && __adc_scan_pins[i] != pin)
+				++i;
+
+			return i;
+		}
+
+# if defined __AVR__
+		// Returns the ADC channel of an analog input pin.
+		inline uint8_t adc_scan_channel(pin_t pin)
+		{
+#  if defined analogPinToChannel
+			return analogPinToChannel(pin >= A0 ? pin - A0 : pin);
+#  else
+			return pin >= A0 ? pin - A0 : pin;
+#  endif
+		}
+
+		// Selects a pin and starts converting it.
+		inline void adc_scan_convert(uint8_t index)
+		{
+			const uint8_t channel = adc_scan_channel(__adc_scan_pins[index]);
+
+#  if defined MUX5
+			ADCSRB = (ADCSRB & ~(1 << MUX5)) | (((channel >> 3) & 0x01) << MUX5);
+#  endif
+			ADMUX = (1 << REFS0) | (channel & 0x07);
+			ADCSRA |= (1 << ADSC);
+		}
+# else // SAMD21
+		inline void adc_scan_sync()
+		{
+			while (ADC->STATUS.bit.SYNCBUSY);
+		}
+
+		// Selects a pin and starts converting it.
+		inline void adc_scan_convert(uint8_t index)
+		{
+			ADC->INPUTCTRL.bit.MUXPOS = g_APinDescription[__adc_scan_pins[index]].ulADCChannelNumber;
+			adc_scan_sync();
+			ADC->SWTRIG.bit.START = 1;
+		}
+# endif
+	} // namespace details
+
+	bool adc_scan::add(pin_t pin)
+	{
+		bool result = contains(pin);
+
+		if (!result && details::__adc_scan_size < ChannelsMax && !details::__adc_scan_running)
+		{
+# if defined __AVR__
+			pinMode(pin, INPUT);
+# else
+			pinPeripheral(pin, PIO_ANALOG);
+# endif
+			details::__adc_scan_samples[details::__adc_scan_size] = 0;
+			details::__adc_scan_pins[details::__adc_scan_size++] = pin;
+			result = true;
+		}
+
+		return result;
+	}
+
+	void adc_scan::clear()
+	{
+		stop();
+		details::__adc_scan_size = 0;
+	}
+
+	bool adc_scan::contains(pin_t pin)
+	{
+		return details::adc_scan_find(pin) < details::__adc_scan_size;
+	}
+
+	analog_t adc_scan::read(pin_t pin)
+	{
+		const uint8_t i = details::adc_scan_find(pin);
+		analog_t value = 0;
+
+		if (i < details::__adc_scan_size)
+		{
+# if defined __AVR__
+			const uint8_t sreg = SREG;
+
+			cli();	// 16-bit reads are not atomic.
+			value = details::__adc_scan_samples[i];
+			SREG = sreg;
+# else
+			value = details::__adc_scan_samples[i];
+# endif
+		}
+
+		return value;
+	}
+
+	uint32_t adc_scan::sweeps()
+	{
+		uint32_t value;
+# if defined __AVR__
+		const uint8_t sreg = SREG;
+
+		cli();
+		value = details::__adc_scan_sweeps;
+		SREG = sreg;
+# else
+		value = details::__adc_scan_sweeps;
+# endif
+
+		return value;
+	}
+
+	void adc_scan::start()
+	{
+		if (details::__adc_scan_size && !details::__adc_scan_running)
+		{
+			details::__adc_scan_current = 0;
+			details::__adc_scan_running = true;
+# if defined __AVR__
+			ADCSRA |= (1 << ADEN) | (1 << ADIE);
+# else
+			ADC->CTRLA.bit.ENABLE = 1;
+			details::adc_scan_sync();
+			ADC->INTFLAG.reg = ADC_INTFLAG_RESRDY;
+			ADC->INTENSET.reg = ADC_INTENSET_RESRDY;
+			NVIC_EnableIRQ(ADC_IRQn);
+# endif
+			details::adc_scan_convert(0);
+		}
+	}
+
+	void adc_scan::stop()
+	{
+		details::__adc_scan_running = false;
+# if defined __AVR__
+		ADCSRA &= ~(1 << ADIE);
+# else
+		ADC->INTENCLR.reg = ADC_INTENCLR_RESRDY;
+# endif
+	}
+
+	void adc_scan::isr()
+	{
+		uint8_t i = details::__adc_scan_current;
+
+# if defined __AVR__
+		details::__adc_scan_samples[i] = ADC;
+# else
+		details::__adc_scan_samples[i] = ADC->RESULT.reg;	// Also clears the RESRDY flag.
+# endif
+		if (++i == details::__adc_scan_size)
+		{
+			i = 0;
+			++details::__adc_scan_sweeps;
+		}
+		details::__adc_scan_current = i;
+		if (details::__adc_scan_running)
+			details::adc_scan_convert(i);
+	}
+} // namespace pg
+
+#  if defined __AVR__
+ISR(ADC_vect)
+{
+	pg::adc_scan::isr();
+}
+#  else
+extern "C" void ADC_Handler(void)
+{
+	pg::adc_scan::isr();
+}
+#  endif
+
+# endif // defined __PG_HAS_NAMESPACES && defined __PG_HAS_ADC_SCAN
+
+#endif // !defined __PG_ADCSCAN_H
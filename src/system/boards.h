@@ -87,10 +87,33 @@
 	using PinStatus = int;
 # elif defined ARDUINO_ARCH_SAMD
 	using PinStatus = int;
+# elif defined ARDUINO_ARCH_RP2040 || defined ARDUINO_ARCH_MBED
+	// ArduinoCore-API defines PinStatus as enumerated type.
+# elif defined ARDUINO_ARCH_ESP32
+	using PinStatus = int;
 # else
 	using PinStatus = int;
 # endif
 
+	//
+	// These select hardware peripheral backends, where the architecture has them.
+	//
+	//	__PG_HAS_DMAC_CRC: DMAC CRC-16/CRC-32 unit (SAMD), used by crc(). SAM3X 
+	//	has no CRC unit and uses the software algorithms.
+	//
+# if defined ARDUINO_ARCH_SAMD && defined DMAC_CRCCTRL_CRCSRC_IO && !defined __PG_NO_DMAC_CRC
+#  define __PG_HAS_DMAC_CRC 1
+# endif
+
+	//
+	//	__PG_HAS_DSP_SIMD: ARM DSP extension packed 8/16-bit instructions 
+	//	(Cortex-M4/M7), used by the valarray and inner_product() kernels in 
+	//	<lib/simd.h>.
+	//
+# if defined __ARM_FEATURE_DSP && __ARM_FEATURE_DSP && !defined __PG_NO_DSP_SIMD
+#  define __PG_HAS_DSP_SIMD 1
+# endif
+
 	//
 	// These specify an architecture-independent definition.
 	//
@@ -254,8 +277,11 @@ namespace pg
 	struct Arduino_Yun {};
 	struct Arduino_Yun_Mini {};
 	struct Arduino_Zero {};
+	struct Arduino_Nano_RP2040 {};
 	struct Digispark {};
 	struct Digispark_Pro {};
+	struct Esp32_Dev {};
+	struct Raspberry_Pi_Pico {};
 	struct Teensy_2_0 {};
 	struct Teensy_plusplus_2_0 {};
 	struct Teensy_3_0 {};
@@ -866,6 +892,57 @@ namespace pg
 		static constexpr const char* mcu = "ARM Cortex-M7";
 	};
 
+	template<>
+	struct board_traits<Raspberry_Pi_Pico>
+	{
+		static constexpr uint8_t adc_digits = 12;
+		static constexpr frequency_t pwm_frequency(pin_t pin)
+		{
+			return pin <= 28 ? 1000 : 0;
+		}
+		static constexpr uint8_t pwm_timer(pin_t pin)
+		{
+			return pin <= 28 ? (pin >> 1) & 0x07 : InvalidPin; // PWM slice.
+		}
+		static constexpr frequency_t clock_frequency = 133000000;
+		static constexpr const char* board = "Raspberry Pi Pico";
+		static constexpr const char* mcu = "RP2040";
+	};
+
+	template<>
+	struct board_traits<Arduino_Nano_RP2040>
+	{
+		static constexpr uint8_t adc_digits = 12;
+		static constexpr frequency_t pwm_frequency(pin_t pin)
+		{
+			return pin <= 21 ? 500 : 0;
+		}
+		static constexpr uint8_t pwm_timer(pin_t)
+		{
+			return InvalidPin;
+		}
+		static constexpr frequency_t clock_frequency = 133000000;
+		static constexpr const char* board = "Arduino Nano RP2040 Connect";
+		static constexpr const char* mcu = "RP2040";
+	};
+
+	template<>
+	struct board_traits<Esp32_Dev>
+	{
+		static constexpr uint8_t adc_digits = 12;
+		static constexpr frequency_t pwm_frequency(pin_t pin)
+		{
+			return pin < 34 ? 1000 : 0; // GPIO 34-39 are input only.
+		}
+		static constexpr uint8_t pwm_timer(pin_t)
+		{
+			return InvalidPin; // LEDC channels are assigned at run time.
+		}
+		static constexpr frequency_t clock_frequency = 240000000;
+		static constexpr const char* board = "ESP32 Dev Module";
+		static constexpr const char* mcu = "ESP32";
+	};
+
 #pragma endregion
 #pragma region board identifiers
 
@@ -1003,6 +1080,12 @@ namespace pg
 		using board_type = Arduino_101;
 #    elif defined(ARDUINO_PORTENTA_H7_M7)
 		using board_type = Arduino_Portenta_H7;
+#    elif defined(ARDUINO_NANO_RP2040_CONNECT)
+		using board_type = Arduino_Nano_RP2040;
+#    elif defined(ARDUINO_RASPBERRY_PI_PICO) || defined(ARDUINO_RASPBERRY_PI_PICO_W)
+		using board_type = Raspberry_Pi_Pico;
+#    elif defined(ARDUINO_ESP32_DEV)
+		using board_type = Esp32_Dev;
 #    endif // defined(ARDUINO_AVR_ADK) 
 #   endif // defined TEENSYDUINO
 #  endif // defined ARDUINO
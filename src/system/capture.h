@@ -0,0 +1,310 @@
+/*
+ *	This files defines a hardware input capture unit for measuring periods.
+ *
+ *	***************************************************************************
+ *
+ *	File: capture.h
+ *	Date: October 14, 2026
+ *	Version: 1.0
+ *	Author: Michael Brodsky
+ *	Email: mbrodskiis@gmail.com
+ *	Copyright (c) 2012-2022 Michael Brodsky
+ *
+ *	***************************************************************************
+ *
+ *  This file is part of "Pretty Good" (Pg). "Pg" is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  This file is distributed in the hope that it will be useful, but
+ *	WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this file. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *	**************************************************************************
+ *
+ *	Description:
+ *
+ *	`hw_capture' measures the period of a digital input signal with a timer
+ *	capture unit, which latches the timer count in hardware on each signal
+ *	edge, so the result is independent of interrupt latency and micros()
+ *	resolution. Jack's timers use it in the Capture mode (see
+ *	<components/Jack.h>). Periods are returned in timer ticks of 1/Frequency
+ *	seconds and nanoseconds() converts them:
+ *
+ *		pg::hw_capture::begin(8);
+ *		...
+ *		uint32_t ns = pg::hw_capture::nanoseconds(pg::hw_capture::period());
+ *
+ *	On the ATmega328P and ATmega32U4, Timer1 counts at the CPU clock with
+ *	its noise canceler enabled, 62.5 ns resolution at 16 MHz, and ICP1 is
+ *	pin 8 or 4. The capture interrupt only reads the latched count and is
+ *	extended to 32 bits by the overflow interrupt, so periods of up to 2^32
+ *	ticks are measured. Timer1 is also used by the Servo library, hw_timer
+ *	and the AVR cycle counter, so it can't be used with them.
+ *
+ *	On the SAMD21, any external interrupt pin routes its edges through the
+ *	event system to TC3, which runs at 3 MHz, 333 ns resolution at 48 MHz,
+ *	in pulse-period capture mode. TC3 restarts on every edge and latches the
+ *	period into CC0, so no software runs per edge at all. Periods longer than
+ *	2^16 ticks, about 21.8 ms, overflow the counter and read as 0.
+ *
+ *	The capture unit is only compiled if the client defines __PG_HW_CAPTURE,
+ *	and __PG_HAS_HW_CAPTURE is defined if it is available.
+ *
+ *	**************************************************************************/
+
+#if !defined __PG_CAPTURE_H
+# define __PG_CAPTURE_H 20261014L
+
+# include <cstdint>			// Fixed-width integer types.
+# include <system/api.h>	// Arduino api.
+# include <system/types.h>	// pin_t type.
+# if defined __PG_HW_CAPTURE
+#  if defined __AVR__
+#   include <avr/interrupt.h>
+#   if defined __PG_CYCLE_COUNTER || defined __PG_HW_TIMER
+#    error Input capture, hw_timer and the AVR cycle counter all use Timer1.
+#   elif defined TIMSK1 && defined ICR1 && (defined __AVR_ATmega328P__ || defined __AVR_ATmega168__)
+#    define __PG_HAS_HW_CAPTURE
+#    define __PG_HW_CAPTURE_PIN 8
+#   elif defined TIMSK1 && defined ICR1 && defined __AVR_ATmega32U4__
+#    define __PG_HAS_HW_CAPTURE
+#    define __PG_HW_CAPTURE_PIN 4
+#   endif
+#  elif defined ARDUINO_ARCH_SAMD && defined TC_EVCTRL_EVACT_PPW && defined GCLK_CLKCTRL_ID_TCC2_TC3
+#   include <wiring_private.h>
+#   define __PG_HAS_HW_CAPTURE
+#  endif
+# endif
+
+# if defined __PG_HAS_NAMESPACES && defined __PG_HAS_HW_CAPTURE
+
+namespace pg
+{
+	// Hardware input capture unit.
+	struct hw_capture
+	{
+		using value_type = uint32_t;	// Type that holds a period in timer ticks.
+
+# if defined __AVR__
+		static constexpr uint32_t Frequency = F_CPU;		// Capture timer ticks per second.
+# else
+		static constexpr uint32_t Frequency = F_CPU / 16;	// Capture timer ticks per second.
+# endif
+
+		// Returns true if a pin can be captured.
+		static bool isPin(pin_t);
+		// Starts capturing the rising or falling edges of a pin, returns false if it can't be captured.
+		static bool begin(pin_t, bool = false);
+		// Stops capturing.
+		static void end();
+		// Returns true if capturing.
+		static bool active();
+		// Discards the last period.
+		static void reset();
+		// Returns the last period in ticks, or 0 if none was captured.
+		static value_type period();
+		// Converts ticks to nanoseconds, saturating at UINT32_MAX.
+		static uint32_t nanoseconds(value_type);
+# if defined __AVR__
+		// Services the capture interrupt.
+		static void isr();
+# endif
+	};
+
+	namespace details
+	{
+		static bool __hw_capture_active = false;				// Flag indicating whether the unit is capturing.
+# if defined __AVR__
+		static volatile uint16_t __hw_capture_overflows = 0;	// Timer1 overflow count, the count high word.
+		static volatile uint32_t __hw_capture_last = 0;			// Count at the last edge.
+		static volatile uint32_t __hw_capture_period = 0;		// Ticks between the last two edges.
+		static volatile uint8_t __hw_capture_edges = 0;			// Edges captured, saturates at 2.
+# else
+		inline void hw_capture_sync()
+		{
+			while (TC3->COUNT16.STATUS.bit.SYNCBUSY);
+		}
+# endif
+	} // namespace details
+
+	bool hw_capture::isPin(pin_t pin)
+	{
+# if defined __AVR__
+		return pin == __PG_HW_CAPTURE_PIN;
+# else
+		return pin < PINS_COUNT && g_APinDescription[pin].ulExtInt != NOT_AN_INTERRUPT;
+# endif
+	}
+
+	bool hw_capture::begin(pin_t pin, bool falling)
+	{
+		if (!isPin(pin))
+			return false;
+		end();
+# if defined __AVR__
+		const uint8_t sreg = SREG;
+
+		cli();
+		TCCR1A = 0;
+		TCCR1B = 0;
+		TCNT1 = 0;
+		details::__hw_capture_overflows = 0;
+		details::__hw_capture_edges = 0;
+		details::__hw_capture_period = 0;
+		TIFR1 = (1 << ICF1) | (1 << TOV1);
+		TIMSK1 = (1 << ICIE1) | (1 << TOIE1);
+		TCCR1B = (1 << ICNC1) | (falling ? 0 : (1 << ICES1)) | (1 << CS10);	// Normal mode, no prescaling.
+		SREG = sreg;
+# else
+		const uint32_t ch = static_cast<uint32_t>(g_APinDescription[pin].ulExtInt);
+		const uint32_t shift = (ch % 8) * 4;
+
+		PM->APBAMASK.reg |= PM_APBAMASK_EIC;
+		PM->APBCMASK.reg |= PM_APBCMASK_EVSYS | PM_APBCMASK_TC3;
+		GCLK->CLKCTRL.reg = GCLK_CLKCTRL_ID_EIC | GCLK_CLKCTRL_GEN_GCLK0 | GCLK_CLKCTRL_CLKEN;
+		while (GCLK->STATUS.bit.SYNCBUSY);
+		GCLK->CLKCTRL.reg = GCLK_CLKCTRL_ID_TCC2_TC3 | GCLK_CLKCTRL_GEN_GCLK0 | GCLK_CLKCTRL_CLKEN;
+		while (GCLK->STATUS.bit.SYNCBUSY);
+		pinPeripheral(pin, PIO_EXTINT);
+		// The pin's edges are events, not interrupts.
+		EIC->CTRL.bit.ENABLE = 0;
+		while (EIC->STATUS.bit.SYNCBUSY);
+		EIC->INTENCLR.reg = 1UL << ch;
+		EIC->EVCTRL.reg |= 1UL << ch;
+		EIC->CONFIG[ch / 8].reg = (EIC->CONFIG[ch / 8].reg & ~(0xfUL << shift)) |
+			(static_cast<uint32_t>(falling ? EIC_CONFIG_SENSE0_FALL_Val : EIC_CONFIG_SENSE0_RISE_Val) << shift);
+		EIC->CTRL.bit.ENABLE = 1;
+		while (EIC->STATUS.bit.SYNCBUSY);
+		// Event channel 0 carries them to TC3.
+		EVSYS->USER.reg = EVSYS_USER_CHANNEL(1) | EVSYS_USER_USER(EVSYS_ID_USER_TC3_EVU);
+		EVSYS->CHANNEL.reg = EVSYS_CHANNEL_EDGSEL_NO_EVT_OUTPUT | EVSYS_CHANNEL_PATH_ASYNCHRONOUS |
+			EVSYS_CHANNEL_EVGEN(EVSYS_ID_GEN_EIC_EXTINT_0 + ch) | EVSYS_CHANNEL_CHANNEL(0);
+		// TC3 restarts on each edge and latches the period into CC0 and the pulse width into CC1.
+		TC3->COUNT16.CTRLA.reg = TC_CTRLA_MODE_COUNT16 | TC_CTRLA_PRESCALER_DIV16;
+		details::hw_capture_sync();
+		TC3->COUNT16.EVCTRL.reg = TC_EVCTRL_TCEI | TC_EVCTRL_EVACT_PPW;
+		TC3->COUNT16.CTRLC.reg = TC_CTRLC_CPTEN0 | TC_CTRLC_CPTEN1;
+		details::hw_capture_sync();
+		TC3->COUNT16.INTFLAG.reg = TC_INTFLAG_OVF | TC_INTFLAG_MC0 | TC_INTFLAG_MC1;
+		TC3->COUNT16.CTRLA.reg |= TC_CTRLA_ENABLE;
+		details::hw_capture_sync();
+# endif
+		details::__hw_capture_active = true;
+
+		return true;
+	}
+
+	void hw_capture::end()
+	{
+# if defined __AVR__
+		const uint8_t sreg = SREG;
+
+		cli();
+		TCCR1B = 0;
+		TIMSK1 &= ~((1 << ICIE1) | (1 << TOIE1));
+		SREG = sreg;
+# else
+		if (details::__hw_capture_active)
+		{
+			TC3->COUNT16.CTRLA.reg &= ~TC_CTRLA_ENABLE;
+			details::hw_capture_sync();
+			EVSYS->USER.reg = EVSYS_USER_CHANNEL(0) | EVSYS_USER_USER(EVSYS_ID_USER_TC3_EVU);
+		}
+# endif
+		details::__hw_capture_active = false;
+	}
+
+	bool hw_capture::active()
+	{
+		return details::__hw_capture_active;
+	}
+
+	void hw_capture::reset()
+	{
+# if defined __AVR__
+		const uint8_t sreg = SREG;
+
+		cli();
+		details::__hw_capture_edges = 0;
+		details::__hw_capture_period = 0;
+		SREG = sreg;
+# else
+		TC3->COUNT16.INTFLAG.reg = TC_INTFLAG_OVF | TC_INTFLAG_MC0 | TC_INTFLAG_MC1;
+# endif
+	}
+
+	typename hw_capture::value_type hw_capture::period()
+	{
+		value_type result = 0;
+
+		if (details::__hw_capture_active)
+		{
+# if defined __AVR__
+			const uint8_t sreg = SREG;
+
+			cli();
+			result = details::__hw_capture_period;
+			SREG = sreg;
+# else
+			if (TC3->COUNT16.INTFLAG.bit.OVF)
+				TC3->COUNT16.INTFLAG.reg = TC_INTFLAG_OVF | TC_INTFLAG_MC0;	// Too slow or no signal, wait for a fresh edge.
+			else if (TC3->COUNT16.INTFLAG.bit.MC0)
+			{
+				TC3->COUNT16.READREQ.reg = TC_READREQ_RREQ | TC_READREQ_ADDR(TC_COUNT16_CC_OFFSET);
+				details::hw_capture_sync();
+				result = TC3->COUNT16.CC[0].reg;	// Keeps MC0 set, CC0 holds the last period until the next edge.
+			}
+# endif
+		}
+
+		return result;
+	}
+
+	uint32_t hw_capture::nanoseconds(value_type ticks)
+	{
+		const uint64_t ns = static_cast<uint64_t>(ticks) * 1000000000ULL / Frequency;
+
+		return ns > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(ns);
+	}
+
+# if defined __AVR__
+	void hw_capture::isr()
+	{
+		const uint16_t low = ICR1;
+		uint16_t high = details::__hw_capture_overflows;
+
+		if ((TIFR1 & (1 << TOV1)) && low < 0x8000)
+			++high;	// Timer1 overflowed before the edge, but its interrupt hasn't run yet.
+
+		const uint32_t count = (static_cast<uint32_t>(high) << 16) | low;
+
+		if (details::__hw_capture_edges < 2)
+			++details::__hw_capture_edges;
+		if (details::__hw_capture_edges == 2)
+			details::__hw_capture_period = count - details::__hw_capture_last;
+		details::__hw_capture_last = count;
+	}
+# endif
+} // namespace pg
+
+#  if defined __AVR__
+ISR(TIMER1_CAPT_vect)
+{
+	pg::hw_capture::isr();
+}
+
+ISR(TIMER1_OVF_vect)
+{
+	++pg::details::__hw_capture_overflows;
+}
+#  endif
+
+# endif // defined __PG_HAS_NAMESPACES && defined __PG_HAS_HW_CAPTURE
+
+#endif // !defined __PG_CAPTURE_H
@@ -34,6 +34,9 @@
 # include <ctime>			// std::time_t type.
 # include <ratio>			// SI ratio types.
 # include <system/api.h>	// Arduino api. 
+# if defined __PG_HW_CLOCK
+#  include <system/hwclock.h>	// Hardware steady clock source.
+# endif
 
 # if defined __PG_HAS_NAMESPACES 
 
@@ -41,24 +44,38 @@ namespace pg
 {
 
 #  if defined ARDUINO 
-#   define steady_clock_api micros
+#   if defined __PG_HW_CLOCK
+#    define steady_clock_api hw_clock::now
+	using steady_clock_rep = hw_clock::rep;
+	using steady_clock_period = hw_clock::period;
+#   else
+#    define steady_clock_api micros
+	using steady_clock_rep = std::time_t;
+	using steady_clock_period = std::micro;
+#   endif
 #   define system_clock_api millis
+	using system_clock_rep = std::time_t;
 	using system_clock_period = std::milli;
-	using steady_clock_period = std::micro;
 #  endif // defined ARDUINO 
 
 	struct steady_clock_t
 	{
+		using rep = steady_clock_rep;
 		using period = steady_clock_period;
 
-		static inline std::time_t now() { return steady_clock_api(); }
+		static inline rep now() { return steady_clock_api() + offset(); }
+		// Returns a reference to the time not counted by the api, e.g. while asleep.
+		static inline rep& offset() { static rep offset_ = 0; return offset_; }
 	};
 
 	struct system_clock_t
 	{
+		using rep = system_clock_rep;
 		using period = system_clock_period;
 
-		static inline std::time_t now() { return system_clock_api(); }
+		static inline rep now() { return system_clock_api() + offset(); }
+		// Returns a reference to the time not counted by the api, e.g. while asleep.
+		static inline rep& offset() { static rep offset_ = 0; return offset_; }
 	};
 }
 
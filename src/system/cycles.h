@@ -0,0 +1,150 @@
+/*
+ *	This files defines a CPU cycle counter for timing code.
+ *
+ *	***************************************************************************
+ *
+ *	File: cycles.h
+ *	Date: October 14, 2026
+ *	Version: 1.0
+ *	Author: Michael Brodsky
+ *	Email: mbrodskiis@gmail.com
+ *	Copyright (c) 2012-2022 Michael Brodsky
+ *
+ *	***************************************************************************
+ *
+ *  This file is part of "Pretty Good" (Pg). "Pg" is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  This file is distributed in the hope that it will be useful, but
+ *	WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this file. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *	**************************************************************************
+ *
+ *	Description:
+ *
+ *	`cycle_counter' counts CPU clock cycles, for measuring how long code
+ *	takes to run:
+ *
+ *		pg::cycle_counter::start();
+ *		...
+ *		pg::cycle_counter::value_type t = pg::cycle_counter::now();
+ *		crc = pg::crc(first, last, pg::crc_16());
+ *		t = pg::cycle_counter::now() - t;
+ *
+ *	The count is a free-running 32-bit value, so differences are correct
+ *	across wraparound for intervals shorter than 2^32 cycles. The counter
+ *	source depends on the architecture:
+ *
+ *		Cortex-M3/M4/M7 (SAM, SAMD51, Teensy 3/4): DWT cycle counter.
+ *		ESP32: CPU cycle count register.
+ *		AVR: Timer1 at the CPU clock, extended to 32 bits by its overflow
+ *			interrupt, if the client defines __PG_CYCLE_COUNTER.
+ *		Others: micros() scaled by the clock frequency, so the resolution
+ *			is one microsecond.
+ *
+ *	__PG_HAS_CYCLE_COUNTER is defined if the count is cycle-accurate. The AVR
+ *	counter takes over Timer1, so it is opt-in: it conflicts with the Servo
+ *	library and with analogWrite() on the Timer1 PWM pins.
+ *
+ *	**************************************************************************/
+
+#if !defined __PG_CYCLES_H
+# define __PG_CYCLES_H 20261014L
+
+# include <cstdint>			// Fixed-width integer types.
+# include <system/api.h>	// Arduino api.
+# if defined DWT_CTRL_CYCCNTENA_Msk
+#  define __PG_HAS_CYCLE_COUNTER
+# elif defined ARDUINO_ARCH_ESP32
+#  define __PG_HAS_CYCLE_COUNTER
+# elif defined __AVR__ && defined __PG_CYCLE_COUNTER
+#  include <avr/interrupt.h>
+#  define __PG_HAS_CYCLE_COUNTER
+# endif
+
+# if defined __PG_HAS_NAMESPACES
+
+namespace pg
+{
+	// CPU clock cycle counter.
+	struct cycle_counter
+	{
+		using value_type = uint32_t;
+
+		// Starts the counter, clients must call it once before now().
+		static void start();
+		// Returns the current cycle count.
+		static value_type now();
+	};
+
+# if defined __AVR__ && defined __PG_HAS_CYCLE_COUNTER
+	namespace details
+	{
+		static volatile uint16_t __cycle_counter_overflows = 0;	// Timer1 overflow count, the counter high word.
+	} // namespace details
+# endif
+
+	inline void cycle_counter::start()
+	{
+# if defined DWT_CTRL_CYCCNTENA_Msk
+		CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+		DWT->CYCCNT = 0;
+		DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+# elif defined __AVR__ && defined __PG_HAS_CYCLE_COUNTER
+		const uint8_t sreg = SREG;
+
+		cli();
+		TCCR1A = 0;
+		TCCR1B = (1 << CS10);	// Normal mode, no prescaling.
+		TCNT1 = 0;
+		TIFR1 = (1 << TOV1);
+		TIMSK1 = (1 << TOIE1);
+		details::__cycle_counter_overflows = 0;
+		SREG = sreg;
+# endif
+	}
+
+	inline cycle_counter::value_type cycle_counter::now()
+	{
+# if defined DWT_CTRL_CYCCNTENA_Msk
+		return DWT->CYCCNT;
+# elif defined ARDUINO_ARCH_ESP32
+		return ESP.getCycleCount();
+# elif defined __AVR__ && defined __PG_HAS_CYCLE_COUNTER
+		const uint8_t sreg = SREG;
+
+		cli();
+
+		uint16_t high = details::__cycle_counter_overflows;
+		const uint16_t low = TCNT1;
+
+		if ((TIFR1 & (1 << TOV1)) && low < 0x8000)
+			++high;	// Timer1 overflowed after interrupts were disabled.
+		SREG = sreg;
+
+		return (static_cast<value_type>(high) << 16) | low;
+# else
+		return micros() * static_cast<value_type>(F_CPU / 1000000UL);
+# endif
+	}
+} // namespace pg
+
+#  if defined __AVR__ && defined __PG_HAS_CYCLE_COUNTER
+ISR(TIMER1_OVF_vect)
+{
+	++pg::details::__cycle_counter_overflows;
+}
+#  endif
+
+# else // !defined __PG_HAS_NAMESPACES
+#  error Requires C++11 and namespace support.
+# endif // defined __PG_HAS_NAMESPACES
+
+#endif // !defined __PG_CYCLES_H
@@ -0,0 +1,368 @@
+/*
+ *	This files defines a compile-time GPIO pin type.
+ *
+ *	***************************************************************************
+ *
+ *	File: fastpin.h
+ *	Date: October 14, 2026
+ *	Version: 1.0
+ *	Author: Michael Brodsky
+ *	Email: mbrodskiis@gmail.com
+ *	Copyright (c) 2012-2022 Michael Brodsky
+ *
+ *	***************************************************************************
+ *
+ *  This file is part of "Pretty Good" (Pg). "Pg" is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  This file is distributed in the hope that it will be useful, but
+ *	WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this file. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *	**************************************************************************
+ *
+ *	Description:
+ *
+ *	`FastPin<P>' accesses GPIO pin P through its port registers, without the
+ *	pin number lookups, range checks and PWM shutdown done by digitalRead()
+ *	and digitalWrite() on every call. The pin number is a template argument,
+ *	so each pin is a distinct empty type and all register addresses and bit
+ *	masks are constants:
+ *
+ *		using Led = pg::FastPin<LED_BUILTIN>;
+ *		Led::mode(OUTPUT);
+ *		Led::toggle();
+ *		bool b = pg::FastPin<2>::read();
+ *
+ *	On ATmega168/328P, ATmega1280/2560 and ATmega32U4 boards, the port and
+ *	bit of each pin are resolved at compile time from the boards' pin maps,
+ *	so set(), clear(), toggle() and read() compile to single sbi, cbi and
+ *	sbic instructions on the low I/O ports. Ports H-L of the ATmega2560 are
+ *	memory mapped, so set() and clear() disable interrupts around their
+ *	read-modify-write cycle. __PG_HAS_FASTPIN_MAP is defined on these
+ *	boards. On other AVR, megaAVR, SAM and SAMD boards, the registers are
+ *	taken from the core's pin tables at a constant index, and each operation
+ *	is a single register store or load. Other architectures fall back to
+ *	digitalRead() and digitalWrite().
+ *
+ *	FastPin does not disconnect PWM timers from the pin, as digitalWrite()
+ *	does, so pins driven by analogWrite() must be written with
+ *	digitalWrite() once first. Pin modes are set with pinMode(), as they are
+ *	not time critical.
+ *
+ *	**************************************************************************/
+
+#if !defined __PG_FASTPIN_H
+# define __PG_FASTPIN_H 20261014L
+
+# include <cstdint>			// Fixed-width integer types.
+# include <system/api.h>	// Arduino api.
+# include <system/boards.h>	// GpioCount.
+# include <system/types.h>	// pin_t type.
+# if defined __AVR__
+#  include <avr/interrupt.h>
+#  if defined __AVR_ATmega168__ || defined __AVR_ATmega168P__ || defined __AVR_ATmega328__ || defined __AVR_ATmega328P__ \
+	|| defined __AVR_ATmega1280__ || defined __AVR_ATmega2560__ || defined __AVR_ATmega32U4__
+#   define __PG_HAS_FASTPIN_MAP
+#  endif
+# endif
+
+# if defined __PG_HAS_NAMESPACES
+
+namespace pg
+{
+	namespace details
+	{
+# if defined __PG_HAS_FASTPIN_MAP
+#  if defined __AVR_ATmega1280__ || defined __AVR_ATmega2560__
+		constexpr const char* FastPinPorts = "EEEEGEHHHHBBBBJJHHDDDDAAAAAAAACCCCCCCCDGGGLLLLLLLLBBBBFFFFFFFFKKKKKKKK";
+		constexpr const char* FastPinBits = "0145533456456710103210012345677654321072107654321032100123456701234567";
+#  elif defined __AVR_ATmega32U4__
+		constexpr const char* FastPinPorts = "DDDDDCDEBBBBDCBBBBFFFFFFDDBBBDD";
+		constexpr const char* FastPinBits = "2310467645676731207654104745665";
+#  else // ATmega168/328
+		constexpr const char* FastPinPorts = "DDDDDDDDBBBBBBCCCCCC";
+		constexpr const char* FastPinBits = "01234567012345012345";
+#  endif
+
+		// Returns the data space address of a port's PINx register, DDRx and PORTx follow it.
+		constexpr uint16_t fastpin_address(char port)
+		{
+			return port < 'H' ? 0x20 + (port - 'A') * 3 : 0x100 + (port - 'H' - (port > 'I')) * 3;
+		}
+
+		// Returns the address of a pin's PINx register.
+		constexpr uint16_t fastpin_input(pin_t pin)
+		{
+			return fastpin_address(FastPinPorts[pin]);
+		}
+
+		// Returns a pin's port bit mask.
+		constexpr uint8_t fastpin_mask(pin_t pin)
+		{
+			return 1 << (FastPinBits[pin] - '0');
+		}
+
+		inline volatile uint8_t& fastpin_register(uint16_t address)
+		{
+			return *reinterpret_cast<volatile uint8_t*>(address);
+		}
+# endif
+	} // namespace details
+
+	// GPIO pin accessed through its port registers.
+	template<pin_t P>
+	struct FastPin
+	{
+		static constexpr pin_t pin = P;	// The pin number.
+
+		// Sets the pin mode, INPUT, INPUT_PULLUP or OUTPUT.
+		static void mode(uint8_t);
+		// Drives the pin high.
+		static void set();
+		// Drives the pin low.
+		static void clear();
+		// Inverts the pin output.
+		static void toggle();
+		// Drives the pin to a given level.
+		static void write(bool);
+		// Returns the pin input level.
+		static bool read();
+
+# if defined __PG_HAS_FASTPIN_MAP
+		static_assert(P < GpioCount, "FastPin number out of range.");
+
+		static constexpr uint16_t Input = details::fastpin_input(P);	// PINx register address.
+		static constexpr uint16_t Output = Input + 2;					// PORTx register address.
+		static constexpr uint8_t Mask = details::fastpin_mask(P);		// Port bit mask.
+		static constexpr bool Atomic = Output < 0x40;					// sbi/cbi addressable.
+# endif
+	};
+
+	template<pin_t P>
+	void FastPin<P>::mode(uint8_t value)
+	{
+		pinMode(P, value);
+	}
+
+	template<pin_t P>
+	void FastPin<P>::write(bool value)
+	{
+		if (value)
+			set();
+		else
+			clear();
+	}
+
+# if defined __PG_HAS_FASTPIN_MAP
+
+	template<pin_t P>
+	void FastPin<P>::set()
+	{
+		if (Atomic)
+			details::fastpin_register(Output) |= Mask;
+		else
+		{
+			const uint8_t sreg = SREG;
+
+			cli();
+			details::fastpin_register(Output) |= Mask;
+			SREG = sreg;
+		}
+	}
+
+	template<pin_t P>
+	void FastPin<P>::clear()
+	{
+		if (Atomic)
+			details::fastpin_register(Output) &= ~Mask;
+		else
+		{
+			const uint8_t sreg = SREG;
+
+			cli();
+			details::fastpin_register(Output) &= ~Mask;
+			SREG = sreg;
+		}
+	}
+
+	template<pin_t P>
+	void FastPin<P>::toggle()
+	{
+		details::fastpin_register(Input) = Mask;	// Writing a 1 to PINx toggles PORTx.
+	}
+
+	template<pin_t P>
+	bool FastPin<P>::read()
+	{
+		return details::fastpin_register(Input) & Mask;
+	}
+
+# elif defined ARDUINO_ARCH_MEGAAVR
+
+	template<pin_t P>
+	void FastPin<P>::set()
+	{
+		digitalPinToPortStruct(P)->OUTSET = digitalPinToBitMask(P);
+	}
+
+	template<pin_t P>
+	void FastPin<P>::clear()
+	{
+		digitalPinToPortStruct(P)->OUTCLR = digitalPinToBitMask(P);
+	}
+
+	template<pin_t P>
+	void FastPin<P>::toggle()
+	{
+		digitalPinToPortStruct(P)->OUTTGL = digitalPinToBitMask(P);
+	}
+
+	template<pin_t P>
+	bool FastPin<P>::read()
+	{
+		return digitalPinToPortStruct(P)->IN & digitalPinToBitMask(P);
+	}
+
+# elif defined __AVR__
+
+	template<pin_t P>
+	void FastPin<P>::set()
+	{
+		volatile uint8_t* out = portOutputRegister(digitalPinToPort(P));
+		const uint8_t mask = digitalPinToBitMask(P);
+		const uint8_t sreg = SREG;
+
+		cli();
+		*out |= mask;
+		SREG = sreg;
+	}
+
+	template<pin_t P>
+	void FastPin<P>::clear()
+	{
+		volatile uint8_t* out = portOutputRegister(digitalPinToPort(P));
+		const uint8_t mask = digitalPinToBitMask(P);
+		const uint8_t sreg = SREG;
+
+		cli();
+		*out &= ~mask;
+		SREG = sreg;
+	}
+
+	template<pin_t P>
+	void FastPin<P>::toggle()
+	{
+		volatile uint8_t* out = portOutputRegister(digitalPinToPort(P));
+		const uint8_t mask = digitalPinToBitMask(P);
+		const uint8_t sreg = SREG;
+
+		cli();	// Not all AVR devices toggle PORTx when writing to PINx.
+		*out ^= mask;
+		SREG = sreg;
+	}
+
+	template<pin_t P>
+	bool FastPin<P>::read()
+	{
+		return *portInputRegister(digitalPinToPort(P)) & digitalPinToBitMask(P);
+	}
+
+# elif defined ARDUINO_ARCH_SAMD
+
+	template<pin_t P>
+	void FastPin<P>::set()
+	{
+		PORT->Group[g_APinDescription[P].ulPort].OUTSET.reg = 1UL << g_APinDescription[P].ulPin;
+	}
+
+	template<pin_t P>
+	void FastPin<P>::clear()
+	{
+		PORT->Group[g_APinDescription[P].ulPort].OUTCLR.reg = 1UL << g_APinDescription[P].ulPin;
+	}
+
+	template<pin_t P>
+	void FastPin<P>::toggle()
+	{
+		PORT->Group[g_APinDescription[P].ulPort].OUTTGL.reg = 1UL << g_APinDescription[P].ulPin;
+	}
+
+	template<pin_t P>
+	bool FastPin<P>::read()
+	{
+		return PORT->Group[g_APinDescription[P].ulPort].IN.reg & (1UL << g_APinDescription[P].ulPin);
+	}
+
+# elif defined ARDUINO_ARCH_SAM
+
+	template<pin_t P>
+	void FastPin<P>::set()
+	{
+		g_APinDescription[P].pPort->PIO_SODR = g_APinDescription[P].ulPin;
+	}
+
+	template<pin_t P>
+	void FastPin<P>::clear()
+	{
+		g_APinDescription[P].pPort->PIO_CODR = g_APinDescription[P].ulPin;
+	}
+
+	template<pin_t P>
+	void FastPin<P>::toggle()
+	{
+		Pio* port = g_APinDescription[P].pPort;
+		const uint32_t mask = g_APinDescription[P].ulPin;
+
+		if (port->PIO_ODSR & mask)
+			port->PIO_CODR = mask;
+		else
+			port->PIO_SODR = mask;
+	}
+
+	template<pin_t P>
+	bool FastPin<P>::read()
+	{
+		return g_APinDescription[P].pPort->PIO_PDSR & g_APinDescription[P].ulPin;
+	}
+
+# else
+
+	template<pin_t P>
+	void FastPin<P>::set()
+	{
+		digitalWrite(P, HIGH);
+	}
+
+	template<pin_t P>
+	void FastPin<P>::clear()
+	{
+		digitalWrite(P, LOW);
+	}
+
+	template<pin_t P>
+	void FastPin<P>::toggle()
+	{
+		digitalWrite(P, !digitalRead(P));
+	}
+
+	template<pin_t P>
+	bool FastPin<P>::read()
+	{
+		return digitalRead(P);
+	}
+
+# endif
+} // namespace pg
+
+# else // !defined __PG_HAS_NAMESPACES
+#  error Requires C++11 and namespace support.
+# endif // defined __PG_HAS_NAMESPACES
+
+#endif // !defined __PG_FASTPIN_H
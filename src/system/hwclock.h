@@ -0,0 +1,219 @@
+/*
+ *	This files defines a high-resolution, non-wrapping hardware clock source.
+ *
+ *	***************************************************************************
+ *
+ *	File: hwclock.h
+ *	Date: October 14, 2026
+ *	Version: 1.0
+ *	Author: Michael Brodsky
+ *	Email: mbrodskiis@gmail.com
+ *	Copyright (c) 2012-2022 Michael Brodsky
+ *
+ *	***************************************************************************
+ *
+ *  This file is part of "Pretty Good" (Pg). "Pg" is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  This file is distributed in the hope that it will be useful, but
+ *	WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this file. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *	**************************************************************************
+ *
+ *	Description:
+ *
+ *	`hw_clock' is a free-running hardware timer, extended to 64 bits in
+ *	software by its overflow interrupt, so its count never wraps in
+ *	practice. Defining __PG_HW_CLOCK makes it the source of
+ *	std::chrono::steady_clock (see <system/clock.h>), and of Timer objects,
+ *	schedulers and Jack timers built on them (see <utilities/Timer.h>).
+ *	Clients must call hw_clock::begin() once, from setup(), before reading
+ *	the clock:
+ *
+ *		void setup()
+ *		{
+ *			pg::hw_clock::begin();
+ *			...
+ *		}
+ *
+ *	The clock source depends on the architecture:
+ *
+ *		AVR: Timer1 with a prescaler of 8, 0.5 us ticks at 16 MHz,
+ *			overflowing every 32.8 ms.
+ *		SAMD21: TC4 and TC5 as a 32-bit counter with a prescaler of 16,
+ *			333 ns ticks at 48 MHz, overflowing every 24 minutes.
+ *		Others: micros(), extended to 64 bits when the clock is read, so it
+ *			must be read at least once every 71 minutes.
+ *
+ *	__PG_HAS_HW_CLOCK is defined if the clock is driven by a hardware timer.
+ *	Reads don't disable interrupts: the high word is read before and after
+ *	the counter until it doesn't change, and an overflow still pending
+ *	when interrupts are disabled is added in. On AVR boards, the clock
+ *	takes over Timer1, so it can't be used with the hardware timer, input
+ *	capture or cycle counter (see <system/hwtimer.h>, <system/capture.h>
+ *	and <system/cycles.h>), the Servo library or analogWrite() on the
+ *	Timer1 PWM pins. On SAMD21 boards it takes over TC4 and TC5, which are
+ *	also used by the Servo library and tone().
+ *
+ *	**************************************************************************/
+
+#if !defined __PG_HWCLOCK_H
+# define __PG_HWCLOCK_H 20261014L
+
+# include <cstdint>			// Fixed-width integer types.
+# include <ratio>			// SI ratio types.
+# include <system/api.h>	// Arduino api.
+# if defined __PG_HW_CLOCK
+#  if defined __AVR__
+#   include <avr/interrupt.h>
+#   if defined __PG_HW_TIMER || defined __PG_HW_CAPTURE || defined __PG_CYCLE_COUNTER
+#    error The hardware clock, hardware timer, input capture and AVR cycle counter all use Timer1.
+#   elif defined TIMSK1 && defined TCNT1
+#    define __PG_HAS_HW_CLOCK
+#   endif
+#  elif defined ARDUINO_ARCH_SAMD && defined TC_READREQ_RCONT && defined GCLK_CLKCTRL_ID_TC4_TC5
+#   define __PG_HAS_HW_CLOCK
+#  endif
+# endif
+
+# if defined __PG_HAS_NAMESPACES && defined __PG_HW_CLOCK
+
+namespace pg
+{
+	// Free-running 64-bit hardware clock.
+	struct hw_clock
+	{
+		using rep = int64_t;						// Clock ticks type.
+# if defined __PG_HAS_HW_CLOCK && defined __AVR__
+		using period = std::ratio<8, F_CPU>;		// Clock tick period in seconds.
+# elif defined __PG_HAS_HW_CLOCK
+		using period = std::ratio<16, F_CPU>;		// Clock tick period in seconds.
+# else
+		using period = std::micro;					// Clock tick period in seconds.
+# endif
+
+		// Starts the clock at zero, clients must call it once before now().
+		static void begin();
+		// Returns the current clock ticks.
+		static rep now();
+# if defined __PG_HAS_HW_CLOCK
+		// Services the overflow interrupt.
+		static void isr();
+# endif
+	};
+
+	namespace details
+	{
+		static volatile uint32_t __hw_clock_overflows = 0;	// Counter overflows, the clock high word.
+# if !defined __PG_HAS_HW_CLOCK
+		static uint32_t __hw_clock_last = 0;				// Count at the last read.
+# endif
+	} // namespace details
+
+	inline void hw_clock::begin()
+	{
+# if defined __PG_HAS_HW_CLOCK && defined __AVR__
+		const uint8_t sreg = SREG;
+
+		cli();
+		TCCR1A = 0;
+		TCCR1B = (1 << CS11);	// Normal mode, prescaler 8.
+		TCNT1 = 0;
+		TIFR1 = (1 << TOV1);
+		TIMSK1 = (1 << TOIE1);
+		details::__hw_clock_overflows = 0;
+		SREG = sreg;
+# elif defined __PG_HAS_HW_CLOCK
+		// TC4 is the master of the 32-bit counter, TC5 its slave, clocked by GCLK0.
+		GCLK->CLKCTRL.reg = GCLK_CLKCTRL_CLKEN | GCLK_CLKCTRL_GEN_GCLK0 | GCLK_CLKCTRL_ID_TC4_TC5;
+		while (GCLK->STATUS.bit.SYNCBUSY);
+		PM->APBCMASK.reg |= PM_APBCMASK_TC4 | PM_APBCMASK_TC5;
+		TC4->COUNT32.CTRLA.reg = TC_CTRLA_SWRST;
+		while (TC4->COUNT32.CTRLA.bit.SWRST);
+		TC4->COUNT32.CTRLA.reg = TC_CTRLA_MODE_COUNT32 | TC_CTRLA_WAVEGEN_NFRQ | TC_CTRLA_PRESCALER_DIV16;
+		TC4->COUNT32.READREQ.reg = TC_READREQ_RCONT | TC_READREQ_ADDR(TC_COUNT32_COUNT_OFFSET);	// COUNT is always synchronized.
+		TC4->COUNT32.INTFLAG.reg = TC_INTFLAG_OVF;
+		TC4->COUNT32.INTENSET.reg = TC_INTENSET_OVF;
+		details::__hw_clock_overflows = 0;
+		NVIC_ClearPendingIRQ(TC4_IRQn);
+		NVIC_EnableIRQ(TC4_IRQn);
+		TC4->COUNT32.CTRLA.reg |= TC_CTRLA_ENABLE;
+		while (TC4->COUNT32.STATUS.bit.SYNCBUSY);
+# else
+		details::__hw_clock_overflows = 0;
+		details::__hw_clock_last = micros();
+# endif
+	}
+
+	inline hw_clock::rep hw_clock::now()
+	{
+# if defined __PG_HAS_HW_CLOCK && defined __AVR__
+		uint32_t high;
+		uint16_t low;
+
+		do
+		{
+			high = details::__hw_clock_overflows;
+			low = TCNT1;
+		} while (high != details::__hw_clock_overflows);
+		if ((TIFR1 & (1 << TOV1)) && low < 0x8000)
+			++high;	// Timer1 overflowed, but its interrupt hasn't run yet.
+
+		return (static_cast<rep>(high) << 16) | low;
+# elif defined __PG_HAS_HW_CLOCK
+		uint32_t high;
+		uint32_t low;
+
+		do
+		{
+			high = details::__hw_clock_overflows;
+			low = TC4->COUNT32.COUNT.reg;
+		} while (high != details::__hw_clock_overflows);
+		if (TC4->COUNT32.INTFLAG.bit.OVF && low < 0x80000000UL)
+			++high;	// TC4 overflowed, but its interrupt hasn't run yet.
+
+		return (static_cast<rep>(high) << 32) | low;
+# else
+		const uint32_t low = micros();
+
+		if (low < details::__hw_clock_last)
+			++details::__hw_clock_overflows;	// micros() wrapped since the last read.
+		details::__hw_clock_last = low;
+
+		return (static_cast<rep>(details::__hw_clock_overflows) << 32) | low;
+# endif
+	}
+
+# if defined __PG_HAS_HW_CLOCK
+	inline void hw_clock::isr()
+	{
+#  if !defined __AVR__
+		TC4->COUNT32.INTFLAG.reg = TC_INTFLAG_OVF;
+#  endif
+		details::__hw_clock_overflows = details::__hw_clock_overflows + 1;
+	}
+# endif
+} // namespace pg
+
+#  if defined __PG_HAS_HW_CLOCK && defined __AVR__
+ISR(TIMER1_OVF_vect)
+{
+	pg::hw_clock::isr();
+}
+#  elif defined __PG_HAS_HW_CLOCK
+extern "C" void TC4_Handler(void)
+{
+	pg::hw_clock::isr();
+}
+#  endif
+
+# endif // defined __PG_HAS_NAMESPACES && defined __PG_HW_CLOCK
+
+#endif // !defined __PG_HWCLOCK_H
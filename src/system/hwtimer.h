@@ -0,0 +1,157 @@
+/*
+ *	This files defines a one-shot hardware compare timer.
+ *
+ *	***************************************************************************
+ *
+ *	File: hwtimer.h
+ *	Date: October 14, 2026
+ *	Version: 1.0
+ *	Author: Michael Brodsky
+ *	Email: mbrodskiis@gmail.com
+ *	Copyright (c) 2012-2022 Michael Brodsky
+ *
+ *	***************************************************************************
+ *
+ *  This file is part of "Pretty Good" (Pg). "Pg" is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  This file is distributed in the hope that it will be useful, but
+ *	WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this file. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *	**************************************************************************
+ *
+ *	Description:
+ *
+ *	`hw_timer' calls a client function from an interrupt once a given number
+ *	of microseconds has elapsed. It is used by EventSequencer to time events
+ *	independently of loop() (see <components/EventSequencer.h>).
+ *
+ *	On AVR boards with a 16-bit Timer1, the timer runs in CTC mode with a
+ *	prescaler of 8, giving 0.5 us resolution at 16 MHz. Delays longer than
+ *	one timer period are counted down in full periods from the compare
+ *	interrupt, and the last two periods are split evenly, so the last
+ *	compare value is always well ahead of the counter. Timer1 is also used by the Servo library and PWM on pins 9
+ *	and 10 of the Uno, so the hardware timer is only compiled if the client
+ *	defines __PG_HW_TIMER, and __PG_HAS_HW_TIMER is defined if it is
+ *	available.
+ *
+ *	**************************************************************************/
+
+#if !defined __PG_HWTIMER_H
+# define __PG_HWTIMER_H 20261014L
+
+# include <cstdint>			// Fixed-width integer types.
+# include <system/api.h>	// Arduino api.
+# if defined __PG_HW_TIMER && defined __AVR__
+#  include <avr/interrupt.h>
+#  if defined TIMSK1 && defined OCR1A
+#   define __PG_HAS_HW_TIMER
+#  endif
+# endif
+
+# if defined __PG_HAS_NAMESPACES && defined __PG_HAS_HW_TIMER
+
+namespace pg
+{
+	// One-shot hardware compare timer.
+	struct hw_timer
+	{
+		using callback_type = void(*)(void*);	// Expiry callback type.
+
+		// Sets the function called from the interrupt when the timer expires.
+		static void begin(callback_type, void*);
+		// Starts the timer, replacing any current delay.
+		static void arm(uint32_t);
+		// Stops the timer without calling the callback.
+		static void cancel();
+		// Services the compare interrupt.
+		static void isr();
+	};
+
+	namespace details
+	{
+		static hw_timer::callback_type __hw_timer_callback = nullptr;	// Client expiry callback.
+		static void* __hw_timer_arg = nullptr;							// Client callback argument.
+		static volatile uint32_t __hw_timer_remaining = 0;				// Timer ticks left after the current period.
+
+		// Loads the next timer period, at most 2^16 ticks. The last two periods are split evenly, 
+		// a short remainder loaded from the isr could already be behind TCNT1 and miss its compare.
+		inline void hw_timer_load()
+		{
+			uint32_t period = __hw_timer_remaining;
+
+			if (period > 0x20000UL)
+				period = 0x10000UL;
+			else if (period > 0x10000UL)
+				period = (period + 1) / 2;
+			if (period == 0)
+				period = 1;
+			OCR1A = static_cast<uint16_t>(period - 1);
+			if (__hw_timer_remaining >= period)
+				__hw_timer_remaining -= period;
+		}
+	} // namespace details
+
+	void hw_timer::begin(callback_type callback, void* arg)
+	{
+		cancel();
+		details::__hw_timer_callback = callback;
+		details::__hw_timer_arg = arg;
+	}
+
+	void hw_timer::arm(uint32_t us)
+	{
+		const uint8_t sreg = SREG;
+
+		cli();
+		TCCR1B = 0;
+		TCCR1A = 0;
+		TCNT1 = 0;
+		details::__hw_timer_remaining = static_cast<uint32_t>(static_cast<uint64_t>(us) * (F_CPU / 1000000UL) / 8);
+		details::hw_timer_load();
+		TIFR1 = (1 << OCF1A);
+		TIMSK1 |= (1 << OCIE1A);
+		TCCR1B = (1 << WGM12) | (1 << CS11);	// CTC mode, clk/8.
+		SREG = sreg;
+	}
+
+	void hw_timer::cancel()
+	{
+		const uint8_t sreg = SREG;
+
+		cli();
+		TCCR1B = 0;
+		TIMSK1 &= ~(1 << OCIE1A);
+		details::__hw_timer_remaining = 0;
+		SREG = sreg;
+	}
+
+	void hw_timer::isr()
+	{
+		if (details::__hw_timer_remaining)
+			details::hw_timer_load();
+		else
+		{
+			TCCR1B = 0;
+			TIMSK1 &= ~(1 << OCIE1A);
+			if (details::__hw_timer_callback)
+				(*details::__hw_timer_callback)(details::__hw_timer_arg);
+		}
+	}
+} // namespace pg
+
+ISR(TIMER1_COMPA_vect)
+{
+	pg::hw_timer::isr();
+}
+
+# endif // defined __PG_HAS_NAMESPACES && defined __PG_HAS_HW_TIMER
+
+#endif // !defined __PG_HWTIMER_H
@@ -0,0 +1,351 @@
+/*
+ *	This files defines core identification, cross-core locking and message
+ *	passing for multi-core boards.
+ *
+ *	***************************************************************************
+ *
+ *	File: multicore.h
+ *	Date: October 14, 2026
+ *	Version: 1.0
+ *	Author: Michael Brodsky
+ *	Email: mbrodskiis@gmail.com
+ *	Copyright (c) 2012-2022 Michael Brodsky
+ *
+ *	***************************************************************************
+ *
+ *  This file is part of "Pretty Good" (Pg). "Pg" is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  This file is distributed in the hope that it will be useful, but
+ *	WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this file. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *	**************************************************************************
+ *
+ *	Description:
+ *
+ *	This file provides the primitives that let both cores of an RP2040 or
+ *	ESP32 board share work:
+ *
+ *		CoreCount: number of cores that can run client code,
+ *		core_id(): returns the number of the calling core, in [0, CoreCount),
+ *		core_lock: short critical section that excludes the other core and
+ *			local interrupts,
+ *		spsc_queue<T, N>: lock-free single-producer/single-consumer queue.
+ *
+ *	__PG_HAS_MULTICORE is defined on RP2040 boards using the Raspberry Pi
+ *	Pico core, where setup1() and loop1() run on core 1, and on dual-core
+ *	ESP32 boards, where loop() runs on core 1 and clients start core 0 work
+ *	with xTaskCreatePinnedToCore(). On other boards CoreCount is 1, core_id()
+ *	returns 0 and core_lock only disables interrupts. On AVR and ARM boards
+ *	unlock() restores the interrupt state saved by lock(), so a core_lock
+ *	can be taken with interrupts already disabled, such as from an ISR.
+ *
+ *	An `spsc_queue' passes messages from exactly one producer, a core or an
+ *	interrupt, to exactly one consumer. Each index is written by one side
+ *	only and published with release/acquire ordering, so neither side ever
+ *	waits for or locks out the other:
+ *
+ *		pg::spsc_queue<Message, 8> to_control;	// Network core -> control core.
+ *
+ *		// Core 0:						// Core 1:
+ *		to_control.push(msg);			Message m;
+ *										while (to_control.pop(m)) ...
+ *
+ *	The queue holds up to N messages. On AVR boards N must be less than 256,
+ *	so the indices are read and written atomically.
+ *
+ *	**************************************************************************/
+
+#if !defined __PG_MULTICORE_H
+# define __PG_MULTICORE_H 20261014L
+
+# include <cstdint>			// Fixed-width integer types.
+# include <type_traits>		// std::conditional
+# include <system/api.h>	// Arduino api.
+# if defined ARDUINO_ARCH_RP2040
+#  include <hardware/sync.h>	// Hardware spin locks.
+#  define __PG_HAS_MULTICORE
+# elif defined ARDUINO_ARCH_ESP32 && !defined CONFIG_FREERTOS_UNICORE
+#  include <freertos/FreeRTOS.h>
+#  define __PG_HAS_MULTICORE
+# elif defined __AVR__
+#  include <avr/interrupt.h>
+# endif
+
+# if defined __PG_HAS_NAMESPACES
+
+namespace pg
+{
+# if defined __PG_HAS_MULTICORE
+	constexpr uint8_t CoreCount = 2;	// Number of cores that run client code.
+# else
+	constexpr uint8_t CoreCount = 1;	// Number of cores that run client code.
+# endif
+
+	// Returns the number of the calling core.
+	inline uint8_t core_id()
+	{
+# if defined ARDUINO_ARCH_RP2040
+		return get_core_num();
+# elif defined __PG_HAS_MULTICORE
+		return xPortGetCoreID();
+# else
+		return 0;
+# endif
+	}
+
+	// Short critical section shared by all cores and interrupts.
+	class core_lock
+	{
+	public:
+		core_lock();
+		core_lock(const core_lock&) = delete;
+		core_lock& operator=(const core_lock&) = delete;
+
+	public:
+		// Waits for and takes the lock, disabling local interrupts.
+		void lock();
+		// Releases the lock, restoring local interrupts.
+		void unlock();
+
+	private:
+# if defined ARDUINO_ARCH_RP2040
+		spin_lock_t*	lock_;	// Hardware spin lock.
+		uint32_t		save_;	// Saved interrupt state.
+# elif defined __PG_HAS_MULTICORE
+		portMUX_TYPE	lock_;	// FreeRTOS spin lock.
+# elif defined __AVR__
+		uint8_t			sreg_;	// Saved status register.
+# elif defined __arm__
+		uint32_t		primask_;	// Saved interrupt mask.
+# endif
+	};
+
+	// Holds a core_lock for the lifetime of the guard.
+	class core_lock_guard
+	{
+	public:
+		explicit core_lock_guard(core_lock& lock) : lock_(lock) { lock_.lock(); }
+		~core_lock_guard() { lock_.unlock(); }
+		core_lock_guard(const core_lock_guard&) = delete;
+		core_lock_guard& operator=(const core_lock_guard&) = delete;
+
+	private:
+		core_lock& lock_;	// The held lock.
+	};
+
+	// Lock-free single-producer/single-consumer queue of up to N items of type T.
+	template<class T, std::size_t N>
+	class spsc_queue
+	{
+# if defined __AVR__
+		static_assert(N < 256, "spsc_queue size must be less than 256 on AVR.");
+# endif
+		static_assert(N > 0, "spsc_queue size must be non-zero.");
+
+	public:
+		using value_type = T;
+		using size_type = typename std::conditional<(N < 256), uint8_t, std::size_t>::type;
+
+	public:
+		spsc_queue();
+		spsc_queue(const spsc_queue&) = delete;
+		spsc_queue& operator=(const spsc_queue&) = delete;
+
+	public:
+		// Appends an item and returns true, or returns false if the queue is full. Producer only.
+		bool push(const value_type&);
+		// Removes the oldest item and returns true, or returns false if the queue is empty. Consumer only.
+		bool pop(value_type&);
+		// Checks whether the queue is empty.
+		bool empty() const;
+		// Checks whether the queue is full.
+		bool full() const;
+		// Returns the number of queued items.
+		size_type size() const;
+		// Returns the maximum number of queued items.
+		constexpr size_type capacity() const { return N; }
+
+	private:
+		// Returns the index following i.
+		static constexpr size_type next(size_type i) { return i == N ? 0 : i + 1; }
+
+	private:
+		value_type	items_[N + 1];	// Item ring, one slot is always empty.
+		size_type	head_;			// Index of the oldest item, written by the consumer.
+		size_type	tail_;			// Index of the next free slot, written by the producer.
+	};
+
+#pragma region core_lock
+
+# if defined ARDUINO_ARCH_RP2040
+
+	inline core_lock::core_lock() :
+		lock_(spin_lock_init(spin_lock_claim_unused(true))), save_()
+	{
+
+	}
+
+	inline void core_lock::lock()
+	{
+		save_ = spin_lock_blocking(lock_);
+	}
+
+	inline void core_lock::unlock()
+	{
+		spin_unlock(lock_, save_);
+	}
+
+# elif defined __PG_HAS_MULTICORE
+
+	inline core_lock::core_lock() : lock_(portMUX_INITIALIZER_UNLOCKED)
+	{
+
+	}
+
+	inline void core_lock::lock()
+	{
+		portENTER_CRITICAL(&lock_);
+	}
+
+	inline void core_lock::unlock()
+	{
+		portEXIT_CRITICAL(&lock_);
+	}
+
+# elif defined __AVR__
+
+	inline core_lock::core_lock() : sreg_()
+	{
+
+	}
+
+	inline void core_lock::lock()
+	{
+		const uint8_t sreg = SREG;
+
+		cli();
+		sreg_ = sreg;
+	}
+
+	inline void core_lock::unlock()
+	{
+		SREG = sreg_;
+	}
+
+# elif defined __arm__
+
+	inline core_lock::core_lock() : primask_()
+	{
+
+	}
+
+	inline void core_lock::lock()
+	{
+		uint32_t primask;
+
+		__asm__ volatile ("mrs %0, primask" : "=r" (primask));
+		__asm__ volatile ("cpsid i" ::: "memory");
+		primask_ = primask;
+	}
+
+	inline void core_lock::unlock()
+	{
+		__asm__ volatile ("msr primask, %0" :: "r" (primask_) : "memory");
+	}
+
+# else
+
+	inline core_lock::core_lock()
+	{
+
+	}
+
+	inline void core_lock::lock()
+	{
+		noInterrupts();
+	}
+
+	inline void core_lock::unlock()
+	{
+		interrupts();
+	}
+
+# endif
+
+#pragma endregion
+#pragma region spsc_queue
+
+	template<class T, std::size_t N>
+	spsc_queue<T, N>::spsc_queue() : items_(), head_(), tail_()
+	{
+
+	}
+
+	template<class T, std::size_t N>
+	bool spsc_queue<T, N>::push(const value_type& item)
+	{
+		const size_type tail = __atomic_load_n(&tail_, __ATOMIC_RELAXED);
+		const size_type next_tail = next(tail);
+		bool result = next_tail != __atomic_load_n(&head_, __ATOMIC_ACQUIRE);
+
+		if (result)
+		{
+			items_[tail] = item;
+			__atomic_store_n(&tail_, next_tail, __ATOMIC_RELEASE);	// Publishes the item.
+		}
+
+		return result;
+	}
+
+	template<class T, std::size_t N>
+	bool spsc_queue<T, N>::pop(value_type& item)
+	{
+		const size_type head = __atomic_load_n(&head_, __ATOMIC_RELAXED);
+		bool result = head != __atomic_load_n(&tail_, __ATOMIC_ACQUIRE);
+
+		if (result)
+		{
+			item = items_[head];
+			__atomic_store_n(&head_, next(head), __ATOMIC_RELEASE);	// Frees the slot.
+		}
+
+		return result;
+	}
+
+	template<class T, std::size_t N>
+	bool spsc_queue<T, N>::empty() const
+	{
+		return __atomic_load_n(&head_, __ATOMIC_ACQUIRE) == __atomic_load_n(&tail_, __ATOMIC_ACQUIRE);
+	}
+
+	template<class T, std::size_t N>
+	bool spsc_queue<T, N>::full() const
+	{
+		return next(__atomic_load_n(&tail_, __ATOMIC_ACQUIRE)) == __atomic_load_n(&head_, __ATOMIC_ACQUIRE);
+	}
+
+	template<class T, std::size_t N>
+	typename spsc_queue<T, N>::size_type spsc_queue<T, N>::size() const
+	{
+		const size_type head = __atomic_load_n(&head_, __ATOMIC_ACQUIRE);
+		const size_type tail = __atomic_load_n(&tail_, __ATOMIC_ACQUIRE);
+
+		return tail >= head ? tail - head : N + 1 - head + tail;
+	}
+
+#pragma endregion
+} // namespace pg
+
+# else // !defined __PG_HAS_NAMESPACES
+#  error Requires C++11 and namespace support.
+# endif // defined __PG_HAS_NAMESPACES
+
+#endif // !defined __PG_MULTICORE_H
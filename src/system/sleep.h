@@ -0,0 +1,257 @@
+/*
+ *	This files defines low-power idle functions.
+ *
+ *	***************************************************************************
+ *
+ *	File: sleep.h
+ *	Date: October 14, 2026
+ *	Version: 1.0
+ *	Author: Michael Brodsky
+ *	Email: mbrodskiis@gmail.com
+ *	Copyright (c) 2012-2022 Michael Brodsky
+ *
+ *	***************************************************************************
+ *
+ *  This file is part of "Pretty Good" (Pg). "Pg" is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  This file is distributed in the hope that it will be useful, but
+ *	WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this file. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *	**************************************************************************
+ *
+ *	Description:
+ *
+ *	`deep_sleep(ms)' puts the mcu into the deepest sleep state that still
+ *	wakes within ms milliseconds, then adds the time slept to the std::chrono
+ *	clock offsets (see <system/clock.h>), so timers keep counting while the
+ *	api clock is stopped. It returns the time slept, which is zero if no
+ *	supported sleep period is short enough or the board is not supported.
+ *
+ *	`idle(s0, s1, ..., sN)' finds the earliest pending deadline of any objects
+ *	with a `remaining()' method, such as TaskScheduler, DeadlineScheduler and
+ *	EventSequencer, and sleeps until then, for at most IdleMaxMs. Typical use
+ *	is to call idle() at the end of loop():
+ *
+ *		void loop()
+ *		{
+ *			scheduler.tick();
+ *			sequencer.clock();
+ *			pg::idle(scheduler, sequencer);
+ *		}
+ *
+ *	On AVR boards, the mcu is powered down and woken by the watchdog timer,
+ *	whose periods range from 15 ms to 8 s. The clocks are advanced by the
+ *	nominal watchdog period, so wakes caused by other interrupts are counted
+ *	as full periods. On SAMD21 boards, the mcu enters standby and is woken by
+ *	the RTC, clocked at 1024 Hz from the ultra low-power oscillator, and the
+ *	clocks are advanced by the measured RTC count. The SAMD21 USB connection
+ *	does not survive standby.
+ *
+ *	On SAMD21 boards, the RTC compare is set at least RtcMinTicks ahead, and
+ *	the mcu does not sleep if the count has passed it by the time the compare
+ *	register is synchronized, since the RTC interrupt would then not fire
+ *	until the counter wraps.
+ *
+ *	This file claims the watchdog (ISR(WDT_vect)) or RTC (RTC_Handler)
+ *	interrupt handler and defines it, so it can be included in only one
+ *	translation unit. The handlers can be compiled out by defining
+ *	__PG_NO_SLEEP_ISR, if the application defines its own or includes this
+ *	file in other translation units.
+ *
+ *	**************************************************************************/
+
+#if !defined __PG_SLEEP_H
+# define __PG_SLEEP_H 20261014L
+
+# include <chrono>			// std::chrono types.
+# include <ctime>			// std::time_t type.
+# include <system/clock.h>	// Clock offsets.
+# if defined __AVR__
+#  include <avr/interrupt.h>
+#  include <avr/sleep.h>
+#  include <avr/wdt.h>
+#  if defined WDTCSR
+#   define __PG_HAS_WDT_SLEEP
+#  endif
+# elif defined ARDUINO_ARCH_SAMD && defined RTC_MODE0_CTRL_MODE_COUNT32 && defined GCLK_GENCTRL_SRC_OSCULP32K
+#  define __PG_HAS_RTC_SLEEP
+# endif
+
+# if defined __PG_HAS_NAMESPACES
+
+namespace pg
+{
+	constexpr std::time_t IdleMaxMs = 8000;	// Longest time idle() sleeps.
+
+	namespace details
+	{
+		// Advances the std::chrono clocks by the time slept.
+		inline void sleep_compensate(std::time_t ms)
+		{
+			using steady_ms = std::ratio_divide<std::milli, steady_clock_t::period>;	// Steady clock ticks per ms.
+
+			system_clock_t::offset() += ms;
+			steady_clock_t::offset() += static_cast<steady_clock_t::rep>(ms) * steady_ms::num / steady_ms::den;
+		}
+
+# if defined __PG_HAS_WDT_SLEEP
+		// Powers down for a watchdog period, 0 = 15 ms ... 9 = 8 s.
+		inline void wdt_sleep(uint8_t period)
+		{
+			cli();
+			MCUSR &= ~(1 << WDRF);
+			WDTCSR = (1 << WDCE) | (1 << WDE);
+			WDTCSR = (1 << WDIE) | ((period & 0x08) ? (1 << WDP3) : 0) | (period & 0x07);
+			wdt_reset();
+			set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+			sleep_enable();
+			sei();
+			sleep_cpu();
+			sleep_disable();
+			wdt_disable();
+		}
+# elif defined __PG_HAS_RTC_SLEEP
+		constexpr std::time_t RtcHz = 1024;	// RTC count frequency.
+		constexpr uint8_t RtcGclk = 4;		// Generic clock generator used by the RTC.
+		constexpr uint32_t RtcMinTicks = 4;	// Shortest RTC sleep, covers the compare write latency.
+
+		inline void rtc_sync()
+		{
+			while (RTC->MODE0.STATUS.bit.SYNCBUSY);
+		}
+
+		inline uint32_t rtc_count()
+		{
+			RTC->MODE0.READREQ.reg = RTC_READREQ_RREQ;
+			rtc_sync();
+
+			return RTC->MODE0.COUNT.reg;
+		}
+
+		// Starts the RTC as a free-running 1024 Hz counter, once.
+		inline void rtc_begin()
+		{
+			static bool running = false;
+
+			if (!running)
+			{
+				GCLK->GENDIV.reg = GCLK_GENDIV_ID(RtcGclk) | GCLK_GENDIV_DIV(4);	// 32768 / 2^(4 + 1) = 1024 Hz.
+				while (GCLK->STATUS.bit.SYNCBUSY);
+				GCLK->GENCTRL.reg = GCLK_GENCTRL_ID(RtcGclk) | GCLK_GENCTRL_SRC_OSCULP32K |
+					GCLK_GENCTRL_GENEN | GCLK_GENCTRL_DIVSEL | GCLK_GENCTRL_RUNSTDBY;
+				while (GCLK->STATUS.bit.SYNCBUSY);
+				GCLK->CLKCTRL.reg = GCLK_CLKCTRL_ID_RTC | GCLK_CLKCTRL_GEN(RtcGclk) | GCLK_CLKCTRL_CLKEN;
+				while (GCLK->STATUS.bit.SYNCBUSY);
+				PM->APBAMASK.reg |= PM_APBAMASK_RTC;
+				RTC->MODE0.CTRL.reg &= ~RTC_MODE0_CTRL_ENABLE;
+				rtc_sync();
+				RTC->MODE0.CTRL.reg = RTC_MODE0_CTRL_MODE_COUNT32 | RTC_MODE0_CTRL_PRESCALER_DIV1;
+				rtc_sync();
+				RTC->MODE0.INTENSET.reg = RTC_MODE0_INTENSET_CMP0;
+				NVIC_EnableIRQ(RTC_IRQn);
+				RTC->MODE0.CTRL.reg |= RTC_MODE0_CTRL_ENABLE;
+				rtc_sync();
+				running = true;
+			}
+		}
+# endif
+
+		inline std::time_t min_remaining()
+		{
+			return IdleMaxMs;
+		}
+
+		// Returns the earliest remaining time of a list of objects, in milliseconds.
+		template<class T, class... Ts>
+		std::time_t min_remaining(const T& object, const Ts&... objects)
+		{
+			using duration = decltype(object.remaining());
+			const duration remaining = object.remaining();
+			const std::time_t rest = min_remaining(objects...);
+			const std::time_t ms = remaining == duration::max()
+				? rest
+				: static_cast<std::time_t>(std::chrono::duration_cast<std::chrono::milliseconds>(remaining).count());
+
+			return ms < rest ? ms : rest;
+		}
+	} // namespace details
+
+	// Sleeps for at most ms milliseconds, compensates the clocks and returns the time slept.
+	inline std::time_t deep_sleep(std::time_t ms)
+	{
+		std::time_t slept = 0;
+
+# if defined __PG_HAS_WDT_SLEEP
+		static const uint16_t periods[] = { 15, 30, 60, 120, 250, 500, 1000, 2000, 4000, 8000 };
+
+		for (uint8_t i = sizeof(periods) / sizeof(periods[0]); i-- > 0;)
+		{
+			while (ms - slept >= static_cast<std::time_t>(periods[i]))
+			{
+				details::wdt_sleep(i);
+				slept += periods[i];
+			}
+		}
+# elif defined __PG_HAS_RTC_SLEEP
+		const uint32_t ticks = ms > 0 ? static_cast<uint32_t>(static_cast<uint64_t>(ms) * details::RtcHz / 1000) : 0;
+
+		if (ticks >= details::RtcMinTicks)
+		{
+			uint32_t begin;
+
+			details::rtc_begin();
+			begin = details::rtc_count();
+			RTC->MODE0.COMP[0].reg = begin + ticks;
+			details::rtc_sync();
+			RTC->MODE0.INTFLAG.reg = RTC_MODE0_INTFLAG_CMP0;
+			if (details::rtc_count() - begin + details::RtcMinTicks <= ticks)	// Don't sleep past a missed compare.
+			{
+				SysTick->CTRL &= ~SysTick_CTRL_TICKINT_Msk;	// A pending SysTick would wake the mcu at once.
+				SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
+				__DSB();
+				__WFI();
+				SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+				SysTick->CTRL |= SysTick_CTRL_TICKINT_Msk;
+			}
+			slept = static_cast<std::time_t>(static_cast<uint64_t>(details::rtc_count() - begin) * 1000 / details::RtcHz);
+		}
+# else
+		(void)ms;
+# endif
+		details::sleep_compensate(slept);
+
+		return slept;
+	}
+
+	// Sleeps until the earliest pending deadline of a list of objects and returns the time slept.
+	template<class... Ts>
+	std::time_t idle(const Ts&... objects)
+	{
+		return deep_sleep(details::min_remaining(objects...));
+	}
+} // namespace pg
+
+#  if !defined __PG_NO_SLEEP_ISR
+#   if defined __PG_HAS_WDT_SLEEP
+ISR(WDT_vect) {}
+#   elif defined __PG_HAS_RTC_SLEEP
+extern "C" void RTC_Handler(void)
+{
+	RTC->MODE0.INTFLAG.reg = RTC_MODE0_INTFLAG_CMP0;
+}
+#   endif
+#  endif // !defined __PG_NO_SLEEP_ISR
+
+# else // !defined __PG_HAS_NAMESPACES
+#  error Requires C++11 and named namespace support.
+# endif // defined __PG_HAS_NAMESPACES
+
+#endif // !defined __PG_SLEEP_H
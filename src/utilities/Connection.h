@@ -33,10 +33,38 @@
  *	Fixed bugs in WiFiConnection & EthernetConnection: removed 
  *	udp_.endPacket() in receive() methods, which only apply to sending.
  * 
- *	TODO:
- * 
- *	Make async/concurrent version `AsyncConnection' with buffered i/o, clock()
- *	method.
+ *	Added `AsyncConnection' which decorates any other connection type with 
+ *	ring-buffered, non-blocking i/o drained incrementally from clock().
+ *
+ *	Added client sessions: network connections track up to SessionsMax
+ *	remote clients by address and port, each with its own acknowledge and 
+ *	checksum flags. receive() selects the session of each message or frame 
+ *	it returns, so replies go back to the client that sent it, even when 
+ *	several clients' datagrams are received in the same clock() pass. New 
+ *	clients replace the least recently heard from session. Define 
+ *	__PG_CONNECTION_SESSIONS to change the number of sessions, it is 1 if 
+ *	both network connection types are disabled.
+ *
+ *	Added per-transport receive buffer sizes: define __PG_SERIAL_BUFFER_SIZE, 
+ *	__PG_ETHERNET_BUFFER_SIZE or __PG_WIFI_BUFFER_SIZE to change them. 
+ *	Network buffers default to one whole unfragmented datagram on boards with 
+ *	more than 4K of RAM, and one datagram may carry several newline-separated 
+ *	messages, all returned by receive(). Message size is still limited to 
+ *	size(), the smallest serial hardware buffer.
+ *
+ *	Made network connection bring-up non-blocking: open(params) only starts 
+ *	it and returns at once, then clock() advances it, so the device keeps 
+ *	running while the link comes up. status() reports it, and an optional 
+ *	callback set with statusCallback() is called whenever it changes. WiFi 
+ *	attempts are retried every WaitConnect ms, and open connections check 
+ *	their link and lease every MaintainInterval ms from maintainConnection(), 
+ *	going back to Connecting if the link is lost. The Arduino Ethernet 
+ *	library has no non-blocking DHCP api, so each DHCP request still blocks 
+ *	for up to __PG_ETHERNET_DHCP_TIMEOUT ms (default 1000). Ethernet 
+ *	attempts are retried after WaitConnect ms, doubling up to WaitConnectMax 
+ *	(32 s), so a device without a DHCP server is blocked about 3% of the 
+ *	time once it has backed off. maintainConnection() only blocks, for as 
+ *	long, when the lease is due for renewal.
  *
  *	**************************************************************************/
 
@@ -45,16 +73,49 @@
 
 # include <cstdio>
 # include <cstdlib>
+# include <cstring>
+# include <limits>
+# include <lib/callback.h>
+# include <lib/crc.h>
+# include <lib/format.h>
 # include <lib/strtok.h>
 # include <system/boards.h>
 # include <interfaces/iclockable.h>
 # include <utilities/ValueWrappers.h>
+# include <utilities/Profiler.h>
 # if !defined __PG_NO_ETHERNET_CONNECTION
 #  include <system/ethernet.h>
 # endif
 # if !defined __PG_NO_WIFI_CONNECTION
 #  include <system/wifi.h>
 # endif
+# if !defined __PG_CONNECTION_SESSIONS
+#  if defined __PG_NO_ETHERNET_CONNECTION && defined __PG_NO_WIFI_CONNECTION
+#   define __PG_CONNECTION_SESSIONS 1
+#  else
+#   define __PG_CONNECTION_SESSIONS 4
+#  endif
+# endif
+# if !defined __PG_SERIAL_BUFFER_SIZE
+#  define __PG_SERIAL_BUFFER_SIZE (SERIAL_RX_BUFFER_SIZE < SERIAL_TX_BUFFER_SIZE ? SERIAL_RX_BUFFER_SIZE : SERIAL_TX_BUFFER_SIZE)
+# endif
+# if !defined __PG_ETHERNET_BUFFER_SIZE
+#  if RAMSIZE > 4096
+#   define __PG_ETHERNET_BUFFER_SIZE 508
+#  else
+#   define __PG_ETHERNET_BUFFER_SIZE 128
+#  endif
+# endif
+# if !defined __PG_WIFI_BUFFER_SIZE
+#  if RAMSIZE > 4096
+#   define __PG_WIFI_BUFFER_SIZE 508
+#  else
+#   define __PG_WIFI_BUFFER_SIZE 128
+#  endif
+# endif
+# if !defined __PG_ETHERNET_DHCP_TIMEOUT
+#  define __PG_ETHERNET_DHCP_TIMEOUT 1000
+# endif
 
 namespace pg
 {
@@ -77,15 +138,53 @@ namespace pg
 			 WiFi = 2,
 			 Invalid = 3
 		};
-		using size_type = uint8_t;
+		enum class Protocol : uint8_t
+		{
+			Text = 0,	// Newline-terminated text messages.
+			Binary = 1	// CRC-checked binary frames.
+		};
+		enum class Status : uint8_t
+		{
+			Closed = 0,		// Not open.
+			Connecting = 1,	// Bringing up the link, advanced by clock().
+			Open = 2,		// Open and usable.
+			Failed = 3		// No network hardware.
+		};
+		using size_type = uint16_t;
+		using status_callback_type = typename callback<void, void, Connection*>::type;
+
+		// Binary message frame: | FrameStartByte | opcode | size | args[size] | crc |
+		struct Frame
+		{
+			uint8_t			opcode;	// Frame operation code.
+			size_type		size;	// Size of the packed args in bytes.
+			const uint8_t*	args;	// Pointer to the packed little-endian args.
+		};
+
+		// Remote client state, point-to-point connections only have one.
+		struct Session
+		{
+			uint32_t	address;	// Client IPv4 address, 0 if none.
+			uint16_t	port;		// Client port, 0 to use the connection's own port.
+			uint16_t	used;		// Time of last use, for replacing the least recently used session.
+			bool		ack;		// Command acknowledge flag.
+			bool		checksum;	// Flag indicating whether the client's last message included a checksum.
+		};
 
 		static constexpr const char* ParamsDelimiterChar = ",";
-		static constexpr size_type size() 
+		static constexpr uint8_t FrameStartByte = 0x7e;
+		static constexpr size_type size() // Largest message size, common to all transports.
 		{ 
 			return SERIAL_RX_BUFFER_SIZE < SERIAL_TX_BUFFER_SIZE 
 				? SERIAL_RX_BUFFER_SIZE 
 				: SERIAL_TX_BUFFER_SIZE; 
 		}
+		static constexpr size_type FrameOverhead = 4;	// Start byte, opcode, size and crc.
+		static constexpr size_type frameArgsMax() // Largest frame args size, whole frames fit the receive buffers' reserved byte.
+		{ 
+			return size() - FrameOverhead - 1 < UINT8_MAX ? size() - FrameOverhead - 1 : UINT8_MAX; 
+		}
+		static constexpr size_type SessionsMax = __PG_CONNECTION_SESSIONS;	// Maximum number of concurrent clients.
 
 	public:
 		virtual ~Connection() = default;
@@ -96,32 +195,252 @@ namespace pg
 		virtual void close() = 0;
 		virtual void flush() = 0;
 		virtual size_type send(const char*) = 0;
+		virtual size_type write(const uint8_t*, size_type) = 0;
+		virtual size_type read(uint8_t*, size_type) = 0;			// Reads any raw bytes already received, without blocking.
+		virtual size_type writable() { return size(); }				// Returns the number of bytes writable without blocking.
+		virtual void coalesce(bool) {}								// Starts/stops packing sent messages into as few datagrams as possible.
 		virtual const char* params(char*) = 0;
 		virtual Maintain maintainConnection() = 0;
+		virtual Session& session() { return sessions_[session_]; }				// Returns the current session.
+		virtual size_type sessionIndex() const { return session_; }				// Returns the index of the current session.
+		virtual void session(size_type i) { if (i < SessionsMax) session_ = i; }	// Selects the session replies are sent to.
+		virtual Status status() const { return status_; }								// Returns the connection status.
+		virtual void statusCallback(status_callback_type cb) { status_callback_ = cb; }	// Sets the status change callback.
 		Type type() const { return type_; }
+		Protocol protocol() const { return protocol_; }
+		void protocol(Protocol p) 
+		{ 
+			// Drop anything left in the receive buffer, including messages queued behind 
+			// the one that switched protocols, it belongs to the old protocol.
+			if (p == Protocol::Binary)
+				end_ = next_;
+			else
+				next_ = end_;
+			*next_ = '\0';
+			marks_size_ = 0;
+			protocol_ = p; 
+		}
 		const char* receive()
 		{
+			PG_PROFILE_SCOPE("Connection::receive");
 			char* msg = next_;
 
 			if (*msg)
+			{
+				selectSession(msg);
 				next_ += (strlen(next_) + 1);
+			}
 
 			return msg;
 		}
+		bool receive(Frame&);
+		size_type send(uint8_t, const uint8_t*, size_type);
 
 	protected:
-		explicit Connection(Type type) : type_(type) {}
+		explicit Connection(Type type) : 
+			next_(), end_(), sessions_(), session_(), uses_(), marks_(), marks_size_(), type_(type), protocol_(), 
+			status_(), status_callback_() {}
 
 	protected:
-		size_type remaining(char* ptr, char* buf) { return size() - (ptr - buf); }
+		template<std::size_t N>
+		static size_type remaining(const char* ptr, const char (&buf)[N]) { return N - (ptr - buf); }
+		static char* split(char*, char*);
+		template<std::size_t N>
+		char* unread(char (&buf)[N]) { return unread(buf, N); }
+		char* unread(char*, size_type);
+		size_type findSession(uint32_t, uint16_t);
+		void mark(char*, size_type);
+		void clearMarks() { marks_size_ = 0; }
+		bool marksFull() const { return marks_size_ == SessionsMax; }
+		void selectSession(const char*);
+		const Session& currentSession() const { return sessions_[session_]; }
+		void setStatus(Status);
+		static uint8_t frameCheck(const uint8_t* first, const uint8_t* last) 
+		{ 
+			return pg::crc(const_cast<uint8_t*>(first), const_cast<uint8_t*>(last), crc_8()); 
+		}
 
 	protected:
-		char* next_;
+		char* next_;	// Pointer to the next unread message.
+		char* end_;		// Pointer to one past the last received byte in binary mode.
 
 	private:
+		// Marks the end of the received bytes of one session.
+		struct Mark
+		{
+			char*		end;		// Pointer to one past the session's last received byte.
+			size_type	session;	// Index of the session.
+		};
+
+		Session		sessions_[SessionsMax];	// Client sessions.
+		size_type	session_;				// Index of the current session.
+		uint16_t	uses_;					// Session use counter.
+		Mark		marks_[SessionsMax];	// Sessions of the received bytes, in order.
+		size_type	marks_size_;			// Number of marks.
 		Type type_;
+		Protocol protocol_;
+		Status status_;							// Connection status.
+		status_callback_type status_callback_;	// Called when status_ changes.
 	};
 
+	// Sets the connection status, calling the status callback if it changed.
+	void Connection::setStatus(Status status)
+	{
+		if (status != status_)
+		{
+			status_ = status;
+			if (status_callback_)
+				(*status_callback_)(this);
+		}
+	}
+
+	// Extracts the next valid frame from the receive buffer, returns false if none.
+	bool Connection::receive(Frame& frame)
+	{
+		PG_PROFILE_SCOPE("Connection::receive");
+		bool result = false;
+
+		while (!result && next_ < end_)
+		{
+			const uint8_t* ptr = reinterpret_cast<const uint8_t*>(next_);
+			std::ptrdiff_t avail = end_ - next_;
+
+			if (*ptr != FrameStartByte)
+				++next_;				// Resync on the next start byte.
+			else if (avail < FrameOverhead)
+				break;					// Incomplete header, rest is yet to arrive.
+			else if (ptr[2] > frameArgsMax())
+				++next_;				// Noise or oversized frame, drop the start byte and resync.
+			else if (avail < FrameOverhead + ptr[2])
+				break;					// Incomplete frame, rest is yet to arrive.
+			else if (frameCheck(ptr + 1, ptr + 3 + ptr[2]) != ptr[3 + ptr[2]])
+				++next_;				// Bad check value, drop the start byte and resync.
+			else
+			{
+				selectSession(next_);
+				frame.opcode = ptr[1];
+				frame.size = ptr[2];
+				frame.args = ptr + 3;
+				next_ += FrameOverhead + frame.size;
+				result = true;
+			}
+		}
+
+		return result;
+	}
+
+	// Sends a binary frame with the given opcode and packed args.
+	Connection::size_type Connection::send(uint8_t opcode, const uint8_t* args, size_type n)
+	{
+		uint8_t frame[size()] = { FrameStartByte, opcode };
+
+		if (n > frameArgsMax())
+			n = frameArgsMax();
+		frame[2] = n;
+		std::memcpy(frame + 3, args, n);
+		frame[3 + n] = frameCheck(frame + 1, frame + 3 + n);
+
+		return write(frame, FrameOverhead + n);
+	}
+
+	// Splits the newline-separated text in [first, last) into null-terminated messages, dropping empty 
+	// lines, and returns a pointer to one past the last terminator, which may be written to *last.
+	char* Connection::split(char* first, char* last)
+	{
+		char* const begin = first;
+		char* p = first;
+
+		for (; first != last; ++first)
+		{
+			if (*first != '\n' && *first != '\r')
+				*p++ = *first;
+			else if (p != begin && p[-1] != '\0')
+				*p++ = '\0';
+		}
+		if (p != begin && p[-1] != '\0')
+			*p++ = '\0';
+
+		return p;
+	}
+
+	// Moves any unread bytes to the beginning of buf, of length len, and returns a pointer to one past the last one.
+	char* Connection::unread(char* buf, size_type len)
+	{
+		std::size_t n = next_ && end_ > next_ ? end_ - next_ : 0;
+		std::ptrdiff_t shift;
+		size_type m = 0;
+
+		if (protocol_ == Protocol::Binary && n && n >= len - 1u)
+		{
+			// A partial frame filling the buffer can never complete, resync on the next start byte.
+			char* first = next_ + 1;
+
+			while (first != end_ && static_cast<uint8_t>(*first) != FrameStartByte)
+				++first;
+			n -= first - next_;
+			next_ = first;
+		}
+		shift = n ? next_ - buf : 0;
+		if (n && next_ != buf)
+			std::memmove(buf, next_, n);
+		for (size_type i = 0; i < marks_size_; ++i)	// Keep the marks of the unread bytes.
+			if (n && marks_[i].end - shift > buf)
+			{
+				marks_[m] = marks_[i];
+				marks_[m++].end -= shift;
+			}
+		marks_size_ = m;
+		next_ = buf;
+
+		return end_ = buf + n;
+	}
+
+	// Returns the index of a client's session, replacing the least recently used session if it has none.
+	Connection::size_type Connection::findSession(uint32_t address, uint16_t port)
+	{
+		size_type i = 0, lru = 0;
+		uint16_t lru_age = 0;
+
+		for (; i < SessionsMax; ++i)
+		{
+			const Session& s = sessions_[i];
+			const uint16_t age = s.address ? static_cast<uint16_t>(uses_ - s.used) : UINT16_MAX;
+
+			if (s.address == address && s.port == port)
+				break;
+			if (age > lru_age)
+			{
+				lru = i;
+				lru_age = age;
+			}
+		}
+		if (i == SessionsMax)
+			sessions_[i = lru] = Session{ address, port, 0, false, false };
+		sessions_[i].used = ++uses_;
+
+		return i;
+	}
+
+	// Marks the received bytes up to end as belonging to a session.
+	void Connection::mark(char* end, size_type session)
+	{
+		if (marks_size_ && (marks_[marks_size_ - 1].session == session || marksFull()))
+			marks_[marks_size_ - 1].end = end;	// Extends the last mark.
+		else
+			marks_[marks_size_++] = Mark{ end, session };
+	}
+
+	// Selects the session of the received byte at ptr, if it is marked.
+	void Connection::selectSession(const char* ptr)
+	{
+		for (size_type i = 0; i < marks_size_; ++i)
+			if (ptr < marks_[i].end)
+			{
+				session(marks_[i].session);
+				break;
+			}
+	}
+
 	// Creates a serial network connection.
 	class SerialConnection : public Connection
 	{
@@ -136,6 +455,7 @@ namespace pg
 		static constexpr frame_map_type DefaultFrame = frame_map_type{ SERIAL_8N1, "8N1" };
 		static constexpr timeout_type DefaultTimeout = 0;
 		static constexpr const char EndOfMessageChar = '\n';
+		static constexpr size_type BufferSize = __PG_SERIAL_BUFFER_SIZE;	// Receive buffer size.
 
 	public:
 		SerialConnection(HardwareSerial&, const char* = nullptr);
@@ -147,6 +467,9 @@ namespace pg
 		void close() override;
 		void flush() override;
 		size_type send(const char*) override;
+		size_type write(const uint8_t*, size_type) override;
+		size_type read(uint8_t*, size_type) override;
+		size_type writable() override;
 		const char* params(char*) override;
 		HardwareSerial& hardware();
 		baud_type baud() const;
@@ -164,7 +487,7 @@ namespace pg
 		frame_map_type		frame_;			// The current frame.
 		timeout_type		timeout_;		// The current write timeout in milliseconds.
 		bool				is_open_;		// Flag indicating whether the connection is currently open.
-		char				buf_[size()];	// Receive buffer. 
+		char				buf_[BufferSize];	// Receive buffer. 
 	};
 
 	namespace detail
@@ -177,13 +500,36 @@ namespace pg
 	}
 
 	const std::ArrayWrapper<SerialConnection::frame_map_type> SerialConnection::SupportedFrames(detail::supported_frames);
+# if defined __PG_ETHERNET_H || defined __PG_WIFI_H
+	namespace detail
+	{
+		// Packs an IPv4 address into a session address.
+		inline uint32_t ip_value(const IPAddress& ip)
+		{
+			return static_cast<uint32_t>(ip[0]) | static_cast<uint32_t>(ip[1]) << 8 | 
+				static_cast<uint32_t>(ip[2]) << 16 | static_cast<uint32_t>(ip[3]) << 24;
+		}
+
+		// Unpacks a session address.
+		inline IPAddress ip_address(uint32_t value)
+		{
+			return IPAddress(value & 0xff, (value >> 8) & 0xff, (value >> 16) & 0xff, value >> 24);
+		}
+	}
+# endif
 # if defined __PG_ETHERNET_H
 	class EthernetConnection : public Connection
 	{
 	public:
-		static constexpr uint32_t WaitConnect = 2000;
-		static constexpr uint32_t MaxWaitTime = 10000;
+		static constexpr uint32_t WaitConnect = 2000;		// Time between the first and second connect attempts, in ms.
+		static constexpr uint32_t WaitConnectMax = 32000;	// Longest time between connect attempts, in ms.
+		static constexpr uint32_t MaintainInterval = 1000;	// Time between link and lease checks, in ms.
+		static constexpr uint32_t DhcpTimeout = __PG_ETHERNET_DHCP_TIMEOUT;	// Longest DHCP attempt, in ms.
+		static constexpr uint32_t DhcpResponseTimeout = DhcpTimeout / 2;		// Longest wait for a DHCP reply, in ms.
 		static constexpr const char* MacDelimiterChar = " ";
+		static constexpr uint16_t DatagramSizeMax = 508;	// Largest coalesced datagram, never fragmented on IPv4.
+		static constexpr char EndOfMessageChar = '\n';
+		static constexpr size_type BufferSize = __PG_ETHERNET_BUFFER_SIZE;	// Receive buffer size, up to one datagram.
 
 	public:
 		EthernetConnection(const char* = nullptr);
@@ -196,6 +542,9 @@ namespace pg
 		void close() override;
 		void flush() override;
 		size_type send(const char*) override;
+		size_type write(const uint8_t*, size_type) override;
+		size_type read(uint8_t*, size_type) override;
+		void coalesce(bool) override;
 		const char* params(char*) override;
 		EthernetClass& hardware();
 		const mac_type& mac() const;
@@ -207,16 +556,24 @@ namespace pg
 		Maintain maintainConnection() override;
 
 	private:
+		size_type append(const uint8_t*, size_type, bool);
+		bool beginPacket();
+		void receiveFrom();
 		void parseParams(const char* params);
+		void connect();
 
 	private:
-		char			buf_[size()];	// Receive buffer.
+		char			buf_[BufferSize];	// Receive buffer.
 		EthernetUDP		udp_;			// Arduino UDP api.
-		bool			is_open_;		// Flag indicating whether the connection is open.
+		uint16_t		pending_;		// Bytes in the current coalesced datagram.
+		size_type		pending_session_;	// Session of the current coalesced datagram.
+		bool			coalesce_;		// Flag indicating whether sent messages are coalesced.
+		bool			dhcp_;			// Flag indicating whether the local IP address is leased.
+		uint32_t		time_;			// Time of the last connect attempt or maintenance, in ms.
+		uint32_t		wait_;			// Time from the last connect attempt to the next, in ms, 0 to try at once.
 		IPAddress		local_ip_;		// The current local IP address.
 		mac_type		mac_;			// The MAC address.
 		unsigned int	port_;			// The current UDP port.
-		IPAddress		remote_ip_;		// The current remote address.
 	};
 # endif
 # if defined __PG_WIFI_H
@@ -224,8 +581,11 @@ namespace pg
 	class WiFiConnection : public Connection
 	{
 	public:
-		static constexpr uint32_t WaitConnect = 2000; 
-		static constexpr uint32_t MaxWaitTime = 10000;
+		static constexpr uint32_t WaitConnect = 2000;		// Time between connect attempts, in ms.
+		static constexpr uint32_t MaintainInterval = 1000;	// Time between link checks, in ms.
+		static constexpr uint16_t DatagramSizeMax = 508;	// Largest coalesced datagram, never fragmented on IPv4.
+		static constexpr char EndOfMessageChar = '\n';
+		static constexpr size_type BufferSize = __PG_WIFI_BUFFER_SIZE;	// Receive buffer size, up to one datagram.
 
 	public:
 		WiFiConnection(const char* = nullptr);
@@ -238,6 +598,9 @@ namespace pg
 		void close() override;
 		void flush() override;
 		size_type send(const char*) override;
+		size_type write(const uint8_t*, size_type) override;
+		size_type read(uint8_t*, size_type) override;
+		void coalesce(bool) override;
 		const char* params(char*) override;
 		WiFiClass& hardware();
 		const char* ssid() const;
@@ -249,16 +612,23 @@ namespace pg
 		Maintain maintainConnection() override;
 
 	private:
+		size_type append(const uint8_t*, size_type, bool);
+		bool beginPacket();
+		void receiveFrom();
 		void parseParams(const char* params);
+		void connect();
 
 	private:
 		char*			ssid_;			// Network ssid.
 		char*			pw_;			// Network passphrase.
 		unsigned int	port_;			// The current UDP port.
 		int				status_;		// Network connection status.
+		uint32_t		time_;			// Time of the last connect attempt or link check, in ms.
 		WiFiUDP			udp_;			// Arduino UDP api.
-		IPAddress		remote_ip_;		// The current remote address.
-		char			buf_[size()];	// Receive buffer.
+		uint16_t		pending_;		// Bytes in the current coalesced datagram.
+		bool			coalesce_;		// Flag indicating whether sent messages are coalesced.
+		size_type		pending_session_;	// Session of the current coalesced datagram.
+		char			buf_[BufferSize];	// Receive buffer.
 
 	};
 # endif
@@ -268,6 +638,7 @@ namespace pg
 		Connection(Type::Serial), hardware_(hs), baud_(), frame_(DefaultFrame),
 		timeout_(DefaultTimeout), is_open_(), buf_() 
 	{
+		next_ = end_ = buf_;
 		if (params)
 			open(params);
 	}
@@ -285,6 +656,7 @@ namespace pg
 			hardware_.setTimeout(timeout_);
 		while (!hardware_);
 		is_open_ = true;
+		setStatus(Status::Open);
 	}
 
 	bool SerialConnection::open()
@@ -296,6 +668,7 @@ namespace pg
 	{
 		hardware_.end();
 		is_open_ = false;
+		setStatus(Status::Closed);
 	}
 
 	void SerialConnection::flush()
@@ -310,9 +683,26 @@ namespace pg
 		return hardware_.println(message);
 	}
 
+	Connection::size_type SerialConnection::write(const uint8_t* buf, size_type n)
+	{
+		return hardware_.write(buf, n);
+	}
+
+	Connection::size_type SerialConnection::read(uint8_t* buf, size_type n)
+	{
+		size_type avail = hardware_.available();	// readBytes() only blocks if asked for more.
+
+		return hardware_.readBytes(reinterpret_cast<char*>(buf), n < avail ? n : avail);
+	}
+
+	Connection::size_type SerialConnection::writable()
+	{
+		return hardware_.availableForWrite();
+	}
+
 	const char* SerialConnection::params(char* buf)
 	{
-		(void)std::sprintf(buf, "%lu,%3s,%lu", baud_, frame_.string(), timeout_);
+		(void)pg::format(buf, "%lu,%3s,%lu", baud_, frame_.string(), timeout_);
 
 		return buf;
 	}
@@ -324,7 +714,7 @@ namespace pg
 
 		if ((tok = pg::strtok(buf, params, ParamsDelimiterChar, size()))) // Parse a copy of params.
 		{
-			baud_ = std::atol(tok);
+			(void)std::from_chars(tok, tok + std::strlen(tok), baud_);
 			if ((tok = std::strtok(nullptr, ParamsDelimiterChar)))
 			{
 				auto it = std::find(static_cast<frames_type>(SupportedFrames).begin(), 
@@ -333,7 +723,7 @@ namespace pg
 				if (it)
 					frame_ = *it;
 				if((tok = std::strtok(nullptr, ParamsDelimiterChar)))
-					timeout_ = std::atol(tok);
+					(void)std::from_chars(tok, tok + std::strlen(tok), timeout_);
 			}
 		}
 	}
@@ -362,13 +752,24 @@ namespace pg
 	{
 		char* p = buf_;
 
-		if (Serial.available())
+		if (protocol() == Protocol::Binary)
+		{
+			// Binary frames may straddle reads, so keep any partial frame and append to it. 
+			// One byte is reserved for the terminator written by protocol().
+			size_type n = hardware_.available();
+
+			p = unread(buf_);
+			if (n > remaining(p, buf_) - 1)
+				n = remaining(p, buf_) - 1;
+			end_ = p + hardware_.readBytes(p, n);
+		}
+		else if (Serial.available())
 		{
 			do
 			{
-				p += Serial.readBytesUntil('\n', p, remaining(p, buf_));
+				p += Serial.readBytesUntil('\n', p, remaining(p, buf_) - 2);
 				*p++ = '\0';
-			} while (Serial.available());
+			} while (Serial.available() && remaining(p, buf_) > 2);
 			*p = '\0';
 			next_ = buf_;
 		}
@@ -382,8 +783,9 @@ namespace pg
 #pragma region EthernetConnection
 # if defined __PG_ETHERNET_H
 	EthernetConnection::EthernetConnection(const char* params) : 
-		Connection(Type::Ethernet), buf_(), is_open_(), local_ip_(), mac_(), port_()
+		Connection(Type::Ethernet), buf_(), dhcp_(), time_(), wait_(), local_ip_(), mac_(), port_(), pending_(), pending_session_(), coalesce_()
 	{
+		next_ = end_ = buf_;
 		if (params)
 			open(params);
 	}
@@ -395,30 +797,32 @@ namespace pg
 
 	void EthernetConnection::open(const char* params) 
 	{
+		// Only starts the bring-up, clock() finishes it.
 		parseParams(params);
 #  if !defined __PG_NO_ETHERNET_DHCP 
-		if (local_ip_ == IPAddress())
-			Ethernet.begin(mac_.data());
-		else
+		dhcp_ = local_ip_ == IPAddress();
 #  endif
-		Ethernet.begin(mac_.data(), local_ip_);
+		Ethernet.begin(mac_.data(), local_ip_);	// Initializes the hardware, leases are requested by connect().
 		// hardwareStatus() valid only after begin() called.
-		if (!(Ethernet.hardwareStatus() == EthernetNoHardware) || Ethernet.linkStatus() == LinkOFF)
+		if (Ethernet.hardwareStatus() == EthernetNoHardware)
+			setStatus(Status::Failed);
+		else
 		{
-			local_ip_ = localIP();	// Save the actual ip assigned.
-			is_open_ = udp_.begin(port_);
+			wait_ = 0;	// Try at once.
+			time_ = millis();
+			setStatus(Status::Connecting);
 		}
 	}
 
 	bool EthernetConnection::open()
 	{
-		return is_open_;
+		return status() == Status::Open;
 	}
 
 	void EthernetConnection::close()
 	{
 		udp_.stop();
-		is_open_ = false;
+		setStatus(Status::Closed);
 	}
 
 	void EthernetConnection::flush()
@@ -430,9 +834,11 @@ namespace pg
 	{
 		size_type n = 0;
 
-		if (open())
+		if (coalesce_)
+			n = append(reinterpret_cast<const uint8_t*>(message), std::strlen(message), true);
+		else if (open())
 		{
-			if (udp_.beginPacket(remote_ip_, port_))
+			if (beginPacket())
 			{
 				n = udp_.write(message);
 				n = udp_.endPacket() ? n : 0;
@@ -442,13 +848,79 @@ namespace pg
 		return n;
 	}
 
+	Connection::size_type EthernetConnection::write(const uint8_t* buf, size_type n)
+	{
+		size_type result = 0;
+
+		if (coalesce_)
+			result = append(buf, n, false);
+		else if (open())
+		{
+			if (beginPacket())
+			{
+				result = udp_.write(buf, n);
+				result = udp_.endPacket() ? result : 0;
+			}
+		}
+
+		return result;
+	}
+
+	Connection::size_type EthernetConnection::read(uint8_t* buf, size_type n)
+	{
+		// Reads at most one datagram per call.
+		size_type result = 0;
+
+		if (open() && udp_.parsePacket())
+		{
+			result = udp_.read(buf, n);
+			receiveFrom();
+		}
+
+		return result;
+	}
+
+	void EthernetConnection::coalesce(bool value)
+	{
+		if (!value && pending_)
+		{
+			(void)udp_.endPacket();	// Send whatever has been coalesced so far.
+			pending_ = 0;
+		}
+		coalesce_ = value;
+	}
+
+	Connection::size_type EthernetConnection::append(const uint8_t* buf, size_type n, bool eol)
+	{
+		// Appends to the current datagram, text messages are newline-separated. 
+		// A new datagram is started whenever the next message won't fit.
+		uint16_t m = n + eol;
+		size_type result = 0;
+
+		if (pending_ && (pending_ + m > DatagramSizeMax || pending_session_ != sessionIndex()))
+		{
+			(void)udp_.endPacket();
+			pending_ = 0;
+		}
+		if (open() && (pending_ || beginPacket()))
+		{
+			pending_session_ = sessionIndex();
+			result = udp_.write(buf, n);
+			if (eol)
+				(void)udp_.write(static_cast<uint8_t>(EndOfMessageChar));
+			pending_ += m;
+		}
+
+		return result;
+	}
+
 	const char* EthernetConnection::params(char* buf)
 	{
 		if (buf)
 		{
 			IPAddress ip = localIP();
 
-			(void)std::sprintf(buf, "%d %d %d %d %d %d,%d.%d.%d.%d:%u", 
+			(void)pg::format(buf, "%d %d %d %d %d %d,%d.%d.%d.%d:%u", 
 				mac_[0], mac_[1], mac_[2], mac_[3], mac_[4], mac_[5], ip[0], ip[1], ip[2], ip[3], port_);
 		}
 
@@ -472,12 +944,23 @@ namespace pg
 
 	void EthernetConnection::remoteIP(IPAddress ip)
 	{
-		remote_ip_ = ip;
+		session().address = detail::ip_value(ip);
+		session().port = 0;
+	}
+
+	bool EthernetConnection::beginPacket()
+	{
+		return udp_.beginPacket(detail::ip_address(session().address), session().port ? session().port : port_);
+	}
+
+	void EthernetConnection::receiveFrom()
+	{
+		session(findSession(detail::ip_value(udp_.remoteIP()), udp_.remotePort()));
 	}
 
 	IPAddress EthernetConnection::remoteIP() const
 	{
-		return remote_ip_;
+		return detail::ip_address(currentSession().address);
 	}
 
 	IPAddress EthernetConnection::localIP() const
@@ -501,7 +984,7 @@ namespace pg
 
 				do
 				{
-					mac_[i++] = std::strtol(tok, nullptr, 16);
+					(void)std::from_chars(tok, tok + std::strlen(tok), mac_[i++], 16);
 				} while ((tok = std::strtok(nullptr, MacDelimiterChar)));
 			}
 		}
@@ -518,33 +1001,93 @@ namespace pg
 		else
 			tok = std::strtok(nullptr, ParamsDelimiterChar);
 		if (tok)
-			port_ = std::atoi(tok);
+			(void)std::from_chars(tok, tok + std::strlen(tok), port_);
 	}
 
 	void EthernetConnection::clock()
 	{
 		char* p = buf_;
 
-		if (udp_.parsePacket())
+		if (status() == Status::Connecting)
+			connect();
+		else if (open() && protocol() == Protocol::Binary)
 		{
+			// Each datagram holds one or more whole frames, reserve one byte for the terminator.
+			if (udp_.parsePacket())
+			{
+				p = unread(buf_);
+				do
+				{
+					p += udp_.read(p, remaining(p, buf_) - 1);
+					receiveFrom();
+					mark(p, sessionIndex());
+				} while (!marksFull() && udp_.parsePacket() && remaining(p, buf_) > 1);
+				end_ = p;
+			}
+		}
+		else if (open() && udp_.parsePacket())
+		{
+			// Each datagram holds one or more newline-separated messages. Two bytes are 
+			// reserved for the last message's terminator and the end of messages terminator.
+			clearMarks();
 			do
 			{
-				p += udp_.read(p, remaining(p, buf_));
-				*p++ = '\0';
-			} while (udp_.parsePacket());
+				size_type n = udp_.read(p, remaining(p, buf_) - 2);
+
+				if (udp_.available())	// Datagram truncated, drop its partial last message.
+					while (n && p[n - 1] != EndOfMessageChar)
+						--n;
+				p = split(p, p + n);
+				receiveFrom();
+				mark(p, sessionIndex());
+			} while (!marksFull() && udp_.parsePacket() && remaining(p, buf_) > 2);
 			*p = '\0';
 			next_ = buf_;
-			remote_ip_ = udp_.remoteIP();
 		}
 	}
 
 	Connection::Maintain EthernetConnection::maintainConnection()
 	{
-# if !defined __PG_NO_ETHERNET_DHCP
-		return static_cast<Maintain>(hardware().maintain());
-# else
-		return Connection::Maintain::NothingHappened;
-# endif
+		Maintain result = Connection::Maintain::NothingHappened;
+		const uint32_t now = millis();
+
+		if (open() && now - time_ >= MaintainInterval)
+		{
+			time_ = now;
+			if (Ethernet.linkStatus() == LinkOFF)
+			{
+				udp_.stop();
+				wait_ = 0;
+				time_ = now;
+				setStatus(Status::Connecting);	// Reconnects when the link comes back.
+			}
+#  if !defined __PG_NO_ETHERNET_DHCP
+			else if (dhcp_)
+				result = static_cast<Maintain>(hardware().maintain());	// Only blocks, up to DhcpTimeout, to renew the lease.
+#  endif
+		}
+
+		return result;
+	}
+
+	// Advances the bring-up once the link is up. Attempts are made at once, then after WaitConnect ms, 
+	// with the wait doubling up to WaitConnectMax, bounding the time failed DHCP requests block.
+	void EthernetConnection::connect()
+	{
+		const uint32_t now = millis();
+
+		if (Ethernet.linkStatus() != LinkOFF && now - time_ >= wait_)
+		{
+			time_ = now;
+			wait_ = !wait_ ? WaitConnect : wait_ < WaitConnectMax / 2 ? wait_ * 2 : WaitConnectMax;
+#  if !defined __PG_NO_ETHERNET_DHCP
+			if (dhcp_ && !Ethernet.begin(mac_.data(), DhcpTimeout, DhcpResponseTimeout))
+				return;	// No lease yet.
+#  endif
+			local_ip_ = localIP();	// Save the actual ip assigned.
+			if (udp_.begin(port_))
+				setStatus(Status::Open);
+		}
 	}
 
 
@@ -553,8 +1096,9 @@ namespace pg
 #pragma region WiFiConnection
 # if defined __PG_WIFI_H
 	WiFiConnection::WiFiConnection(const char* params) : 
-		Connection(Type::WiFi), ssid_(), pw_(), status_(WL_IDLE_STATUS), udp_(), remote_ip_(), port_(), buf_()
+		Connection(Type::WiFi), ssid_(), pw_(), status_(WL_IDLE_STATUS), time_(), udp_(), port_(), pending_session_(), buf_(), pending_(), coalesce_()
 	{
+		next_ = end_ = buf_;
 		if (params)
 			open(params);
 	}
@@ -566,29 +1110,28 @@ namespace pg
 
 	void WiFiConnection::open(const char* params)
 	{
-		if (WiFi.status() != WL_NO_SHIELD)
+		// Only starts the bring-up, clock() finishes it.
+		if ((status_ = WiFi.status()) == WL_NO_SHIELD)
+			setStatus(Status::Failed);
+		else
 		{
-			uint32_t waited = 0;
-
 			parseParams(params);
-			while (status_ != WL_CONNECTED && waited < MaxWaitTime)
-			{
-				status_ = WiFi.begin(const_cast<ssid_t>(ssid_), pw_);
-				delay(WaitConnect);
-				waited += WaitConnect;
-			}
-			udp_.begin(port_);
+			time_ = millis() - WaitConnect;	// Try at once.
+			setStatus(Status::Connecting);
 		}
 	}
 
 	bool WiFiConnection::open()
 	{
-		return status_ == WL_CONNECTED;
+		return status() == Status::Open;
 	}
 
 	void WiFiConnection::close()
 	{
+		udp_.stop();
 		WiFi.disconnect();
+		status_ = WL_DISCONNECTED;
+		setStatus(Status::Closed);
 	}
 
 	void WiFiConnection::flush()
@@ -600,9 +1143,11 @@ namespace pg
 	{
 		size_type n = 0;
 
-		if (open())
+		if (coalesce_)
+			n = append(reinterpret_cast<const uint8_t*>(message), std::strlen(message), true);
+		else if (open())
 		{
-			if (udp_.beginPacket(remote_ip_, port_))
+			if (beginPacket())
 			{
 				n = udp_.write(message);
 				n = udp_.endPacket() ? n : 0;
@@ -612,13 +1157,79 @@ namespace pg
 		return n;
 	}
 
+	Connection::size_type WiFiConnection::write(const uint8_t* buf, size_type n)
+	{
+		size_type result = 0;
+
+		if (coalesce_)
+			result = append(buf, n, false);
+		else if (open())
+		{
+			if (beginPacket())
+			{
+				result = udp_.write(buf, n);
+				result = udp_.endPacket() ? result : 0;
+			}
+		}
+
+		return result;
+	}
+
+	Connection::size_type WiFiConnection::read(uint8_t* buf, size_type n)
+	{
+		// Reads at most one datagram per call.
+		size_type result = 0;
+
+		if (open() && udp_.parsePacket())
+		{
+			result = udp_.read(buf, n);
+			receiveFrom();
+		}
+
+		return result;
+	}
+
+	void WiFiConnection::coalesce(bool value)
+	{
+		if (!value && pending_)
+		{
+			(void)udp_.endPacket();	// Send whatever has been coalesced so far.
+			pending_ = 0;
+		}
+		coalesce_ = value;
+	}
+
+	Connection::size_type WiFiConnection::append(const uint8_t* buf, size_type n, bool eol)
+	{
+		// Appends to the current datagram, text messages are newline-separated. 
+		// A new datagram is started whenever the next message won't fit.
+		uint16_t m = n + eol;
+		size_type result = 0;
+
+		if (pending_ && (pending_ + m > DatagramSizeMax || pending_session_ != sessionIndex()))
+		{
+			(void)udp_.endPacket();
+			pending_ = 0;
+		}
+		if (open() && (pending_ || beginPacket()))
+		{
+			pending_session_ = sessionIndex();
+			result = udp_.write(buf, n);
+			if (eol)
+				(void)udp_.write(static_cast<uint8_t>(EndOfMessageChar));
+			pending_ += m;
+		}
+
+		return result;
+	}
+
 	const char* WiFiConnection::params(char* buf)
 	{
 		if (buf)
 		{
 			IPAddress ip = localIP();
 
-			(void)std::sprintf(buf, "%s,%d.%d.%d.%d:%u", WiFi.SSID(), ip[0], ip[1], ip[2], ip[3], port_);
+			(void)pg::format(buf, "%s,%d.%d.%d.%d:%u", WiFi.SSID(), ip[0], ip[1], ip[2], ip[3], port_);
 		}
 
 		return buf;
@@ -641,12 +1252,23 @@ namespace pg
 
 	IPAddress WiFiConnection::remoteIP() const
 	{
-		return remote_ip_;
+		return detail::ip_address(currentSession().address);
 	}
 
 	void WiFiConnection::remoteIP(IPAddress ip)
 	{
-		remote_ip_ = ip;
+		session().address = detail::ip_value(ip);
+		session().port = 0;
+	}
+
+	bool WiFiConnection::beginPacket()
+	{
+		return udp_.beginPacket(detail::ip_address(session().address), session().port ? session().port : port_);
+	}
+
+	void WiFiConnection::receiveFrom()
+	{
+		session(findSession(detail::ip_value(udp_.remoteIP()), udp_.remotePort()));
 	}
 
 	IPAddress WiFiConnection::localIP() const
@@ -662,33 +1284,504 @@ namespace pg
 		if ((ssid_ = pg::strtok(buf, params, ParamsDelimiterChar, size()))) // Parse a copy of params.
 			if ((pw_ = std::strtok(nullptr, ParamsDelimiterChar)))
 				if ((port = std::strtok(nullptr, ParamsDelimiterChar)))
-					port_ = std::atoi(port);
+					(void)std::from_chars(port, port + std::strlen(port), port_);
 	}
 
 	void WiFiConnection::clock()
 	{
 		char* p = buf_;
 
-		if (udp_.parsePacket())
+		if (status() == Status::Connecting)
+			connect();
+		else if (open() && protocol() == Protocol::Binary)
 		{
+			// Each datagram holds one or more whole frames, reserve one byte for the terminator.
+			if (udp_.parsePacket())
+			{
+				p = unread(buf_);
+				do
+				{
+					p += udp_.read(p, remaining(p, buf_) - 1);
+					receiveFrom();
+					mark(p, sessionIndex());
+				} while (!marksFull() && udp_.parsePacket() && remaining(p, buf_) > 1);
+				end_ = p;
+			}
+		}
+		else if (open() && udp_.parsePacket())
+		{
+			// Each datagram holds one or more newline-separated messages. Two bytes are 
+			// reserved for the last message's terminator and the end of messages terminator.
+			clearMarks();
 			do
 			{
-				p += udp_.read(p, remaining(p, buf_));
-				*p++ = '\0';
-			} while (udp_.parsePacket());
+				size_type n = udp_.read(p, remaining(p, buf_) - 2);
+
+				if (udp_.available())	// Datagram truncated, drop its partial last message.
+					while (n && p[n - 1] != EndOfMessageChar)
+						--n;
+				p = split(p, p + n);
+				receiveFrom();
+				mark(p, sessionIndex());
+			} while (!marksFull() && udp_.parsePacket() && remaining(p, buf_) > 2);
 			*p = '\0';
 			next_ = buf_;
-			remote_ip_ = udp_.remoteIP();
 		}
 	} 
 
 	Connection::Maintain WiFiConnection::maintainConnection()
 	{
+		const uint32_t now = millis();
+
+		if (open() && now - time_ >= MaintainInterval)
+		{
+			time_ = now;
+			if ((status_ = WiFi.status()) != WL_CONNECTED)
+			{
+				udp_.stop();
+				time_ = now - WaitConnect;
+				setStatus(Status::Connecting);	// Reconnects when the network comes back.
+			}
+		}
+
 		return Connection::Maintain::NothingHappened;
 	}
 
+	// Advances the bring-up, making at most one attempt every WaitConnect ms.
+	void WiFiConnection::connect()
+	{
+		const uint32_t now = millis();
+
+		if ((status_ = WiFi.status()) == WL_CONNECTED)
+		{
+			if (udp_.begin(port_))
+				setStatus(Status::Open);
+		}
+		else if (now - time_ >= WaitConnect)
+		{
+			time_ = now;
+			status_ = WiFi.begin(const_cast<ssid_t>(ssid_), pw_);
+		}
+	}
+
 # endif
 #pragma endregion
+#pragma region AsyncConnection
+
+	// Decorates another connection with ring-buffered, non-blocking i/o, drained from clock().
+	template<std::size_t TxSize = 128, std::size_t RxSize = Connection::size()>
+	class AsyncConnection : public Connection
+	{
+	public:
+		static constexpr size_type DefaultBudget = 32;			// Default maximum bytes transferred per clock() call.
+		static constexpr const char* EndOfLineChars = "\r\n";	// Appended to serial text messages, same as println().
+
+	public:
+		explicit AsyncConnection(Connection*, size_type = DefaultBudget);
+		~AsyncConnection() override;
+
+	public:
+		void open(const char*) override;
+		bool open() override;
+		void close() override;
+		void flush() override;
+		size_type send(const char*) override;
+		size_type write(const uint8_t*, size_type) override;
+		size_type read(uint8_t*, size_type) override;
+		size_type writable() override;
+		void coalesce(bool) override;
+		const char* params(char*) override;
+		Maintain maintainConnection() override;
+		Session& session() override;
+		size_type sessionIndex() const override;
+		void session(size_type) override;
+		Status status() const override;
+		void statusCallback(status_callback_type) override;
+		void clock() override;
+		size_type budget() const;
+		void budget(size_type);
+		Connection* connection() const;
+		std::size_t pending() const;
+		std::size_t overruns() const;
+
+	private:
+		bool stream() const;
+		size_type queue(const uint8_t*, size_type, const char* = "");
+		void push(const uint8_t*, std::size_t);
+		void pop(uint8_t*, std::size_t);
+		void drain(size_type);
+		void fill(size_type);
+		void endLine();
+
+	private:
+		Connection*		conn_;			// The decorated connection, owned by this object.
+		size_type		budget_;		// Maximum bytes transferred per clock() call.
+		uint8_t			tx_[TxSize];	// Transmit ring buffer of length and session prefixed records.
+		std::size_t		head_;			// Index of the first queued byte.
+		std::size_t		count_;			// Number of queued bytes.
+		size_type		left_;			// Bytes left to send from the current record.
+		char			line_[RxSize];	// Partially received text line.
+		std::size_t		line_size_;		// Number of chars in line_.
+		char			rx_[RxSize];	// Receive buffer of null-terminated messages or raw bytes.
+		std::size_t		overruns_;		// Number of messages dropped because a buffer was full.
+		bool			coalesce_;		// Flag indicating whether the client is coalescing sent messages.
+	};
+
+	template<std::size_t TxSize, std::size_t RxSize>
+	AsyncConnection<TxSize, RxSize>::AsyncConnection(Connection* connection, size_type budget) :
+		Connection(connection->type()), conn_(connection), budget_(budget), tx_(), head_(), count_(), left_(),
+		line_(), line_size_(), rx_(), overruns_(), coalesce_()
+	{
+		static_assert(RxSize > 1, "RxSize must be greater than 1.");
+		next_ = end_ = rx_;
+	}
+
+	template<std::size_t TxSize, std::size_t RxSize>
+	AsyncConnection<TxSize, RxSize>::~AsyncConnection()
+	{
+		delete conn_;
+	}
+
+	template<std::size_t TxSize, std::size_t RxSize>
+	void AsyncConnection<TxSize, RxSize>::open(const char* params)
+	{
+		conn_->open(params);
+	}
+
+	template<std::size_t TxSize, std::size_t RxSize>
+	bool AsyncConnection<TxSize, RxSize>::open()
+	{
+		return conn_->open();
+	}
+
+	template<std::size_t TxSize, std::size_t RxSize>
+	void AsyncConnection<TxSize, RxSize>::close()
+	{
+		conn_->close();
+		count_ = left_ = line_size_ = 0;
+		*(next_ = end_ = rx_) = '\0';
+	}
+
+	template<std::size_t TxSize, std::size_t RxSize>
+	void AsyncConnection<TxSize, RxSize>::flush()
+	{
+		// Blocks until all queued bytes are sent, then discards any received bytes.
+		while (count_ && conn_->open())
+			drain(std::numeric_limits<size_type>::max());
+		conn_->flush();
+		line_size_ = 0;
+		*(next_ = end_ = rx_) = '\0';
+	}
+
+	template<std::size_t TxSize, std::size_t RxSize>
+	Connection::size_type AsyncConnection<TxSize, RxSize>::send(const char* message)
+	{
+		return queue(reinterpret_cast<const uint8_t*>(message), std::strlen(message), stream() ? EndOfLineChars : "");
+	}
+
+	template<std::size_t TxSize, std::size_t RxSize>
+	Connection::size_type AsyncConnection<TxSize, RxSize>::write(const uint8_t* buf, size_type n)
+	{
+		return queue(buf, n);
+	}
+
+	template<std::size_t TxSize, std::size_t RxSize>
+	Connection::size_type AsyncConnection<TxSize, RxSize>::read(uint8_t* buf, size_type n)
+	{
+		// Reads buffered raw bytes, only meaningful in binary mode.
+		size_type avail = protocol() == Protocol::Binary ? end_ - next_ : 0;
+
+		if (n > avail)
+			n = avail;
+		std::memcpy(buf, next_, n);
+		next_ += n;
+
+		return n;
+	}
+
+	template<std::size_t TxSize, std::size_t RxSize>
+	Connection::size_type AsyncConnection<TxSize, RxSize>::writable()
+	{
+		// Reports back pressure as the largest message that can currently be queued.
+		std::size_t n = TxSize - count_;
+
+		n = n > 2 * sizeof(size_type) ? n - 2 * sizeof(size_type) : 0;
+
+		return n < size() ? n : size();
+	}
+
+	template<std::size_t TxSize, std::size_t RxSize>
+	void AsyncConnection<TxSize, RxSize>::coalesce(bool value)
+	{
+		coalesce_ = value;
+		conn_->coalesce(value);	// Keeps datagrams open across drains until the client stops coalescing.
+	}
+
+	template<std::size_t TxSize, std::size_t RxSize>
+	const char* AsyncConnection<TxSize, RxSize>::params(char* buf)
+	{
+		return conn_->params(buf);
+	}
+
+	template<std::size_t TxSize, std::size_t RxSize>
+	Connection::Maintain AsyncConnection<TxSize, RxSize>::maintainConnection()
+	{
+		return conn_->maintainConnection();
+	}
+
+	template<std::size_t TxSize, std::size_t RxSize>
+	Connection::Session& AsyncConnection<TxSize, RxSize>::session()
+	{
+		return conn_->session();
+	}
+
+	template<std::size_t TxSize, std::size_t RxSize>
+	Connection::size_type AsyncConnection<TxSize, RxSize>::sessionIndex() const
+	{
+		return conn_->sessionIndex();
+	}
+
+	template<std::size_t TxSize, std::size_t RxSize>
+	void AsyncConnection<TxSize, RxSize>::session(size_type i)
+	{
+		conn_->session(i);
+	}
+
+	template<std::size_t TxSize, std::size_t RxSize>
+	Connection::Status AsyncConnection<TxSize, RxSize>::status() const
+	{
+		return conn_->status();
+	}
+
+	template<std::size_t TxSize, std::size_t RxSize>
+	void AsyncConnection<TxSize, RxSize>::statusCallback(status_callback_type cb)
+	{
+		conn_->statusCallback(cb);	// Called with the decorated connection.
+	}
+
+	template<std::size_t TxSize, std::size_t RxSize>
+	void AsyncConnection<TxSize, RxSize>::clock()
+	{
+		if (conn_->status() == Status::Connecting)
+			conn_->clock();	// Advances the bring-up of the decorated connection.
+		else
+		{
+			drain(budget_);
+			fill(budget_);
+		}
+	}
+
+	template<std::size_t TxSize, std::size_t RxSize>
+	Connection::size_type AsyncConnection<TxSize, RxSize>::budget() const
+	{
+		return budget_;
+	}
+
+	template<std::size_t TxSize, std::size_t RxSize>
+	void AsyncConnection<TxSize, RxSize>::budget(size_type n)
+	{
+		budget_ = n;
+	}
+
+	template<std::size_t TxSize, std::size_t RxSize>
+	Connection* AsyncConnection<TxSize, RxSize>::connection() const
+	{
+		return conn_;
+	}
+
+	template<std::size_t TxSize, std::size_t RxSize>
+	std::size_t AsyncConnection<TxSize, RxSize>::pending() const
+	{
+		return count_;
+	}
+
+	template<std::size_t TxSize, std::size_t RxSize>
+	std::size_t AsyncConnection<TxSize, RxSize>::overruns() const
+	{
+		return overruns_;
+	}
+
+	template<std::size_t TxSize, std::size_t RxSize>
+	bool AsyncConnection<TxSize, RxSize>::stream() const
+	{
+		// Serial connections are byte streams, the others send each record as a datagram.
+		return type() == Type::Serial;
+	}
+
+	template<std::size_t TxSize, std::size_t RxSize>
+	Connection::size_type AsyncConnection<TxSize, RxSize>::queue(const uint8_t* buf, size_type n, const char* eol)
+	{
+		// Records are queued whole, as | size | session | bytes[size] |, or dropped if they don't fit.
+		size_type m = std::strlen(eol);
+
+		if (n + m > size())
+			n = size() - m;
+		if (count_ + 2 * sizeof(size_type) + n + m > TxSize)
+		{
+			++overruns_;
+			n = m = 0;
+		}
+		else
+		{
+			size_type record = n + m, session = conn_->sessionIndex();
+
+			push(reinterpret_cast<const uint8_t*>(&record), sizeof(record));
+			push(reinterpret_cast<const uint8_t*>(&session), sizeof(session));
+			push(buf, n);
+			push(reinterpret_cast<const uint8_t*>(eol), m);
+		}
+
+		return n + m;
+	}
+
+	template<std::size_t TxSize, std::size_t RxSize>
+	void AsyncConnection<TxSize, RxSize>::push(const uint8_t* buf, std::size_t n)
+	{
+		std::size_t tail = (head_ + count_) % TxSize;
+
+		count_ += n;
+		while (n--)
+		{
+			tx_[tail] = *buf++;
+			if (++tail == TxSize)
+				tail = 0;
+		}
+	}
+
+	template<std::size_t TxSize, std::size_t RxSize>
+	void AsyncConnection<TxSize, RxSize>::pop(uint8_t* buf, std::size_t n)
+	{
+		count_ -= n;
+		while (n--)
+		{
+			*buf++ = tx_[head_];
+			if (++head_ == TxSize)
+				head_ = 0;
+		}
+	}
+
+	template<std::size_t TxSize, std::size_t RxSize>
+	void AsyncConnection<TxSize, RxSize>::drain(size_type budget)
+	{
+		// Streams are drained only as fast as the hardware buffer accepts bytes, datagrams are sent 
+		// whole. At least one datagram is sent per call, even if larger than the budget.
+		uint8_t buf[size() + 1];
+		bool first = true;
+
+		conn_->coalesce(true);
+		while (count_ && budget)
+		{
+			size_type n;
+
+			if (!left_)
+			{
+				size_type session;
+
+				pop(reinterpret_cast<uint8_t*>(&left_), sizeof(left_));
+				pop(reinterpret_cast<uint8_t*>(&session), sizeof(session));
+				conn_->session(session);	// Replies go to the client that was current when they were queued.
+			}
+			n = left_;
+			if (stream())
+			{
+				size_type avail = conn_->writable();
+
+				if (n > budget)
+					n = budget;
+				if (n > avail)
+					n = avail;
+				if (!n)
+					break;
+			}
+			else if (n > budget && !first)
+				break;
+			pop(buf, n);
+			if (!stream() && protocol() == Protocol::Text)
+			{
+				buf[n] = '\0';
+				(void)conn_->send(reinterpret_cast<const char*>(buf));	// Coalesced text messages get separators.
+			}
+			else
+				(void)conn_->write(buf, n);
+			left_ -= n;
+			budget = n < budget ? budget - n : 0;
+			first = false;
+		}
+		if (!coalesce_)
+			conn_->coalesce(false);
+	}
+
+	template<std::size_t TxSize, std::size_t RxSize>
+	void AsyncConnection<TxSize, RxSize>::fill(size_type budget)
+	{
+		// Unread bytes are kept and new bytes appended, one byte is reserved for the terminator.
+		char* p = unread(rx_);
+		std::size_t avail = sizeof(rx_) - (p - rx_) - 1;
+
+		// Datagram reads consume a whole datagram and drop whatever doesn't fit, so they 
+		// aren't limited by the budget, and aren't made at all without room to spare.
+		if (!stream() || budget > avail)
+			budget = avail;
+		if (protocol() == Protocol::Binary)
+		{
+			line_size_ = 0;
+			if (budget && (end_ = p + conn_->read(reinterpret_cast<uint8_t*>(p), budget)) != p)
+				mark(end_, conn_->sessionIndex());
+		}
+		else if (!stream())
+		{
+			// Each datagram holds one or more newline-separated messages, another byte 
+			// is reserved for the last message's terminator.
+			size_type n;
+
+			if (budget > 1 && (n = conn_->read(reinterpret_cast<uint8_t*>(p), budget - 1)))
+			{
+				end_ = split(p, p + n);
+				mark(end_, conn_->sessionIndex());
+			}
+			*end_ = '\0';
+		}
+		else
+		{
+			// Text is assembled into lines which are only made visible to receive() once complete.
+			uint8_t buf[size()];
+			size_type n;
+
+			if (budget > sizeof(buf))
+				budget = sizeof(buf);
+			if ((n = conn_->read(buf, budget)))
+			{
+				for (size_type i = 0; i < n; ++i)
+				{
+					if (buf[i] == '\n' || buf[i] == '\r')
+						endLine();
+					else if (line_size_ < sizeof(line_))
+						line_[line_size_++] = static_cast<char>(buf[i]);
+				}
+				mark(end_, conn_->sessionIndex());
+			}
+			*end_ = '\0';
+		}
+	}
+
+	template<std::size_t TxSize, std::size_t RxSize>
+	void AsyncConnection<TxSize, RxSize>::endLine()
+	{
+		if (line_size_)
+		{
+			if (line_size_ < static_cast<std::size_t>(rx_ + sizeof(rx_) - end_) - 1)
+			{
+				std::memcpy(end_, line_, line_size_);
+				end_ += line_size_;
+				*end_++ = '\0';
+			}
+			else
+				++overruns_;
+			line_size_ = 0;
+		}
+	}
+
+#pragma endregion
 
 } // namespace pg
 
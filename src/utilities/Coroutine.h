@@ -0,0 +1,163 @@
+/*
+ *	This files defines a stackless coroutine task type.
+ *
+ *	***************************************************************************
+ *
+ *	File: Coroutine.h
+ *	Date: October 14, 2026
+ *	Version: 1.0
+ *	Author: Michael Brodsky
+ *	Email: mbrodskiis@gmail.com
+ *	Copyright (c) 2012-2022 Michael Brodsky
+ *
+ *	***************************************************************************
+ *
+ *  This file is part of "Pretty Good" (Pg). "Pg" is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  This file is distributed in the hope that it will be useful, but
+ *	WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *	along with this file. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *	Description:
+ *
+ *		The Coroutine class lets long operations be split into steps that run
+ *		across several calls to `execute()', instead of stalling the caller
+ *		until they finish. Coroutines are commands (see <interfaces/icommand.h>)
+ *		so they can be scheduled like any other TaskScheduler or
+ *		DeadlineScheduler task, which resumes them on each interval.
+ *
+ *		Coroutines are stackless, in the style of protothreads. Clients
+ *		derive from Coroutine and override `resume()', bracketing its body
+ *		with the PG_BEGIN() and PG_END() macros. Inside the body:
+ *
+ *			PG_YIELD()				returns to the caller and resumes on the
+ *									next statement.
+ *			PG_WAIT_UNTIL(d)		returns to the caller until duration d
+ *									has elapsed, a zero duration yields
+ *									once.
+ *			PG_WAIT_FOR(c)			returns to the caller until condition c
+ *									is true.
+ *			PG_RETURN()				ends the coroutine.
+ *
+ *		Once ended, `execute()' does nothing until the coroutine is
+ *		`restart()'ed.
+ *
+ *		class Store : public Coroutine<>
+ *		{
+ *			void resume() override
+ *			{
+ *				PG_BEGIN();
+ *				for (i_ = 0; i_ < size_; ++i_)
+ *				{
+ *					EEPROM.update(i_, data_[i_]);
+ *					PG_YIELD();
+ *				}
+ *				PG_WAIT_UNTIL(std::chrono::milliseconds(10));
+ *				PG_END();
+ *			}
+ *			uint8_t i_;
+ *			...
+ *		};
+ *
+ *	Notes:
+ *
+ *		Local variables are not preserved across yields, use class members
+ *		instead. Yields cannot be used inside a switch statement in the body,
+ *		nor in any function called from `resume()'.
+ *
+ *	**************************************************************************/
+
+#if !defined __PG_COROUTINE_H
+# define __PG_COROUTINE_H 20261014L
+
+# include <cstdint>					// Fixed-width integer types.
+# include <interfaces/icommand.h>	// `icommand' interface.
+# include <utilities/Timer.h>		// `Timer' class.
+
+// Begins a coroutine body.
+# define PG_BEGIN() switch (this->line_) { case 0:
+// Ends a coroutine body.
+# define PG_END() } this->line_ = this->Done
+// Returns to the caller, resuming on the next statement.
+# define PG_YIELD() do { this->line_ = __LINE__; return; case __LINE__:; } while (0)
+// Returns to the caller until a duration has elapsed.
+# define PG_WAIT_UNTIL(d) do { this->timer_.start(d); this->line_ = __LINE__; return; case __LINE__: if (this->timer_.interval().count() && !this->timer_.expired()) return; this->timer_.stop(); } while (0)
+// Returns to the caller until a condition is true.
+# define PG_WAIT_FOR(c) do { this->line_ = __LINE__; case __LINE__: if (!(c)) return; } while (0)
+// Ends the coroutine.
+# define PG_RETURN() do { this->line_ = this->Done; return; } while (0)
+
+# if defined __PG_HAS_NAMESPACES
+
+namespace pg
+{
+	// Resumable stackless coroutine command.
+	template<class T = std::chrono::milliseconds>
+	class Coroutine : public icommand
+	{
+	public:
+		using timer_type = Timer<T>;
+		using duration = typename timer_type::duration;
+		using line_type = uint16_t;
+
+		static constexpr line_type Done = UINT16_MAX;	// Line value of ended coroutines.
+
+	public:
+		Coroutine();
+
+	public:
+		// Resumes the coroutine, if not ended.
+		void execute() override;
+		// Checks whether the coroutine has ended.
+		bool done() const;
+		// Restarts the coroutine from the beginning.
+		void restart();
+
+	protected:
+		// Coroutine body, runs from the last yield to the next.
+		virtual void resume() = 0;
+
+	protected:
+		line_type	line_;	// Line to resume from, 0 = beginning.
+		timer_type	timer_;	// Timer used by PG_WAIT_UNTIL().
+	};
+
+	template<class T>
+	Coroutine<T>::Coroutine() : line_(), timer_()
+	{
+
+	}
+
+	template<class T>
+	void Coroutine<T>::execute()
+	{
+		if (!done())
+			resume();
+	}
+
+	template<class T>
+	bool Coroutine<T>::done() const
+	{
+		return line_ == Done;
+	}
+
+	template<class T>
+	void Coroutine<T>::restart()
+	{
+		line_ = 0;
+		timer_.stop();
+	}
+} // namespace pg
+
+# else // !defined __PG_HAS_NAMESPACES
+#  error Requires C++11 and namespace support.
+# endif // defined __PG_HAS_NAMESPACES
+
+#endif // !defined __PG_COROUTINE_H
@@ -0,0 +1,596 @@
+/*
+ *	This files declares a deadline-ordered task scheduling class.
+ *
+ *	***************************************************************************
+ *
+ *	File: DeadlineScheduler.h
+ *	Date: October 14, 2026
+ *	Version: 1.0
+ *	Author: Michael Brodsky
+ *	Email: mbrodskiis@gmail.com
+ *	Copyright (c) 2012-2022 Michael Brodsky
+ *
+ *	***************************************************************************
+ *
+ *  This file is part of "Pretty Good" (Pg). "Pg" is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  This file is distributed in the hope that it will be useful, but
+ *	WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *	along with this file. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *	Description:
+ *
+ *		The DeadlineScheduler class is a drop-in alternative to TaskScheduler
+ *		(see <utilities/TaskScheduler.h>) for larger task sets. Instead of
+ *		polling every task on each `tick()', it keeps the tasks in a binary
+ *		min-heap ordered by the time each task is next due, so `tick()' only
+ *		looks at the root of the heap and touches only tasks that are due.
+ *		Checking for due tasks costs O(1) and rescheduling a task costs
+ *		O(log n).
+ *
+ *		Tasks have the same interval, command and state properties as
+ *		TaskScheduler tasks, plus a priority. When two tasks are due at the
+ *		same time, the one with the higher priority runs first. Idle tasks
+ *		sink to the bottom of the heap and are never looked at by `tick()'.
+ *
+ *		The scheduler keeps its own copy of the task pointers, so it can
+ *		reorder them without touching the client's collection. The maximum
+ *		number of tasks is set by the `N' template parameter.
+ *
+ *	Notes:
+ *
+ *		Tasks belong to at most one DeadlineScheduler at a time. Changing a
+ *		task's interval, state or priority reschedules it automatically.
+ *
+ *		Due times are compared by their signed difference, so scheduling
+ *		survives the clock rolling over, like TaskScheduler's elapsed times,
+ *		as long as task intervals are less than half the clock's range,
+ *		about 24 days for the default millis() clock.
+ *
+ *	**************************************************************************/
+
+#if !defined __PG_DEADLINESCHEDULER_H
+# define __PG_DEADLINESCHEDULER_H 20261014L
+
+# include <array>						// Fixed-size array types.
+# include <type_traits>					// std::make_signed
+# include <utilities/CommandTimer.h>	// CommandTimer type.
+# if defined __PG_TASK_STATS
+#  include <utilities/TaskStats.h>	// TaskStats type.
+# endif
+
+# if defined __PG_HAS_NAMESPACES
+
+namespace pg
+{
+	// Schedules tasks to run concurrently at specified intervals, in deadline order.
+	template<class T = CommandTimer<std::chrono::milliseconds>, std::size_t N = 8>
+	class DeadlineScheduler
+	{
+	public:
+		using timer_type = T;
+		using duration = typename timer_type::duration;
+		using time_point = typename timer_type::time_point;
+		using clock_type = typename timer_type::clock_type;
+		using difference_type = typename std::make_signed<typename duration::rep>::type;
+		using priority_type = uint8_t;
+
+		// Scheduled task type.
+		class Task
+		{
+			friend class DeadlineScheduler<T, N>;
+
+		public:
+			// Enumerates the valid task states.
+			enum class State
+			{
+				Idle = 0,	// Indicates the task is not currently active.
+				Active		// Indicates the task is currently active.
+			};
+
+		public:
+			// Constructs an idle task that doesn't belong to a scheduler.
+			Task() = default;
+			// Constructs a task with a given interval, command, state and priority.
+			Task(duration, icommand*, State = State::Idle, priority_type = 0);
+			// Move constructor.
+			Task(Task&&) = default;
+			// No copy constructor.
+			Task(const Task&) = delete;
+			// No copy assignment operator.
+			Task& operator=(const Task&) = delete;
+
+		public:
+			// Sets the current task command.
+			void command(icommand*);
+			// Returns the current task command.
+			const icommand* command() const;
+			// Sets the current task interval.
+			void interval(duration);
+			// Returns the current task interval.
+			const duration interval() const;
+			// Sets the current task priority.
+			void priority(priority_type);
+			// Returns the current task priority.
+			priority_type priority() const;
+			// Sets the current task state.
+			void state(State);
+			// Returns the current task state.
+			const State& state() const;
+			// Resets the task timer.
+			void reset();
+# if defined __PG_TASK_STATS
+			// Returns a mutable reference to the task execution statistics.
+			TaskStats& stats();
+			// Returns an immutable reference to the task execution statistics.
+			const TaskStats& stats() const;
+# endif
+
+		private:
+			// Checks whether the task is active with a non-zero interval, and so ever comes due.
+			bool scheduled() const;
+			// Recomputes the task due time from its timer.
+			void due();
+			// Recomputes the task due time and reschedules it.
+			void reschedule();
+
+		private:
+			timer_type			timer_;		// Task timer and executor.
+			State				state_ = State::Idle;	// The current task state.
+			priority_type		priority_ = 0;			// Tie-breaking priority, higher runs first.
+			time_point			due_;					// Time point when the task is next due.
+			DeadlineScheduler*	owner_ = nullptr;		// The scheduler this task belongs to, if any.
+			std::size_t			index_ = 0;				// The task's position in the owner's heap.
+# if defined __PG_TASK_STATS
+			TaskStats			stats_;					// Task execution statistics.
+# endif
+		};
+
+	public:
+		// Enumerates the valid task scheduler states.
+		enum class State
+		{
+			Idle = 0,	// Indicates the scheduler is not currently active.
+			Active		// Indicates the scheduler is currently active.
+		};
+		using container_type = typename std::ArrayWrapper<Task*>;
+
+	public:
+		// Constructs an uninitialized DeadlineScheduler.
+		DeadlineScheduler();
+		// Constructs a DeadlineScheduler from an array of Tasks.
+		template <std::size_t M>
+		explicit DeadlineScheduler(Task* (&)[M]);
+		// Constructs a DeadlineScheduler from pointer to and size of Tasks.
+		DeadlineScheduler(Task* [], size_t);
+		// Constructs a DeadlineScheduler from a range of Tasks.
+		DeadlineScheduler(Task**, Task**);
+		// Constructs a DeadlineScheduler from a list of Tasks.
+		DeadlineScheduler(std::initializer_list<Task*>);
+		// Constructs a DeadlineScheduler from a collection of Tasks.
+		DeadlineScheduler(const container_type&);
+		// No copy constructor, tasks refer back to their scheduler.
+		DeadlineScheduler(const DeadlineScheduler&) = delete;
+		// No copy assignment operator.
+		DeadlineScheduler& operator=(const DeadlineScheduler&) = delete;
+
+	public:
+		// Starts all active tasks.
+		void start();
+		// Stops all active tasks.
+		void stop();
+		// Resets all tasks.
+		void reset();
+		// Returns an immutable reference to the current state.
+		const State& state() const;
+		// Sets the tasks from an array.
+		template <std::size_t M>
+		void tasks(Task* (&)[M]);
+		// Sets the tasks from a pointer and size.
+		void tasks(Task* [], std::size_t n);
+		// Sets the tasks from a range.
+		void tasks(Task**, Task**);
+		// Sets the tasks from a list.
+		void tasks(std::initializer_list<Task*>);
+		// Sets the tasks from a collection.
+		void tasks(const container_type&);
+		// Returns an immutable reference to the current tasks collection, in heap order.
+		const container_type& tasks() const;
+		// Returns the time remaining until the next task is due, or duration::max() if none are active.
+		duration remaining() const;
+		// Executes any currently active scheduled tasks that are due.
+		void tick();
+
+	private:
+		// Checks whether task `a' should run before task `b'.
+		static bool before(const Task*, const Task*);
+		// Returns the signed time from b to a, which is correct across clock rollovers.
+		static difference_type until(const time_point& a, const time_point& b);
+		// Rebuilds the heap from the current tasks.
+		void make_heap();
+		// Stores a task at a given heap position.
+		void place(Task*, std::size_t);
+		// Moves a task to its correct heap position.
+		void update(std::size_t);
+		// Moves a task towards the root of the heap.
+		void sift_up(std::size_t);
+		// Moves a task towards the bottom of the heap.
+		void sift_down(std::size_t);
+
+	private:
+		Task*			heap_[N];	// Task pointers ordered as a min-heap on due time.
+		container_type	tasks_;		// The current tasks collection, wraps heap_.
+		State			state_;		// The current scheduler state.
+	};
+
+#pragma region DeadlineScheduler
+
+	template<class T, std::size_t N>
+	DeadlineScheduler<T, N>::DeadlineScheduler() :
+		heap_(), tasks_(heap_, heap_), state_()
+	{
+
+	}
+
+	template<class T, std::size_t N>
+	template <std::size_t M>
+	DeadlineScheduler<T, N>::DeadlineScheduler(Task* (&tasks)[M]) :
+		DeadlineScheduler()
+	{
+		this->tasks(tasks);
+	}
+
+	template<class T, std::size_t N>
+	DeadlineScheduler<T, N>::DeadlineScheduler(Task* tasks[], size_t n) :
+		DeadlineScheduler()
+	{
+		this->tasks(tasks, n);
+	}
+
+	template<class T, std::size_t N>
+	DeadlineScheduler<T, N>::DeadlineScheduler(Task** first, Task** last) :
+		DeadlineScheduler()
+	{
+		tasks(first, last);
+	}
+
+	template<class T, std::size_t N>
+	DeadlineScheduler<T, N>::DeadlineScheduler(std::initializer_list<Task*> il) :
+		DeadlineScheduler()
+	{
+		tasks(il);
+	}
+
+	template<class T, std::size_t N>
+	DeadlineScheduler<T, N>::DeadlineScheduler(const container_type& tasks) :
+		DeadlineScheduler()
+	{
+		this->tasks(tasks);
+	}
+
+	template<class T, std::size_t N>
+	template <std::size_t M>
+	void DeadlineScheduler<T, N>::tasks(Task* (&tasks)[M])
+	{
+		this->tasks(tasks, M);
+	}
+
+	template<class T, std::size_t N>
+	void DeadlineScheduler<T, N>::tasks(Task* tasks[], std::size_t n)
+	{
+		this->tasks(tasks, tasks + n);
+	}
+
+	template<class T, std::size_t N>
+	void DeadlineScheduler<T, N>::tasks(Task** first, Task** last)
+	{
+		std::size_t n = 0;
+
+		for (auto i : tasks_)
+			i->owner_ = nullptr;
+		for (; first != last && n < N; ++first)
+		{
+			assert(*first);
+			place(*first, n++);
+			(*first)->owner_ = this;
+		}
+		tasks_ = container_type(heap_, n);
+		make_heap();
+	}
+
+	template<class T, std::size_t N>
+	void DeadlineScheduler<T, N>::tasks(std::initializer_list<Task*> il)
+	{
+		tasks(const_cast<Task**>(il.begin()), const_cast<Task**>(il.end()));
+	}
+
+	template<class T, std::size_t N>
+	void DeadlineScheduler<T, N>::tasks(const container_type& tasks)
+	{
+		this->tasks(const_cast<Task**>(tasks.data()), const_cast<Task**>(tasks.data()) + tasks.size());
+	}
+
+	template<class T, std::size_t N>
+	const typename DeadlineScheduler<T, N>::container_type& DeadlineScheduler<T, N>::tasks() const
+	{
+		return tasks_;
+	}
+
+	template<class T, std::size_t N>
+	void DeadlineScheduler<T, N>::start()
+	{
+		state_ = State::Active;
+		for (auto i : tasks_)
+			if (i->state_ == Task::State::Active)
+				i->timer_.resume();
+		make_heap();
+	}
+
+	template<class T, std::size_t N>
+	void DeadlineScheduler<T, N>::stop()
+	{
+		state_ = State::Idle;
+	}
+
+	template<class T, std::size_t N>
+	void DeadlineScheduler<T, N>::reset()
+	{
+		for (auto i : tasks_)
+			i->timer_.reset();
+		make_heap();
+	}
+
+	template<class T, std::size_t N>
+	const typename DeadlineScheduler<T, N>::State& DeadlineScheduler<T, N>::state() const
+	{
+		return state_;
+	}
+
+	template<class T, std::size_t N>
+	typename DeadlineScheduler<T, N>::duration DeadlineScheduler<T, N>::remaining() const
+	{
+		duration remaining = duration::max();
+
+		if (state_ == State::Active && !tasks_.empty() && tasks_[0]->scheduled())
+		{
+			const difference_type until_due = until(tasks_[0]->due_, time_point(clock_type::now()));
+
+			remaining = until_due > 0 ? duration(until_due) : duration();
+		}
+
+		return remaining;
+	}
+
+	template<class T, std::size_t N>
+	void DeadlineScheduler<T, N>::tick()
+	{
+		if (state_ == State::Active && !tasks_.empty())
+		{
+			time_point now = time_point(clock_type::now());
+
+			// Each task runs at most once per tick, same as TaskScheduler.
+			for (std::size_t n = tasks_.size(); n; --n)
+			{
+				Task* task = heap_[0];
+
+				if (!task->scheduled() || until(task->due_, now) > 0)
+					break;
+# if defined __PG_TASK_STATS
+				task->stats_.tick(task->timer_);
+# else
+				task->timer_.tick();
+# endif
+				task->due();	// Timer was reset by tick().
+				sift_down(0);
+			}
+		}
+	}
+
+	template<class T, std::size_t N>
+	bool DeadlineScheduler<T, N>::before(const Task* a, const Task* b)
+	{
+		bool result = false;
+
+		if (a->scheduled() != b->scheduled())
+			result = a->scheduled();
+		else if (a->scheduled())
+		{
+			const difference_type d = until(a->due_, b->due_);
+
+			result = d < 0 || (d == 0 && a->priority_ > b->priority_);
+		}
+
+		return result;
+	}
+
+	template<class T, std::size_t N>
+	typename DeadlineScheduler<T, N>::difference_type 
+		DeadlineScheduler<T, N>::until(const time_point& a, const time_point& b)
+	{
+		return static_cast<difference_type>((a - b).count());	// Unsigned reps wrap, the cast recovers the sign.
+	}
+
+	template<class T, std::size_t N>
+	void DeadlineScheduler<T, N>::make_heap()
+	{
+		for (auto i : tasks_)
+			i->due();
+		for (std::size_t i = tasks_.size() / 2; i-- > 0;)
+			sift_down(i);
+	}
+
+	template<class T, std::size_t N>
+	void DeadlineScheduler<T, N>::place(Task* task, std::size_t i)
+	{
+		heap_[i] = task;
+		task->index_ = i;
+	}
+
+	template<class T, std::size_t N>
+	void DeadlineScheduler<T, N>::update(std::size_t i)
+	{
+		Task* task = heap_[i];
+
+		sift_up(i);
+		sift_down(task->index_);
+	}
+
+	template<class T, std::size_t N>
+	void DeadlineScheduler<T, N>::sift_up(std::size_t i)
+	{
+		Task* task = heap_[i];
+
+		while (i > 0)
+		{
+			std::size_t parent = (i - 1) / 2;
+
+			if (!before(task, heap_[parent]))
+				break;
+			place(heap_[parent], i);
+			i = parent;
+		}
+		place(task, i);
+	}
+
+	template<class T, std::size_t N>
+	void DeadlineScheduler<T, N>::sift_down(std::size_t i)
+	{
+		const std::size_t n = tasks_.size();
+		Task* task = heap_[i];
+
+		for (std::size_t child; (child = 2 * i + 1) < n; i = child)
+		{
+			if (child + 1 < n && before(heap_[child + 1], heap_[child]))
+				++child;
+			if (!before(heap_[child], task))
+				break;
+			place(heap_[child], i);
+		}
+		place(task, i);
+	}
+
+#pragma endregion
+#pragma region Task
+
+	template<class T, std::size_t N>
+	DeadlineScheduler<T, N>::Task::Task(duration interval, icommand* command, State state, priority_type priority) :
+		timer_(interval, command, true), state_(state), priority_(priority), due_(), owner_(), index_()
+# if defined __PG_TASK_STATS
+		, stats_()
+# endif
+	{
+		assert(command);
+	}
+
+	template<class T, std::size_t N>
+	void DeadlineScheduler<T, N>::Task::command(icommand* cmd)
+	{
+		assert(cmd);
+		timer_.command(cmd);
+	}
+
+	template<class T, std::size_t N>
+	const icommand* DeadlineScheduler<T, N>::Task::command() const
+	{
+		return timer_.command();
+	}
+
+	template<class T, std::size_t N>
+	void DeadlineScheduler<T, N>::Task::interval(duration intvl)
+	{
+		timer_.interval(intvl);
+		reschedule();
+	}
+
+	template<class T, std::size_t N>
+	const typename DeadlineScheduler<T, N>::duration DeadlineScheduler<T, N>::Task::interval() const
+	{
+		return timer_.interval();
+	}
+
+	template<class T, std::size_t N>
+	void DeadlineScheduler<T, N>::Task::priority(priority_type val)
+	{
+		priority_ = val;
+		reschedule();
+	}
+
+	template<class T, std::size_t N>
+	typename DeadlineScheduler<T, N>::priority_type DeadlineScheduler<T, N>::Task::priority() const
+	{
+		return priority_;
+	}
+
+	template<class T, std::size_t N>
+	void DeadlineScheduler<T, N>::Task::state(State val)
+	{
+		if ((state_ = val) == State::Active)
+			timer_.resume();
+		else
+			timer_.stop();
+		reschedule();
+	}
+
+	template<class T, std::size_t N>
+	const typename DeadlineScheduler<T, N>::Task::State& DeadlineScheduler<T, N>::Task::state() const
+	{
+		return state_;
+	}
+
+	template<class T, std::size_t N>
+	void DeadlineScheduler<T, N>::Task::reset()
+	{
+		timer_.reset();
+		reschedule();
+	}
+
+	template<class T, std::size_t N>
+	bool DeadlineScheduler<T, N>::Task::scheduled() const
+	{
+		// Zero intervals never expire (see Timer::expired()), so never come due.
+		return state_ == State::Active && timer_.interval() != duration();
+	}
+
+	template<class T, std::size_t N>
+	void DeadlineScheduler<T, N>::Task::due()
+	{
+		due_ = time_point(clock_type::now()) + (timer_.interval() - timer_.elapsed());
+	}
+
+	template<class T, std::size_t N>
+	void DeadlineScheduler<T, N>::Task::reschedule()
+	{
+		due();
+		if (owner_)
+			owner_->update(index_);
+	}
+
+# if defined __PG_TASK_STATS
+	template<class T, std::size_t N>
+	TaskStats& DeadlineScheduler<T, N>::Task::stats()
+	{
+		return stats_;
+	}
+
+	template<class T, std::size_t N>
+	const TaskStats& DeadlineScheduler<T, N>::Task::stats() const
+	{
+		return stats_;
+	}
+
+# endif
+#pragma endregion
+} // namespace pg
+
+# else // !defined __PG_HAS_NAMESPACES
+#  error Requires C++11 and namespace support.
+# endif // defined __PG_HAS_NAMESPACES
+
+#endif // !defined __PG_DEADLINESCHEDULER_H
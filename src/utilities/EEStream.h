@@ -82,11 +82,11 @@
  * 
  *	The nested i/o manipulator types `update' and `noupdate' are used to turn 
  *	the EEPROM update/noupdate functionality on and off. If update is on, 
- *	data is only written if it differs from the currently stored data (much 
+ *	only bytes that differ from the currently stored data are written (much 
  *	like the Arduino EEPROM.update() function except that it works with any 
  *	type instead of only one byte at a time). If update is off, data is 
- *	automatically written regardless of the EEPROM's current contents. Objects 
- *	must be equal comparable to use update. The update and noupdate types are 
+ *	automatically written regardless of the EEPROM's current contents. The 
+ *	update and noupdate types are 
  *	simply streamed to the EEStream object, like any other type, the same way 
  *	std::boolalpha is used with std::iostream in the C++ Standard Library:
  * 
@@ -109,6 +109,21 @@
  *		long  ln;
  *  }
  * 
+ *	Objects, strings and arrays of types without their own overloads are 
+ *	transferred as blocks of bytes. On AVR boards, blocks are read and 
+ *	written with the avr-libc eeprom_read_block(), eeprom_write_block() and 
+ *	eeprom_update_block() functions, which are several times faster than 
+ *	byte at a time access through the EEPROM library. On boards that emulate 
+ *	the EEPROM in flash memory, writes are buffered by the EEPROM library, 
+ *	and commit() writes the buffered pages in one pass if the board defines 
+ *	__PG_EEPROM_COMMIT (see below).
+ *
+ *	Raw blocks of bytes, such as buffers holding several strings, are 
+ *	transferred with read() and write(), which also advance the address:
+ *
+ *		e.write(buf, n);	// Writes n bytes of buf.
+ *		e.read(buf, n);		// Reads them back.
+ *
  *	Types using their overrides must appear as the lefthand side operand:
  *
  *		EEStream ee;
@@ -116,6 +131,46 @@
  *		a >> ee;	// Uses A's insertion operator.
  *		ee << a;	// Uses EEStream's insertion operator.
  * 
+ *	Journal Mode:
+ *
+ *	Each EEPROM byte write takes about 3.3 ms on AVR boards, and writes 
+ *	block until the previous one has finished, so storing a large 
+ *	configuration can stall the program for hundreds of milliseconds. On 
+ *	boards that emulate the EEPROM in flash memory, every write rewrites a 
+ *	whole page. The EEJournal class keeps a RAM image of a region of the 
+ *	EEPROM instead. An EEStream attached to a journal reads and writes the 
+ *	image, and commit() schedules the changes to be written by the journal's 
+ *	clock() method: 
+ *
+ *		uint8_t image[64];
+ *		EEJournal journal(image);
+ *		EEStream e(journal);
+ *		journal.begin();	// Load the newest valid record into the image.
+ *		...
+ *		e.reset();
+ *		e << i;				// Only changes the image.
+ *		e << f;
+ *		e.commit();			// Write the changes ...
+ *		...
+ *		journal.clock();	// ... a byte at a time, from the main loop.
+ *
+ *	Journal addresses are offsets into the image, starting at zero. The 
+ *	image is stored as a record with a sequence number and a CRC, and the 
+ *	records rotate through as many slots as fit in the EEPROM after the 
+ *	journal's base address, or through a given number of slots. Each commit 
+ *	writes the next slot, so wear is spread across all of them. Only bytes 
+ *	that differ from the slot's contents are written, and the CRC is written 
+ *	last. If the device resets during a commit, begin() recovers the last 
+ *	complete record. On AVR boards, clock() starts at most one byte write 
+ *	per call, which the EEPROM completes in the background, so a commit 
+ *	never blocks. On other boards all of the changes are written in one 
+ *	pass. If the board's EEPROM library buffers writes until EEPROM.commit() 
+ *	is called, as on ESP32 and RP2040 boards, the pass ends with 
+ *	EEPROM.commit(). Define __PG_EEPROM_COMMIT to call it on other boards, 
+ *	such as SAMD boards using a flash storage library without auto-commit. 
+ *	Without a journal, EEStream::commit() then calls EEPROM.commit() directly. 
+ *	flush() waits until all committed changes have been written.
+ *
  *	**************************************************************************/
 
 #if !defined __PG_EESTREAM_H
@@ -123,12 +178,87 @@
 
 # include <Arduino.h>	// Arduino system api.
 # include <EEPROM.h>	// Arduino EEPROM api.
+# include <cstring>		// memchr(), strlen()
 # include <type_traits>	// Type support library.
+# include <lib/crc.h>	// crc_engine type.
+# include <interfaces/iclockable.h>	// iclockable interface.
+# if defined __AVR__
+#  include <avr/eeprom.h>	// eeprom_is_ready()
+# endif
+# if defined ARDUINO_ARCH_ESP32 || defined ARDUINO_ARCH_RP2040
+#  define __PG_EEPROM_COMMIT
+# endif
 
 # if defined __PG_HAS_NAMESPACES 
 
 namespace pg
 {
+	// Type that buffers an EEPROM region in RAM and writes changes in wear-leveled records.
+	class EEJournal : public iclockable
+	{
+	public:
+		using address_type = unsigned;	// EEPROM addressing type alias.
+		using size_type = unsigned;		// Type that can hold the size of the image.
+		using seq_type = uint16_t;		// Record sequence number type.
+		using crc_type = crc_16;		// Record CRC algorithm.
+
+		static constexpr size_type RecordOverhead = 
+			sizeof(seq_type) + sizeof(typename crc_type::value_type);	// Record bytes other than the image.
+
+	public:
+		// Constructs a journal of an image array, stored from base in a number of slots, or in as many as fit if zero.
+		template<std::size_t N>
+		explicit EEJournal(uint8_t(&image)[N], address_type base = 0, uint8_t slots = 0) : 
+			EEJournal(image, N, base, slots) {}
+		EEJournal(const EEJournal&) = delete;
+		EEJournal& operator=(const EEJournal&) = delete;
+
+	public:
+		// Loads the newest valid record into the image and returns true, or returns false if none.
+		bool begin();
+		// Writes committed changes to the EEPROM, without blocking on AVR boards.
+		void clock() override;
+		// Schedules changes to the image to be written to the EEPROM.
+		void commit();
+		// Waits until all committed changes have been written to the EEPROM.
+		void flush();
+		// Checks whether committed changes have yet to be written to the EEPROM.
+		bool pending() const;
+		// Returns the image byte at an address.
+		uint8_t read(address_type) const;
+		// Copies a number of image bytes from an address.
+		void read(address_type, void*, size_type) const;
+		// Returns the size of the image in bytes.
+		size_type size() const;
+		// Returns the number of record slots.
+		uint8_t slots() const;
+		// Sets the image byte at an address.
+		void write(address_type, uint8_t);
+		// Copies a number of bytes to the image at an address.
+		void write(address_type, const void*, size_type);
+
+	private:
+		EEJournal(uint8_t*, size_type, address_type, uint8_t);
+
+	private:
+		// Returns the EEPROM address of a record slot.
+		address_type slot(uint8_t) const;
+		// Writes the next record byte, if it differs from the EEPROM, and returns true if written.
+		bool step();
+
+	private:
+		uint8_t*				image_;		// The EEPROM image.
+		size_type				size_;		// The image size in bytes.
+		address_type			base_;		// EEPROM address of the first slot.
+		uint8_t					slots_;		// Number of record slots.
+		uint8_t					current_;	// Slot holding the newest record.
+		seq_type				seq_;		// Sequence number of the newest record.
+		size_type				next_;		// Next record byte to write, or the record size if idle.
+		crc_engine<crc_type>	crc_;		// CRC of the record being written.
+		bool					dirty_;		// Flag indicating whether the image differs from the newest record.
+		bool					commit_;	// Flag indicating whether the changes are to be written.
+	};
+
 	// Type that provides EEPROM streaming services.
 	class EEStream
 	{
@@ -141,6 +271,8 @@ namespace pg
 	public:
 		// Constructs an EEStream.
 		EEStream();
+		// Constructs an EEStream that reads and writes a journal image.
+		explicit EEStream(EEJournal&);
 		// No copy constructor.
 		EEStream(const EEStream&) = delete;
 		// Move constructor.
@@ -161,14 +293,48 @@ namespace pg
 		// Stream array extraction operator.
 		template<class T, std::size_t N>
 		EEStream& operator>>(T(&t)[N]);
+		// Reads a number of bytes from the current address.
+		EEStream& read(void*, std::size_t);
+		// Writes a number of bytes to the current address.
+		EEStream& write(const void*, std::size_t);
 		// Returns a mutable reference to the current read/write address.
 		address_type& address();
 		// Returns a immutable reference to the current read/write address.
 		const address_type& address() const;
 		// Resets the EEPROM read/write address to zero.
 		void reset();
+		// Returns the attached journal, if any.
+		EEJournal* journal() const;
+		// Attaches a journal, or detaches it if nullptr.
+		void journal(EEJournal*);
+		// Schedules journaled writes to be written to the EEPROM, or commits buffered EEPROM writes.
+		void commit();
+		// Waits until journaled writes have been written to the EEPROM, does nothing if not journaled.
+		void flush();
 
 	private:
+		static constexpr std::size_t BlockSize = 16;	// Size of string read blocks.
+
+		// Checks whether arrays of T are transferred as one block.
+		template<class T>
+		using is_block = std::integral_constant<bool, 
+			std::is_trivially_copyable<T>::value && !std::is_pointer<T>::value>;
+
+	private:
+		// Reads a block of bytes from the EEPROM or journal.
+		void get(address_type, void*, std::size_t) const;
+		// Writes a block of bytes to the EEPROM or journal.
+		void put(address_type, const void*, std::size_t);
+		// Reads a byte from the EEPROM or journal.
+		uint8_t get(address_type) const;
+		// Reads an object of type T from the EEPROM or journal.
+		template<class T>
+		void get(address_type, T&) const;
+		// Writes a byte to the EEPROM or journal.
+		void put(address_type, uint8_t);
+		// Writes an object of type T to the EEPROM or journal.
+		template<class T>
+		void put(address_type, const T&);
 		// Reads an object of type T from the EEPROM.
 		template<class T>
 		std::size_t read(address_type, T&);
@@ -180,6 +346,12 @@ namespace pg
 		std::size_t read(address_type, signed char*);
 		// Reads an object of type String from the EEPROM.
 		std::size_t read(address_type, String&);
+		// Reads an array of objects of type T from the EEPROM as one block.
+		template<class T, std::size_t N>
+		std::size_t read(address_type, T(&)[N], std::true_type);
+		// Reads an array of objects of type T from the EEPROM one element at a time.
+		template<class T, std::size_t N>
+		std::size_t read(address_type, T(&)[N], std::false_type);
 		// Writes an object of type T to the EEPROM.
 		template<class T>
 		std::size_t write(address_type, const T&);
@@ -202,6 +374,12 @@ namespace pg
 		std::size_t write(address_type, const String&);
 		// Writes an object of type String to the EEPROM.
 		std::size_t write(address_type, String&);
+		// Writes an array of objects of type T to the EEPROM as one block.
+		template<class T, std::size_t N>
+		std::size_t write(address_type, const T(&)[N], std::true_type);
+		// Writes an array of objects of type T to the EEPROM one element at a time.
+		template<class T, std::size_t N>
+		std::size_t write(address_type, const T(&)[N], std::false_type);
 		// I/O manipulator "update" handler.
 		std::size_t write(address_type, update);
 		//I/O manipulator "noupdate" handler.
@@ -210,16 +388,209 @@ namespace pg
 	private:
 		address_type	address_;	// The current EEPROM read/write address.
 		bool			update_;	// Flag indicating whether to put or update data on writes.
+		EEJournal*		journal_;	// The attached journal, if any.
 	};
 
-#pragma region Implementation
+#pragma region EEJournal
+
+	EEJournal::EEJournal(uint8_t* image, size_type size, address_type base, uint8_t slots) :
+		image_(image), size_(size), base_(base), slots_(slots), current_(), seq_(), 
+		next_(size + RecordOverhead), crc_(), dirty_(), commit_()
+	{
+
+	}
+
+	bool EEJournal::begin()
+	{
+		// Find the valid record with the highest sequence number. Sequence numbers only 
+		// advance by one per commit, so they are compared across wraparound.
+
+		using value_type = typename crc_type::value_type;
+
+		const size_type record = size_ + RecordOverhead;
+		bool result = false;
+
+		if (slots_ == 0)
+		{
+			const size_type fit = EEPROM.length() > base_ ? (EEPROM.length() - base_) / record : 0;
+
+			slots_ = fit > 255 ? 255 : fit ? fit : 1;
+		}
+		for (uint8_t i = 0; i < slots_; ++i)
+		{
+			const address_type address = slot(i);
+			crc_engine<crc_type> crc;
+			seq_type seq = 0;
+			value_type check = 0;
+
+			for (size_type j = 0; j < size_ + sizeof(seq_type); ++j)
+				crc.update(EEPROM.read(address + j));
+			for (size_type j = 0; j < sizeof(seq_type); ++j)
+				seq |= static_cast<seq_type>(EEPROM.read(address + size_ + j)) << (8 * j);
+			for (size_type j = 0; j < sizeof(value_type); ++j)
+				check |= static_cast<value_type>(EEPROM.read(address + size_ + sizeof(seq_type) + j)) << (8 * j);
+			if (check == crc.value() && (!result || static_cast<int16_t>(seq - seq_) > 0))
+			{
+				current_ = i;
+				seq_ = seq;
+				result = true;
+			}
+		}
+		if (result)
+		{
+			for (size_type j = 0; j < size_; ++j)
+				image_[j] = EEPROM.read(slot(current_) + j);
+		}
+		else
+		{
+			current_ = slots_ - 1;	// The first commit writes slot 0.
+			seq_ = 0;
+		}
+		next_ = record;
+		dirty_ = commit_ = false;
+
+		return result;
+	}
+
+	void EEJournal::clock()
+	{
+		const size_type record = size_ + RecordOverhead;
+
+		if (next_ == record && commit_)
+		{
+			if (dirty_)
+			{
+				next_ = 0;	// Start a new record.
+				crc_.reset();
+				dirty_ = false;
+			}
+			commit_ = false;
+		}
+		if (next_ < record)
+		{
+# if defined __AVR__
+			// Unchanged bytes are skipped, changed ones are written one per call, 
+			// once the EEPROM has finished the previous write.
+			while (next_ < record && eeprom_is_ready() && !step());
+# else
+			while (next_ < record)
+				(void)step();
+# endif
+		}
+	}
+
+	void EEJournal::commit()
+	{
+		commit_ = true;
+	}
+
+	void EEJournal::flush()
+	{
+		while (pending())
+			clock();
+	}
+
+	bool EEJournal::pending() const
+	{
+		return next_ < size_ + RecordOverhead || (commit_ && dirty_);
+	}
+
+	uint8_t EEJournal::read(address_type address) const
+	{
+		return address < size_ ? image_[address] : 0;
+	}
+
+	void EEJournal::read(address_type address, void* data, size_type n) const
+	{
+		uint8_t* ptr = static_cast<uint8_t*>(data);
+
+		while (n--)
+			*ptr++ = read(address++);
+	}
+
+	typename EEJournal::size_type EEJournal::size() const
+	{
+		return size_;
+	}
+
+	uint8_t EEJournal::slots() const
+	{
+		return slots_;
+	}
+
+	void EEJournal::write(address_type address, uint8_t value)
+	{
+		if (address < size_ && image_[address] != value)
+		{
+			image_[address] = value;
+			dirty_ = true;
+		}
+	}
+
+	void EEJournal::write(address_type address, const void* data, size_type n)
+	{
+		const uint8_t* ptr = static_cast<const uint8_t*>(data);
+
+		while (n--)
+			write(address++, *ptr++);
+	}
+
+	typename EEJournal::address_type EEJournal::slot(uint8_t i) const
+	{
+		return base_ + i * (size_ + RecordOverhead);
+	}
+
+	bool EEJournal::step()
+	{
+		// Records are written image first, then the sequence number, then the CRC, low bytes 
+		// first. The CRC covers the bytes as they were written, so changes made to the image 
+		// during a commit are only lost to this record, and are marked dirty for the next.
+
+		const uint8_t target = current_ + 1 < slots_ ? current_ + 1 : 0;
+		const seq_type seq = seq_ + 1;
+		uint8_t value = 0;
+
+		if (next_ < size_)
+			value = image_[next_];
+		else if (next_ < size_ + sizeof(seq_type))
+			value = static_cast<uint8_t>(seq >> (8 * (next_ - size_)));
+		else
+			value = static_cast<uint8_t>(crc_.value() >> (8 * (next_ - size_ - sizeof(seq_type))));
+		if (next_ < size_ + sizeof(seq_type))
+			crc_.update(value);
+
+		const address_type address = slot(target) + next_;
+		const bool result = EEPROM.read(address) != value;
+
+		if (result)
+			EEPROM.write(address, value);
+		if (++next_ == size_ + RecordOverhead)
+		{
+			current_ = target;	// The record is complete.
+			seq_ = seq;
+# if defined __PG_EEPROM_COMMIT
+			(void)EEPROM.commit();
+# endif
+		}
+
+		return result;
+	}
+
+#pragma endregion
+#pragma region EEStream
 
 	EEStream::EEStream() : 
-		address_(), update_() 
+		address_(), update_(), journal_()
 	{
 	
 	}
 
+	EEStream::EEStream(EEJournal& journal) : 
+		address_(), update_(), journal_(&journal)
+	{
+
+	}
+
 	typename EEStream::address_type& EEStream::address()
 	{
 		return address_;
@@ -235,6 +606,114 @@ namespace pg
 		address_ = 0;
 	}
 
+	EEJournal* EEStream::journal() const
+	{
+		return journal_;
+	}
+
+	void EEStream::journal(EEJournal* journal)
+	{
+		journal_ = journal;
+	}
+
+	void EEStream::commit()
+	{
+		if (journal_)
+			journal_->commit();
+# if defined __PG_EEPROM_COMMIT
+		else
+			(void)EEPROM.commit();
+# endif
+	}
+
+	EEStream& EEStream::read(void* data, std::size_t n)
+	{
+		get(address_, data, n);
+		address_ += n;
+
+		return *this;
+	}
+
+	EEStream& EEStream::write(const void* data, std::size_t n)
+	{
+		put(address_, data, n);
+		address_ += n;
+
+		return *this;
+	}
+
+	void EEStream::flush()
+	{
+		if (journal_)
+			journal_->flush();
+	}
+
+	void EEStream::get(address_type address, void* data, std::size_t n) const
+	{
+		if (journal_)
+			journal_->read(address, data, n);
+		else
+		{
+# if defined __AVR__
+			eeprom_read_block(data, reinterpret_cast<const void*>(address), n);
+# else
+			uint8_t* ptr = static_cast<uint8_t*>(data);
+
+			while (n--)
+				*ptr++ = EEPROM.read(address++);
+# endif
+		}
+	}
+
+	void EEStream::put(address_type address, const void* data, std::size_t n)
+	{
+		// Journals only mark bytes that change, so journaled writes are always updates.
+
+		if (journal_)
+			journal_->write(address, data, n);
+		else
+		{
+# if defined __AVR__
+			if (update_)
+				eeprom_update_block(data, reinterpret_cast<void*>(address), n);
+			else
+				eeprom_write_block(data, reinterpret_cast<void*>(address), n);
+# else
+			const uint8_t* ptr = static_cast<const uint8_t*>(data);
+
+			for (; n--; ++address, ++ptr)
+				update_ ? EEPROM.update(address, *ptr) : EEPROM.write(address, *ptr);
+# endif
+		}
+	}
+
+	uint8_t EEStream::get(address_type address) const
+	{
+		return journal_ ? journal_->read(address) : EEPROM.read(address);
+	}
+
+	template<class T>
+	void EEStream::get(address_type address, T& value) const
+	{
+		get(address, &value, sizeof(value));
+	}
+
+	void EEStream::put(address_type address, uint8_t value)
+	{
+		if (journal_)
+			journal_->write(address, value);
+		else if (update_)
+			EEPROM.update(address, value);
+		else
+			EEPROM.write(address, value);
+	}
+
+	template<class T>
+	void EEStream::put(address_type address, const T& value)
+	{
+		put(address, &value, sizeof(value));
+	}
+
 	template<class T>
 	EEStream& EEStream::operator<<(const T& t)
 	{
@@ -254,8 +733,7 @@ namespace pg
 	template<class T, std::size_t N>
 	EEStream& EEStream::operator<<(const T(&t)[N])
 	{
-		for (std::size_t i = 0; i < N; ++i)
-			address_ += write(address_, t[i]);
+		address_ += write(address_, t, is_block<T>());
 
 		return *this;
 	}
@@ -263,8 +741,7 @@ namespace pg
 	template<class T, std::size_t N>
 	EEStream& EEStream::operator>>(T(&t)[N])
 	{
-		for (std::size_t i = 0; i < N; ++i)
-			address_ += read(address_, t[i]);
+		address_ += read(address_, t, is_block<T>());
 
 		return *this;
 	}
@@ -272,19 +749,31 @@ namespace pg
 	template<class T>
 	std::size_t EEStream::read(address_type address, T& value)
 	{
-		EEPROM.get(address, value);
+		get(address, value);
 
 		return sizeof(value);
 	}
 
 	std::size_t EEStream::read(address_type address, char* value)
 	{
-		// C-strings are read as individual chars including the trailing NULL.
+		// C-strings are read in blocks, up to and including the trailing NULL.
 
 		address_type first = address;
+		const char* end = nullptr;
+
+		do
+		{
+			char buf[BlockSize];
+
+			get(address, buf, sizeof(buf));
+			end = static_cast<const char*>(std::memchr(buf, '\0', sizeof(buf)));
+
+			const std::size_t n = end ? end - buf + 1 : sizeof(buf);
 
-		while ((*value++ = static_cast<char>(EEPROM.read(address++))));
-		*value = '\0';
+			std::memcpy(value, buf, n);
+			value += n;
+			address += n;
+		} while (!end);
 
 		return address - first;
 	}
@@ -304,29 +793,45 @@ namespace pg
 		// String objects are read as C-strings.
 
 		address_type first = address;
-		char c = '\0';
+		const char* end = nullptr;
 
-		while ((c = EEPROM.read(address++)))
-			value += c;
+		do
+		{
+			char buf[BlockSize];
+
+			get(address, buf, sizeof(buf));
+			end = static_cast<const char*>(std::memchr(buf, '\0', sizeof(buf)));
+			for (const char* c = buf; c < (end ? end : buf + sizeof(buf)); ++c)
+				value += *c;
+			address += end ? end - buf + 1 : sizeof(buf);
+		} while (!end);
 
 		return address - first;
 	}
 
-	template<class T>
-	std::size_t EEStream::write(address_type address, const T& value)
+	template<class T, std::size_t N>
+	std::size_t EEStream::read(address_type address, T(&t)[N], std::true_type)
 	{
-		// Arduino update() only works byte-at-a-time, so we use this workaround.
-		// T must be equal comparable.
+		get(address, t, sizeof(t));
 
-		if (update_)
-		{
-			T t = EEPROM.get(address, t);
+		return sizeof(t);
+	}
 
-			if(!(t == value))
-				(void)EEPROM.put(address, value);
-		}
-		else 
-			(void)EEPROM.put(address, value);
+	template<class T, std::size_t N>
+	std::size_t EEStream::read(address_type address, T(&t)[N], std::false_type)
+	{
+		address_type first = address;
+
+		for (std::size_t i = 0; i < N; ++i)
+			address += read(address, t[i]);
+
+		return address - first;
+	}
+
+	template<class T>
+	std::size_t EEStream::write(address_type address, const T& value)
+	{
+		put(address, value);
 
 		return sizeof(value);
 	}
@@ -339,15 +844,13 @@ namespace pg
 
 	std::size_t EEStream::write(address_type address, const char* value)
 	{
-		// C-strings are written as individual chars including the trailing NULL.
+		// C-strings are written as one block including the trailing NULL.
 
-		address_type first = address;
+		const std::size_t n = std::strlen(value) + 1;
 
-		while (*value)
-			(update_) ? EEPROM.update(address++, *value++) : EEPROM.write(address++, *value++);
-		(update_) ? EEPROM.update(address++, '\0') : EEPROM.write(address++, '\0');
+		put(address, value, n);
 
-		return address - first;
+		return n;
 	}
 
 	std::size_t EEStream::write(address_type address, char* value)
@@ -387,6 +890,25 @@ namespace pg
 		return write(address, const_cast<const String&>(value));
 	}
 
+	template<class T, std::size_t N>
+	std::size_t EEStream::write(address_type address, const T(&t)[N], std::true_type)
+	{
+		put(address, t, sizeof(t));
+
+		return sizeof(t);
+	}
+
+	template<class T, std::size_t N>
+	std::size_t EEStream::write(address_type address, const T(&t)[N], std::false_type)
+	{
+		address_type first = address;
+
+		for (std::size_t i = 0; i < N; ++i)
+			address += write(address, t[i]);
+
+		return address - first;
+	}
+
 	std::size_t EEStream::write(address_type address, update)
 	{
 		update_ = true;
@@ -0,0 +1,238 @@
+/*
+ *	This files defines a queued, allocation-free event bus mediator.
+ *
+ *	***************************************************************************
+ *
+ *	File: EventBus.h
+ *	Date: October 14, 2026
+ *	Version: 1.0
+ *	Author: Michael Brodsky
+ *	Email: mbrodskiis@gmail.com
+ *	Copyright (c) 2012-2022 Michael Brodsky
+ *
+ *	***************************************************************************
+ *
+ *  This file is part of "Pretty Good" (Pg). "Pg" is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  This file is distributed in the hope that it will be useful, but
+ *	WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this file. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *	**************************************************************************
+ *
+ *	Description:
+ *
+ *	The `EventBus' class is a mediator (see <interfaces/imediator.h>) that
+ *	decouples the components that raise events from those that handle them.
+ *	Events are identified by integer or enumerated ids of type `Id', and
+ *	carry an integer argument, wide enough to hold a pointer, and the
+ *	sending component, if any.
+ *
+ *	Publishing an event only copies it into a fixed-capacity queue of N
+ *	events, so it is cheap and can be done from interrupt handlers. Queued
+ *	events are dispatched in order to the subscribers of their id by the
+ *	`dispatch()' or `clock()' methods, from the main loop or a scheduled
+ *	task, so a slow handler never delays the sender. Each dispatch only
+ *	handles the events queued before it began, so handlers can publish
+ *	events of their own. Up to M subscriptions, each an id and a callback,
+ *	can be made. If the queue is full, events are dropped and counted.
+ *
+ *		enum class Events : uint8_t { Key = 1, Input, Refresh };
+ *		using Bus = EventBus<Events>;
+ *
+ *		Bus bus;
+ *		void onKey(const Bus::Event& e) { display.show(e.arg_); }
+ *		...
+ *		bus.subscribe(Events::Key, &onKey);
+ *		bus.publish(Events::Key, '5');	// From a keypad callback or an ISR.
+ *		...
+ *		bus.dispatch();					// Calls onKey(), from loop().
+ *
+ *	Components that call notify() on their mediator publish an event with
+ *	the id Id(), whose argument is the notification pointer, so those
+ *	components can use an EventBus without changes. The queue is guarded
+ *	by a `core_lock' (see <system/multicore.h>), which disables interrupts
+ *	for the few cycles it takes to copy an event.
+ *
+ *	**************************************************************************/
+
+#if !defined __PG_EVENTBUS_H
+# define __PG_EVENTBUS_H 20261014L
+
+# include <cstddef>					// std::size_t
+# include <cstdint>					// Fixed-width integer types.
+# include <lib/callback.h>			// callback function signatures.
+# include <interfaces/imediator.h>	// imediator interface.
+# include <interfaces/iclockable.h>	// iclockable interface.
+# include <system/multicore.h>		// core_lock, spsc_queue types.
+
+# if defined __PG_HAS_NAMESPACES
+
+namespace pg
+{
+	// Queued, allocation-free event bus mediator.
+	template<class Id = uint8_t, std::size_t N = 16, std::size_t M = 8>
+	class EventBus : public imediator, public iclockable
+	{
+	public:
+		using id_type = Id;
+		using arg_type = intptr_t;
+		using size_type = std::size_t;
+
+		// Encapsulates information about an event.
+		struct Event
+		{
+			id_type		id_;		// Event id.
+			arg_type	arg_;		// Event argument.
+			icomponent*	sender_;	// Sending component, if any.
+		};
+
+		using callback_type = typename callback<void, void, const Event&>::type;
+
+	public:
+		// Constructs an event bus with no subscriptions.
+		EventBus();
+		EventBus(const EventBus&) = delete;
+		EventBus& operator=(const EventBus&) = delete;
+
+	public:
+		// Queues an event and returns true, or returns false if the queue is full. Interrupt-safe.
+		bool publish(id_type, arg_type = 0, icomponent* = nullptr) const;
+		// Queues a component notification as an event with the id Id(). Interrupt-safe.
+		void notify(icomponent*, const notification) const override;
+		// Subscribes a callback to an event id and returns true, or returns false if there are no free subscriptions.
+		bool subscribe(id_type, callback_type);
+		// Unsubscribes a callback from an event id.
+		void unsubscribe(id_type, callback_type);
+		// Dispatches the queued events to their subscribers and returns the number of events dispatched.
+		size_type dispatch();
+		// Returns the number of queued events.
+		size_type pending() const;
+		// Returns the number of events dropped because the queue was full.
+		size_type dropped() const;
+		// Returns the maximum number of queued events.
+		constexpr size_type capacity() const { return N; }
+
+	private:
+		// Calls the `dispatch()' method.
+		void clock() override;
+
+	private:
+		// Encapsulates information about a subscription.
+		struct Subscription
+		{
+			id_type			id_;		// Subscribed event id.
+			callback_type	callback_;	// Subscriber callback.
+		};
+
+		mutable spsc_queue<Event, N>	queue_;			// Queued events, producers are serialized by lock_.
+		mutable core_lock				lock_;			// Serializes publishers.
+		mutable volatile uint16_t		dropped_;		// Number of dropped events.
+		Subscription					subs_[M];		// Subscriptions.
+		size_type						subs_size_;		// Number of subscriptions.
+	};
+
+#pragma region member_funcs
+
+	template<class Id, std::size_t N, std::size_t M>
+	EventBus<Id, N, M>::EventBus() :
+		queue_(), lock_(), dropped_(), subs_(), subs_size_()
+	{
+
+	}
+
+	template<class Id, std::size_t N, std::size_t M>
+	bool EventBus<Id, N, M>::publish(id_type id, arg_type arg, icomponent* sender) const
+	{
+		core_lock_guard guard(lock_);
+		const bool queued = queue_.push(Event{ id, arg, sender });
+
+		if (!queued)
+			dropped_ = dropped_ + 1;
+
+		return queued;
+	}
+
+	template<class Id, std::size_t N, std::size_t M>
+	void EventBus<Id, N, M>::notify(icomponent* sender, const notification event) const
+	{
+		(void)publish(id_type(), reinterpret_cast<arg_type>(event), sender);
+	}
+
+	template<class Id, std::size_t N, std::size_t M>
+	bool EventBus<Id, N, M>::subscribe(id_type id, callback_type callback)
+	{
+		bool result = subs_size_ < M;
+
+		if (result)
+			subs_[subs_size_++] = Subscription{ id, callback };
+
+		return result;
+	}
+
+	template<class Id, std::size_t N, std::size_t M>
+	void EventBus<Id, N, M>::unsubscribe(id_type id, callback_type callback)
+	{
+		for (size_type i = 0; i < subs_size_; ++i)
+		{
+			if (subs_[i].id_ == id && subs_[i].callback_ == callback)
+			{
+				for (size_type j = i + 1; j < subs_size_; ++j)
+					subs_[j - 1] = subs_[j];	// Keep subscriptions in order.
+				--subs_size_;
+				break;
+			}
+		}
+	}
+
+	template<class Id, std::size_t N, std::size_t M>
+	typename EventBus<Id, N, M>::size_type EventBus<Id, N, M>::dispatch()
+	{
+		const size_type queued = queue_.size();	// Events published by handlers wait for the next dispatch.
+		size_type n = 0;
+		Event event;
+
+		while (n < queued && queue_.pop(event))
+		{
+			++n;
+			for (size_type i = 0; i < subs_size_; ++i)
+				if (subs_[i].id_ == event.id_)
+					(*subs_[i].callback_)(event);
+		}
+
+		return n;
+	}
+
+	template<class Id, std::size_t N, std::size_t M>
+	typename EventBus<Id, N, M>::size_type EventBus<Id, N, M>::pending() const
+	{
+		return queue_.size();
+	}
+
+	template<class Id, std::size_t N, std::size_t M>
+	typename EventBus<Id, N, M>::size_type EventBus<Id, N, M>::dropped() const
+	{
+		core_lock_guard guard(lock_);	// 16-bit reads are not atomic on AVR.
+
+		return dropped_;
+	}
+
+	template<class Id, std::size_t N, std::size_t M>
+	void EventBus<Id, N, M>::clock()
+	{
+		(void)dispatch();
+	}
+
+#pragma endregion
+} // namespace pg
+
+# endif // defined __PG_HAS_NAMESPACES
+
+#endif // !defined __PG_EVENTBUS_H
@@ -0,0 +1,355 @@
+/*
+ *	This file defines several allocation-free digital filter classes.
+ *
+ *	***************************************************************************
+ *
+ *	File: Filters.h
+ *	Date: October 14, 2026
+ *	Version: 1.0
+ *	Author: Michael Brodsky
+ *	Email: mbrodskiis@gmail.com
+ *	Copyright (c) 2012-2022 Michael Brodsky
+ *
+ *	***************************************************************************
+ *
+ *  This file is part of "Pretty Good" (Pg). "Pg" is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  This file is distributed in the hope that it will be useful, but
+ *	WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *	along with this file. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *	**************************************************************************
+ *
+ *	Description:
+ *
+ *	This file defines three filters with the same interface as
+ *	`MovingAverage' (see <utilities/MovingAverage.h>), that are cheaper in
+ *	memory or cycles:
+ *
+ *	`ExponentialAverage<T, K>' is a first-order IIR filter with a smoothing
+ *	factor of 1/2^K. It stores only its internal sum and needs no division.
+ *
+ *	`BoxcarAverage<T, N>' is a moving average whose number of taps N is a
+ *	power of two, so the sum is scaled with a shift instead of a division
+ *	for integral types.
+ *
+ *	`MedianFilter<T, N>' outputs the median of the last N values, which
+ *	rejects spikes shorter than N / 2 samples. N must be odd and is meant to
+ *	be small, as each update takes O(N) time.
+ *
+ *	For integral types T, the filters keep their internal sums in 32-bit
+ *	integers, with the same signedness as T. The `out(first, last)' method
+ *	overloads update the filters with a range of values and return the
+ *	resulting output state.
+ *
+ *****************************************************************************/
+
+#if !defined __PG_FILTERS_H
+# define __PG_FILTERS_H 20261014L
+
+# include <cstdint>		// Fixed-width integer types.
+# include <type_traits>	// Type traits.
+
+namespace pg
+{
+	namespace details
+	{
+		// Type that holds filter sums of type T.
+		template<class T>
+		using filter_sum_t = typename std::conditional<std::is_integral<T>::value,
+			typename std::conditional<std::is_signed<T>::value, int32_t, uint32_t>::type, T>::type;
+
+		// Divides an integral sum by 2^Shift.
+		template<uint8_t Shift, class T>
+		constexpr T filter_scale(T sum, std::true_type)
+		{
+			return sum >> Shift;
+		}
+
+		// Divides a floating point sum by 2^Shift.
+		template<uint8_t Shift, class T>
+		constexpr T filter_scale(T sum, std::false_type)
+		{
+			return sum / static_cast<T>(1UL << Shift);
+		}
+
+		template<uint8_t Shift, class T>
+		constexpr T filter_scale(T sum)
+		{
+			return filter_scale<Shift>(sum, std::integral_constant<bool, std::is_integral<T>::value>());
+		}
+
+		// Returns the base 2 logarithm of a power of two.
+		constexpr uint8_t filter_log2(std::size_t n)
+		{
+			return n > 1 ? 1 + filter_log2(n >> 1) : 0;
+		}
+	} // namespace details
+
+	// First-order IIR filter with a smoothing factor of 1/2^K.
+	template<class T, uint8_t K = 3>
+	class ExponentialAverage
+	{
+	public:
+		using value_type = T;
+		using sum_type = details::filter_sum_t<T>;
+
+	public:
+		// Constructs an empty filter.
+		ExponentialAverage();
+
+	public:
+		// Seeds the filter with a value.
+		void seed(value_type);
+		// Updates the filter state with a value and returns the resulting output state.
+		const value_type& out(const value_type&);
+		// Updates the filter state with a range of values and returns the resulting output state.
+		template<class InputIt>
+		const value_type& out(InputIt, InputIt);
+		// Returns the current filter output state.
+		const value_type& out() const;
+
+	private:
+		value_type	avg_;	// The filter's current output state.
+		sum_type	sum_;	// The filter's current internal sum, scaled by 2^K.
+	};
+
+	// Moving average filter with a power of two number of taps.
+	template<class T, std::size_t N>
+	class BoxcarAverage
+	{
+		static_assert(N > 0 && (N & (N - 1)) == 0, "BoxcarAverage size must be a power of two.");
+
+	public:
+		using value_type = T;
+		using sum_type = details::filter_sum_t<T>;
+
+		static constexpr uint8_t Shift = details::filter_log2(N);	// Base 2 logarithm of N.
+
+	public:
+		// Constructs an empty filter.
+		BoxcarAverage();
+
+	public:
+		// Seeds the filter with a value.
+		void seed(value_type);
+		// Seeds the filter with values from an array beginning at a pointer.
+		void seed(const value_type*);
+		// Updates the filter state with a value and returns the resulting output state.
+		const value_type& out(const value_type&);
+		// Updates the filter state with a range of values and returns the resulting output state.
+		template<class InputIt>
+		const value_type& out(InputIt, InputIt);
+		// Returns the current filter output state.
+		const value_type& out() const;
+
+	private:
+		value_type	data_[N];	// Historical data buffer.
+		std::size_t	head_;		// Index of the oldest value in the data buffer.
+		value_type	avg_;		// The filter's current output state.
+		sum_type	sum_;		// The filter's current internal sum.
+	};
+
+	// Running median filter over an odd number of values.
+	template<class T, std::size_t N = 5>
+	class MedianFilter
+	{
+		static_assert(N % 2 == 1, "MedianFilter size must be odd.");
+
+	public:
+		using value_type = T;
+
+	public:
+		// Constructs an empty filter.
+		MedianFilter();
+
+	public:
+		// Seeds the filter with a value.
+		void seed(value_type);
+		// Seeds the filter with values from an array beginning at a pointer.
+		void seed(const value_type*);
+		// Updates the filter state with a value and returns the resulting output state.
+		const value_type& out(const value_type&);
+		// Updates the filter state with a range of values and returns the resulting output state.
+		template<class InputIt>
+		const value_type& out(InputIt, InputIt);
+		// Returns the current filter output state.
+		const value_type& out() const;
+
+	private:
+		value_type	data_[N];	// Historical data buffer, in arrival order.
+		value_type	sorted_[N];	// Historical data, in ascending order.
+		std::size_t	head_;		// Index of the oldest value in the data buffer.
+	};
+
+#pragma region ExponentialAverage
+
+	template<class T, uint8_t K>
+	ExponentialAverage<T, K>::ExponentialAverage() : avg_(), sum_()
+	{
+
+	}
+
+	template<class T, uint8_t K>
+	void ExponentialAverage<T, K>::seed(value_type seed)
+	{
+		sum_ = static_cast<sum_type>(seed) * static_cast<sum_type>(1UL << K);
+		avg_ = seed;
+	}
+
+	template<class T, uint8_t K>
+	const typename ExponentialAverage<T, K>::value_type& ExponentialAverage<T, K>::out(const value_type& value)
+	{
+		sum_ += static_cast<sum_type>(value) - details::filter_scale<K>(sum_);
+
+		return (avg_ = static_cast<value_type>(details::filter_scale<K>(sum_)));
+	}
+
+	template<class T, uint8_t K>
+	template<class InputIt>
+	const typename ExponentialAverage<T, K>::value_type& ExponentialAverage<T, K>::out(InputIt first, InputIt last)
+	{
+		while (first != last)
+			out(*first++);
+
+		return avg_;
+	}
+
+	template<class T, uint8_t K>
+	const typename ExponentialAverage<T, K>::value_type& ExponentialAverage<T, K>::out() const
+	{
+		return avg_;
+	}
+
+#pragma endregion
+#pragma region BoxcarAverage
+
+	template<class T, std::size_t N>
+	BoxcarAverage<T, N>::BoxcarAverage() : data_(), head_(), avg_(), sum_()
+	{
+
+	}
+
+	template<class T, std::size_t N>
+	void BoxcarAverage<T, N>::seed(value_type seed)
+	{
+		for (auto& i : data_)
+			i = seed;
+		sum_ = static_cast<sum_type>(seed) * static_cast<sum_type>(N);
+		avg_ = seed;
+	}
+
+	template<class T, std::size_t N>
+	void BoxcarAverage<T, N>::seed(const value_type* seed)
+	{
+		sum_ = sum_type();
+		for (auto& i : data_)
+			sum_ += (i = *seed++);
+		head_ = 0;
+		avg_ = static_cast<value_type>(details::filter_scale<Shift>(sum_));
+	}
+
+	template<class T, std::size_t N>
+	const typename BoxcarAverage<T, N>::value_type& BoxcarAverage<T, N>::out(const value_type& value)
+	{
+		sum_ += static_cast<sum_type>(value) - static_cast<sum_type>(data_[head_]);
+		data_[head_] = value;
+		head_ = (head_ + 1) & (N - 1);
+
+		return (avg_ = static_cast<value_type>(details::filter_scale<Shift>(sum_)));
+	}
+
+	template<class T, std::size_t N>
+	template<class InputIt>
+	const typename BoxcarAverage<T, N>::value_type& BoxcarAverage<T, N>::out(InputIt first, InputIt last)
+	{
+		while (first != last)
+			out(*first++);
+
+		return avg_;
+	}
+
+	template<class T, std::size_t N>
+	const typename BoxcarAverage<T, N>::value_type& BoxcarAverage<T, N>::out() const
+	{
+		return avg_;
+	}
+
+#pragma endregion
+#pragma region MedianFilter
+
+	template<class T, std::size_t N>
+	MedianFilter<T, N>::MedianFilter() : data_(), sorted_(), head_()
+	{
+
+	}
+
+	template<class T, std::size_t N>
+	void MedianFilter<T, N>::seed(value_type seed)
+	{
+		for (std::size_t i = 0; i < N; ++i)
+			data_[i] = sorted_[i] = seed;
+		head_ = 0;
+	}
+
+	template<class T, std::size_t N>
+	void MedianFilter<T, N>::seed(const value_type* seed)
+	{
+		for (std::size_t i = 0; i < N; ++i)
+		{
+			std::size_t j = i;
+
+			data_[i] = seed[i];
+			for (; j > 0 && seed[i] < sorted_[j - 1]; --j)
+				sorted_[j] = sorted_[j - 1];
+			sorted_[j] = seed[i];
+		}
+		head_ = 0;
+	}
+
+	template<class T, std::size_t N>
+	const typename MedianFilter<T, N>::value_type& MedianFilter<T, N>::out(const value_type& value)
+	{
+		std::size_t i = 0;
+
+		while (sorted_[i] != data_[head_])	// Find the oldest value, which must be present.
+			++i;
+		for (; i + 1 < N && sorted_[i + 1] < value; ++i)	// Shift larger values down past the removed slot ...
+			sorted_[i] = sorted_[i + 1];
+		for (; i > 0 && value < sorted_[i - 1]; --i)		// ... or smaller values up into it.
+			sorted_[i] = sorted_[i - 1];
+		sorted_[i] = value;
+		data_[head_] = value;
+		if (++head_ == N)
+			head_ = 0;
+
+		return out();
+	}
+
+	template<class T, std::size_t N>
+	template<class InputIt>
+	const typename MedianFilter<T, N>::value_type& MedianFilter<T, N>::out(InputIt first, InputIt last)
+	{
+		while (first != last)
+			out(*first++);
+
+		return out();
+	}
+
+	template<class T, std::size_t N>
+	const typename MedianFilter<T, N>::value_type& MedianFilter<T, N>::out() const
+	{
+		return sorted_[N / 2];
+	}
+
+#pragma endregion
+} // namespace pg
+
+#endif // !defined __PG_FILTERS_H
@@ -31,12 +31,15 @@
 #if !defined __PG_INTERPRETER_H
 # define __PG_INTERPRETER_H 20220525L
 
-# include <cstdlib>					// atoi(), atol(), atof()
+# include <cstdlib>					// std::from_chars()
+# include <cstring>					// memchr(), memcpy(), strcmp()
 # include <array>					// Fixed-size sequence containers.
 # include <tuple>					// Command args storage class.
-# include <lib/strtok.h>			// Non-mangling strtok().
+# include <lib/tokenizer.h>			// Non-copying tokenizer.
 # include <lib/imath.h>				// isignof()
+# include <lib/fixed.h>				// Fixed-point args.
 # include <interfaces/icommand.h>	// Command pattern interface.
+# include <utilities/Profiler.h>	// PG_PROFILE_SCOPE
 
 namespace pg
 {
@@ -84,102 +87,231 @@ namespace pg
 			arg = tok;
 		}
 
-		void getArg(const char* tok, bool& arg)
+		// Numeric args are parsed with from_chars(), integers may have a 0x or 0b prefix.
+
+		template<class T>
+		typename std::enable_if<std::is_integral<T>::value, std::from_chars_result>::type
+			fromChars(const char* first, const char* last, T& value)
+		{
+			return std::from_chars(first, last, value, 0);
+		}
+
+		template<class T>
+		typename std::enable_if<std::is_floating_point<T>::value, std::from_chars_result>::type
+			fromChars(const char* first, const char* last, T& value)
 		{
-			arg = static_cast<bool>(std::atoi(tok));
+			return std::from_chars(first, last, value);
 		}
 
-		void getArg(const char* tok, char& arg)
+		template<int I, int F>
+		std::from_chars_result fromChars(const char* first, const char* last, fixed<I, F>& value)
 		{
-			arg = static_cast<char>(std::atoi(tok));
+			return pg::from_chars(first, last, value);
 		}
 
-		void getArg(const char* tok, unsigned char& arg)
+		// Converts a numeric token, invalid and out of range values are converted to zero.
+		template<class T>
+		void getNumber(const char* tok, T& arg)
 		{
-			arg = static_cast<unsigned char>(std::atoi(tok));
+			while (*tok == ' ')
+				++tok;
+			if (*tok == '+')
+				++tok;
+			if (fromChars(tok, tok + std::strlen(tok), arg).ec != std::errc())
+				arg = T();
 		}
 
-		void getArg(const char* tok, signed char& arg)
+		void getArg(const char* tok, bool& arg)
 		{
-			arg = static_cast<signed char>(std::atoi(tok));
+			int value = 0;
+
+			getNumber(tok, value);
+			arg = value != 0;
 		}
 
-		void getArg(const char* tok, short& arg)
+		template<class T>
+		typename std::enable_if<std::is_arithmetic<T>::value>::type
+			getArg(const char* tok, T& arg)
 		{
-			arg = static_cast<short>(std::atoi(tok));
+			getNumber(tok, arg);
 		}
 
-		void getArg(const char* tok, unsigned short& arg)
+		template<int I, int F>
+		void getArg(const char* tok, fixed<I, F>& arg)
 		{
-			arg = static_cast<unsigned short>(std::atoi(tok));
+			getNumber(tok, arg);
 		}
 
-		void getArg(const char* tok, int& arg)
+		// Numeric args are converted straight from the token, string args must be terminated in place.
+
+		template<class T>
+		char* getToken(tokenizer& tok, T&)
 		{
-			arg = std::atoi(tok);
+			return tok.token();
 		}
 
-		void getArg(const char* tok, unsigned int& arg)
+		char* getToken(tokenizer& tok, const char*&)
 		{
-			arg = static_cast<unsigned int>(std::atoi(tok));
+			return tok.terminate();
 		}
 
-		void getArg(const char* tok, long& arg)
+		char* getToken(tokenizer& tok, char*&)
 		{
-			arg = std::atol(tok);
+			return tok.terminate();
 		}
 
-		void getArg(const char* tok, unsigned long& arg)
+		template<std::size_t I = 0, class...Ts>
+		typename std::enable_if<I == sizeof...(Ts), uint8_t>::type
+			getArgs(tokenizer&, const char*, std::tuple<Ts...>&)
+		{
+			return I;	// End case, all args found.
+		}
+
+		template<std::size_t I = 0, class...Ts>
+		typename std::enable_if <I < sizeof...(Ts), uint8_t>::type
+			getArgs(tokenizer& tok, const char* delim, std::tuple<Ts...>& args)
 		{
-			arg = static_cast<unsigned long>(std::atol(tok));
+			uint8_t i = 0;
+			char* arg = nullptr;
+
+			if (tok.next(delim) && (arg = getToken(tok, std::get<I>(args))))
+			{
+				getArg(arg, std::get<I>(args));
+				i = getArgs<I + 1, Ts...>(tok, delim, args);	// Recurse until all args found or no more to parse.
+			}
+
+			return i;
 		}
 
-		void getArg(const char* tok, long long& arg)
+		// Binary args are packed little-endian, the native byte order of all supported architectures.
+
+		template<class T>
+		typename std::enable_if<std::is_arithmetic<T>::value, bool>::type
+			getArg(const uint8_t*& first, const uint8_t* last, T& arg)
 		{
-			arg = static_cast<long long>(std::atol(tok));
+			bool result = static_cast<std::size_t>(last - first) >= sizeof(T);
+
+			if (result)
+			{
+				std::memcpy(&arg, first, sizeof(T));
+				first += sizeof(T);
+			}
+
+			return result;
 		}
 
-		void getArg(const char* tok, unsigned long long& arg)
+		template<int I, int F>
+		bool getArg(const uint8_t*& first, const uint8_t* last, fixed<I, F>& arg)
 		{
-			arg = static_cast<unsigned long long>(std::atol(tok));
+			// Fixed-point args are packed as their raw value.
+			typename fixed<I, F>::rep raw = 0;
+			bool result = getArg(first, last, raw);
+
+			if (result)
+				arg = fixed<I, F>::from_raw(raw);
+
+			return result;
 		}
 
-		void getArg(const char* tok, float& arg)
+		bool getArg(const uint8_t*& first, const uint8_t* last, bool& arg)
 		{
-			arg = static_cast<float>(std::atof(tok));
+			bool result = first < last;
+
+			if (result)
+				arg = static_cast<bool>(*first++);
+
+			return result;
 		}
 
-		void getArg(const char* tok, double& arg)
+		bool getArg(const uint8_t*& first, const uint8_t* last, const char*& arg)
 		{
-			arg = std::atof(tok);
+			// Strings are packed with their null terminator.
+			const uint8_t* end = static_cast<const uint8_t*>(std::memchr(first, '\0', last - first));
+
+			if (end)
+			{
+				arg = reinterpret_cast<const char*>(first);
+				first = end + 1;
+			}
+
+			return end != nullptr;
 		}
 
-		void getArg(const char* tok, long double& arg)
+		bool getArg(const uint8_t*& first, const uint8_t* last, char*& arg)
 		{
-			arg = static_cast<long double>(std::atof(tok));
+			const char* str = nullptr;
+			bool result = getArg(first, last, str);
+
+			arg = const_cast<char*>(str);
+
+			return result;
 		}
 
 		template<std::size_t I = 0, class...Ts>
 		typename std::enable_if<I == sizeof...(Ts), uint8_t>::type
-			getArgs(const char* delim, std::tuple<Ts...>& args)
+			getArgs(const uint8_t*, const uint8_t*, std::tuple<Ts...>&)
 		{
 			return I;	// End case, all args found.
 		}
 
 		template<std::size_t I = 0, class...Ts>
 		typename std::enable_if <I < sizeof...(Ts), uint8_t>::type
-			getArgs(const char* delim, std::tuple<Ts...>& args)
+			getArgs(const uint8_t* first, const uint8_t* last, std::tuple<Ts...>& args)
 		{
-			uint8_t i = 0;	// Prob should be i = I
-			char* tok = std::strtok(nullptr, delim);
+			uint8_t i = 0;
 
-			if (tok)
+			if (getArg(first, last, std::get<I>(args)))
+				i = getArgs<I + 1, Ts...>(first, last, args);	// Recurse until all args found or no more to unpack.
+
+			return i;
+		}
+
+		template<class T>
+		typename std::enable_if<std::is_arithmetic<T>::value, bool>::type
+			putArg(uint8_t*& first, const uint8_t* last, T arg)
+		{
+			bool result = static_cast<std::size_t>(last - first) >= sizeof(T);
+
+			if (result)
 			{
-				getArg(tok, std::get<I>(args));
-				i = getArgs<I + 1, Ts...>(delim, args);	// Recurse until all args found or no more to parse.
+				std::memcpy(first, &arg, sizeof(T));
+				first += sizeof(T);
 			}
 
-			return i;
+			return result;
+		}
+
+		template<int I, int F>
+		bool putArg(uint8_t*& first, const uint8_t* last, fixed<I, F> arg)
+		{
+			return putArg(first, last, arg.raw());
+		}
+
+		bool putArg(uint8_t*& first, const uint8_t* last, const char* arg)
+		{
+			std::size_t n = std::strlen(arg) + sizeof(char);
+			bool result = static_cast<std::size_t>(last - first) >= n;
+
+			if (result)
+			{
+				std::memcpy(first, arg, n);
+				first += n;
+			}
+
+			return result;
+		}
+
+		inline uint8_t* putArgs(uint8_t* first, const uint8_t*)
+		{
+			return first;	// End case, all args packed.
+		}
+
+		template<class T, class...Ts>
+		uint8_t* putArgs(uint8_t* first, const uint8_t* last, T arg, Ts... args)
+		{
+			return putArg(first, last, arg) 
+				? putArgs(first, last, args...) 
+				: first;	// Stop at the first arg that doesn't fit.
 		}
 	} // namespace details
 
@@ -187,12 +319,31 @@ namespace pg
 	class Interpreter
 	{
 	public:
+		using hash_type = uint32_t;	// Type that can hold a packed command key.
+		using size_type = uint8_t;
+
+		static constexpr size_type KeySizeMax = sizeof(hash_type);	// Longest command key that is packed exactly, in characters.
+		static constexpr hash_type NoKey = 0;						// Hash value of empty keys.
+
+		// Packs up to KeySizeMax characters of a key into an integer. Longer keys 
+		// are hashed in full, with the top bit set so they never equal a packed 
+		// ASCII key.
+		static constexpr hash_type hash(const char* key, std::size_t n)
+		{
+			return n > KeySizeMax ? fnv(key, n, FnvBasis) | LongKeyBit : pack(key, n);
+		}
+
+		static constexpr hash_type hash(const char* key)
+		{
+			return hash(key, length(key));
+		}
+
 		class CommandBase : public icommand
 		{
 		public:
 			using key_type = char const*;
 		public:
-			CommandBase(const key_type& key) : key_(key) {}
+			CommandBase(const key_type& key) : key_(key), hash_(Interpreter::hash(key)) {}
 		public:
 			bool operator==(const key_type& key) { return std::strcmp(key_, key) == 0; }
 			bool operator!=(const key_type& key) { return !(*this == key); }
@@ -207,10 +358,13 @@ namespace pg
 			bool operator>=(const CommandBase& other) { return *this >= other.key_; }
 			bool operator<=(const CommandBase& other) { return *this <= other.key_; }
 		public:
-			virtual bool assemble(char*) = 0;
+			virtual bool assemble(tokenizer&) = 0;
+			virtual bool assemble(const uint8_t*, uint8_t) = 0;
 			const key_type& key() { return key_; }
+			hash_type hash() const { return hash_; }
 		private:
 			key_type key_;
+			hash_type hash_;
 		};
 
 		template <class Ret, class Obj = void, class...Args>
@@ -228,7 +382,8 @@ namespace pg
 		public:
 			void execute() override { std::experimental::apply(&obj_, del_, args_); }
 		private:
-			bool assemble(char* line) override { return parse(line, args_) == args_.size(); }
+			bool assemble(tokenizer& tok) override { return parse(tok, args_) == args_.size(); }
+			bool assemble(const uint8_t* args, uint8_t n) override { return unpack(args, n, args_) == args_.size(); }
 		private:
 			object_type&	obj_;
 			delegate_type	del_;
@@ -250,7 +405,8 @@ namespace pg
 		public:
 			void execute() override { std::experimental::apply(del_, args_); }
 		private:
-			bool assemble(char* line) override { return parse(line, args_) == args_.size(); }
+			bool assemble(tokenizer& tok) override { return parse(tok, args_) == args_.size(); }
+			bool assemble(const uint8_t* args, uint8_t n) override { return unpack(args, n, args_) == args_.size(); }
 		private:
 			delegate_type	del_;
 			args_type		args_;
@@ -271,7 +427,8 @@ namespace pg
 		public:
 			void execute() override { (obj_.*del_)(); }
 		private:
-			bool assemble(char* line) override { return true; }
+			bool assemble(tokenizer& tok) override { return true; }
+			bool assemble(const uint8_t* args, uint8_t n) override { return true; }
 		private:
 			object_type&	obj_;
 			delegate_type	del_;
@@ -292,14 +449,12 @@ namespace pg
 		public:
 			void execute() override { (*del_)(); }
 		private:
-			bool assemble(char* line) override { return true; }
+			bool assemble(tokenizer& tok) override { return true; }
+			bool assemble(const uint8_t* args, uint8_t n) override { return true; }
 		private:
 			delegate_type	del_;
 		};
 
-		using size_type = uint8_t;
-
-		static constexpr size_type MsgSizeMax = 64;
 		static constexpr const char* CmdDelimChars = "= ";
 		static constexpr const char* ArgDelimChars = ",";
 
@@ -307,48 +462,81 @@ namespace pg
 		Interpreter();
 
 	public:
+		// Lines are tokenized in place and must be writable. interpret() leaves any string 
+		// args null-terminated in the line, restore() puts back the original text. 
 		bool execute(CommandBase**, CommandBase**, const char*);
+		template<class Lookup>
+		bool execute(Lookup, const char*);
 		icommand* interpret(CommandBase**, CommandBase**, const char*);
+		template<class Lookup>
+		icommand* interpret(Lookup, const char*);
+		static CommandBase* find(CommandBase**, CommandBase**, hash_type, const char* = nullptr, std::size_t = 0);
+		void restore();
+		template<class...Ts>
+		static size_type parse(tokenizer&, std::tuple<Ts...>&);
+		template<class...Ts>
+		static size_type unpack(const uint8_t*, size_type, std::tuple<Ts...>&);
 		template<class...Ts>
-		static size_type parse(char*, std::tuple<Ts...>&);
+		static size_type pack(uint8_t*, size_type, Ts...);
+
+	private:
+		static constexpr hash_type FnvBasis = 2166136261UL;		// FNV-1a offset basis.
+		static constexpr hash_type FnvPrime = 16777619UL;		// FNV-1a prime.
+		static constexpr hash_type LongKeyBit = 0x80000000UL;	// Marks hashed (long) keys.
+
+		static constexpr hash_type pack(const char* key, std::size_t n)
+		{
+			return n ? static_cast<uint8_t>(*key) | (pack(key + 1, n - 1) << 8) : 0;
+		}
+
+		static constexpr hash_type fnv(const char* key, std::size_t n, hash_type h)
+		{
+			return n ? fnv(key + 1, n - 1, (h ^ static_cast<uint8_t>(*key)) * FnvPrime) : h;
+		}
+
+		static constexpr std::size_t length(const char* key)
+		{
+			return *key ? length(key + 1) + 1 : 0;
+		}
+
+		// Checks whether a command's key is the n chars of key, long keys are only matched by hash.
+		static bool matches(CommandBase* cmd, const char* key, std::size_t n)
+		{
+			return !(cmd->hash() & LongKeyBit) || (std::strncmp(cmd->key(), key, n) == 0 && cmd->key()[n] == '\0');
+		}
 
 	private:
-		char buf_[MsgSizeMax];		// Temporary message buffer.
+		tokenizer tok_;		// Tokenizes messages in place.
 	};
 
 	Interpreter::Interpreter() :
-		buf_{}
+		tok_()
 	{
 
 	}
 
 	icommand* Interpreter::interpret(CommandBase** first, CommandBase** last, const char* line)
+	{
+		return interpret([this, first, last](hash_type key) { return find(first, last, key, tok_.token(), tok_.size()); }, line);
+	}
+
+	template<class Lookup>
+	icommand* Interpreter::interpret(Lookup lookup, const char* line)
 	{
 		icommand* result = nullptr;
-		char* key = nullptr;
 
-		if (line)
+		tok_.reset(const_cast<char*>(line));
+		if (tok_.next(CmdDelimChars))
 		{
-			// Make a copy of the line and look for a command key.
-			if ((key = pg::strtok(buf_, line, CmdDelimChars, sizeof(buf_)))) 
+			// Pack the line key and look for a matching command, long keys are confirmed in full.
+			CommandBase* cmd = lookup(hash(tok_.token(), tok_.size()));
+
+			// If the line key matches one of the our command keys and  
+			// the line contains the number of expected command arguments, ...
+			if (cmd && matches(cmd, tok_.token(), tok_.size()) && cmd->assemble(tok_))
 			{
-				CommandBase** it = bsearch(first, last, key, 
-					[](CommandBase* c, CommandBase::key_type k) { return std::strcmp(c->key(), k); });
-
-				// If the line key matches one of the our command keys, ...
-				if (it)
-				{
-					CommandBase* cmd = *it;
-
-					// ... make a copy of the line without the key.
-					(void)pg::strtok(buf_, line, CmdDelimChars, sizeof(buf_));
-					// If the line contains the number of expected command arguments, ...
-					if (cmd->assemble(buf_))
-					{
-						// ... return the matched command.
-						result = cmd;
-					}
-				}
+				// ... return the matched command.
+				result = cmd;
 			}
 		}
 
@@ -357,21 +545,70 @@ namespace pg
 
 	bool Interpreter::execute(CommandBase** first, CommandBase** last, const char* line)
 	{
+		PG_PROFILE_SCOPE("Interpreter::execute");
+
 		icommand* cmd = interpret(first, last, line);
 		bool result = cmd != nullptr;
 
 		if (result)
 			cmd->execute();
+		restore();
 
 		return result;
 	}
 
+	template<class Lookup>
+	bool Interpreter::execute(Lookup lookup, const char* line)
+	{
+		PG_PROFILE_SCOPE("Interpreter::execute");
+
+		icommand* cmd = interpret(lookup, line);
+		bool result = cmd != nullptr;
+
+		if (result)
+			cmd->execute();
+		restore();
+
+		return result;
+	}
+
+	Interpreter::CommandBase* Interpreter::find(CommandBase** first, CommandBase** last, hash_type key, const char* text, std::size_t n)
+	{
+		// Linear search on packed keys, collections need not be sorted. If the key 
+		// text is given, commands whose long keys only collide with it are skipped.
+		CommandBase* result = nullptr;
+
+		if (key != NoKey)
+		{
+			for (; first < last && !result; ++first)
+				if (*first && (*first)->hash() == key && (!text || matches(*first, text, n)))
+					result = *first;
+		}
+
+		return result;
+	}
+
+	void Interpreter::restore()
+	{
+		tok_.restore();
+	}
+
 	template<class...Ts>
-	Interpreter::size_type Interpreter::parse(char* line, std::tuple<Ts...>& args)
+	Interpreter::size_type Interpreter::parse(tokenizer& tok, std::tuple<Ts...>& args)
 	{
-		size_type n = line ? details::getArgs(ArgDelimChars, args) : 0;
+		return details::getArgs(tok, ArgDelimChars, args);
+	}
 
-		return n;
+	template<class...Ts>
+	Interpreter::size_type Interpreter::unpack(const uint8_t* args, size_type n, std::tuple<Ts...>& t)
+	{
+		return args ? details::getArgs(args, args + n, t) : 0;
+	}
+
+	template<class...Ts>
+	Interpreter::size_type Interpreter::pack(uint8_t* buf, size_type n, Ts... args)
+	{
+		return details::putArgs(buf, buf + n, args...) - buf;
 	}
 
 	// Comparator for sorting arrays of Interpreter command objects.
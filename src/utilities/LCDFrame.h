@@ -0,0 +1,196 @@
+/*
+ *	This file defines a shadow frame buffer for character lcd displays.
+ *
+ *	***************************************************************************
+ *
+ *	File: LCDFrame.h
+ *	Date: October 14, 2026
+ *	Version: 1.0
+ *	Author: Michael Brodsky
+ *	Email: mbrodskiis@gmail.com
+ *	Copyright (c) 2012-2022 Michael Brodsky
+ *
+ *	***************************************************************************
+ *
+ *  This file is part of "Pretty Good" (Pg). "Pg" is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  This file is distributed in the hope that it will be useful, but
+ *	WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *	along with this file. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *	**************************************************************************
+ *
+ *	Description:
+ *
+ *	The `LCDFrame' class keeps a copy of the characters shown on a Cols x Rows
+ *	character lcd display, and of the characters it should show, so that a
+ *	refresh only transmits the characters that changed. A refresh renders
+ *	text into the frame with `setCursor()' and `print()', and `flush()' then
+ *	writes each changed run of characters to the device, moving the device
+ *	cursor only when the next run does not follow the last one. Runs
+ *	separated by a single unchanged character are merged, since rewriting
+ *	one character costs no more than a cursor command. Text is clipped at
+ *	the end of each row.
+ *
+ *	The frame also serves as the display's output queue: `flush()' can be
+ *	given a limit on the number of bytes (characters and cursor commands)
+ *	it transmits per call, and later calls resume with whatever is still
+ *	different, so a redraw can be spread over many short calls. Rendering
+ *	again before the queue is drained just updates the pending characters.
+ *
+ *	It is used by LCDDisplay (see <components/LCDDisplay.h>), where it cuts
+ *	the time of a typical refresh, which only changes a few field values,
+ *	by an order of magnitude over slow device interfaces such as I2C
+ *	backpacks.
+ *
+ *	The device contents are unknown until the frame is first flushed or
+ *	`clear()' is called, so the first flush writes every rendered character.
+ *	If the device is written to bypassing the frame, `invalidate()' forces
+ *	the next flush to rewrite every rendered character.
+ *
+ *	**************************************************************************/
+
+#if !defined __PG_LCDFRAME_H
+# define __PG_LCDFRAME_H 20261014L
+
+# include <cstdint>		// Fixed-width integer types.
+# include <cstring>		// std::memset
+
+namespace pg
+{
+	// Shadow frame buffer for character lcd displays.
+	template<uint8_t Cols, uint8_t Rows>
+	class LCDFrame
+	{
+	public:
+		static constexpr char Unknown = '\0';	// Placeholder for unknown device characters.
+
+	public:
+		// Constructs a frame with unknown device contents.
+		LCDFrame();
+
+	public:
+		// Marks the device contents unknown.
+		void invalidate();
+		// Marks the device contents blank, after the device has been cleared.
+		void clear();
+		// Begins rendering a new frame at the home position.
+		void begin();
+		// Sets the render position.
+		void setCursor(uint8_t, uint8_t);
+		// Renders a string at the render position and advances it.
+		void print(const char*);
+		// Writes at most a number of bytes of changed characters to a device, or all if 0, 
+		// and returns true if the device is up to date.
+		template<class Device>
+		bool flush(Device*, uint8_t = 0);
+		// Checks whether any rendered characters have not been written to the device.
+		bool pending() const;
+
+	private:
+		char	shadow_[Rows][Cols];	// The device contents.
+		char	frame_[Rows][Cols];		// The rendered contents.
+		uint8_t	col_;					// Render column index.
+		uint8_t	row_;					// Render row index.
+	};
+
+	template<uint8_t Cols, uint8_t Rows>
+	LCDFrame<Cols, Rows>::LCDFrame() : shadow_(), frame_(), col_(), row_()
+	{
+		invalidate();
+	}
+
+	template<uint8_t Cols, uint8_t Rows>
+	void LCDFrame<Cols, Rows>::invalidate()
+	{
+		std::memset(shadow_, Unknown, sizeof(shadow_));
+	}
+
+	template<uint8_t Cols, uint8_t Rows>
+	void LCDFrame<Cols, Rows>::clear()
+	{
+		std::memset(shadow_, ' ', sizeof(shadow_));
+		std::memset(frame_, ' ', sizeof(frame_));	// Drops any pending characters.
+	}
+
+	template<uint8_t Cols, uint8_t Rows>
+	void LCDFrame<Cols, Rows>::begin()
+	{
+		col_ = row_ = 0;
+	}
+
+	template<uint8_t Cols, uint8_t Rows>
+	void LCDFrame<Cols, Rows>::setCursor(uint8_t col, uint8_t row)
+	{
+		col_ = col;
+		row_ = row;
+	}
+
+	template<uint8_t Cols, uint8_t Rows>
+	void LCDFrame<Cols, Rows>::print(const char* str)
+	{
+		if (row_ < Rows && str)
+		{
+			while (*str && col_ < Cols)
+				frame_[row_][col_++] = *str++;
+		}
+	}
+
+	template<uint8_t Cols, uint8_t Rows>
+	template<class Device>
+	bool LCDFrame<Cols, Rows>::flush(Device* device, uint8_t limit)
+	{
+		uint8_t count = 0;	// Number of bytes transmitted.
+
+		for (uint8_t row = 0; row < Rows; ++row)
+		{
+			uint8_t cursor = Cols;	// Device cursor column, if on this row, else Cols.
+
+			for (uint8_t col = 0; col < Cols; ++col)
+			{
+				if (frame_[row][col] == shadow_[row][col] || frame_[row][col] == Unknown)
+					continue;
+				if (limit && count && count + (cursor == col ? 1 : 2) > limit)
+					return false;	// Out of budget, resume on the next call.
+				if (cursor != col)
+				{
+					if (cursor + 1 == col && frame_[row][cursor] != Unknown)
+						device->write(static_cast<uint8_t>(frame_[row][cursor]));	// Cheaper than moving the cursor.
+					else
+						device->setCursor(col, row);
+					++count;
+				}
+				device->write(static_cast<uint8_t>(frame_[row][col]));
+				shadow_[row][col] = frame_[row][col];
+				cursor = col + 1;
+				++count;
+			}
+		}
+
+		return true;
+	}
+
+	template<uint8_t Cols, uint8_t Rows>
+	bool LCDFrame<Cols, Rows>::pending() const
+	{
+		for (uint8_t row = 0; row < Rows; ++row)
+		{
+			for (uint8_t col = 0; col < Cols; ++col)
+			{
+				if (frame_[row][col] != shadow_[row][col] && frame_[row][col] != Unknown)
+					return true;
+			}
+		}
+
+		return false;
+	}
+} // namespace pg
+
+#endif // !defined __PG_LCDFRAME_H
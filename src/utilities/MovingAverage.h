@@ -42,17 +42,24 @@
  *	overloads, one that inserts a new value into the stream and returns the 
  *	the resulting filter output state, and another that returns only the 
  *	current output state. The filter can be seeded with a single or a 
- *	collection of values with the `seed()' method overloads. The 
+ *	collection of values with the `seed()' method overloads, and updated with 
+ *	a range of values with the `out(first, last)' overload. The 
  *	`get_allocator()' method returns an immutable reference to the filter's 
  *	underlying allocator so that clients can access its properties for 
  *	calculations.
+ *
+ *	Cheaper exponential, power-of-two and median filters with the same 
+ *	interface are defined in <utilities/Filters.h>.
  * 
  *****************************************************************************/
 
 #if !defined __PG_MOVINGAVERAGE_H
 # define __PG_MOVINGAVERAGE_H 20211006L
 
+# include <algorithm>	// std::fill and std::copy.
 # include <array>	// Default data buffer allocator type.
+# include <iterator>	// Circular iterator type.
+# include <numeric>	// std::accumulate.
 
 namespace pg
 {
@@ -76,6 +83,9 @@ namespace pg
 		void seed(value_type*);
 		// Updates the filter state with a value and returns the resulting output state. 
 		const value_type& out(const value_type&);
+		// Updates the filter state with a range of values and returns the resulting output state.
+		template<class InputIt>
+		const value_type& out(InputIt, InputIt);
 		// Returns the current filter output state.
 		const value_type& out() const;
 		// Returns a reference to the underlying data buffer.
@@ -106,7 +116,7 @@ namespace pg
 	template<class value_type, std::size_t N, template<class = value_type, std::size_t = N> typename Alloc>
 	void MovingAverage<value_type, N, Alloc>::seed(value_type* seed)
 	{
-		std::copy(alloc_.begin(), alloc_.end(), seed);
+		std::copy(seed, seed + N, alloc_.begin());
 		sum_ = std::accumulate(alloc_.begin(), alloc_.end(), value_type());
 		avg_ = sum_ / N;
 	}
@@ -122,6 +132,17 @@ namespace pg
 		return (avg_ = sum_ / N);
 	}
 
+	template<class value_type, std::size_t N, template<class = value_type, std::size_t = N> typename Alloc>
+	template<class InputIt>
+	const typename MovingAverage<value_type, N, Alloc>::value_type& 
+		MovingAverage<value_type, N, Alloc>::out(InputIt first, InputIt last)
+	{
+		while (first != last)
+			out(*first++);
+
+		return avg_;
+	}
+
 	template<class value_type, std::size_t N, template<class = value_type, std::size_t = N> typename Alloc>
 	const typename MovingAverage<value_type, N, Alloc>::value_type& 
 		MovingAverage<value_type, N, Alloc>::out() const
@@ -0,0 +1,308 @@
+/*
+ *	This file defines a bank of PID controllers with shared timing.
+ *
+ *	***************************************************************************
+ *
+ *	File: PIDBank.h
+ *	Date: October 14, 2026
+ *	Version: 1.0
+ *	Author: Michael Brodsky
+ *	Email: mbrodskiis@gmail.com
+ *	Copyright (c) 2012-2022 Michael Brodsky
+ *
+ *	***************************************************************************
+ *
+ *  This file is part of "Pretty Good" (Pg). "Pg" is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  This file is distributed in the hope that it will be useful, but
+ *	WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *	along with this file. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *	**************************************************************************
+ *
+ *	Description:
+ *
+ *	The `PIDBank' class runs N PID control loops (see <utilities/PIDController.h>)
+ *	that share one sample period. The loop parameters and states are kept in
+ *	contiguous arrays, one per field, and all loops are updated in a single
+ *	pass by the `loop()' or `clock()' methods, so adding loops costs neither
+ *	a virtual call nor a clock read. Loops are addressed by index in [0, N).
+ *
+ *	Each loop's output is clamped to its `limits()', and the integrator is
+ *	held while the output is saturated in the direction of the error, to
+ *	prevent windup. Loops can be switched to manual mode, where the client
+ *	sets the output directly. Switching back to automatic mode is bumpless:
+ *	the integrator is loaded so the first automatic output equals the last
+ *	manual one.
+ *
+ *		PIDBank<float, 8> bank;
+ *		bank.tune(0, 2.0, 0.5, 0.0, 1.0);
+ *		bank.set_point(0, 50.0);
+ *		bank.limits(0, 0.0, 1.0);
+ *		bank.start(PIDBank<float, 8>::clock_type::now());
+ *		...
+ *		bank.loop(measured);			// Updates all loops from an array of N process values.
+ *		heater.dutyCycle(bank.output(0));
+ *
+ *	The gains are assumed to be positive, as in PIDController.
+ *
+ *	**************************************************************************/
+
+#if !defined __PG_PIDBANK_H
+# define __PG_PIDBANK_H 20261014L
+
+# include <chrono>
+# include <limits>
+# include <interfaces/iclockable.h>
+# include <lib/callback.h>
+# include <utilities/PIDController.h>	// details::pid_seconds.
+
+# if defined __PG_HAS_NAMESPACES
+
+namespace pg
+{
+	// A bank of N proportional-integral-derivative (PID) controllers.
+	template<class T = float, std::size_t N = 8>
+	class PIDBank : public iclockable
+	{
+	public:
+		using value_type = T;
+		using size_type = std::size_t;
+		using duration = std::chrono::duration<value_type, std::ratio<1>>;
+		using clock_type = std::chrono::steady_clock;
+		using time_point = typename clock_type::time_point;
+		using input_type = typename callback<void, void, value_type*>::type;
+		using output_type = typename callback<void, void, const value_type*>::type;
+
+	public:
+		// Constructs a bank of loops with zero gains, in automatic mode.
+		PIDBank();
+		// Constructs a bank of loops with zero gains and client callbacks.
+		PIDBank(input_type, output_type);
+
+	public:
+		// Returns the number of loops.
+		constexpr size_type size() const { return N; }
+		// Sets a loop's proportional, integral and derivative coefficients and gain.
+		void tune(size_type, value_type, value_type, value_type, value_type = value_type(1));
+		// Sets a loop's set point.
+		void set_point(size_type, value_type);
+		// Returns a loop's set point.
+		value_type set_point(size_type) const;
+		// Sets a loop's output limits.
+		void limits(size_type, value_type, value_type);
+		// Switches a loop to automatic or manual mode.
+		void automatic(size_type, bool);
+		// Checks whether a loop is in automatic mode.
+		bool automatic(size_type) const;
+		// Sets a manual mode loop's output.
+		void manual(size_type, value_type);
+		// Returns a loop's last measured process value.
+		value_type measured_value(size_type) const;
+		// Returns a loop's current output.
+		value_type output(size_type) const;
+		// Returns the current outputs of all loops.
+		const value_type* outputs() const;
+		// Sets the last loop time.
+		void start(time_point);
+		// Returns the last integration/derivative time.
+		duration dt() const;
+		// Sets the client process values read and control values write methods.
+		void callbacks(input_type, output_type);
+		// Updates all loops from an array of N process values and returns the outputs.
+		const value_type* loop(const value_type*);
+
+	private:
+		// Reads the process values, updates all loops and writes the outputs.
+		void clock() override;
+
+	private:
+		value_type	set_point_[N];		// Process set points (SP).
+		value_type	measured_[N];		// Last measured process values (PV).
+		value_type	Kp_[N];				// Proportional coefficients.
+		value_type	Ki_[N];				// Integral coefficients.
+		value_type	Kd_[N];				// Derivative coefficients.
+		value_type	gain_[N];			// Output gains (A).
+		value_type	low_[N];			// Output lower limits.
+		value_type	high_[N];			// Output upper limits.
+		value_type	integral_[N];		// Integrator states (int(0,t) e(t)dt).
+		value_type	previous_error_[N];	// Last process errors (e).
+		value_type	output_[N];			// Outputs (CV).
+		bool		automatic_[N];		// Flags indicating whether loops are in automatic mode.
+		duration	dt_;				// Last integration/derivative time (dt).
+		time_point	tp_;				// Last loop time.
+		input_type	in_;				// Process values read method.
+		output_type	out_;				// Control values write method.
+	};
+
+	template<class T, std::size_t N>
+	PIDBank<T, N>::PIDBank() : PIDBank(nullptr, nullptr)
+	{
+
+	}
+
+	template<class T, std::size_t N>
+	PIDBank<T, N>::PIDBank(input_type in, output_type out) :
+		set_point_(), measured_(), Kp_(), Ki_(), Kd_(), gain_(), low_(), high_(), integral_(),
+		previous_error_(), output_(), automatic_(), dt_(), tp_(), in_(in), out_(out)
+	{
+		for (size_type i = 0; i < N; ++i)
+		{
+			low_[i] = std::numeric_limits<value_type>::lowest();
+			high_[i] = std::numeric_limits<value_type>::max();
+			automatic_[i] = true;
+		}
+	}
+
+	template<class T, std::size_t N>
+	void PIDBank<T, N>::tune(size_type i, value_type Kp, value_type Ki, value_type Kd, value_type gain)
+	{
+		Kp_[i] = Kp;
+		Ki_[i] = Ki;
+		Kd_[i] = Kd;
+		gain_[i] = gain;
+	}
+
+	template<class T, std::size_t N>
+	void PIDBank<T, N>::set_point(size_type i, value_type value)
+	{
+		integral_[i] = 0;
+		previous_error_[i] = 0;
+		set_point_[i] = value;
+	}
+
+	template<class T, std::size_t N>
+	typename PIDBank<T, N>::value_type PIDBank<T, N>::set_point(size_type i) const
+	{
+		return set_point_[i];
+	}
+
+	template<class T, std::size_t N>
+	void PIDBank<T, N>::limits(size_type i, value_type low, value_type high)
+	{
+		low_[i] = low;
+		high_[i] = high;
+	}
+
+	template<class T, std::size_t N>
+	void PIDBank<T, N>::automatic(size_type i, bool value)
+	{
+		if (value && !automatic_[i])
+		{
+			// Load the integrator so the next output continues from the manual output.
+			const value_type error = set_point_[i] - measured_[i];
+
+			integral_[i] = Ki_[i] != value_type(0) && gain_[i] != value_type(0)
+				? (output_[i] / gain_[i] - Kp_[i] * error) / Ki_[i]
+				: value_type(0);
+			previous_error_[i] = error;
+		}
+		automatic_[i] = value;
+	}
+
+	template<class T, std::size_t N>
+	bool PIDBank<T, N>::automatic(size_type i) const
+	{
+		return automatic_[i];
+	}
+
+	template<class T, std::size_t N>
+	void PIDBank<T, N>::manual(size_type i, value_type value)
+	{
+		if (!automatic_[i])
+			output_[i] = value < low_[i] ? low_[i] : value > high_[i] ? high_[i] : value;
+	}
+
+	template<class T, std::size_t N>
+	typename PIDBank<T, N>::value_type PIDBank<T, N>::measured_value(size_type i) const
+	{
+		return measured_[i];
+	}
+
+	template<class T, std::size_t N>
+	typename PIDBank<T, N>::value_type PIDBank<T, N>::output(size_type i) const
+	{
+		return output_[i];
+	}
+
+	template<class T, std::size_t N>
+	const typename PIDBank<T, N>::value_type* PIDBank<T, N>::outputs() const
+	{
+		return output_;
+	}
+
+	template<class T, std::size_t N>
+	void PIDBank<T, N>::start(time_point value)
+	{
+		tp_ = value;
+	}
+
+	template<class T, std::size_t N>
+	typename PIDBank<T, N>::duration PIDBank<T, N>::dt() const
+	{
+		return dt_;
+	}
+
+	template<class T, std::size_t N>
+	void PIDBank<T, N>::callbacks(input_type in, output_type out)
+	{
+		in_ = in;
+		out_ = out;
+	}
+
+	template<class T, std::size_t N>
+	const typename PIDBank<T, N>::value_type* PIDBank<T, N>::loop(const value_type* measured)
+	{
+		const time_point now = clock_type::now();
+
+		dt_ = duration(details::pid_seconds<value_type>::convert(now - tp_));
+		tp_ = now;
+
+		const value_type dt = dt_.count();
+
+		for (size_type i = 0; i < N; ++i)
+		{
+			// CV = A(Kp*e + Ki*int(0,t) e(t)dt + Kd*de/dt), clamped to [low, high].
+			const value_type error = set_point_[i] - measured[i];
+
+			measured_[i] = measured[i];
+			if (automatic_[i])
+			{
+				const value_type derivative = (error - previous_error_[i]) / dt;
+				const value_type integral = integral_[i] + error * dt;
+				value_type cv = gain_[i] * (Kp_[i] * error + Ki_[i] * integral + Kd_[i] * derivative);
+
+				if (cv > high_[i])
+					cv = high_[i];
+				else if (cv < low_[i])
+					cv = low_[i];
+				if (!((cv == high_[i] && error > value_type(0)) || (cv == low_[i] && error < value_type(0))))
+					integral_[i] = integral;	// Hold the integrator while saturated, to prevent windup.
+				output_[i] = cv;
+			}
+			previous_error_[i] = error;
+		}
+
+		return output_;
+	}
+
+	template<class T, std::size_t N>
+	void PIDBank<T, N>::clock()
+	{
+		(*in_)(measured_);
+		(*out_)(loop(measured_));
+	}
+} // namespace pg
+
+# else // !defined __PG_HAS_NAMESPACES
+#  error Requires C++11 and namespace support.
+# endif // defined __PG_HAS_NAMESPACES
+
+#endif // !defined __PG_PIDBANK_H
@@ -51,6 +51,11 @@
  *	clients should keep the loop time constant. Prior to operation, clients 
  *	must call the start() method, passing in the current system time. 
  * 
+ *	The value type T may be a floating point or a fixed-point type (see 
+ *	<lib/fixed.h>). Fixed-point controllers avoid software floating point on 
+ *	boards without an FPU, at the cost of range and resolution, for instance 
+ *	a q15_16 loop time is quantized to about 15 us. 
+ * 
  *****************************************************************************/
 
 #if !defined __PG_PIDCONTROLLER_H 
@@ -59,11 +64,34 @@
 # include <chrono>
 # include <utility>
 # include <interfaces/iclockable.h>
+# include <lib/fixed.h>
 
 # if defined __PG_HAS_NAMESPACES
 
 namespace pg
 {
+	namespace details
+	{
+		// Converts a clock duration to seconds of type T.
+		template<class T>
+		struct pid_seconds
+		{
+			template<class D>
+			static T convert(D d) { return std::chrono::duration_cast<std::chrono::duration<T>>(d).count(); }
+		};
+
+		// Converts a clock duration to fixed-point seconds without overflowing intermediate values.
+		template<int I, int F>
+		struct pid_seconds<fixed<I, F>>
+		{
+			template<class D>
+			static fixed<I, F> convert(D d) 
+			{ 
+				return fixed<I, F>::from_ratio(std::chrono::duration_cast<std::chrono::microseconds>(d).count(), 1000000); 
+			}
+		};
+	} // namespace details
+
 	// A proportionalintegralderivative (PID) controller.
 	template<class T = float>
 	class PIDController : public iclockable 
@@ -72,7 +100,7 @@ namespace pg
 		using value_type = T;
 		using duration = std::chrono::duration<value_type, std::ratio<1>>;
 		using clock_type = std::chrono::steady_clock;
-		using time_point = std::chrono::time_point<clock_type, duration>;
+		using time_point = typename clock_type::time_point;
 		using input_type = typename callback<value_type>::type;
 		using output_type = typename callback<void, void, value_type>::type;
 
@@ -112,8 +140,8 @@ namespace pg
 			// CV = A(Kp*e + Ki*int(0,t) e(t)dt + Kd*de/dt), 
 			// where e = SP - PV, SP = process set point, PV = process variable.
 
-			time_point now = time_point(clock_type::now());
-			dt_ = duration(now - tp_);
+			time_point now = clock_type::now();
+			dt_ = duration(details::pid_seconds<value_type>::convert(now - tp_));
 			value_type error = set_point_ - measured_value;
 			value_type proportional = error;
 			value_type derivative = (error - previous_error_) / dt_.count();
@@ -92,7 +92,14 @@ namespace pg
 		}
 	};
 
+	template<class T, class CtrlType>
+	constexpr T duty_cycle<T, CtrlType>::min;
+
+	template<class T, class CtrlType>
+	constexpr T duty_cycle<T, CtrlType>::max;
+
 	// PWM output controller. (T = fractional duty cycle type, CtrlType = interger control register type.)
+	// T may be a floating point or a fixed-point type (see <lib/fixed.h>).
 	template<class T = float, class CtrlType = uint8_t>
 	class PWMOutput
 	{
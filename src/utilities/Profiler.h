@@ -0,0 +1,198 @@
+/*
+ *	This file defines scoped, cycle-counting profiling instrumentation.
+ *
+ *	***************************************************************************
+ *
+ *	File: Profiler.h
+ *	Date: October 14, 2026
+ *	Version: 1.0
+ *	Author: Michael Brodsky
+ *	Email: mbrodskiis@gmail.com
+ *	Copyright (c) 2012-2022 Michael Brodsky
+ *
+ *	***************************************************************************
+ *
+ *  This file is part of "Pretty Good" (Pg). "Pg" is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  This file is distributed in the hope that it will be useful, but
+ *	WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *	along with this file. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *	**************************************************************************
+ *
+ *	Description:
+ *
+ *		PG_PROFILE_SCOPE(name) measures the CPU cycles spent in the
+ *		enclosing scope, from the macro to the end of the scope, with
+ *		`cycle_counter' (see <system/cycles.h>):
+ *
+ *			void Sensor::clock()
+ *			{
+ *				PG_PROFILE_SCOPE("Sensor::clock");
+ *				...
+ *			}
+ *
+ *		Each instrumented scope has one static `ProfileEntry', which records
+ *		its call count and its shortest, longest and total cycle counts, and
+ *		adds itself to the `Profiler' table the first time the scope runs. Up
+ *		to Profiler::EntriesMax scopes are recorded, later ones are measured
+ *		but not listed. Jack's `prf' command replies with the table remotely.
+ *
+ *		Profiling is enabled by defining __PG_PROFILE, and PG_PROFILE_SCOPE
+ *		expands to nothing otherwise, so instrumentation left in place costs
+ *		nothing in normal builds. Library scopes instrumented this way are
+ *		Jack::clock(), Interpreter::execute(), Connection::receive(),
+ *		LCDDisplay::refresh() and LCDDisplay::flush(). On AVR boards, also
+ *		define __PG_CYCLE_COUNTER to count cycles with Timer1, instead of
+ *		micros().
+ *
+ *	**************************************************************************/
+
+#if !defined __PG_PROFILER_H
+# define __PG_PROFILER_H 20261014L
+
+# if defined __PG_PROFILE
+
+#  include <cstdint>			// Fixed-width integer types.
+#  include <system/cycles.h>	// cycle_counter type.
+
+#  if defined __PG_HAS_NAMESPACES
+
+namespace pg
+{
+	// Execution statistics of one profiled scope.
+	struct ProfileEntry
+	{
+		using value_type = cycle_counter::value_type;	// Type that holds cycle counts and call counts.
+
+		const char*	name_;	// Scope name.
+		value_type	calls_;	// Number of times the scope ran.
+		value_type	min_;	// Fewest cycles in the scope.
+		value_type	max_;	// Most cycles in the scope.
+		uint64_t	total_;	// Total cycles in the scope.
+
+		// Constructs an entry and adds it to the Profiler table.
+		explicit ProfileEntry(const char*);
+
+		// Returns the mean cycles per call.
+		value_type mean() const;
+		// Records one call.
+		void record(value_type);
+		// Clears all statistics.
+		void reset();
+	};
+
+	// Table of profiled scopes.
+	struct Profiler
+	{
+		using size_type = uint8_t;
+
+		static constexpr size_type EntriesMax = 16;	// Maximum number of listed scopes.
+
+		// Adds an entry to the table and returns true, or returns false if the table is full.
+		static bool add(ProfileEntry*);
+		// Returns the entry at an index in [0, size()).
+		static const ProfileEntry* entry(size_type);
+		// Clears the statistics of all entries.
+		static void reset();
+		// Returns the number of entries in the table.
+		static size_type size();
+	};
+
+	// Records the cycles spent in a scope when it goes out of scope.
+	class ProfileScope
+	{
+	public:
+		explicit ProfileScope(ProfileEntry& entry) : entry_(entry), begin_(cycle_counter::now()) {}
+		~ProfileScope() { entry_.record(cycle_counter::now() - begin_); }
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+
+	private:
+		ProfileEntry&				entry_;	// The scope's entry.
+		cycle_counter::value_type	begin_;	// Cycle count when the scope was entered.
+	};
+
+	namespace details
+	{
+		static ProfileEntry* __profile_entries[Profiler::EntriesMax];	// Profiled scopes table.
+		static Profiler::size_type __profile_size = 0;					// Number of table entries.
+	} // namespace details
+
+	ProfileEntry::ProfileEntry(const char* name) :
+		name_(name), calls_(), min_(), max_(), total_()
+	{
+		(void)Profiler::add(this);
+	}
+
+	typename ProfileEntry::value_type ProfileEntry::mean() const
+	{
+		return calls_ ? static_cast<value_type>(total_ / calls_) : 0;
+	}
+
+	void ProfileEntry::record(value_type cycles)
+	{
+		if (calls_ == 0 || cycles < min_)
+			min_ = cycles;
+		if (cycles > max_)
+			max_ = cycles;
+		total_ += cycles;
+		++calls_;
+	}
+
+	void ProfileEntry::reset()
+	{
+		calls_ = min_ = max_ = 0;
+		total_ = 0;
+	}
+
+	bool Profiler::add(ProfileEntry* entry)
+	{
+		bool result = details::__profile_size < EntriesMax;
+
+		if (details::__profile_size == 0)
+			cycle_counter::start();	// The first profiled scope starts the counter.
+		if (result)
+			details::__profile_entries[details::__profile_size++] = entry;
+
+		return result;
+	}
+
+	const ProfileEntry* Profiler::entry(size_type i)
+	{
+		return i < details::__profile_size ? details::__profile_entries[i] : nullptr;
+	}
+
+	void Profiler::reset()
+	{
+		for (size_type i = 0; i < details::__profile_size; ++i)
+			details::__profile_entries[i]->reset();
+	}
+
+	typename Profiler::size_type Profiler::size()
+	{
+		return details::__profile_size;
+	}
+} // namespace pg
+
+#  else // !defined __PG_HAS_NAMESPACES
+#   error Requires C++11 and namespace support.
+#  endif // defined __PG_HAS_NAMESPACES
+
+#  define __PG_PROFILE_CAT_(a, b) a##b
+#  define __PG_PROFILE_CAT(a, b) __PG_PROFILE_CAT_(a, b)
+#  define PG_PROFILE_SCOPE(name) \
+	static pg::ProfileEntry __PG_PROFILE_CAT(__pg_profile_entry_, __LINE__)(name); \
+	pg::ProfileScope __PG_PROFILE_CAT(__pg_profile_scope_, __LINE__)(__PG_PROFILE_CAT(__pg_profile_entry_, __LINE__))
+# else // !defined __PG_PROFILE
+#  define PG_PROFILE_SCOPE(name)
+# endif // defined __PG_PROFILE
+
+#endif // !defined __PG_PROFILER_H
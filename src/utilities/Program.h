@@ -30,12 +30,37 @@
 #if !defined __PG_PROGRAM_H
 # define __PG_PROGRAM_H 20220610L
 
+# include <algorithm>
 # include <cstdint>
 # include <cstring>
 # include <cstdlib>
 # include <stack>
+# include <lib/crc.h>
+# include <lib/tokenizer.h>
+# include <system/boards.h>
 # include <utilities/Timer.h>
+# include <utilities/EEStream.h>
 # include <utilities/Interpreter.h>
+# if !defined __PG_PROGRAM_STEPS
+#  define __PG_PROGRAM_STEPS 1	// Default maximum instructions executed per clock.
+# endif
+# if !defined __PG_PROGRAM_SLICE
+#  define __PG_PROGRAM_SLICE 0	// Default maximum microseconds spent executing per clock, 0 = no limit.
+# endif
+# if !defined __PG_PROGRAM_CODE_MAX
+#  if RAMSIZE > 4096
+#   define __PG_PROGRAM_CODE_MAX 64	// Default maximum number of compiled program instructions.
+#  else
+#   define __PG_PROGRAM_CODE_MAX 24	// Each instruction takes about 13 bytes on AVR boards.
+#  endif
+# endif
+# if !defined __PG_PROGRAM_CHARS_MAX
+#  if RAMSIZE > 4096
+#   define __PG_PROGRAM_CHARS_MAX 1024	// Default maximum size of program text in characters.
+#  else
+#   define __PG_PROGRAM_CHARS_MAX 704	// Text and compiled code share the former 1K text buffer's RAM.
+#  endif
+# endif
 
 namespace pg
 {
@@ -43,11 +68,31 @@ namespace pg
 	{
 		using value_type = int32_t;
 
-		virtual value_type sys_get(const char*) = 0;
+		virtual value_type sys_get(char, value_type) = 0;	// Returns the value of a system object, selected by its SystemCallChars char and index.
 	};
 
 	class Jack;
 	// Type that manages a set of executable instructions.
+	//
+	// Program text is compiled when loading ends: each line is pre-decoded into an 
+	// opcode and its operands, and lines that aren't program instructions are kept 
+	// as remote commands for the caller to execute. The text itself is retained, since 
+	// remote command lines execute from it and it's needed for listing, verifying and 
+	// storing the program. Programs with more than CodeMax lines can't be compiled or 
+	// run, and overflow() reports them. Define __PG_PROGRAM_CODE_MAX to change CodeMax, 
+	// which defaults to 64, or 24 on boards with 4K of RAM or less. On those boards 
+	// the text is limited to 704 chars, so the text and the compiled code together 
+	// take no more RAM than the text alone did. Define __PG_PROGRAM_CHARS_MAX to 
+	// change CharsMax.
+	//
+	// store() saves the program text to the EEPROM as a record holding its size, an 
+	// autorun flag, the text and a CRC, using only as many bytes as the text takes. 
+	// load() checks the CRC before replacing the current program, then compiles it, 
+	// so a device can recover its program at power-up without the host re-sending it.
+	//
+	// The budget limits how many instructions the caller executes per clock, and for 
+	// how many microseconds, before yielding. Execution also yields when a `dly' 
+	// instruction puts the program to sleep.
 	class Program
 	{
 		friend class Jack;
@@ -64,18 +109,27 @@ namespace pg
 			Active = 6, // Current program status.
 			Verify = 7,	// Verifies the current program.
 			List = 8,	// Lists the current program text.
+			Store = 9,	// Stores the current program in the EEPROM.
+			Load = 10,	// Loads the stored program from the EEPROM.
+			Autorun = 11,	// Stores the current program and runs it at power-up.
+			TooLong = 12,	// Program has too many lines to compile, replies with CodeMax.
 		};
 		using size_type = uint16_t;	// Type that can hold the size of any program object.
 		using value_type = iprogram::value_type;	// Type that can hold the value of any program object. 
 		using timer_type = Timer<std::chrono::milliseconds>; // Program sleep timer type.
 		using key_type = const char*;
 		using command_type = Interpreter::CommandBase;
+		using crc_type = crc_16;	// Stored program CRC algorithm.
 		template<class... Ts>
 		using Instruction = typename Interpreter::Command<void, Program, Ts...>;
 
-		static constexpr size_type CharsMax = 1024;	// Maximum size of program text in characters.
+		static constexpr size_type CharsMax = __PG_PROGRAM_CHARS_MAX;	// Maximum size of program text in characters.
 		static constexpr size_type StackSize = 32;	// Maximum size of program stack.
 		static constexpr size_type InstructionSetMaxCount = 32;	// Maximum size of built-in instruction set.
+		static constexpr size_type CodeMax = __PG_PROGRAM_CODE_MAX;	// Maximum number of compiled program instructions.
+		static constexpr size_type OperandsMax = 2;	// Maximum number of operands per instruction.
+		static constexpr size_type StoreOverhead = 
+			sizeof(size_type) + sizeof(uint8_t) + sizeof(typename crc_type::value_type);	// Stored bytes other than the text.
 
 		using InstructionSet = typename std::array<command_type*, InstructionSetMaxCount>;
 
@@ -118,34 +172,111 @@ namespace pg
 
 		using stack_type = std::stack<value_type, StackSize>; // Program stack.
 
+		// Enumerates the compiled instruction opcodes, in instruction set order (branches OpJump-OpLoop are contiguous).
+		enum Opcode : uint8_t
+		{
+			OpCompare = 0,
+			OpMove,
+			OpNegate,
+			OpNot,
+			OpSleep,
+			OpJump,
+			OpJumpEqual,
+			OpJumpNotEqual,
+			OpJumpLess,
+			OpJumpLessEqual,
+			OpJumpGreater,
+			OpJumpGreaterEqual,
+			OpLoop,
+			OpDecrement,
+			OpIncrement,
+			OpAdd,
+			OpSubtract,
+			OpMultiply,
+			OpDivide,
+			OpModulo,
+			OpAnd,
+			OpOr,
+			OpTest,
+			OpXor,
+			OpCall,
+			OpReturn,
+			OpReturnValue,
+			OpPush,
+			OpPop,
+			OpCommand = 0xFF	// Remote command, executed by the caller.
+		};
+
+		// Enumerates the program registers.
+		enum Registers : uint8_t
+		{
+			Ax = 0,
+			Bx,
+			Cx,
+			Dx,
+			Pc,
+			Sr,
+			RegistersCount
+		};
+
+		// Type that holds a pre-decoded instruction operand.
+		struct Operand
+		{
+			enum Type : uint8_t { Literal = 0, Register, SystemCall };
+
+			Type		type_;	// Operand type.
+			char		call_;	// SystemCallChars char, if a system call.
+			value_type	value_;	// Literal value, register index or system object index.
+
+			friend void getArg(const char* tok, Operand& arg) { arg = Program::operand(tok); }
+			friend bool getArg(const uint8_t*&, const uint8_t*, Operand&) { return false; }	// Programs are only sent as text.
+		};
+
+		// Type that holds a compiled program instruction.
+		struct Code
+		{
+			Opcode	op_;					// Instruction opcode.
+			Operand	args_[OperandsMax];		// Instruction operands, remote commands store their text offset in args_[0].
+		};
+
 	public:
 		Program(iprogram&);
 
 	public: /* Program control methods. */
 		bool active() const;					// Checks whether the program is currently running.
 		void begin();							// Begins loading a new program.
+		void budget(size_type, uint16_t);		// Sets the maximum instructions and microseconds executed per clock.
 		void end();								// Ends loading a new program.
 		void halt();							// Stops a running program.
 		void instruction(const char*);			// Adds an instruction to a new program.
-		const char* instruction();				// Returns the current program instruction and advances to the next one.
+		bool load(EEStream&, bool&);			// Loads a stored program and its autorun flag, returns true if valid.
 		InstructionSet& instructions();			// Returns a reference to the current instruction set.
+		command_type* lookup(Interpreter::hash_type);	// Returns the instruction matching a packed key, if any.
 		bool loading() const;					// Checks whether a new program is currently loading.
+		bool overflow() const;					// Checks whether the current program has too many lines to compile.
 		size_type next(const char*);			// Returns a pointer to the next instruction.
+		bool resolved() const;					// Checks whether all branch targets are within the current program.
+		static Operand operand(const char*);	// Decodes an instruction operand.
 		void reset();							// Resets the program to the first instruction.		
 		void run();								// Marks the current program as active.
 		size_type size() const;					// Returns the current program size in characters.
+		size_type steps() const;				// Returns the maximum instructions executed per clock.
+		bool store(EEStream&, size_type, bool) const;	// Stores the program and an autorun flag in at most a number of bytes, returns true if it fits.
 		void sleep(std::time_t);				// Puts the program execution to sleep for a given interval.
+		bool sleeping();						// Checks whether the program execution is sleeping.
+		uint16_t slice() const;					// Returns the maximum microseconds executed per clock, 0 = no limit.
+		const char* step();						// Executes the current instruction and advances, returns the text of remote commands.
 		const char* text() const;				// Returns a pointer to the beginning of the program text.
 		const char* tryGet(char*);				// Tries to substitute program status value into a Jack command.
 
 	private:	/* Program instrucution methods. */
-		void add(const char*, const char*);
+		void add(Operand, Operand);
 		void call(size_type);
-		void compare(const char*, const char*);	
-		void decrement(const char*);
-		void divide(const char*, const char*);
-		value_type get(const char*);			
-		void increment(const char*);
+		void compare(Operand, Operand);	
+		void decrement(Operand);
+		void divide(Operand, Operand);
+		value_type get(const Operand&);			
+		void increment(Operand);
 		void jump(size_type);
 		void jumpEqual(size_type);
 		void jumpGreater(size_type);
@@ -157,44 +288,48 @@ namespace pg
 		void jumpNotZero(size_type);
 		void jumpSign(size_type);
 		void jumpZero(size_type);
-		void logicalAnd(const char*, const char*);
-		void logicalOr(const char*, const char*);
-		void logicalTest(const char*, const char*);	// Missing instruction def.
-		void logicalXor(const char*, const char*);
-		void logicalNot(const char*);
+		void logicalAnd(Operand, Operand);
+		void logicalOr(Operand, Operand);
+		void logicalTest(Operand, Operand);	// Missing instruction def.
+		void logicalXor(Operand, Operand);
+		void logicalNot(Operand);
 		void loop(size_type);
-		void modulo(const char*, const char*);
-		void move(const char*, const char*);
-		void multiply(const char*, const char*);
-		void negate(const char*);
-		void pop(const char*);
-		void push(const char*);
+		void modulo(Operand, Operand);
+		void move(Operand, Operand);
+		void multiply(Operand, Operand);
+		void negate(Operand);
+		void pop(Operand);
+		void push(Operand);
 		void ret();
-		void ret(const char*);
-		void subtract(const char*, const char*);
+		void ret(Operand);
+		void subtract(Operand, Operand);
+		static bool branches(Opcode);
+		void compile();
+		void decode(char*, Code&);
+		void execute(const Code&);
 		value_type* getDest(const char*);
-		bool isSysCall(const char*);
-		//value_type getRegVal(const char*);
-		void moveValue(const char*, value_type);
-		bool sleeping();			
+		static uint8_t getRegister(const char*);
+		static bool isSysCall(const char*);
+		void moveValue(const Operand&, value_type);
+		static Opcode opcode(Interpreter::hash_type);
 		void sysSet(const char*, const char*);
 
 	private:	/* Built-in instruction commands */
-		Instruction<const char*, const char*> ins_add_{ Program::KeyAdd, *this, &Program::add };
-		Instruction<const char*, const char*> ins_subtract_{ Program::KeySubtract, *this, &Program::subtract };
-		Instruction<const char*, const char*> ins_multiply_{ Program::KeyMultiply, *this, &Program::multiply };
-		Instruction<const char*, const char*> ins_divide_{ Program::KeyDivide, *this, &Program::divide };
-		Instruction<const char*, const char*> ins_modulo_{ Program::KeyModulo, *this, &Program::modulo };
-		Instruction<const char*, const char*> ins_and_{ Program::KeyLogicalAnd, *this, &Program::logicalAnd };
-		Instruction<const char*, const char*> ins_or_{ Program::KeyLogicalOr, *this, &Program::logicalOr };
-		Instruction<const char*, const char*> ins_test_{ Program::KeyLogicalTest, *this, &Program::logicalTest };
-		Instruction<const char*, const char*> ins_xor_{ Program::KeyLogicalXor, *this, &Program::logicalXor };
-		Instruction<const char*, const char*> ins_compare_{ Program::KeyCompare, *this, &Program::compare };
-		Instruction<const char*, const char*> ins_move_{ Program::KeyMove, *this, &Program::move };
-		Instruction<const char*> ins_not_{ Program::KeyLogicalNot, *this, &Program::logicalNot };
-		Instruction<const char*> ins_decrement_{ Program::KeyDecrement, *this, &Program::decrement };
-		Instruction<const char*> ins_increment_{ Program::KeyIncrement, *this, &Program::increment };
-		Instruction<const char*> ins_negate_{ Program::KeyNegate, *this, &Program::negate };
+		Instruction<Operand, Operand> ins_add_{ Program::KeyAdd, *this, &Program::add };
+		Instruction<Operand, Operand> ins_subtract_{ Program::KeySubtract, *this, &Program::subtract };
+		Instruction<Operand, Operand> ins_multiply_{ Program::KeyMultiply, *this, &Program::multiply };
+		Instruction<Operand, Operand> ins_divide_{ Program::KeyDivide, *this, &Program::divide };
+		Instruction<Operand, Operand> ins_modulo_{ Program::KeyModulo, *this, &Program::modulo };
+		Instruction<Operand, Operand> ins_and_{ Program::KeyLogicalAnd, *this, &Program::logicalAnd };
+		Instruction<Operand, Operand> ins_or_{ Program::KeyLogicalOr, *this, &Program::logicalOr };
+		Instruction<Operand, Operand> ins_test_{ Program::KeyLogicalTest, *this, &Program::logicalTest };
+		Instruction<Operand, Operand> ins_xor_{ Program::KeyLogicalXor, *this, &Program::logicalXor };
+		Instruction<Operand, Operand> ins_compare_{ Program::KeyCompare, *this, &Program::compare };
+		Instruction<Operand, Operand> ins_move_{ Program::KeyMove, *this, &Program::move };
+		Instruction<Operand> ins_not_{ Program::KeyLogicalNot, *this, &Program::logicalNot };
+		Instruction<Operand> ins_decrement_{ Program::KeyDecrement, *this, &Program::decrement };
+		Instruction<Operand> ins_increment_{ Program::KeyIncrement, *this, &Program::increment };
+		Instruction<Operand> ins_negate_{ Program::KeyNegate, *this, &Program::negate };
 		Instruction<std::time_t> ins_sleep_{ Program::KeySleep, *this, &Program::sleep };
 		Instruction<size_type> ins_jump_{ Program::KeyJump, *this, &Program::jump };
 		Instruction<size_type> ins_jumpequal_{ Program::KeyJumpEqual, *this, &Program::jumpEqual };
@@ -202,26 +337,28 @@ namespace pg
 		Instruction<size_type> ins_jumpgreater_{ Program::KeyJumpGreater, *this, &Program::jumpGreater };
 		Instruction<size_type> ins_jumpgreaterequal_{ Program::KeyJumpGreaterEqual, *this, &Program::jumpGreaterEqual };
 		Instruction<size_type> ins_jumpless_{ Program::KeyJumpLess, *this, &Program::jumpLess };
-		Instruction<size_type> ins_jumplessequal_{ Program::KeyJumpLess, *this, &Program::jumpLessEqual };
+		Instruction<size_type> ins_jumplessequal_{ Program::KeyJumpLessEqual, *this, &Program::jumpLessEqual };
 		Instruction<size_type> ins_loop_{ Program::KeyLoop, *this, &Program::loop };
 		Instruction<size_type> ins_call_{ Program::KeyCall, *this, &Program::call };
 		Instruction<void> ins_return_{ Program::KeyReturn, *this, &Program::ret };
-		Instruction<const char*> ins_returnvalue_{ Program::KeyReturn, *this, &Program::ret };
-		Instruction<const char*> ins_push_{ Program::KeyPush, *this, &Program::push };
-		Instruction<const char*> ins_pop_{ Program::KeyPop, *this, &Program::pop };
+		Instruction<Operand> ins_returnvalue_{ Program::KeyReturnValue, *this, &Program::ret };
+		Instruction<Operand> ins_push_{ Program::KeyPush, *this, &Program::push };
+		Instruction<Operand> ins_pop_{ Program::KeyPop, *this, &Program::pop };
 
 	private:	/* Private class members */
 		bool			loading_;			// Flag indicating whether a new program is loading.
 		bool			active_;			// Flag indicating whether the current program is active.
 		char			text_[CharsMax];	// Program text buffer. Instructions stored as consecutive null-terminated strings.
-		char*			ptr_;				// Pointer to the current program instruction.
+		char*			ptr_;				// Pointer to the next free text position while loading.
 		char*			end_;				// Pointer to one past the last program instruction.
+		Code			code_[CodeMax];		// Compiled program instructions.
+		size_type		count_;				// Number of compiled program instructions.
+		bool			overflow_;			// Flag indicating whether the program had too many lines to compile.
+		bool			resolved_;			// Flag indicating whether all branch targets are valid code_ indexes.
 		timer_type		sleep_;				// Program sleep timer.
-		value_type		ax_;				
-		value_type		bx_;
-		value_type		cx_;
-		value_type		dx_;
-		value_type		sr_;
+		size_type		steps_;				// Maximum instructions executed per clock.
+		uint16_t		slice_;				// Maximum microseconds executed per clock, 0 = no limit.
+		value_type		registers_[RegistersCount];	// Program registers, indexed by Registers.
 		stack_type		stack_;
 		iprogram&		system_;			// Reference to the "system" object.
 		InstructionSet	instructions_;		// The current instruction set.
@@ -230,16 +367,13 @@ namespace pg
 #pragma region public program control methods
 
 	Program::Program(iprogram& system) :
-		loading_(), active_(), text_{}, ptr_(text_), end_(ptr_), sleep_(),
-		ax_(), bx_(), cx_(), dx_(), sr_(), stack_(), system_(system), 
+		loading_(), active_(), text_{}, ptr_(text_), end_(ptr_), code_(), count_(), overflow_(), resolved_(), sleep_(),
+		steps_(__PG_PROGRAM_STEPS), slice_(__PG_PROGRAM_SLICE), registers_(), stack_(), system_(system), 
 		instructions_({ &ins_compare_, &ins_move_, &ins_negate_, &ins_not_, &ins_sleep_, &ins_jump_, &ins_jumpequal_,
 			&ins_jumpnotequal_, &ins_jumpless_, &ins_jumplessequal_, &ins_jumpgreater_, &ins_jumpgreaterequal_,
 			&ins_loop_, &ins_decrement_, &ins_increment_, &ins_add_, &ins_subtract_, &ins_multiply_,
 			&ins_divide_, &ins_modulo_, &ins_and_, &ins_or_, &ins_test_, &ins_xor_, &ins_call_, &ins_return_,
-			&ins_returnvalue_, &ins_push_, &ins_pop_ })
-	{
-		std::sort(std::begin(instructions_), std::end(instructions_), cbcomp);
-	}
+			&ins_returnvalue_, &ins_push_, &ins_pop_ }) {}
 
 	bool Program::active() const
 	{
@@ -252,10 +386,17 @@ namespace pg
 		{
 			loading_ = true;
 			ptr_ = end_ = text_;
+			count_ = 0;
 			*ptr_ = '\0';	// Start of text marked with NULL.
 		}
 	}
 
+	void Program::budget(size_type steps, uint16_t slice)
+	{
+		steps_ = steps ? steps : 1;	// At least one instruction per clock.
+		slice_ = slice;
+	}
+
 	void Program::end()
 	{
 		if (loading_)
@@ -263,24 +404,11 @@ namespace pg
 			loading_ = false;
 			*ptr_ = '\0';	// End of text marked with NULL one past the last instruction.
 			ptr_ = text_;
+			compile();
+			registers_[Pc] = 0;
 		}
 	}
 
-	Program::value_type Program::get(const char* arg)
-	{
-		Program::value_type value = 0;
-		value_type* dest = nullptr;
-
-		if (isSysCall(arg))
-			value = system_.sys_get(arg);
-		else if ((dest = getDest(arg)))
-			value = *dest;
-		else
-			value = std::atol(arg);
-
-		return value;
-	}
-
 	void Program::halt()
 	{
 		active_ = false;
@@ -296,14 +424,50 @@ namespace pg
 		}
 	}
 
-	const char* Program::instruction()
+	bool Program::load(EEStream& eeprom, bool& autorun)
 	{
-		const char* ins = ((active_ &= ptr_ < end_) && !sleeping()) ? ptr_ : nullptr;
+		// The stored text is checked in blocks before it replaces the current program.
 
-		if (ins)
-			ptr_ += next(ptr_);
+		const EEStream::address_type address = eeprom.address();
+		size_type size = 0;
+		uint8_t flags = 0;
+		typename crc_type::value_type value = 0;
+		crc_engine<crc_type> crc;
+		bool result = false;
 
-		return ins;
+		if (!(active_ || loading_))
+		{
+			eeprom >> size >> flags;
+			if (size <= CharsMax - 2 * sizeof(char))	// Room for the two terminating NULLs.
+			{
+				crc.update(reinterpret_cast<const uint8_t*>(&size), reinterpret_cast<const uint8_t*>(&size + 1));
+				crc.update(flags);
+				for (size_type n = 0; n < size;)
+				{
+					uint8_t buf[16];
+					const size_type count = std::min<size_type>(sizeof(buf), size - n);
+
+					eeprom.read(buf, count);
+					crc.update(buf, buf + count);
+					n += count;
+				}
+				eeprom >> value;
+				if ((result = (value == crc.value())))
+				{
+					eeprom.address() = address + sizeof(size) + sizeof(flags);
+					eeprom.read(text_, size);
+					text_[size] = text_[size + 1] = '\0';
+					ptr_ = text_;
+					end_ = text_ + size;
+					compile();
+					registers_[Pc] = 0;
+					autorun = flags != 0;
+				}
+			}
+			eeprom.address() = address + StoreOverhead + size;
+		}
+
+		return result;
 	}
 
 	Program::InstructionSet& Program::instructions()
@@ -311,20 +475,37 @@ namespace pg
 		return instructions_;
 	}
 
+	typename Program::command_type* Program::lookup(Interpreter::hash_type key)
+	{
+		Opcode op = opcode(key);
+
+		return op != OpCommand ? instructions_[op] : nullptr;
+	}
+
+	bool Program::resolved() const
+	{
+		return resolved_;
+	}
+
 	bool Program::loading() const
 	{
 		return loading_;
 	}
+
+	bool Program::overflow() const
+	{
+		return overflow_;
+	}
 	
 	void Program::reset()
 	{
 		if (!loading_)
-			ptr_ = text_;
+			registers_[Pc] = 0;
 	}
 
 	void Program::run()
 	{
-		active_ = !(loading_ || size() == 0);
+		active_ = !(loading_ || count_ == 0);	// Programs too long to compile can't be run.
 	}
 
 	typename Program::size_type Program::size() const
@@ -332,12 +513,67 @@ namespace pg
 		return std::distance(const_cast<char* const>(text_), end_);
 	}
 
+	bool Program::store(EEStream& eeprom, size_type max, bool autorun) const
+	{
+		const size_type size = this->size();
+		const uint8_t flags = autorun;
+		bool result = !loading_ && size + StoreOverhead <= max;
+
+		if (result)
+		{
+			crc_engine<crc_type> crc;
+
+			crc.update(reinterpret_cast<const uint8_t*>(&size), reinterpret_cast<const uint8_t*>(&size + 1));
+			crc.update(flags);
+			crc.update(text_, text_ + size);
+			eeprom << size << flags;
+			eeprom.write(text_, size);
+			eeprom << crc.value();
+		}
+
+		return result;
+	}
+
 	void Program::sleep(std::time_t duration)
 	{
 		sleep_.interval(std::chrono::milliseconds(duration));
 		sleep_.start();
 	}
 
+	bool Program::sleeping()
+	{
+		// timer may roll over if run for long time, might want to stop when expired.
+		return sleep_.active() && !sleep_.expired();
+	}
+
+	uint16_t Program::slice() const
+	{
+		return slice_;
+	}
+
+	typename Program::size_type Program::steps() const
+	{
+		return steps_;
+	}
+
+	const char* Program::step()
+	{
+		const char* command = nullptr;
+		value_type& pc = registers_[Pc];
+
+		if ((active_ &= (pc >= 0 && pc < count_)) && !sleeping())
+		{
+			const Code& code = code_[pc++];
+
+			if (code.op_ == OpCommand)
+				command = text_ + code.args_[0].value_;
+			else
+				execute(code);
+		}
+
+		return command;
+	}
+
 	const char* Program::text() const
 	{
 		return text_;
@@ -345,7 +581,7 @@ namespace pg
 
 	const char* Program::tryGet(char* cmd)
 	{
-		char buf[Connection::size()] = { '\0' };
+		static char buf[Connection::size()];	// Returned to the caller, must outlive this call.
 		char* reg = std::strncpy(buf, cmd, sizeof(buf));
 		char* result = buf;
 
@@ -366,140 +602,308 @@ namespace pg
 #pragma endregion
 #pragma region private
 
+	bool Program::branches(Opcode op)
+	{
+		return (op >= OpJump && op <= OpLoop) || op == OpCall;
+	}
+
+	void Program::compile()
+	{
+		// Pre-decodes each line of program text into code_.
+		char* line = text_;
+
+		count_ = 0;
+		while (*line && count_ < CodeMax)
+		{
+			decode(line, code_[count_++]);
+			line += next(line);
+		}
+		if ((overflow_ = *line))
+			count_ = 0;	// Too many instructions to compile.
+
+		// Branch operands are code_ indexes, so jumps, loops and calls take constant 
+		// time. Once all lines are compiled, check that every target is in range.
+		resolved_ = true;
+		for (size_type i = 0; i < count_; ++i)
+			if (branches(code_[i].op_) && !(code_[i].args_[0].value_ < count_))
+				resolved_ = false;
+	}
+
+	void Program::decode(char* line, Code& code)
+	{
+		// Lines that aren't valid program instructions are kept as remote commands.
+		tokenizer tok(line);
+
+		code.op_ = OpCommand;
+		code.args_[0] = Operand{ Operand::Literal, '\0', static_cast<value_type>(line - text_) };
+		if (tok.next(Interpreter::CmdDelimChars))
+		{
+			Opcode op = opcode(Interpreter::hash(tok.token(), tok.size()));
+			tokenizer args(tok);
+
+			// Let the instruction object check the operands count and types.
+			if (op != OpCommand && instructions_[op]->assemble(args))
+			{
+				code.op_ = op;
+				for (size_type i = 0; i < OperandsMax && tok.next(Interpreter::ArgDelimChars); ++i)
+					code.args_[i] = operand(tok.token());
+			}
+		}
+	}
+
+	void Program::execute(const Code& code)
+	{
+		const Operand& a = code.args_[0];
+		const Operand& b = code.args_[1];
+
+		switch (code.op_)
+		{
+		case OpCompare: compare(a, b); break;
+		case OpMove: move(a, b); break;
+		case OpNegate: negate(a); break;
+		case OpNot: logicalNot(a); break;
+		case OpSleep: sleep(a.value_); break;
+		case OpJump: jump(a.value_); break;
+		case OpJumpEqual: jumpEqual(a.value_); break;
+		case OpJumpNotEqual: jumpNotEqual(a.value_); break;
+		case OpJumpLess: jumpLess(a.value_); break;
+		case OpJumpLessEqual: jumpLessEqual(a.value_); break;
+		case OpJumpGreater: jumpGreater(a.value_); break;
+		case OpJumpGreaterEqual: jumpGreaterEqual(a.value_); break;
+		case OpLoop: loop(a.value_); break;
+		case OpDecrement: decrement(a); break;
+		case OpIncrement: increment(a); break;
+		case OpAdd: add(a, b); break;
+		case OpSubtract: subtract(a, b); break;
+		case OpMultiply: multiply(a, b); break;
+		case OpDivide: divide(a, b); break;
+		case OpModulo: modulo(a, b); break;
+		case OpAnd: logicalAnd(a, b); break;
+		case OpOr: logicalOr(a, b); break;
+		case OpTest: logicalTest(a, b); break;
+		case OpXor: logicalXor(a, b); break;
+		case OpCall: call(a.value_); break;
+		case OpReturn: ret(); break;
+		case OpReturnValue: ret(a); break;
+		case OpPush: push(a); break;
+		case OpPop: pop(a); break;
+		default: break;
+		}
+	}
+
+	Program::value_type Program::get(const Operand& arg)
+	{
+		value_type value = arg.value_;
+
+		switch (arg.type_)
+		{
+		case Operand::Register:
+			value = registers_[arg.value_];
+			break;
+		case Operand::SystemCall:
+			value = system_.sys_get(arg.call_, arg.value_);
+			break;
+		default:
+			break;
+		}
+
+		return value;
+	}
+
 	Program::value_type* Program::getDest(const char* arg)
 	{
-		value_type* dest = nullptr;
+		uint8_t reg = getRegister(arg);
+
+		return reg < RegistersCount ? &registers_[reg] : nullptr;
+	}
+
+	uint8_t Program::getRegister(const char* arg)
+	{
+		uint8_t reg = RegistersCount;
 		char c = 'x';
 
 		switch (*arg)
 		{
 		case 'a':
-			dest = &ax_;
+			reg = Ax;
 			break;
 		case 'b':
-			dest = &bx_;
+			reg = Bx;
 			break;
 		case 'c':
-			dest = &cx_;
+			reg = Cx;
 			break;
 		case 'd':
-			dest = &dx_;
+			reg = Dx;
 			break;
 		case 'p':
-			dest = reinterpret_cast<value_type*>(&ptr_);
+			reg = Pc;
 			c = 'c';
 			break;
 		case 's':
-			dest = &sr_;
+			reg = Sr;
 			c = 'r';
 			break;
 		default:
 			break;
 		}
 
-		return dest && *(arg + 1) == c ? dest : nullptr;
+		return *(arg + 1) == c ? reg : RegistersCount;
 	}
 
 	bool Program::isSysCall(const char* arg)
 	{
-		return std::strpbrk(arg, SystemCallChars) == arg;
+		return *arg && std::strchr(SystemCallChars, *arg);
+	}
+
+	void Program::moveValue(const Operand& arg, value_type value)
+	{
+		if (arg.type_ == Operand::Register)
+			registers_[arg.value_] = value;
 	}
 
-	void Program::moveValue(const char* arg, value_type value)
+	typename Program::Opcode Program::opcode(Interpreter::hash_type key)
 	{
-		value_type* dest = getDest(arg);
+		Opcode op = OpCommand;
 
-		if(dest)
-			*dest = value;
+		switch (key)
+		{
+		case Interpreter::hash(KeyAdd): op = OpAdd; break;
+		case Interpreter::hash(KeyCall): op = OpCall; break;
+		case Interpreter::hash(KeyCompare): op = OpCompare; break;
+		case Interpreter::hash(KeyDecrement): op = OpDecrement; break;
+		case Interpreter::hash(KeyDivide): op = OpDivide; break;
+		case Interpreter::hash(KeyIncrement): op = OpIncrement; break;
+		case Interpreter::hash(KeyJump): op = OpJump; break;
+		case Interpreter::hash(KeyJumpEqual): op = OpJumpEqual; break;
+		case Interpreter::hash(KeyJumpNotEqual): op = OpJumpNotEqual; break;
+		case Interpreter::hash(KeyJumpGreater): op = OpJumpGreater; break;
+		case Interpreter::hash(KeyJumpGreaterEqual): op = OpJumpGreaterEqual; break;
+		case Interpreter::hash(KeyJumpLess): op = OpJumpLess; break;
+		case Interpreter::hash(KeyJumpLessEqual): op = OpJumpLessEqual; break;
+		case Interpreter::hash(KeyLogicalAnd): op = OpAnd; break;
+		case Interpreter::hash(KeyLogicalNot): op = OpNot; break;
+		case Interpreter::hash(KeyLogicalOr): op = OpOr; break;
+		case Interpreter::hash(KeyLogicalTest): op = OpTest; break;
+		case Interpreter::hash(KeyLogicalXor): op = OpXor; break;
+		case Interpreter::hash(KeyLoop): op = OpLoop; break;
+		case Interpreter::hash(KeyModulo): op = OpModulo; break;
+		case Interpreter::hash(KeyMove): op = OpMove; break;
+		case Interpreter::hash(KeyMultiply): op = OpMultiply; break;
+		case Interpreter::hash(KeyNegate): op = OpNegate; break;
+		case Interpreter::hash(KeyPop): op = OpPop; break;
+		case Interpreter::hash(KeyPush): op = OpPush; break;
+		case Interpreter::hash(KeyReturn): op = OpReturn; break;
+		case Interpreter::hash(KeyReturnValue): op = OpReturnValue; break;
+		case Interpreter::hash(KeySleep): op = OpSleep; break;
+		case Interpreter::hash(KeySubtract): op = OpSubtract; break;
+		default: break;
+		}
+
+		return op;
 	}
 
-	Program::size_type Program::next(const char* ptr)
+	typename Program::Operand Program::operand(const char* arg)
 	{
-		return std::strlen(ptr) + sizeof(char);
+		// Operands are decoded once, when the program is compiled.
+		Operand result{ Operand::Literal, '\0', 0 };
+		uint8_t reg = getRegister(arg);
+
+		if (isSysCall(arg))
+		{
+			result.type_ = Operand::SystemCall;
+			result.call_ = *arg;
+			(void)std::from_chars(arg + 1, arg + std::strlen(arg), result.value_, 0);
+		}
+		else if (reg < RegistersCount)
+		{
+			result.type_ = Operand::Register;
+			result.value_ = reg;
+		}
+		else
+			(void)std::from_chars(arg, arg + std::strlen(arg), result.value_, 0);
+
+		return result;
 	}
 
-	bool Program::sleeping()
+	Program::size_type Program::next(const char* ptr)
 	{
-		// timer may roll over if run for long time, might want to stop when expired.
-		return sleep_.active() && !sleep_.expired();
+		return std::strlen(ptr) + sizeof(char);
 	}
 
 #pragma endregion
 #pragma region instructions
 
-	void Program::add(const char* arg1, const char* arg2)
+	void Program::add(Operand arg1, Operand arg2)
 	{
-		moveValue(arg1, (sr_ = get(arg1) + get(arg2)));
+		moveValue(arg1, (registers_[Sr] = get(arg1) + get(arg2)));
 	}
 
 	void Program::call(size_type address)
 	{
-		push("pc");
-		push("sr");
+		stack_.push(registers_[Pc]);
+		stack_.push(registers_[Sr]);
 		jump(address);
 	}
 
-	void Program::compare(const char* arg1, const char* arg2)
+	void Program::compare(Operand arg1, Operand arg2)
 	{
-		sr_ = get(arg1) - get(arg2);
+		registers_[Sr] = get(arg1) - get(arg2);
 	}
 
-	void Program::decrement(const char* arg)
+	void Program::decrement(Operand arg)
 	{
-		moveValue(arg, (sr_ = get(arg) - 1));
+		moveValue(arg, (registers_[Sr] = get(arg) - 1));
 	}
 
-	void Program::divide(const char* arg1, const char* arg2)
+	void Program::divide(Operand arg1, Operand arg2)
 	{
-		moveValue(arg1, (sr_ = get(arg1) / get(arg2)));
+		moveValue(arg1, (registers_[Sr] = get(arg1) / get(arg2)));
 	}
 
-	void Program::increment(const char* arg)
+	void Program::increment(Operand arg)
 	{
-		moveValue(arg, (sr_ = get(arg) + 1));
+		moveValue(arg, (registers_[Sr] = get(arg) + 1));
 	}
 
 	void Program::jump(size_type n)
 	{
-		// This could be slow in large programs.
-		ptr_ = text_;
-		while (n--)
-			ptr_ += next(ptr_);
+		registers_[Pc] = n;
 	}
 
 	void Program::jumpEqual(size_type address)
 	{
-		if (sr_ == 0)
+		if (registers_[Sr] == 0)
 			jump(address);
 	}
 
 	void Program::jumpGreater(size_type address)
 	{
-		if (sr_ > 0)
+		if (registers_[Sr] > 0)
 			jump(address);
 	}
 
 	void Program::jumpGreaterEqual(size_type address)
 	{
-		if (sr_ >= 0)
+		if (registers_[Sr] >= 0)
 			jump(address);
 	}
 
 	void Program::jumpLess(size_type address)
 	{
-		if (sr_ < 0)
+		if (registers_[Sr] < 0)
 			jump(address);
 	}
 
 	void Program::jumpLessEqual(size_type address)
 	{
-		if (sr_ <= 0)
+		if (registers_[Sr] <= 0)
 			jump(address);
 	}
 
 	void Program::jumpNotEqual(size_type address)
 	{
-		if (sr_ != 0)
+		if (registers_[Sr] != 0)
 			jump(address);
 	}
 
@@ -523,91 +927,88 @@ namespace pg
 		jumpEqual(address);
 	}
 
-	void Program::logicalAnd(const char* arg1, const char* arg2)
+	void Program::logicalAnd(Operand arg1, Operand arg2)
 	{
-		moveValue(arg1, (sr_ = get(arg1) & get(arg2)));
+		moveValue(arg1, (registers_[Sr] = get(arg1) & get(arg2)));
 	}
 
-	void Program::logicalOr(const char* arg1, const char* arg2)
+	void Program::logicalOr(Operand arg1, Operand arg2)
 	{
-		moveValue(arg1, (sr_ = get(arg1) | get(arg2)));
+		moveValue(arg1, (registers_[Sr] = get(arg1) | get(arg2)));
 	}
 
-	void Program::logicalTest(const char* arg1, const char* arg2)
+	void Program::logicalTest(Operand arg1, Operand arg2)
 	{
-		sr_ = get(arg1) & get(arg2);
+		registers_[Sr] = get(arg1) & get(arg2);
 	}
 
-	void Program::logicalXor(const char* arg1, const char* arg2)
+	void Program::logicalXor(Operand arg1, Operand arg2)
 	{
-		moveValue(arg1, (sr_ = get(arg1) ^ get(arg2)));
+		moveValue(arg1, (registers_[Sr] = get(arg1) ^ get(arg2)));
 	}
 
-	void Program::logicalNot(const char* arg)
+	void Program::logicalNot(Operand arg)
 	{
-		moveValue(arg, (sr_ = ~get(arg)));
+		moveValue(arg, (registers_[Sr] = ~get(arg)));
 	}
 
 	void Program::loop(size_type address)
 	{
-		if (--cx_ > 0)
+		if (--registers_[Cx] > 0)
 			jump(address);
 	}
 
-	void Program::modulo(const char* arg1, const char* arg2)
+	void Program::modulo(Operand arg1, Operand arg2)
 	{
-		moveValue(arg1, (sr_ = get(arg1) % get(arg2)));
+		moveValue(arg1, (registers_[Sr] = get(arg1) % get(arg2)));
 	}
 
-	void Program::multiply(const char* arg1, const char* arg2)
+	void Program::multiply(Operand arg1, Operand arg2)
 	{
-		moveValue(arg1, (sr_ = get(arg1) * get(arg2)));
+		moveValue(arg1, (registers_[Sr] = get(arg1) * get(arg2)));
 	}
 
-	void Program::move(const char* arg1, const char* arg2)
+	void Program::move(Operand arg1, Operand arg2)
 	{
 		moveValue(arg1, get(arg2));
 	}
 
-	void Program::negate(const char* arg)
+	void Program::negate(Operand arg)
 	{
 		moveValue(arg, -get(arg));
 	}
 
-	void Program::pop(const char* arg)
+	void Program::pop(Operand arg)
 	{
-		value_type* dest = getDest(arg);
-
-		if (dest)
+		if (arg.type_ == Operand::Register)
 		{
-			if (dest == reinterpret_cast<value_type*>(&ptr_))
-				ptr_ = reinterpret_cast<char*>(stack_.top());
-			else
-				*dest = stack_.top();
+			registers_[arg.value_] = stack_.top();
 			stack_.pop();
 		}
 	}
 
-	void Program::push(const char* arg)
+	void Program::push(Operand arg)
 	{
 		stack_.push(get(arg));
 	}
 
 	void Program::ret()
 	{
-		pop("sr");
-		pop("pc");
+		registers_[Sr] = stack_.top();
+		stack_.pop();
+		registers_[Pc] = stack_.top();
+		stack_.pop();
 	}
 
-	void Program::ret(const char* arg)
+	void Program::ret(Operand arg)
 	{
 		ret();
 		push(arg);
 	}
 
-	void Program::subtract(const char* arg1, const char* arg2)
+	void Program::subtract(Operand arg1, Operand arg2)
 	{
-		moveValue(arg1, (sr_ = get(arg1) - get(arg2)));
+		moveValue(arg1, (registers_[Sr] = get(arg1) - get(arg2)));
 	}
 
 #pragma endregion
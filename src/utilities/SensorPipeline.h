@@ -0,0 +1,289 @@
+/*
+ *	This file defines a lazily evaluated, multi-channel sensor pipeline.
+ *
+ *	***************************************************************************
+ *
+ *	File: SensorPipeline.h
+ *	Date: October 14, 2026
+ *	Version: 1.0
+ *	Author: Michael Brodsky
+ *	Email: mbrodskiis@gmail.com
+ *	Copyright (c) 2012-2022 Michael Brodsky
+ *
+ *	***************************************************************************
+ *
+ *  This file is part of "Pretty Good" (Pg). "Pg" is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  This file is distributed in the hope that it will be useful, but
+ *	WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this file. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *	**************************************************************************
+ *
+ *	Description:
+ *
+ *	The `SensorPipeline' class composes the stages that turn raw sensor
+ *	readings into displayed values, such as an AnalogInput, a MovingAverage
+ *	and the thermistor and unit conversions in <lib/thermo.h>, into one
+ *	type at compile time, with no heap allocations. Its template parameters
+ *	are the number of channels N, the `Source', the `Filter' and any number
+ *	of `Stages':
+ *
+ *		Source: a callable that returns the raw reading of a channel in
+ *			[0, N), such as `AnalogSource' below.
+ *		Filter: a filter type with the MovingAverage interface, such as
+ *			those in <utilities/MovingAverage.h> and <utilities/Filters.h>,
+ *			or `NullFilter' to pass readings through unfiltered. Each
+ *			channel has its own filter.
+ *		Stages: callables, such as function pointers, function objects or
+ *			temperature_table objects, each taking the output of the one
+ *			before it. Stage types can be references, so large stages like
+ *			tables aren't copied. Stages are shared by all channels.
+ *
+ *	The `clock()' method reads and filters every channel, and should be
+ *	run at the sensor sampling rate, for instance by a scheduled task,
+ *	since filters must see every reading. The stages aren't run until a
+ *	consumer, such as a display refresh or an alarm check, calls
+ *	`sample()', which then runs only the stages whose inputs changed since
+ *	that channel was last sampled: each stage caches its output per
+ *	channel and the remaining stages are skipped as soon as an output
+ *	doesn't change. Stage outputs must be comparable with operator==.
+ *
+ *		AnalogInput<> probe0(A0), probe1(A1);
+ *		AnalogInput<>* probes[] = { &probe0, &probe1 };
+ *		temperature_table<float> table;
+ *		using Probes = SensorPipeline<2, AnalogSource<2>, MovingAverage<analog_t, 8>,
+ *			const temperature_table<float>&, float(*)(float)>;
+ *
+ *		Probes probes_pipeline(AnalogSource<2>(probes), table, &temperature<units::celsius, float>);
+ *		...
+ *		probes_pipeline.clock();			// Reads and filters both probes.
+ *		float t0 = probes_pipeline.sample(0);	// Converts probe0 if its average changed.
+ *
+ *	The `changed()' method checks whether a channel's filtered reading has
+ *	changed since it was last sampled, and `seed()' seeds the filters with
+ *	the current readings.
+ *
+ *	**************************************************************************/
+
+#if !defined __PG_SENSORPIPELINE_H
+# define __PG_SENSORPIPELINE_H 20261014L
+
+# include <cstddef>						// std::size_t
+# include <type_traits>					// std::remove_cvref, std::declval
+# include <interfaces/iclockable.h>		// iclockable interface.
+# include <components/AnalogInput.h>	// AnalogInput type.
+
+# if defined __PG_HAS_NAMESPACES
+
+namespace pg
+{
+	// Pipeline source that reads an array of N AnalogInput objects.
+	template<std::size_t N, class T = analog_t>
+	class AnalogSource
+	{
+	public:
+		using value_type = T;
+		using input_type = AnalogInput<T>;
+
+	public:
+		// Constructs a source that reads an array of inputs.
+		explicit AnalogSource(input_type* (&inputs)[N]) : inputs_(inputs) {}
+
+	public:
+		// Reads and returns a channel's input value.
+		value_type operator()(std::size_t channel) { return (*inputs_[channel])(); }
+
+	private:
+		input_type** inputs_;	// The channel inputs.
+	};
+
+	// Pipeline filter that passes readings through unfiltered.
+	template<class T>
+	class NullFilter
+	{
+	public:
+		using value_type = T;
+
+	public:
+		// Seeds the filter with a value.
+		void seed(value_type value) { value_ = value; }
+		// Updates the filter state with a value and returns it.
+		const value_type& out(const value_type& value) { return (value_ = value); }
+		// Returns the last value.
+		const value_type& out() const { return value_; }
+
+	private:
+		value_type value_{};	// The last value.
+	};
+
+	namespace details
+	{
+		// Pipeline link that runs stage S on inputs of type In, followed by the remaining Stages.
+		template<std::size_t N, class In, class... Stages>
+		class pipeline_link;
+
+		// Last pipeline link, returns its input.
+		template<std::size_t N, class In>
+		class pipeline_link<N, In>
+		{
+		public:
+			using value_type = In;
+
+		public:
+			const value_type& eval(std::size_t, const In& in, bool) { return in; }
+		};
+
+		template<std::size_t N, class In, class S, class... Stages>
+		class pipeline_link<N, In, S, Stages...>
+		{
+		public:
+			using output_type = typename std::remove_cvref<decltype(std::declval<S&>()(std::declval<const In&>()))>::type;
+			using next_type = pipeline_link<N, output_type, Stages...>;
+			using value_type = typename next_type::value_type;
+
+		public:
+			explicit pipeline_link(S stage, Stages... stages) : stage_(stage), out_(), next_(stages...) {}
+
+		public:
+			// Runs the stage if its input changed and returns the last link's output.
+			const value_type& eval(std::size_t channel, const In& in, bool changed)
+			{
+				if (changed)
+				{
+					output_type out = stage_(in);
+
+					changed = !(out == out_[channel]);
+					out_[channel] = out;
+				}
+
+				return next_.eval(channel, out_[channel], changed);
+			}
+
+		private:
+			S			stage_;		// The stage callable.
+			output_type	out_[N];	// The last stage outputs, per channel.
+			next_type	next_;		// The remaining links.
+		};
+	} // namespace details
+
+	// Lazily evaluated, multi-channel sensor pipeline.
+	template<std::size_t N, class Source, class Filter, class... Stages>
+	class SensorPipeline : public iclockable
+	{
+	public:
+		using source_type = Source;
+		using filter_type = Filter;
+		using filtered_type = typename filter_type::value_type;
+		using link_type = details::pipeline_link<N, filtered_type, Stages...>;
+		using value_type = typename link_type::value_type;
+		using size_type = std::size_t;
+
+	public:
+		// Constructs a pipeline from a source and its stages.
+		explicit SensorPipeline(Source, Stages...);
+
+	public:
+		// Returns the number of channels.
+		constexpr size_type size() const { return N; }
+		// Seeds every channel's filter with its current reading.
+		void seed();
+		// Reads and filters a new reading from every channel.
+		void clock() override;
+		// Runs a channel's changed stages and returns its output value.
+		value_type sample(size_type);
+		// Checks whether a channel's filtered reading has changed since it was last sampled.
+		bool changed(size_type) const;
+		// Returns a channel's filter.
+		filter_type& filter(size_type);
+		// Returns the pipeline source.
+		source_type& source();
+
+	private:
+		source_type		source_;			// The channel readings source.
+		filter_type		filters_[N];		// The channel filters.
+		filtered_type	filtered_[N];		// The last filtered readings.
+		bool			changed_[N];		// Flags indicating whether the filtered readings changed since they were sampled.
+		link_type		links_;				// The pipeline stages.
+	};
+
+#pragma region member_funcs
+
+	template<std::size_t N, class Source, class Filter, class... Stages>
+	SensorPipeline<N, Source, Filter, Stages...>::SensorPipeline(Source source, Stages... stages) :
+		source_(source), filters_(), filtered_(), changed_(), links_(stages...)
+	{
+		for (auto& i : changed_)
+			i = true;
+	}
+
+	template<std::size_t N, class Source, class Filter, class... Stages>
+	void SensorPipeline<N, Source, Filter, Stages...>::seed()
+	{
+		for (size_type i = 0; i < N; ++i)
+		{
+			filters_[i].seed(source_(i));
+			filtered_[i] = filters_[i].out();
+			changed_[i] = true;
+		}
+	}
+
+	template<std::size_t N, class Source, class Filter, class... Stages>
+	void SensorPipeline<N, Source, Filter, Stages...>::clock()
+	{
+		for (size_type i = 0; i < N; ++i)
+		{
+			const filtered_type& value = filters_[i].out(source_(i));
+
+			if (!(value == filtered_[i]))
+			{
+				filtered_[i] = value;
+				changed_[i] = true;
+			}
+		}
+	}
+
+	template<std::size_t N, class Source, class Filter, class... Stages>
+	typename SensorPipeline<N, Source, Filter, Stages...>::value_type
+		SensorPipeline<N, Source, Filter, Stages...>::sample(size_type channel)
+	{
+		const bool changed = changed_[channel];
+
+		changed_[channel] = false;
+
+		return links_.eval(channel, filtered_[channel], changed);
+	}
+
+	template<std::size_t N, class Source, class Filter, class... Stages>
+	bool SensorPipeline<N, Source, Filter, Stages...>::changed(size_type channel) const
+	{
+		return changed_[channel];
+	}
+
+	template<std::size_t N, class Source, class Filter, class... Stages>
+	typename SensorPipeline<N, Source, Filter, Stages...>::filter_type&
+		SensorPipeline<N, Source, Filter, Stages...>::filter(size_type channel)
+	{
+		return filters_[channel];
+	}
+
+	template<std::size_t N, class Source, class Filter, class... Stages>
+	typename SensorPipeline<N, Source, Filter, Stages...>::source_type&
+		SensorPipeline<N, Source, Filter, Stages...>::source()
+	{
+		return source_;
+	}
+
+#pragma endregion
+} // namespace pg
+
+# endif // defined __PG_HAS_NAMESPACES
+
+#endif // !defined __PG_SENSORPIPELINE_H
@@ -43,10 +43,28 @@
  *		their member methods. The TaskScheduler does not modify any task 
  *		properties on its own.
  * 
+ *		On multi-core boards (see <system/multicore.h>), each core calls 
+ *		`tick(core_id())' from its own loop. Tasks pinned to a core with 
+ *		`affinity()' only run on that core, and tasks left on `Task::AnyCore' 
+ *		run on whichever core first finds them due, so a core that is idle 
+ *		picks up ready tasks while the other is busy. A shared task is 
+ *		claimed under a `core_lock' before it runs, so it never runs on both 
+ *		cores at once. For example, network I/O tasks can be pinned to core 0 
+ *		and control loop tasks to core 1, passing messages through an 
+ *		`spsc_queue'.
+ * 
  *	Notes:
  * 
  *		Preemptive multitasking requires re-entrant API functions. Check the 
- *		Arduino documentation for compatibility.
+ *		Arduino documentation for compatibility. On multi-core boards, only 
+ *		`tick(core)' may be called from more than one core.
+ * 
+ *		All schedulers with the same duration type share one claims lock, 
+ *		because each `core_lock' takes one of the RP2040's 32 hardware spin 
+ *		locks, and only a few of those are free for applications. The lock 
+ *		is built by the first scheduler constructed, so schedulers must be 
+ *		constructed before the second core starts ticking, such as globals 
+ *		or in setup().
  * 
  *	**************************************************************************/
 
@@ -54,7 +72,11 @@
 # define __PG_TASKSCHEDULER_H 20211225L 
 
 # include <array>						// Fixed-size array types.
+# include <system/multicore.h>		// core_lock type.
 # include <utilities/CommandTimer.h>	// CommandTimer type.
+# if defined __PG_TASK_STATS
+#  include <utilities/TaskStats.h>	// TaskStats type.
+# endif
 
 # if defined __PG_HAS_NAMESPACES 
 
@@ -81,11 +103,13 @@ namespace pg
 				Active		// Indicates the task is currently active.
 			};
 
+			static constexpr uint8_t AnyCore = 0xFF;	// Affinity of tasks that run on any core.
+
 		public:
 			// Constructs an uninitialized task.
 			Task() = default;
-			// Constructs a task with a given interval, command and state.
-			Task(duration, icommand*, State = State::Idle);
+			// Constructs a task with a given interval, command, state and core affinity.
+			Task(duration, icommand*, State = State::Idle, uint8_t = AnyCore);
 			// Move constructor.
 			Task(Task&&) = default;
 			// No copy constructor.
@@ -108,10 +132,25 @@ namespace pg
 			const State& state() const;
 			// Resets the task timer.
 			void reset();
+			// Sets the core the task runs on, or AnyCore.
+			void affinity(uint8_t);
+			// Returns the core the task runs on, or AnyCore.
+			uint8_t affinity() const;
+# if defined __PG_TASK_STATS
+			// Returns a mutable reference to the task execution statistics.
+			TaskStats& stats();
+			// Returns an immutable reference to the task execution statistics.
+			const TaskStats& stats() const;
+# endif
 			
 		private:
-			timer_type	timer_; // Task timer and executor.
-			State		state_;	// The current task state.
+			timer_type	timer_;		// Task timer and executor.
+			State		state_;		// The current task state.
+			uint8_t		affinity_ = AnyCore;	// The core the task runs on, or AnyCore.
+			bool		claimed_ = false;		// Flag indicating whether a core is running the task.
+# if defined __PG_TASK_STATS
+			TaskStats	stats_;	// Task execution statistics.
+# endif
 		};
 
 	public:
@@ -162,12 +201,25 @@ namespace pg
 		const container_type& tasks() const;
 		// Returns a mutable reference to the current tasks collection.
 		container_type& tasks();
+		// Returns the time remaining until the next task is due, or duration::max() if none are active.
+		duration remaining() const;
 		// Executes any currently active scheduled tasks.
 		void tick();
+		// Executes any currently active scheduled tasks pinned to a core or shared by all cores.
+		void tick(uint8_t);
+
+	private:
+		// Runs a task if its interval has expired.
+		static void run(Task*);
+		// Claims a shared task that is due and returns true, or returns false if another core has.
+		bool claim(Task*);
+		// Returns the claims lock shared by all schedulers.
+		static core_lock& claims();
 
 	private:
 		container_type	tasks_;	// The current tasks collection.
 		State			state_;	// The current scheduler state.
+		core_lock*		lock_ = &claims();	// Shared task claims lock.
 	};
 
 #pragma region TaskScheduler
@@ -280,6 +332,27 @@ namespace pg
 		return state_;
 	}
 
+	template<class T>
+	typename TaskScheduler<T>::duration TaskScheduler<T>::remaining() const
+	{
+		duration remaining = duration::max();
+
+		if (state_ == State::Active)
+		{
+			for (auto i : tasks_)
+				if (i->state_ == Task::State::Active && i->timer_.interval().count() != 0)
+				{
+					duration elapsed = i->timer_.elapsed();
+					duration due = elapsed < i->timer_.interval() ? i->timer_.interval() - elapsed : duration();
+
+					if (due < remaining)
+						remaining = due;
+				}
+		}
+
+		return remaining;
+	}
+
 	template<class T>
 	void TaskScheduler<T>::tick()
 	{
@@ -287,16 +360,74 @@ namespace pg
 		{
 			for (auto i : tasks_)
 				if (i->state_ == Task::State::Active)
-					i->timer_.tick();
+					run(i);
+		}
+	}
+
+	template<class T>
+	void TaskScheduler<T>::tick(uint8_t core)
+	{
+		if (state_ == State::Active)
+		{
+			for (auto i : tasks_)
+			{
+				if (i->state_ != Task::State::Active)
+					continue;
+				if (i->affinity_ == core)
+					run(i);
+				else if (i->affinity_ == Task::AnyCore && claim(i))
+				{
+					run(i);
+					core_lock_guard guard(*lock_);
+					i->claimed_ = false;
+				}
+			}
+		}
+	}
+
+	template<class T>
+	void TaskScheduler<T>::run(Task* task)
+	{
+# if defined __PG_TASK_STATS
+		task->stats_.tick(task->timer_);
+# else
+		task->timer_.tick();
+# endif
+	}
+
+	template<class T>
+	bool TaskScheduler<T>::claim(Task* task)
+	{
+		bool result = false;
+
+		if (task->timer_.expired())	// Only take the lock for tasks that are due.
+		{
+			core_lock_guard guard(*lock_);
+
+			if (!task->claimed_)
+				result = task->claimed_ = true;
 		}
+
+		return result;
+	}
+
+	template<class T>
+	core_lock& TaskScheduler<T>::claims()
+	{
+		static core_lock lock;
+
+		return lock;
 	}
 
 #pragma endregion
 #pragma region Task
 
 	template<class T>
-	TaskScheduler<T>::Task::Task(duration interval, icommand* command, State state) :
-		timer_(interval, command, true), state_(state) 
+	TaskScheduler<T>::Task::Task(duration interval, icommand* command, State state, uint8_t affinity) :
+		timer_(interval, command, true), state_(state), affinity_(affinity), claimed_()
+# if defined __PG_TASK_STATS
+		, stats_()
+# endif
 	{
 		assert(command);
 	}
@@ -347,6 +478,32 @@ namespace pg
 		timer_.reset();
 	}
 
+	template<class T>
+	void TaskScheduler<T>::Task::affinity(uint8_t core)
+	{
+		affinity_ = core;
+	}
+
+	template<class T>
+	uint8_t TaskScheduler<T>::Task::affinity() const
+	{
+		return affinity_;
+	}
+
+# if defined __PG_TASK_STATS
+	template<class T>
+	TaskStats& TaskScheduler<T>::Task::stats()
+	{
+		return stats_;
+	}
+
+	template<class T>
+	const TaskStats& TaskScheduler<T>::Task::stats() const
+	{
+		return stats_;
+	}
+
+# endif
 #pragma endregion
 } // namespace pg
 
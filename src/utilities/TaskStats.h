@@ -0,0 +1,122 @@
+/*
+ *	This files defines a task execution statistics type.
+ *
+ *	***************************************************************************
+ *
+ *	File: TaskStats.h
+ *	Date: October 14, 2026
+ *	Version: 1.0
+ *	Author: Michael Brodsky
+ *	Email: mbrodskiis@gmail.com
+ *	Copyright (c) 2012-2022 Michael Brodsky
+ *
+ *	***************************************************************************
+ *
+ *  This file is part of "Pretty Good" (Pg). "Pg" is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  This file is distributed in the hope that it will be useful, but
+ *	WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *	along with this file. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *	Description:
+ *
+ *		TaskStats records how long a scheduled task takes to execute and how
+ *		late it runs. It is used by TaskScheduler and DeadlineScheduler tasks
+ *		when __PG_TASK_STATS is defined, and compiled out otherwise.
+ *
+ *		Execution times are measured with micros(). Lateness (jitter) is the
+ *		time between when a task was due and when it ran, and has the same
+ *		resolution as the task timer. A run whose execution time exceeds the
+ *		task interval counts as an overrun.
+ *
+ *	**************************************************************************/
+
+#if !defined __PG_TASKSTATS_H
+# define __PG_TASKSTATS_H 20261014L
+
+# include <chrono>		// std::chrono types.
+# include <cstdint>		// Fixed-width integer types.
+# include <system/api.h>	// micros().
+
+# if defined __PG_HAS_NAMESPACES
+
+namespace pg
+{
+	// Task execution time and jitter statistics.
+	struct TaskStats
+	{
+		using value_type = uint32_t;	// Type that holds times in microseconds and counts.
+
+		value_type	runs_;		// Number of times the task executed.
+		value_type	min_;		// Shortest execution time.
+		value_type	max_;		// Longest execution time.
+		uint64_t	total_;		// Total execution time.
+		value_type	late_;		// Longest scheduling lateness.
+		value_type	overruns_;	// Number of executions longer than the task interval.
+
+		// Returns the mean execution time.
+		value_type mean() const;
+		// Records one execution.
+		void record(value_type, value_type, value_type);
+		// Clears all statistics.
+		void reset();
+		// Ticks a CommandTimer and records its execution, if any.
+		template<class T>
+		void tick(T&);
+	};
+
+	typename TaskStats::value_type TaskStats::mean() const
+	{
+		return runs_ ? static_cast<value_type>(total_ / runs_) : 0;
+	}
+
+	void TaskStats::record(value_type time, value_type late, value_type interval)
+	{
+		if (runs_ == 0 || time < min_)
+			min_ = time;
+		if (time > max_)
+			max_ = time;
+		if (late > late_)
+			late_ = late;
+		if (time > interval)
+			++overruns_;
+		total_ += time;
+		++runs_;
+	}
+
+	void TaskStats::reset()
+	{
+		runs_ = min_ = max_ = late_ = overruns_ = 0;
+		total_ = 0;
+	}
+
+	template<class T>
+	void TaskStats::tick(T& timer)
+	{
+		using std::chrono::duration_cast;
+		using std::chrono::microseconds;
+
+		if (timer.expired())
+		{
+			const value_type interval = duration_cast<microseconds>(timer.interval()).count();
+			const value_type late = duration_cast<microseconds>(timer.elapsed()).count() - interval;
+			const value_type begin = micros();
+
+			timer.tick();
+			record(micros() - begin, late, interval);
+		}
+	}
+} // namespace pg
+
+# else // !defined __PG_HAS_NAMESPACES
+#  error Requires C++11 and namespace support.
+# endif // defined __PG_HAS_NAMESPACES
+
+#endif // !defined __PG_TASKSTATS_H
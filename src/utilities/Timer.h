@@ -72,12 +72,17 @@ namespace pg
 	{
 		// The clock source is set to millis() (std::chrono::system_clock), 
 		// since it may be more useful as micros() (std::chrono::steady_clock)
-		// rolls over after 70 minutes. Might want to add another template 
-		// parameter so clients can select the source.
+		// rolls over after 70 minutes. If __PG_HW_CLOCK is defined, the 
+		// steady clock is a non-wrapping hardware clock and used instead 
+		// (see <system/hwclock.h>).
 	public:
 		using duration = T;
-		using time_point = std::chrono::time_point<std::chrono::system_clock, duration>;
+# if defined __PG_HW_CLOCK
+		using clock_type = std::chrono::steady_clock;
+# else
 		using clock_type = std::chrono::system_clock;
+# endif
+		using time_point = std::chrono::time_point<clock_type, duration>;
 
 	public:
 		// Constructs and initializes the timer with a given interval.
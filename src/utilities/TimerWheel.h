@@ -0,0 +1,448 @@
+/*
+ *	This files defines a hierarchical timer wheel service.
+ *
+ *	***************************************************************************
+ *
+ *	File: TimerWheel.h
+ *	Date: October 14, 2026
+ *	Version: 1.0
+ *	Author: Michael Brodsky
+ *	Email: mbrodskiis@gmail.com
+ *	Copyright (c) 2012-2022 Michael Brodsky
+ *
+ *	***************************************************************************
+ *
+ *  This file is part of "Pretty Good" (Pg). "Pg" is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  This file is distributed in the hope that it will be useful, but
+ *	WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *	along with this file. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *	Description:
+ *
+ *		The TimerWheel class services large numbers of software timers from a
+ *		single clock read per `tick()'. Timers are `Handle' objects, owned by
+ *		the client, that have the same interface as `Timer' and `CommandTimer'
+ *		(see <utilities/Timer.h> and <utilities/CommandTimer.h>). Running
+ *		handles are linked into the slots of a hierarchical wheel: `Levels'
+ *		wheels of 2^`Bits' slots each, where every level counts 2^`Bits' times
+ *		slower than the one below it. Starting, stopping and expiring a timer
+ *		each take constant time, and timers due beyond the range of the
+ *		highest level are re-queued when that level turns over.
+ *
+ *		The wheel extends the 32-bit api clock into a 64-bit tick count, so
+ *		intervals and elapsed times are not affected by millis() or micros()
+ *		rolling over, as long as `tick()' is called at least once per
+ *		rollover period. All handle times advance only when the wheel ticks,
+ *		in units of the duration type `T'.
+ *
+ *		When a handle expires it executes its command, if any, then either
+ *		restarts or stops, depending on its repeat mode. Stopped handles stay
+ *		expired until restarted, the same as `Timer'.
+ *
+ *	Notes:
+ *
+ *		Handles must not outlive, or be copied between, wheels.
+ *
+ *	**************************************************************************/
+
+#if !defined __PG_TIMERWHEEL_H
+# define __PG_TIMERWHEEL_H 20261014L
+
+# include <chrono>					// std::chrono types.
+# include <cstdint>					// Fixed-width integer types.
+# include <interfaces/icommand.h>	// `icommand' interface.
+
+# if defined __PG_HAS_NAMESPACES
+
+namespace pg
+{
+	// Services many software timers from a single clock.
+	template<class T = std::chrono::milliseconds, class Clock = std::chrono::system_clock, uint8_t Bits = 5, uint8_t Levels = 4>
+	class TimerWheel
+	{
+	public:
+		using duration = T;
+		using clock_type = Clock;
+		using tick_type = uint64_t;									// Extended tick count type.
+
+		static constexpr uint8_t SlotsCount = 1U << Bits;			// Number of slots in each level.
+		static constexpr tick_type SlotsMask = SlotsCount - 1;		// Level slot index mask.
+		static constexpr tick_type Range =							// Longest interval that does not need re-queuing.
+			(tick_type(1) << (Bits * Levels)) - 1;
+
+		// Timer handle type.
+		class Handle
+		{
+			friend class TimerWheel;
+
+		public:
+			// Constructs a handle on a wheel, with an optional interval, command and repeat mode.
+			explicit Handle(TimerWheel&, duration = duration(), icommand* = nullptr, bool = false);
+			// Unlinks the handle from its wheel.
+			~Handle();
+			// No copy constructor.
+			Handle(const Handle&) = delete;
+			// No copy assignment operator.
+			Handle& operator=(const Handle&) = delete;
+
+		public:
+			bool		active() const;				// Checks whether the timer is currently active.
+			void		command(icommand*);			// Sets the timer command.
+			icommand*	command() const;			// Returns the current timer command.
+			duration	elapsed() const;			// Returns the current elapsed time.
+			bool		expired() const;			// Checks whether the timer is currently expired.
+			void		interval(duration);			// Assigns a new interval.
+			duration	interval() const;			// Returns the current timer interval.
+			void		repeats(bool);				// Sets the interval repeat mode.
+			bool		repeats() const;			// Returns the current interval's repeat mode.
+			void		reset();					// Resets the elapsed time.
+			void		resume();					// Resumes the timer at the currently elapsed time.
+			void		start();					// Starts the timer.
+			void		start(duration);			// Starts the timer with a new interval.
+			void		stop();						// Stops the timer at the currently elapsed time.
+
+		private:
+			void schedule();						// Links the handle into the wheel if it can expire.
+
+		private:
+			TimerWheel&	wheel_;		// The wheel servicing this handle.
+			Handle*		next_;		// Next handle in the same slot.
+			Handle**	prev_;		// Link pointing to this handle, nullptr if not linked.
+			tick_type	begin_;		// Tick when the timer started.
+			tick_type	expiry_;	// Tick when the timer is due.
+			tick_type	elapsed_;	// Elapsed ticks when stopped.
+			duration	interval_;	// Current timer interval.
+			icommand*	command_;	// Command executed on expiry.
+			bool		repeats_;	// Flag indicating whether the interval repeats when expired.
+			bool		active_;	// Flag indicating whether the timer is currently active.
+		};
+
+	public:
+		TimerWheel();
+		// No copy constructor.
+		TimerWheel(const TimerWheel&) = delete;
+		// No copy assignment operator.
+		TimerWheel& operator=(const TimerWheel&) = delete;
+
+	public:
+		// Returns the current extended tick count.
+		tick_type now() const;
+		// Returns the number of running timers.
+		std::size_t size() const;
+		// Reads the clock once and expires any timers that are due.
+		void tick();
+
+	private:
+		void advance();						// Advances the wheel by one tick.
+		void cascade(uint8_t);				// Re-queues the current slot of a level into lower levels.
+		void expire();						// Expires the current slot of level 0.
+		void link(Handle*);					// Links a handle into the slot for its expiry tick.
+		void link(Handle*, tick_type);		// Links a handle, no earlier than a given tick.
+		void unlink(Handle*);				// Unlinks a handle from its slot.
+		static uint32_t raw();				// Reads the 32-bit api clock.
+
+	private:
+		using clock_ticks = std::chrono::duration<tick_type, typename clock_type::duration::period>;
+		using wheel_ticks = std::chrono::duration<tick_type, typename duration::period>;
+
+		Handle*		slots_[Levels][SlotsCount];	// Slot lists, by level.
+		Handle*		pending_;					// Handles being expired.
+		tick_type	now_;						// Current extended tick count.
+		tick_type	clock_;						// Current extended clock count, in clock units.
+		uint32_t	last_;						// Last raw clock reading.
+		std::size_t	size_;						// Number of linked handles.
+	};
+
+#pragma region TimerWheel
+
+	template<class T, class Clock, uint8_t Bits, uint8_t Levels>
+	TimerWheel<T, Clock, Bits, Levels>::TimerWheel() :
+		slots_(), pending_(), now_(), clock_(), last_(raw()), size_()
+	{
+
+	}
+
+	template<class T, class Clock, uint8_t Bits, uint8_t Levels>
+	typename TimerWheel<T, Clock, Bits, Levels>::tick_type TimerWheel<T, Clock, Bits, Levels>::now() const
+	{
+		return now_;
+	}
+
+	template<class T, class Clock, uint8_t Bits, uint8_t Levels>
+	std::size_t TimerWheel<T, Clock, Bits, Levels>::size() const
+	{
+		return size_;
+	}
+
+	template<class T, class Clock, uint8_t Bits, uint8_t Levels>
+	void TimerWheel<T, Clock, Bits, Levels>::tick()
+	{
+		const uint32_t reading = raw();
+		tick_type now;
+
+		clock_ += static_cast<uint32_t>(reading - last_);	// Unsigned difference survives rollover.
+		last_ = reading;
+		now = std::chrono::duration_cast<wheel_ticks>(clock_ticks(clock_)).count();
+		if (size_)
+			while (now_ < now)
+				advance();
+		else
+			now_ = now;	// Nothing to expire, skip ahead.
+	}
+
+	template<class T, class Clock, uint8_t Bits, uint8_t Levels>
+	void TimerWheel<T, Clock, Bits, Levels>::advance()
+	{
+		++now_;
+		for (uint8_t level = 1; level < Levels; ++level)
+		{
+			if (now_ & ((tick_type(1) << (Bits * level)) - 1))
+				break;
+			cascade(level);
+		}
+		expire();
+	}
+
+	template<class T, class Clock, uint8_t Bits, uint8_t Levels>
+	void TimerWheel<T, Clock, Bits, Levels>::cascade(uint8_t level)
+	{
+		Handle*& slot = slots_[level][(now_ >> (Bits * level)) & SlotsMask];
+
+		while (slot)
+		{
+			Handle* handle = slot;
+
+			unlink(handle);
+			link(handle, now_);	// Slot now_ hasn't expired yet, so handles due now still expire on time.
+		}
+	}
+
+	template<class T, class Clock, uint8_t Bits, uint8_t Levels>
+	void TimerWheel<T, Clock, Bits, Levels>::expire()
+	{
+		Handle*& slot = slots_[0][now_ & SlotsMask];
+
+		// Move the slot to a pending list, so commands can start or stop any handle.
+		// Handles on the pending list are still counted by size_.
+		if ((pending_ = slot))
+			pending_->prev_ = &pending_;
+		slot = nullptr;
+		while (pending_)
+		{
+			Handle* handle = pending_;
+
+			unlink(handle);
+			if (handle->expiry_ > now_)
+				link(handle);			// Not due yet, was queued beyond the wheel range.
+			else
+			{
+				if (handle->repeats_)
+				{
+					handle->begin_ = now_;
+					handle->schedule();
+				}
+				else
+				{
+					handle->active_ = false;
+					handle->elapsed_ = handle->expiry_ - handle->begin_;
+				}
+				if (handle->command_)
+					handle->command_->execute();
+			}
+		}
+	}
+
+	template<class T, class Clock, uint8_t Bits, uint8_t Levels>
+	void TimerWheel<T, Clock, Bits, Levels>::link(Handle* handle)
+	{
+		link(handle, now_ + 1);	// Slot now_ has already expired.
+	}
+
+	template<class T, class Clock, uint8_t Bits, uint8_t Levels>
+	void TimerWheel<T, Clock, Bits, Levels>::link(Handle* handle, tick_type earliest)
+	{
+		tick_type expiry = handle->expiry_ > earliest ? handle->expiry_ : earliest;
+		const tick_type delta = expiry - now_;
+		uint8_t level = 0;
+		Handle** slot;
+
+		if (delta > Range)
+			expiry = now_ + Range;	// Re-queued when the highest level turns over.
+		while (level < Levels - 1 && (expiry - now_) >> (Bits * (level + 1)))
+			++level;
+		slot = &slots_[level][(expiry >> (Bits * level)) & SlotsMask];
+		handle->next_ = *slot;
+		if (handle->next_)
+			handle->next_->prev_ = &handle->next_;
+		handle->prev_ = slot;
+		*slot = handle;
+		++size_;
+	}
+
+	template<class T, class Clock, uint8_t Bits, uint8_t Levels>
+	void TimerWheel<T, Clock, Bits, Levels>::unlink(Handle* handle)
+	{
+		if (handle->prev_)
+		{
+			*handle->prev_ = handle->next_;
+			if (handle->next_)
+				handle->next_->prev_ = handle->prev_;
+			handle->next_ = nullptr;
+			handle->prev_ = nullptr;
+			--size_;
+		}
+	}
+
+	template<class T, class Clock, uint8_t Bits, uint8_t Levels>
+	uint32_t TimerWheel<T, Clock, Bits, Levels>::raw()
+	{
+		return static_cast<uint32_t>(clock_type::now().time_since_epoch().count());
+	}
+
+#pragma endregion
+#pragma region Handle
+
+	template<class T, class Clock, uint8_t Bits, uint8_t Levels>
+	TimerWheel<T, Clock, Bits, Levels>::Handle::Handle(TimerWheel& wheel, duration intvl, icommand* cmd, bool repeats) :
+		wheel_(wheel), next_(), prev_(), begin_(), expiry_(), elapsed_(), interval_(intvl),
+		command_(cmd), repeats_(repeats), active_()
+	{
+
+	}
+
+	template<class T, class Clock, uint8_t Bits, uint8_t Levels>
+	TimerWheel<T, Clock, Bits, Levels>::Handle::~Handle()
+	{
+		wheel_.unlink(this);
+	}
+
+	template<class T, class Clock, uint8_t Bits, uint8_t Levels>
+	bool TimerWheel<T, Clock, Bits, Levels>::Handle::active() const
+	{
+		return active_;
+	}
+
+	template<class T, class Clock, uint8_t Bits, uint8_t Levels>
+	void TimerWheel<T, Clock, Bits, Levels>::Handle::command(icommand* cmd)
+	{
+		command_ = cmd;
+	}
+
+	template<class T, class Clock, uint8_t Bits, uint8_t Levels>
+	icommand* TimerWheel<T, Clock, Bits, Levels>::Handle::command() const
+	{
+		return command_;
+	}
+
+	template<class T, class Clock, uint8_t Bits, uint8_t Levels>
+	typename TimerWheel<T, Clock, Bits, Levels>::duration TimerWheel<T, Clock, Bits, Levels>::Handle::elapsed() const
+	{
+		return duration(active_ ? wheel_.now_ - begin_ : elapsed_);
+	}
+
+	template<class T, class Clock, uint8_t Bits, uint8_t Levels>
+	bool TimerWheel<T, Clock, Bits, Levels>::Handle::expired() const
+	{
+		// Returns true only if initialized and expired.
+		return !(interval_.count() == 0 || elapsed() < interval_);
+	}
+
+	template<class T, class Clock, uint8_t Bits, uint8_t Levels>
+	void TimerWheel<T, Clock, Bits, Levels>::Handle::interval(duration intvl)
+	{
+		interval_ = intvl;
+		if (active_)
+			schedule();
+	}
+
+	template<class T, class Clock, uint8_t Bits, uint8_t Levels>
+	typename TimerWheel<T, Clock, Bits, Levels>::duration TimerWheel<T, Clock, Bits, Levels>::Handle::interval() const
+	{
+		return interval_;
+	}
+
+	template<class T, class Clock, uint8_t Bits, uint8_t Levels>
+	void TimerWheel<T, Clock, Bits, Levels>::Handle::repeats(bool repeats)
+	{
+		repeats_ = repeats;
+	}
+
+	template<class T, class Clock, uint8_t Bits, uint8_t Levels>
+	bool TimerWheel<T, Clock, Bits, Levels>::Handle::repeats() const
+	{
+		return repeats_;
+	}
+
+	template<class T, class Clock, uint8_t Bits, uint8_t Levels>
+	void TimerWheel<T, Clock, Bits, Levels>::Handle::reset()
+	{
+		// Resets the elapsed time only, not whether timer is active.
+		begin_ = wheel_.now_;
+		elapsed_ = 0;
+		if (active_)
+			schedule();
+	}
+
+	template<class T, class Clock, uint8_t Bits, uint8_t Levels>
+	void TimerWheel<T, Clock, Bits, Levels>::Handle::resume()
+	{
+		if (!active_)
+		{
+			begin_ = wheel_.now_ - elapsed_;
+			active_ = true;
+			schedule();
+		}
+	}
+
+	template<class T, class Clock, uint8_t Bits, uint8_t Levels>
+	void TimerWheel<T, Clock, Bits, Levels>::Handle::start()
+	{
+		reset();
+		resume();
+	}
+
+	template<class T, class Clock, uint8_t Bits, uint8_t Levels>
+	void TimerWheel<T, Clock, Bits, Levels>::Handle::start(duration intvl)
+	{
+		interval_ = intvl;
+		start();
+	}
+
+	template<class T, class Clock, uint8_t Bits, uint8_t Levels>
+	void TimerWheel<T, Clock, Bits, Levels>::Handle::stop()
+	{
+		if (active_)
+		{
+			elapsed_ = wheel_.now_ - begin_;
+			active_ = false;
+			wheel_.unlink(this);
+		}
+	}
+
+	template<class T, class Clock, uint8_t Bits, uint8_t Levels>
+	void TimerWheel<T, Clock, Bits, Levels>::Handle::schedule()
+	{
+		wheel_.unlink(this);
+		if (interval_.count() != 0)	// Zero intervals never expire.
+		{
+			expiry_ = begin_ + interval_.count();
+			wheel_.link(this);
+		}
+	}
+
+#pragma endregion
+} // namespace pg
+
+# else // !defined __PG_HAS_NAMESPACES
+#  error Requires C++11 and namespace support.
+# endif // defined __PG_HAS_NAMESPACES
+
+#endif // !defined __PG_TIMERWHEEL_H